@@ -1,9 +1,10 @@
-%module pyUni10
+%module(threads="1") pyUni10
 
 %{
   /* Put header files here or function declarations like below */
   #define SWIG_FILE_WITH_INIT
   #include <sstream>
+  #include <algorithm>
   #include <complex>
   #include <uni10/datatype/Qnum.h>
   #include <uni10/data-structure/Bond.h>
@@ -57,8 +58,29 @@ namespace std{
 %apply (std::complex<double>* ARGOUT_ARRAY1, int DIM1) {(std::complex<double>* out_array, int elem_num)}
 %apply (double* IN_ARRAY1, int DIM1) {(double* in_array, int elem_num)}
 %apply (std::complex<double>* IN_ARRAY1, int DIM1) {(std::complex<double>* in_array, int elem_num)}
+%apply (double* INPLACE_ARRAY1, int DIM1) {(double* inplace_array, int elem_num)}
+%apply (std::complex<double>* INPLACE_ARRAY1, int DIM1) {(std::complex<double>* inplace_array, int elem_num)}
 %feature("autodoc");
 
+/* Only release the GIL around the heavy numerical routines and file I/O; everything
+   else, in particular the %extend helpers calling the Python C API, keeps holding it. */
+%nothread;
+%thread uni10::contract;
+%thread uni10::otimes;
+%thread uni10::Network::launch;
+%thread uni10::Network::construct;
+%thread uni10::Network::Network;
+%thread uni10::UniTensor::permute;
+%thread uni10::UniTensor::permuteFm;
+%thread uni10::UniTensor::save;
+%thread uni10::UniTensor::UniTensor;
+%thread uni10::UniTensor::hosvd;
+%thread uni10::Block::svd;
+%thread uni10::Block::eig;
+%thread uni10::Block::eigh;
+%thread uni10::Block::save;
+%thread uni10::Matrix::Matrix;
+
 %exception {
     try {
       $action
@@ -71,6 +93,8 @@ namespace std{
     }
 }
 
+%newobject _UniTensorViewR;
+%newobject _UniTensorViewC;
 %inline{
   uni10::Qnum QnumF(uni10::parityFType _prtF, int _U1=0, uni10::parityType _prt=uni10::PRT_EVEN){
     return uni10::Qnum(_prtF, _U1, _prt);
@@ -84,8 +108,64 @@ namespace std{
   uni10::Matrix CMatrix(const std::string& fname){
       return uni10::Matrix(uni10::CTYPE, fname);
   }
+  /* Non-owning Blocks on top of numpy buffers, see Block.viewNparray */
+  uni10::Block _BlockViewR(size_t _Rnum, size_t _Cnum, bool _diag, double* inplace_array, int elem_num){
+      size_t num = _diag ? std::min(_Rnum, _Cnum) : _Rnum * _Cnum;
+      if((size_t)elem_num != num)
+          throw std::runtime_error("The size of the array does not match the shape of the Block.");
+      return uni10::Block(_Rnum, _Cnum, inplace_array, _diag);
+  }
+  uni10::Block _BlockViewC(size_t _Rnum, size_t _Cnum, bool _diag, std::complex<double>* inplace_array, int elem_num){
+      size_t num = _diag ? std::min(_Rnum, _Cnum) : _Rnum * _Cnum;
+      if((size_t)elem_num != num)
+          throw std::runtime_error("The size of the array does not match the shape of the Block.");
+      return uni10::Block(_Rnum, _Cnum, inplace_array, _diag);
+  }
+  /* Non-owning UniTensors on top of numpy buffers, see UniTensor.viewNparray */
+  uni10::UniTensor* _UniTensorViewR(const std::vector<uni10::Bond>& _bonds, double* inplace_array, int elem_num){
+      uni10::UniTensor* T = new uni10::UniTensor(_bonds, inplace_array);
+      if(T->elemNum() != (size_t)elem_num){
+          delete T;
+          throw std::runtime_error("The size of the array does not match the bonds of the UniTensor.");
+      }
+      return T;
+  }
+  uni10::UniTensor* _UniTensorViewC(const std::vector<uni10::Bond>& _bonds, std::complex<double>* inplace_array, int elem_num){
+      uni10::UniTensor* T = new uni10::UniTensor(_bonds, inplace_array);
+      if(T->elemNum() != (size_t)elem_num){
+          delete T;
+          throw std::runtime_error("The size of the array does not match the bonds of the UniTensor.");
+      }
+      return T;
+  }
 };
 
+%pythoncode{
+import sys as _sys
+
+class _ElemView(object):
+    """Exposes a raw uni10 element buffer through the numpy array interface.
+
+    Holds a reference to the owning object so that the buffer outlives every
+    numpy array created from it. The view is only valid until the owner
+    reallocates its storage (permute, assign, resize, ...).
+    """
+    def __init__(self, owner, addr, shape, typeid):
+        self._owner = owner
+        order = '<' if _sys.byteorder == 'little' else '>'
+        self.__array_interface__ = {
+            'version': 3,
+            'shape': tuple(shape),
+            'typestr': order + ('c16' if typeid == 2 else 'f8'),
+            'data': (addr, False)}
+
+def _npview(owner, addr, shape, typeid):
+    import numpy
+    if addr == 0 or typeid == 0:
+        raise RuntimeError("Can not create a view of an empty object.")
+    return numpy.asarray(_ElemView(owner, addr, shape, typeid))
+}
+
 namespace uni10{
 /* Qnum */
 enum parityType{
@@ -321,7 +401,45 @@ class Block{
       Matrix __rmul__(double a){
         return a * (*self);
       }
+      size_t _elemAddress(){
+        if((*self).isOngpu())
+          throw std::runtime_error("Can not create a numpy view of a Block on GPU.");
+        if((*self).typeID() == 2)
+          return reinterpret_cast<size_t>((*self).getElem(uni10::CTYPE));
+        return reinterpret_cast<size_t>((*self).getElem());
+      }
       %pythoncode {
+          def npview(self):
+              """Returns a numpy array sharing memory with the Block, no copy is made."""
+              shape = (self.elemNum(),) if self.isDiag() else (self.row(), self.col())
+              return _npview(self, self._elemAddress(), shape, self.typeID())
+
+          @property
+          def __array_interface__(self):
+              shape = (self.elemNum(),) if self.isDiag() else (self.row(), self.col())
+              return _ElemView(self, self._elemAddress(), shape, self.typeID()).__array_interface__
+
+          @staticmethod
+          def viewNparray(npa, diag=False):
+              """Adopts the buffer of a C-contiguous float64/complex128 numpy array as a Block.
+
+              No copy is made; the Block keeps a reference to the array. A non-contiguous
+              array (e.g. a transpose) is rejected, pass np.ascontiguousarray(npa) to copy it.
+              """
+              if not npa.flags['C_CONTIGUOUS']:
+                  raise ValueError("Can not view a non-contiguous array, use np.ascontiguousarray() first.")
+              if diag:
+                  nrow = ncol = npa.shape[0]
+              else:
+                  nrow = npa.shape[0]; ncol = npa.shape[1]
+              if npa.dtype == 'complex128':
+                  blk = _BlockViewC(nrow, ncol, diag, npa.reshape(-1))
+              else:
+                  blk = _BlockViewR(nrow, ncol, diag, npa.reshape(-1))
+              blk._npbase = npa
+              blk.args = (nrow, ncol, diag)
+              return blk
+
           def __init__(self, *args):
               """
               __init__(uni10::Block self) -> Block
@@ -820,6 +938,17 @@ class UniTensor{
       static const std::string profile(){
         return uni10::UniTensor::profile(false);
       }
+      size_t _elemAddress(){
+        if((*self).typeID() == 2)
+          return reinterpret_cast<size_t>((*self).getElem(uni10::CTYPE));
+        return reinterpret_cast<size_t>((*self).getElem());
+      }
+      size_t _blockAddress(const uni10::Qnum& qnum){
+        uni10::BlockView blk = (*self).getBlockView(qnum);
+        if(blk.typeID() == 2)
+          return reinterpret_cast<size_t>(blk.getElem(uni10::CTYPE));
+        return reinterpret_cast<size_t>(blk.getElem());
+      }
       const std::string printRawElem(){
         return (*self).printRawElem(false);
       }
@@ -844,6 +973,23 @@ class UniTensor{
               else:
                   self.setElemR(elem)
 
+          @staticmethod
+          def viewNparray(bonds, npa):
+              """Creates a UniTensor on top of the buffer of a C-contiguous float64/complex128 numpy array.
+
+              No copy is made; the tensor keeps a reference to the array and writes to it land in the
+              array, in the order of getRawElem(), until the tensor reallocates its storage (permute,
+              assign, ...). Copies of the tensor get their own elements.
+              """
+              if not npa.flags['C_CONTIGUOUS']:
+                  raise ValueError("Can not view a non-contiguous array, use np.ascontiguousarray() first.")
+              if npa.dtype == 'complex128':
+                  ut = _UniTensorViewC(bonds, npa.reshape(-1))
+              else:
+                  ut = _UniTensorViewR(bonds, npa.reshape(-1))
+              ut._npbase = npa
+              return ut
+
           def putBlockNparray(self, npa, qn=Qnum()):
               blk = Matrix.fromNparray(npa)
               self.putBlock(qn, blk)
@@ -851,6 +997,25 @@ class UniTensor{
           def getBlockNparray(self, qn=Qnum(), diag=False):
               return self.getBlock(qn, diag).nparray()
 
+          def npview(self, qn=None):
+              """Returns a numpy array sharing memory with the tensor, no copy is made.
+
+              Without \c qn, the whole element storage is returned; it is shaped by the bond
+              dimensions when the tensor carries no symmetry and flat (block by block) otherwise.
+              With \c qn, the block of that quantum number is returned as a matrix.
+              Copies of the tensor made afterwards get their own elements, so writes
+              through the view never reach them.
+              """
+              if qn is not None:
+                  blk = self.const_getBlock(qn)
+                  return _npview(self, self._blockAddress(qn), (blk.row(), blk.col()), self.typeID())
+              qns = self.blockQnum()
+              if len(qns) == 1 and all(len(bd.degeneracy()) == 1 for bd in self.bond()):
+                  shape = tuple([bd.dim() for bd in self.bond()])
+              else:
+                  shape = (self.elemNum(),)
+              return _npview(self, self._elemAddress(), shape, self.typeID())
+
           def getBlocksNparray(self):
               qnums = self.blockQnum()
               blk_dict = {}
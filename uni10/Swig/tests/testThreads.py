@@ -0,0 +1,74 @@
+"""Checks that pyUni10 releases the GIL around contract and permute, and that
+contractions from several Python threads match a serial run."""
+from __future__ import print_function
+import threading
+import time
+import unittest
+import pyUni10 as uni10
+
+
+def operands(dim):
+    bdi = uni10.Bond(uni10.BD_IN, dim)
+    bdo = uni10.Bond(uni10.BD_OUT, dim)
+    A = uni10.UniTensor([bdi, bdo])
+    B = uni10.UniTensor([bdi, bdo])
+    A.randomize()
+    B.randomize()
+    A.setLabel([1, 2])
+    B.setLabel([2, 3])
+    return A, B
+
+
+class TestThreads(unittest.TestCase):
+
+    def test_gil_released(self):
+        A, B = operands(700)
+        start = time.time()
+        uni10.contract(uni10.UniTensor(A), uni10.UniTensor(B), False)
+        duration = time.time() - start
+        if duration < 0.02:
+            self.skipTest("a contraction is too fast to observe the GIL")
+
+        # a ticker that needs the GIL, between sleeps that do not
+        stamps = []
+        running = [True]
+        def tick():
+            while running[0]:
+                stamps.append(time.time())
+                time.sleep(0.001)
+        ticker = threading.Thread(target=tick)
+        ticker.start()
+        time.sleep(0.01)
+        start = time.time()
+        uni10.contract(uni10.UniTensor(A), uni10.UniTensor(B), False)
+        end = time.time()
+        running[0] = False
+        ticker.join()
+
+        # with the GIL held, the ticker would stall for the whole contraction
+        during = [t for t in stamps if start <= t <= end]
+        edges = [start] + during + [end]
+        gap = max(b - a for a, b in zip(edges[:-1], edges[1:]))
+        self.assertLess(gap, 0.5 * (end - start))
+
+    def test_concurrent_contract(self):
+        pairs = [operands(16) for i in range(20)]
+        serial = [uni10.contract(uni10.UniTensor(A), uni10.UniTensor(B), False).getBlock() for A, B in pairs]
+        results = [[] for t in range(4)]
+        def work(out):
+            for A, B in pairs:
+                out.append(uni10.contract(uni10.UniTensor(A), uni10.UniTensor(B), False).getBlock())
+        workers = [threading.Thread(target=work, args=(out,)) for out in results]
+        for w in workers:
+            w.start()
+        for w in workers:
+            w.join()
+        for out in results:
+            self.assertEqual(len(out), len(serial))
+            for M, ref in zip(out, serial):
+                for i in range(ref.elemNum()):
+                    self.assertEqual(M[i], ref[i])
+
+
+if __name__ == '__main__':
+    unittest.main()
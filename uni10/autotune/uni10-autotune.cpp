@@ -0,0 +1,178 @@
+/****************************************************************************
+*  @file uni10-autotune.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Calibrates the machine-dependent kernel parameters and writes the tuning profile
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+//
+//   uni10-autotune [--out FILE] [--quick]
+//
+// Times the kernels with each candidate parameter on this machine and writes the best ones to
+// FILE (default $HOME/.uni10/tuning), which uni10 reads on startup. Run it once per machine.
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sys/stat.h>
+#include <uni10.hpp>
+#include <uni10/numeric/lapack/uni10_lapack.h>
+#include <uni10/tools/uni10_tools.h>
+
+using namespace uni10;
+
+namespace{
+  double quantum = 0.02;  // seconds of repetitions per measurement
+
+  // Fastest time per call of f among 3 measurements
+  template<typename F>
+  double timeit(F f){
+    double best = std::numeric_limits<double>::max();
+    for(int m = 0; m < 3; m++){
+      size_t reps = 0;
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      double elapsed = 0;
+      do{
+        f();
+        reps++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      }while(elapsed < quantum);
+      best = std::min(best, elapsed / reps);
+    }
+    return best;
+  }
+
+  // The smallest M*N*K from which BLAS wins for every larger shape tried.
+  size_t tuneGemm(TuningParams params){
+    const int shapes[][3] = {{2, 2, 2}, {4, 4, 4}, {2, 16, 16}, {6, 6, 6}, {8, 8, 8}, {4, 32, 16}, {12, 12, 12},
+      {16, 16, 16}, {8, 64, 16}, {20, 20, 20}, {24, 24, 24}, {32, 32, 32}, {48, 48, 48}, {64, 64, 64}};
+    const int shapeNum = sizeof(shapes) / sizeof(shapes[0]);
+    // the scan below needs the shapes in increasing M*N*K
+    std::vector<int> order(shapeNum);
+    for(int s = 0; s < shapeNum; s++)
+      order[s] = s;
+    std::stable_sort(order.begin(), order.end(), [&shapes](int a, int b){
+      return (size_t)shapes[a][0] * shapes[a][1] * shapes[a][2] < (size_t)shapes[b][0] * shapes[b][1] * shapes[b][2];
+    });
+    std::vector<double> A(64 * 64), B(64 * 64), C(64 * 64);
+    elemRand(&A[0], A.size(), false);
+    elemRand(&B[0], B.size(), false);
+    std::cout << std::setw(14) << "M x N x K" << std::setw(12) << "loop (us)" << std::setw(12) << "blas (us)" << "\n";
+    std::vector<bool> blasWins(shapeNum);
+    for(int s = 0; s < shapeNum; s++){
+      const int* shape = shapes[order[s]];
+      int M = shape[0], N = shape[1], K = shape[2];
+      params.gemmSmallCutoff = std::numeric_limits<size_t>::max();
+      setTuning(params);
+      double loop = timeit([&]{ matrixMul(&A[0], &B[0], M, N, K, &C[0], false, false, false); });
+      params.gemmSmallCutoff = 0;
+      setTuning(params);
+      double blas = timeit([&]{ matrixMul(&A[0], &B[0], M, N, K, &C[0], false, false, false); });
+      blasWins[s] = blas < loop;
+      std::ostringstream name;
+      name << M << "x" << N << "x" << K;
+      std::cout << std::setw(14) << name.str() << std::fixed << std::setprecision(3)
+        << std::setw(12) << loop * 1E6 << std::setw(12) << blas * 1E6 << "\n";
+    }
+    int s = shapeNum;
+    while(s > 0 && blasWins[s - 1])
+      s--;
+    const int* cutoff = shapes[order[s == shapeNum ? shapeNum - 1 : s]];
+    return (size_t)cutoff[0] * cutoff[1] * cutoff[2];
+  }
+
+  // The tile with the fastest transposes of a matrix-like and a rank-4 tensor.
+  size_t tunePermute(TuningParams params, bool quick){
+    int dim = quick ? 256 : 1024;
+    std::vector<Bond> matBonds(2);
+    matBonds[0] = Bond(BD_IN, dim);
+    matBonds[1] = Bond(BD_OUT, dim);
+    int leg = quick ? 16 : 32;
+    std::vector<Bond> rank4Bonds(2, Bond(BD_IN, leg));
+    rank4Bonds.resize(4, Bond(BD_OUT, leg));
+    UniTensor mat(matBonds), rank4(rank4Bonds);
+    mat.randomize();
+    rank4.randomize();
+    int matOrder[] = {1, 0}, rank4Order[] = {3, 2, 1, 0};
+    const size_t tiles[] = {4, 8, 16, 32, 64, 128, 256};
+    std::cout << std::setw(14) << "tile" << std::setw(12) << "2-leg (ms)" << std::setw(12) << "4-leg (ms)" << "\n";
+    size_t bestTile = params.permuteTile;
+    double bestTime = std::numeric_limits<double>::max();
+    for(size_t t = 0; t < sizeof(tiles) / sizeof(tiles[0]); t++){
+      params.permuteTile = tiles[t];
+      setTuning(params);
+      // permute() only records the permutation, reading a block moves the elements
+      double matTime = timeit([&]{ UniTensor T(mat); T.permute(matOrder, 1); (void)T.const_getBlock(); });
+      double rank4Time = timeit([&]{ UniTensor T(rank4); T.permute(rank4Order, 2); (void)T.const_getBlock(); });
+      std::cout << std::setw(14) << tiles[t] << std::fixed << std::setprecision(3)
+        << std::setw(12) << matTime * 1E3 << std::setw(12) << rank4Time * 1E3 << "\n";
+      if(matTime + rank4Time < bestTime){
+        bestTime = matTime + rank4Time;
+        bestTile = tiles[t];
+      }
+    }
+    return bestTile;
+  }
+};
+
+int main(int argc, char** argv){
+  std::string out = defaultTuningFile();
+  bool quick = false;
+  for(int i = 1; i < argc; i++){
+    if(!strcmp(argv[i], "--out") && i + 1 < argc)
+      out = argv[++i];
+    else if(!strcmp(argv[i], "--quick"))
+      quick = true;
+    else{
+      std::cerr << "Usage: " << argv[0] << " [--out FILE] [--quick]\n";
+      return 1;
+    }
+  }
+  if(out.empty()){
+    std::cerr << "HOME is not set, give the profile with --out FILE.\n";
+    return 1;
+  }
+  if(quick)
+    quantum = 0.002;
+  try{
+    TuningParams params;
+    std::cout << "Calibrating the small matrix product cutoff\n";
+    params.gemmSmallCutoff = tuneGemm(params);
+    std::cout << "\nCalibrating the permute tile\n";
+    params.permuteTile = tunePermute(params, quick);
+    if(out == defaultTuningFile())
+      mkdir(out.substr(0, out.rfind('/')).c_str(), 0755);
+    saveTuning(out, params);
+    std::cout << "\nWrote " << out << ":\n" << params.str();
+  }
+  catch(const std::exception& e){
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,192 @@
+/****************************************************************************
+*  @file benchAlgorithm.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Micro-benchmarks of the matrix product state algorithms
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include "benchUtils.h"
+
+using namespace uni10;
+using namespace uni10bench;
+
+namespace{
+  // S.S of two spin-1/2
+  Matrix heisenbergBond(){
+    Real elem[] = {0.25, 0, 0, 0,
+                   0, -0.25, 0.5, 0,
+                   0, 0.5, -0.25, 0,
+                   0, 0, 0, 0.25};
+    return Matrix(4, 4, elem);
+  }
+};
+
+// One two-site gate on the middle of a chain whose bonds are saturated at chi, real (imaginary time) or
+// complex (real time)
+static void BM_tebdGate(benchmark::State& state){
+  seed();
+  int chi = state.range(0);
+  bool realTime = state.range(1);
+  size_t L = 24;
+  TEBDParams params;
+  params.maxChi = chi;
+  params.cutoff = 0;
+  TEBD tebd(MPS(L, 2, chi), params);
+  Matrix h = heisenbergBond();
+  Matrix gate = realTime ? TEBD::realTimeGate(h, 0.01) : TEBD::imaginaryTimeGate(h, 0.01);
+  for(auto _ : state)
+    tebd.applyGate(L / 2 - 1, gate);
+  setRate(state, "gates", 1);
+}
+BENCHMARK(BM_tebdGate)->ArgsProduct({{16, 32, 64, 128}, {0, 1}})->Unit(benchmark::kMicrosecond);
+
+// Both layers of gates of a chain of 32 sites by 1, 2 and 4 threads
+static void BM_tebdLayer(benchmark::State& state){
+  seed();
+  int chi = state.range(0);
+  size_t L = 32;
+  TEBDParams params;
+  params.maxChi = chi;
+  params.cutoff = 0;
+  params.threads = state.range(1);
+  TEBD tebd(MPS(L, 2, chi), params);
+  std::vector<Matrix> gates(1, TEBD::realTimeGate(heisenbergBond(), 0.01));
+  for(auto _ : state)
+    tebd.step(gates);
+  setRate(state, "gates", L - 1);
+}
+BENCHMARK(BM_tebdLayer)->ArgsProduct({{32, 64}, {1, 2, 4}})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// One CTMRG sweep of a random double layer tensor of bond D at the environment bond chi, with full or
+// randomized SVD projectors
+static void BM_ctmrgSweep(benchmark::State& state){
+  seed();
+  int D = state.range(0);
+  CTMRGParams params;
+  params.maxChi = state.range(1);
+  params.cutoff = 0;
+  params.randomized = state.range(2);
+  std::vector<Bond> bonds(2, Bond(BD_IN, D));
+  bonds.resize(4, Bond(BD_OUT, D));
+  UniTensor a(bonds);
+  a.randomize();
+  CTMRG ctm(a, params);
+  for(int n = 0; n < 10; n++)
+    ctm.sweep();
+  for(auto _ : state)
+    ctm.sweep();
+  setRate(state, "moves", 4);
+  state.counters["chi"] = ctm.chi(0);
+}
+BENCHMARK(BM_ctmrgSweep)->ArgsProduct({{4, 9}, {16, 32}, {0, 1}})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Expectation values of every site of an L x L PEPS of bond 3 from cold boundaries at chi, by one thread
+// or all of them
+static void BM_boundaryExpectations(benchmark::State& state){
+  seed();
+  int L = state.range(0);
+  BoundaryParams params;
+  params.maxChi = state.range(1);
+  params.threads = state.range(2);
+  PEPS peps(L, L, 2, 3);
+  Real elem[] = {1, 0, 0, -1};
+  Matrix sz(2, 2, elem);
+  for(auto _ : state){
+    BoundaryMPS bmps(peps, params);
+    for(int r = 0; r < L; r++)
+      benchmark::DoNotOptimize(bmps.expectations(r, sz));
+  }
+  setRate(state, "sites", L * L);
+}
+BENCHMARK(BM_boundaryExpectations)->ArgsProduct({{6}, {9, 16}, {1, 0}})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// H|psi> on a chain of 32 sites at chi, the Heisenberg MPO: the product at the bond chi D_W truncated by
+// SVDs from the left, the zip-up, and the zip-up followed by two variational sweeps
+static void BM_applyMPO(benchmark::State& state){
+  seed();
+  int chi = state.range(0), mode = state.range(1);
+  size_t L = 32;
+  MPS psi(L, 2, chi);
+  MPO H = MPO::heisenberg(L);
+  CompressionParams params;
+  params.maxChi = chi;
+  params.cutoff = 0;
+  params.sweeps = mode == 2 ? 2 : 0;
+  params.tol = 0;
+  for(auto _ : state){
+    if(mode == 0){
+      std::vector<UniTensor> sites(L);
+      int labelW[] = {1, 2, 3, 4}, labelA[] = {5, 4, 6}, labelOut[] = {1, 2, 3};
+      std::vector<int> left(2), right(2);
+      left[0] = 1;
+      left[1] = 5;
+      right[0] = 3;
+      right[1] = 6;
+      for(size_t i = 0; i < L; i++){
+        UniTensor W(H[i]), A(psi[i]);
+        W.setLabel(labelW);
+        A.setLabel(labelA);
+        sites[i] = contract(W, A, true);
+        sites[i].combineBond(left);
+        sites[i].combineBond(right);
+        sites[i].permute(labelOut, 2);
+      }
+      benchmark::DoNotOptimize(compress(MPS(sites), params));
+    }
+    else
+      benchmark::DoNotOptimize(applyMPO(H, psi, params));
+  }
+  setRate(state, "sites", L);
+}
+BENCHMARK(BM_applyMPO)->ArgsProduct({{32, 64}, {0, 1, 2}})->Unit(benchmark::kMillisecond);
+
+// <sz_i sz_j> of all the pairs of a chain of 32 sites at chi: one product() per pair, and the batched sweeps by
+// one thread or all of them
+static void BM_correlations(benchmark::State& state){
+  seed();
+  int chi = state.range(0), mode = state.range(1);
+  size_t L = 32;
+  MPS psi(L, 2, chi);
+  MeasurementParams params;
+  params.threads = mode == 1 ? 1 : 0;
+  Real elem[] = {0.5, -0.5};
+  Matrix sz(2, 2, elem, true);
+  for(auto _ : state){
+    Measurement m(psi, params);
+    if(mode == 0){
+      for(size_t i = 0; i < L; i++)
+        for(size_t j = i + 1; j < L; j++){
+          std::vector<Matrix> ops(j - i + 1, Matrix());
+          ops.front() = sz;
+          ops.back() = sz;
+          benchmark::DoNotOptimize(m.product(i, ops));
+        }
+    }
+    else
+      benchmark::DoNotOptimize(m.correlation(Correlator(sz, sz)));
+  }
+  setRate(state, "pairs", L * (L - 1) / 2);
+}
+BENCHMARK(BM_correlations)->ArgsProduct({{32, 64}, {0, 1, 2}})->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,67 @@
+/****************************************************************************
+*  @file benchMatrix.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Micro-benchmarks of the Matrix decompositions
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include "benchUtils.h"
+
+using namespace uni10;
+using namespace uni10bench;
+
+// The FLOP counts are the nominal LAPACK operation counts of a square matrix with
+// singular/eigen vectors, i.e. 22 n^3 for gesvd and 9 n^3 for syev.
+
+static void BM_svd(benchmark::State& state){
+  seed();
+  size_t n = state.range(0);
+  Matrix M(n, n);
+  M.randomize();
+  for(auto _ : state){
+    std::vector<Matrix> usv = M.svd();
+    benchmark::DoNotOptimize(usv[0].getElem());
+  }
+  state.SetBytesProcessed(state.iterations() * 4 * n * n * sizeof(double));
+  setRate(state, "FLOPS", 22.0 * n * n * n);
+}
+BENCHMARK(BM_svd)->RangeMultiplier(2)->Range(64, 512)->Unit(benchmark::kMillisecond);
+
+static void BM_eigh(benchmark::State& state){
+  seed();
+  size_t n = state.range(0);
+  Matrix A(n, n);
+  A.randomize();
+  Matrix AT = A;
+  AT.transpose();
+  Matrix M = A + AT;
+  for(auto _ : state){
+    std::vector<Matrix> eig = M.eigh();
+    benchmark::DoNotOptimize(eig[1].getElem());
+  }
+  state.SetBytesProcessed(state.iterations() * 2 * n * n * sizeof(double));
+  setRate(state, "FLOPS", 9.0 * n * n * n);
+}
+BENCHMARK(BM_eigh)->RangeMultiplier(2)->Range(64, 512)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,148 @@
+/****************************************************************************
+*  @file benchNetwork.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Micro-benchmarks of Network::launch
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include "benchUtils.h"
+
+using namespace uni10;
+using namespace uni10bench;
+
+// The ternary MERA ascending superoperator of debug/Ascend.cpp. The argument multiplies the
+// degeneracy of every quantum number, so the bottom bonds have dimension 2n and the top ones 8n.
+static void BM_launchAscend(benchmark::State& state){
+  seed();
+  int n = state.range(0);
+  Qnum q10(1, PRT_EVEN), q_10(-1, PRT_EVEN), q30(3, PRT_EVEN);
+  Qnum q_11(-1, PRT_ODD), q11(1, PRT_ODD), q_31(-3, PRT_ODD);
+  std::vector<Qnum> qnums, qnums1;
+  for(int i = 0; i < n; i++){
+    qnums.push_back(q10); qnums.push_back(q_11);
+    qnums1.push_back(q30); qnums1.push_back(q11); qnums1.push_back(q11); qnums1.push_back(q11);
+    qnums1.push_back(q_10); qnums1.push_back(q_10); qnums1.push_back(q_10); qnums1.push_back(q_31);
+  }
+  Bond bdr(BD_IN, qnums), bdc(BD_OUT, qnums), bdr1(BD_IN, qnums1);
+  std::vector<Bond> bonds;
+  bonds.push_back(bdr); bonds.push_back(bdr); bonds.push_back(bdc); bonds.push_back(bdc);
+  UniTensor Ob(bonds, "Ob");
+  Ob.randomize();
+  UniTensor U(bonds, "U");
+  U.orthoRand();
+  bonds.clear();
+  bonds.push_back(bdr1); bonds.push_back(bdc); bonds.push_back(bdc); bonds.push_back(bdc);
+  UniTensor W1(bonds, "W1");
+  W1.orthoRand();
+  UniTensor W2(bonds, "W2");
+  W2.orthoRand();
+
+  Network asd(dataPath("networks/AscendC.net"));
+  for(auto _ : state){
+    state.PauseTiming();
+    asd.putTensor("W1", W1);
+    asd.putTensorT("W1T", W1);
+    asd.putTensor("W2", W2);
+    asd.putTensorT("W2T", W2);
+    asd.putTensor("U", U);
+    asd.putTensorT("UT", U);
+    asd.putTensor("Ob", Ob);
+    state.ResumeTiming();
+    UniTensor H = asd.launch();
+    benchmark::DoNotOptimize(H.getElem());
+  }
+  state.counters["top_dim"] = 8 * n;
+}
+BENCHMARK(BM_launchAscend)->RangeMultiplier(2)->Range(1, 4)->Unit(benchmark::kMicrosecond);
+
+// The network of examples/egN1.cpp with the tensors of egU1.cpp and egU3.cpp
+static void BM_launchEgN1(benchmark::State& state){
+  seed();
+  double heisenberg_s1[] = {
+    1, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 1, 0, 0, 0, 0, 0,
+    0, 0,-1, 0, 1, 0, 0, 0, 0,
+    0, 1, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 1, 0, 0, 0, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 1, 0,
+    0, 0, 0, 0, 1, 0,-1, 0, 0,
+    0, 0, 0, 0, 0, 1, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 1};
+  Qnum q0(0), q1(1), q_1(-1), q2(2), q_2(-2);
+  std::vector<Qnum> qnums;
+  qnums.push_back(q1); qnums.push_back(q0); qnums.push_back(q_1);
+  std::vector<Bond> bonds;
+  bonds.push_back(Bond(BD_IN, qnums)); bonds.push_back(Bond(BD_IN, qnums));
+  bonds.push_back(Bond(BD_OUT, qnums)); bonds.push_back(Bond(BD_OUT, qnums));
+  UniTensor H(bonds, "H");
+  H.setRawElem(heisenberg_s1);
+
+  std::vector<Qnum> in_qnums;
+  in_qnums.push_back(q2); in_qnums.push_back(q1); in_qnums.push_back(q0);
+  in_qnums.push_back(q0); in_qnums.push_back(q_1); in_qnums.push_back(q_2);
+  bonds.clear();
+  bonds.push_back(Bond(BD_IN, in_qnums));
+  bonds.push_back(Bond(BD_OUT, qnums));
+  bonds.push_back(Bond(BD_OUT, qnums));
+  UniTensor W(bonds, "W");
+  W.orthoRand();
+  UniTensor WT = W;
+  WT.transpose();
+
+  Network net(dataPath("../examples/egN1_network"));
+  for(auto _ : state){
+    state.PauseTiming();
+    net.putTensor("H", H);
+    net.putTensor("W", W);
+    net.putTensor("WT", WT);
+    state.ResumeTiming();
+    UniTensor T = net.launch();
+    benchmark::DoNotOptimize(T.getElem());
+  }
+}
+BENCHMARK(BM_launchEgN1)->Unit(benchmark::kMicrosecond);
+
+// Symmetry-free network, contracted through the dense GEMM path of Network::launch
+static void BM_launchDense(benchmark::State& state){
+  seed();
+  int dim = state.range(0);
+  UniTensor W1 = makeTensor(1, 3, dim, false);
+  UniTensor W2 = makeTensor(1, 3, dim, false);
+  UniTensor U = makeTensor(2, 2, dim, false);
+  UniTensor Ob = makeTensor(2, 2, dim, false);
+  Network asd(dataPath("networks/AscendC.net"));
+  asd.putTensor("W1", W1);
+  asd.putTensorT("W1T", W1);
+  asd.putTensor("W2", W2);
+  asd.putTensorT("W2T", W2);
+  asd.putTensor("U", U);
+  asd.putTensorT("UT", U);
+  asd.putTensor("Ob", Ob);
+  for(auto _ : state){
+    UniTensor H = asd.launch();
+    benchmark::DoNotOptimize(H.getElem());
+  }
+}
+BENCHMARK(BM_launchDense)->RangeMultiplier(2)->Range(2, 8)->Unit(benchmark::kMicrosecond);
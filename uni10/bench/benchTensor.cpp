@@ -0,0 +1,255 @@
+/****************************************************************************
+*  @file benchTensor.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Micro-benchmarks of UniTensor permute, contract, combineBond and save/load
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <cstdio>
+#include "benchUtils.h"
+
+using namespace uni10;
+using namespace uni10bench;
+
+// Arguments: bond dimension, symmetry (0: none, 1: U1)
+static void permuteArgs(benchmark::internal::Benchmark* b){
+  for(int u1 = 0; u1 < 2; u1++)
+    for(int dim = 8; dim <= 32; dim *= 2)
+      b->Args({dim, u1});
+}
+
+enum PermuteKind{TRANSPOSE, ROTATION, REVERSAL};
+
+// Arguments: rank, bond dimension, permutation (PermuteKind), symmetry (0: none, 1: U1).
+// The dimensions keep from about 1e4 to 1e6 elements for every rank.
+static void permuteRankArgs(benchmark::internal::Benchmark* b){
+  const int dims[][2] = {{128, 1024}, {8, 32}, {4, 10}};
+  for(int u1 = 0; u1 < 2; u1++)
+    for(int r = 0; r < 3; r++)
+      for(int kind = TRANSPOSE; kind <= REVERSAL; kind++)
+        for(int d = 0; d < 2; d++)
+          if(r > 0 || kind == TRANSPOSE)  // all three coincide for rank 2
+            b->Args({2 * (r + 1), dims[r][d], kind, u1});
+}
+
+static void BM_permute(benchmark::State& state){
+  seed();
+  int rank = state.range(0), kind = state.range(2);
+  UniTensor T = makeTensor(rank / 2, rank / 2, state.range(1), state.range(3));
+  std::vector<int> labels(rank), permuted(rank);
+  for(int b = 0; b < rank; b++){
+    labels[b] = b;
+    if(kind == TRANSPOSE)  // swap the incoming and the outgoing bonds
+      permuted[b] = (b + rank / 2) % rank;
+    else if(kind == ROTATION)
+      permuted[b] = (b + rank - 1) % rank;
+    else
+      permuted[b] = rank - 1 - b;
+  }
+  T.setLabel(labels);
+  bool forth = true;
+  for(auto _ : state){
+    T.permute(forth ? permuted : labels, rank / 2);
+    benchmark::DoNotOptimize(T.getElem());
+    forth = !forth;
+  }
+  const char* names[] = {"transpose", "rotation", "reversal"};
+  state.SetLabel(names[kind]);
+  // every permutation reads and writes the whole element storage
+  state.SetBytesProcessed(state.iterations() * 2 * T.elemNum() * sizeof(double));
+  state.counters["elem"] = T.elemNum();
+}
+BENCHMARK(BM_permute)->Apply(permuteRankArgs);
+
+// C(0, 1; 4, 5) = A(0, 1; 2, 3) * B(2, 3; 4, 5)
+static void BM_contract(benchmark::State& state){
+  seed();
+  int dim = state.range(0);
+  UniTensor A = makeTensor(2, 2, dim, state.range(1));
+  UniTensor B = makeTensor(2, 2, dim, state.range(1));
+  int labelA[] = {0, 1, 2, 3};
+  int labelB[] = {2, 3, 4, 5};
+  A.setLabel(labelA);
+  B.setLabel(labelB);
+  double flops = 0;
+  std::vector<Qnum> qnums = A.blockQnum();
+  for(size_t q = 0; q < qnums.size(); q++){
+    const Block& blkA = A.const_getBlock(qnums[q]);
+    const Block& blkB = B.const_getBlock(qnums[q]);
+    flops += 2.0 * blkA.row() * blkA.col() * blkB.col();
+  }
+  for(auto _ : state){
+    UniTensor C = contract(A, B, true);
+    benchmark::DoNotOptimize(C.getElem());
+  }
+  state.SetBytesProcessed(state.iterations() * 3 * A.elemNum() * sizeof(double));
+  setRate(state, "FLOPS", flops);
+}
+BENCHMARK(BM_contract)->Apply(permuteArgs);
+
+// A transposed contraction, both operands have to be permuted first.
+static void BM_contractTransposed(benchmark::State& state){
+  seed();
+  int dim = state.range(0);
+  UniTensor A = makeTensor(2, 2, dim, state.range(1));
+  UniTensor B = makeTensor(2, 2, dim, state.range(1));
+  int labelA[] = {0, 1, 2, 3};
+  int labelB[] = {4, 0, 5, 2};
+  A.setLabel(labelA);
+  B.setLabel(labelB);
+  for(auto _ : state){
+    UniTensor C = contract(A, B, false);
+    benchmark::DoNotOptimize(C.getElem());
+  }
+  state.SetBytesProcessed(state.iterations() * 3 * A.elemNum() * sizeof(double));
+  if(!state.range(1))
+    setRate(state, "FLOPS", 2.0 * A.elemNum() * dim * dim);
+}
+BENCHMARK(BM_contractTransposed)->Apply(permuteArgs);
+
+// Two permutations of A before C(0, 1; 4, 5) = A(0, 1; 2, 3) * B(2, 3; 4, 5), the elements of A move once
+static void BM_permuteContract(benchmark::State& state){
+  seed();
+  int dim = state.range(0);
+  UniTensor A = makeTensor(2, 2, dim, state.range(1));
+  UniTensor B = makeTensor(2, 2, dim, state.range(1));
+  int labelA[] = {0, 1, 2, 3};
+  int rotated[] = {3, 0, 1, 2};
+  int swapped[] = {1, 0, 2, 3};
+  int labelB[] = {2, 3, 4, 5};
+  B.setLabel(labelB);
+  for(auto _ : state){
+    state.PauseTiming();
+    A.setLabel(labelA);
+    state.ResumeTiming();
+    A.permute(rotated, 1);
+    A.permute(swapped, 2);
+    UniTensor C = contract(A, B, true);
+    benchmark::DoNotOptimize(C.getElem());
+  }
+  state.SetBytesProcessed(state.iterations() * 3 * A.elemNum() * sizeof(double));
+}
+BENCHMARK(BM_permuteContract)->Apply(permuteArgs);
+
+static void BM_combineBond(benchmark::State& state){
+  seed();
+  UniTensor T0 = makeTensor(2, 2, state.range(0), state.range(1));
+  int labels[] = {0, 1, 2, 3};
+  T0.setLabel(labels);
+  std::vector<int> combined(labels + 1, labels + 3);
+  for(auto _ : state){
+    state.PauseTiming();
+    UniTensor T = T0;
+    state.ResumeTiming();
+    T.combineBond(combined);
+    benchmark::DoNotOptimize(T.getElem());
+  }
+  state.SetBytesProcessed(state.iterations() * 2 * T0.elemNum() * sizeof(double));
+}
+BENCHMARK(BM_combineBond)->Apply(permuteArgs);
+
+// A copy that is only read shares the elements, a written one duplicates them
+static void BM_copy(benchmark::State& state){
+  seed();
+  UniTensor T = makeTensor(2, 2, state.range(0), state.range(1));
+  bool write = state.range(2);
+  for(auto _ : state){
+    UniTensor C = T;
+    if(write)
+      C.getElem()[0] = 0;
+    benchmark::DoNotOptimize(C.at(0));
+  }
+  state.counters["elem"] = T.elemNum();
+}
+BENCHMARK(BM_copy)->ArgsProduct({{8, 16, 32}, {0, 1}, {0, 1}});
+
+static void BM_save(benchmark::State& state){
+  seed();
+  UniTensor T = makeTensor(2, 2, state.range(0), state.range(1));
+  std::string fname = "uni10_bench_save.tmp";
+  for(auto _ : state)
+    T.save(fname);
+  remove(fname.c_str());
+  state.SetBytesProcessed(state.iterations() * T.elemNum() * sizeof(double));
+}
+BENCHMARK(BM_save)->Apply(permuteArgs);
+
+static void BM_load(benchmark::State& state){
+  seed();
+  UniTensor T = makeTensor(2, 2, state.range(0), state.range(1));
+  std::string fname = "uni10_bench_load.tmp";
+  T.save(fname);
+  for(auto _ : state){
+    UniTensor L(fname);
+    benchmark::DoNotOptimize(L.getElem());
+  }
+  remove(fname.c_str());
+  state.SetBytesProcessed(state.iterations() * T.elemNum() * sizeof(double));
+}
+BENCHMARK(BM_load)->Apply(permuteArgs);
+
+// The Lanczos update T = a B + b T by the in-place kernel and by the operators
+static void BM_axpby(benchmark::State& state){
+  seed();
+  UniTensor T = makeTensor(2, 2, state.range(0), state.range(1));
+  UniTensor B = makeTensor(2, 2, state.range(0), state.range(1));
+  for(auto _ : state)
+    T.axpby(0.5, B, -0.5);
+  state.SetBytesProcessed(state.iterations() * 3 * T.elemNum() * sizeof(double));
+  state.counters["elem"] = T.elemNum();
+}
+BENCHMARK(BM_axpby)->Apply(permuteArgs);
+
+static void BM_axpbyOperators(benchmark::State& state){
+  seed();
+  UniTensor T = makeTensor(2, 2, state.range(0), state.range(1));
+  UniTensor B = makeTensor(2, 2, state.range(0), state.range(1));
+  for(auto _ : state){
+    T *= -0.5;
+    T += 0.5 * B;
+  }
+  state.SetBytesProcessed(state.iterations() * 3 * T.elemNum() * sizeof(double));
+  state.counters["elem"] = T.elemNum();
+}
+BENCHMARK(BM_axpbyOperators)->Apply(permuteArgs);
+
+// R = a T1 + b T2 + c T3 by the operators and by a lazy expression assigned in place
+static void BM_linearCombination(benchmark::State& state){
+  seed();
+  UniTensor T1 = makeTensor(2, 2, state.range(0), state.range(1));
+  UniTensor T2 = makeTensor(2, 2, state.range(0), state.range(1));
+  UniTensor T3 = makeTensor(2, 2, state.range(0), state.range(1));
+  UniTensor R = T1;
+  bool lazily = state.range(2);
+  for(auto _ : state){
+    if(lazily)
+      R = 0.5 * lazy(T1) - 0.25 * lazy(T2) + 2 * lazy(T3);
+    else
+      R = 0.5 * T1 + (-0.25) * T2 + 2 * T3;
+  }
+  state.SetBytesProcessed(state.iterations() * 4 * R.elemNum() * sizeof(double));
+  state.counters["elem"] = R.elemNum();
+}
+BENCHMARK(BM_linearCombination)->ArgsProduct({{16, 32}, {0, 1}, {0, 1}});
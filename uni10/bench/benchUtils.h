@@ -0,0 +1,79 @@
+/****************************************************************************
+*  @file benchUtils.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Helpers shared by the micro-benchmarks
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef UNI10_BENCH_UTILS_H
+#define UNI10_BENCH_UTILS_H
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <benchmark/benchmark.h>
+#include <uni10.hpp>
+
+namespace uni10bench{
+
+  /// Path of a file shipped with the benchmarks, e.g. a network file
+  inline std::string dataPath(const std::string& fname){
+    return std::string(UNI10_BENCH_DIR) + "/" + fname;
+  }
+
+  /// Seeds the random generator used by UniTensor::randomize() and orthoRand()
+  inline void seed(){
+    srand(20160606);
+  }
+
+  /// Bond of dimension \c dim, without symmetry or with U1 quantum numbers -2, ..., 2
+  inline uni10::Bond makeBond(uni10::bondType tp, int dim, bool u1){
+    if(!u1)
+      return uni10::Bond(tp, dim);
+    std::vector<uni10::Qnum> qnums;
+    for(int i = 0; i < dim; i++)
+      qnums.push_back(uni10::Qnum((i % 5) - 2));
+    return uni10::Bond(tp, qnums);
+  }
+
+  /// Random tensor with \c inNum incoming and \c outNum outgoing bonds of dimension \c dim
+  inline uni10::UniTensor makeTensor(int inNum, int outNum, int dim, bool u1){
+    std::vector<uni10::Bond> bonds;
+    for(int b = 0; b < inNum; b++)
+      bonds.push_back(makeBond(uni10::BD_IN, dim, u1));
+    for(int b = 0; b < outNum; b++)
+      bonds.push_back(makeBond(uni10::BD_OUT, dim, u1));
+    uni10::UniTensor T(bonds);
+    T.randomize();
+    return T;
+  }
+
+  /// Sets the counter \c name to \c num per second
+  inline void setRate(benchmark::State& state, const char* name, double num){
+    state.counters[name] = benchmark::Counter(num * state.iterations(), benchmark::Counter::kIsRate);
+  }
+
+};
+
+#endif /* UNI10_BENCH_UTILS_H */
@@ -0,0 +1,232 @@
+/****************************************************************************
+*  @file e2eDMRG.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief End-to-end benchmark: infinite and finite DMRG of the spin-1/2 Heisenberg chain
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <cmath>
+#include <vector>
+#include <uni10.hpp>
+#include <uni10/numeric/lapack/uni10_lapack.h>
+#include "e2eUtils.h"
+
+using namespace uni10;
+using namespace uni10bench;
+
+/*
+ * Usage: e2eDMRG [--chi 20] [--steps 40] [--lanczos 100] [--json out.json] [--trace trace.json] [--memory 1]
+ *        e2eDMRG --mode finite [--chi 64] [--sites 32] [--sweeps 4] [--lanczos 100] [--json out.json] ...
+ *
+ * The default infinite mode grows the chain two sites per step. The effective
+ * Hamiltonian of the two center sites is built from the environments and the
+ * MPO, its ground state is found by Lanczos and split by SVD, truncated to the
+ * bond dimension chi. The energy per site converges to 1/4 - ln(2) = -0.443147.
+ *
+ * The finite mode runs a fixed number of two-site sweeps of uni10::DMRG on an
+ * open chain, starting from a random MPS already at the bond dimension chi, so
+ * that every sweep costs the same.
+ */
+
+const int W_DIM = 5;
+
+// Lower triangular MPO of H = \sum_i Sz_i Sz_{i+1} + (S+_i S-_{i+1} + S-_i S+_{i+1}) / 2
+UniTensor heisenbergMPO(){
+  double I[] = {1, 0, 0, 1};
+  double Sp[] = {0, 1, 0, 0};
+  double Sm[] = {0, 0, 1, 0};
+  double Sz[] = {0.5, 0, 0, -0.5};
+  double hSp[] = {0, 0.5, 0, 0};
+  double hSm[] = {0, 0, 0.5, 0};
+  double* ops[W_DIM][W_DIM] = {{I, NULL, NULL, NULL, NULL},
+                               {Sp, NULL, NULL, NULL, NULL},
+                               {Sm, NULL, NULL, NULL, NULL},
+                               {Sz, NULL, NULL, NULL, NULL},
+                               {NULL, hSm, hSp, Sz, I}};
+  std::vector<Bond> bonds;
+  bonds.push_back(Bond(BD_IN, W_DIM));
+  bonds.push_back(Bond(BD_IN, 2));
+  bonds.push_back(Bond(BD_OUT, W_DIM));
+  bonds.push_back(Bond(BD_OUT, 2));
+  // raw element order: (wl, s, wr, s')
+  std::vector<double> elem(W_DIM * 2 * W_DIM * 2, 0);
+  for(int wl = 0; wl < W_DIM; wl++)
+    for(int wr = 0; wr < W_DIM; wr++)
+      if(ops[wl][wr] != NULL)
+        for(int s = 0; s < 2; s++)
+          for(int sp = 0; sp < 2; sp++)
+            elem[((wl * 2 + s) * W_DIM + wr) * 2 + sp] = ops[wl][wr][s * 2 + sp];
+  UniTensor W(bonds, "W");
+  W.setRawElem(elem);
+  return W;
+}
+
+UniTensor environment(int chi, int w){
+  std::vector<Bond> bonds;
+  bonds.push_back(Bond(BD_IN, chi));
+  bonds.push_back(Bond(BD_OUT, W_DIM));
+  bonds.push_back(Bond(BD_OUT, chi));
+  UniTensor E(bonds);
+  std::vector<double> elem(W_DIM, 0);
+  elem[w] = 1;
+  E.setRawElem(elem);
+  return E;
+}
+
+int infiniteDMRG(const Options& opts){
+  int chiMax = opts.get("chi", 20);
+  int steps = opts.get("steps", 40);
+  size_t lanczosIter = opts.get("lanczos", 100);
+  srand(20160606);
+
+  PhaseTimer timer(opts);
+  UniTensor W = heisenbergMPO();
+  UniTensor L = environment(1, W_DIM - 1);
+  UniTensor R = environment(1, 0);
+  int chi = 1;
+  double energy = 0, energyPerSite = 0;
+  int labelL[] = {1, 2, 3}, labelW1[] = {2, 4, 5, 6}, labelW2[] = {5, 7, 8, 9}, labelR[] = {10, 8, 11};
+  int labelH[] = {1, 4, 7, 10, 3, 6, 9, 11};
+
+  for(int step = 0; step < steps; step++){
+    Matrix H;
+    {
+      PhaseTimer::Scope scope(timer, "effective_H");
+      UniTensor W1 = W, W2 = W;
+      L.setLabel(labelL);
+      W1.setLabel(labelW1);
+      W2.setLabel(labelW2);
+      R.setLabel(labelR);
+      UniTensor Heff = ((L * W1) * W2) * R;
+      Heff.permute(labelH, 4);
+      H = Heff.getBlock();
+    }
+    size_t dim = H.row();
+    Matrix psi(1, dim);
+    double E;
+    {
+      PhaseTimer::Scope scope(timer, "eigensolver");
+      psi.randomize();
+      psi *= 1.0 / psi.norm();
+      size_t iter = lanczosIter;
+      lanczosEV(H.getElem(), psi.getElem(), dim, iter, 1E-10, E, psi.getElem(), false);
+    }
+    energyPerSite = (E - energy) / 2;
+    energy = E;
+
+    int newChi = std::min(chiMax, chi * 2);
+    UniTensor A, B;
+    {
+      PhaseTimer::Scope scope(timer, "svd");
+      Matrix theta(chi * 2, 2 * chi, psi.getElem());
+      std::vector<Matrix> usv = theta.svd();
+      usv[0].resize(chi * 2, newChi);
+      usv[2].resize(newChi, 2 * chi);
+      std::vector<Bond> bonds;
+      bonds.push_back(Bond(BD_IN, chi));
+      bonds.push_back(Bond(BD_IN, 2));
+      bonds.push_back(Bond(BD_OUT, newChi));
+      A = UniTensor(bonds, "A");
+      A.putBlock(usv[0]);
+      bonds.clear();
+      bonds.push_back(Bond(BD_IN, newChi));
+      bonds.push_back(Bond(BD_OUT, 2));
+      bonds.push_back(Bond(BD_OUT, chi));
+      B = UniTensor(bonds, "B");
+      B.putBlock(usv[2]);
+    }
+    {
+      PhaseTimer::Scope scope(timer, "environment");
+      int labelA[] = {1, 4, 20}, labelAc[] = {3, 6, 21}, labelWL[] = {2, 4, 5, 6};
+      UniTensor Ac = A, Wc = W;
+      A.setLabel(labelA);
+      Ac.setLabel(labelAc);
+      Wc.setLabel(labelWL);
+      L.setLabel(labelL);
+      L = ((L * A) * Wc) * Ac;
+      int labelLnew[] = {20, 5, 21};
+      L.permute(labelLnew, 1);
+
+      int labelB[] = {30, 4, 10}, labelBc[] = {31, 6, 11}, labelWR[] = {40, 4, 8, 6};
+      UniTensor Bc = B;
+      B.setLabel(labelB);
+      Bc.setLabel(labelBc);
+      Wc.setLabel(labelWR);
+      R.setLabel(labelR);
+      R = ((R * B) * Wc) * Bc;
+      int labelRnew[] = {30, 40, 31};
+      R.permute(labelRnew, 1);
+    }
+    chi = newChi;
+  }
+  timer.result("chi", chiMax);
+  timer.result("sites", 2 * steps);
+  timer.result("energy_per_site", energyPerSite);
+  timer.finish(opts, "e2eDMRG");
+  return 0;
+}
+
+int finiteDMRG(const Options& opts){
+  int chi = opts.get("chi", 64);
+  int sites = opts.get("sites", 32);
+  int sweeps = opts.get("sweeps", 4);
+  srand(20160606);
+
+  MPO H = MPO::heisenberg(sites);
+  MPS psi(sites, 2, chi);
+  DMRGParams params;
+  params.maxChi = chi;
+  params.cutoff = 0;
+  params.lanczosIter = opts.get("lanczos", 100);
+  PhaseTimer timer(opts);
+  DMRG dmrg(psi, H, params);
+  SweepInfo info;
+  for(int s = 0; s < sweeps; s++){
+    info = dmrg.sweep();
+    timer.add("eigensolver", info.eigSeconds);
+    timer.add("svd", info.svdSeconds);
+    timer.add("environment", info.envSeconds);
+    timer.add("other", info.seconds - info.eigSeconds - info.svdSeconds - info.envSeconds);
+  }
+  timer.result("chi", info.maxChi);
+  timer.result("sites", sites);
+  timer.result("sweeps", sweeps);
+  timer.result("matvecs", info.matvecs);
+  timer.result("energy_per_site", info.energy / sites);
+  timer.finish(opts, "e2eDMRG finite");
+  return 0;
+}
+
+int main(int argc, char** argv){
+  Options opts(argc, argv);
+  std::string mode = opts.get("mode", std::string("infinite"));
+  if(mode == "finite")
+    return finiteDMRG(opts);
+  if(mode != "infinite"){
+    std::cerr << "Unknown mode " << mode << ", expected infinite or finite\n";
+    return 1;
+  }
+  return infiniteDMRG(opts);
+}
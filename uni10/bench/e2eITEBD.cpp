@@ -0,0 +1,167 @@
+/****************************************************************************
+*  @file e2eITEBD.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief End-to-end benchmark: iTEBD ground state of the transverse field Ising chain
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <cmath>
+#include <vector>
+#include <uni10.hpp>
+#include "e2eUtils.h"
+
+using namespace uni10;
+using namespace uni10bench;
+
+/*
+ * Usage: e2eITEBD [--chi 32] [--steps 1000] [--tau 0.01] [--field 1.0] [--json out.json] [--trace trace.json] [--memory 1]
+ *
+ * Imaginary time evolution of an infinite MPS in Vidal's form with a
+ * two-site unit cell, H = -\sum_i Z_i Z_{i+1} - h \sum_i X_i. Each step
+ * applies the gate exp(-tau h_bond) on the A-B and on the B-A bond and
+ * truncates back to the bond dimension chi. At the critical field h = 1
+ * the energy per site approaches -4/pi = -1.273240.
+ */
+
+// Diagonal matrix of the Schmidt values, or of their inverses
+UniTensor lambdaTensor(const Matrix& lambda, bool inverse){
+  size_t k = lambda.row();
+  const Real* s = lambda.getElem();
+  Matrix mat(k, k);
+  mat.set_zero();
+  for(size_t i = 0; i < k; i++)
+    mat[i * k + i] = inverse ? 1 / s[i] : s[i];
+  std::vector<Bond> bonds;
+  bonds.push_back(Bond(BD_IN, k));
+  bonds.push_back(Bond(BD_OUT, k));
+  UniTensor L(bonds, "lambda");
+  L.putBlock(mat);
+  return L;
+}
+
+// Site tensor (chiL, 2; chiR), or (chiL; 2, chiR) when elem holds the right singular vectors
+UniTensor gammaTensor(size_t chiL, size_t chiR, const Block& elem, bool right = false){
+  std::vector<Bond> bonds;
+  bonds.push_back(Bond(BD_IN, chiL));
+  bonds.push_back(Bond(right ? BD_OUT : BD_IN, 2));
+  bonds.push_back(Bond(BD_OUT, chiR));
+  UniTensor G(bonds, "Gamma");
+  G.putBlock(elem);
+  return G;
+}
+
+int main(int argc, char** argv){
+  Options opts(argc, argv);
+  int chiMax = opts.get("chi", 32);
+  int steps = opts.get("steps", 1000);
+  double tau = opts.get("tau", 0.01);
+  double field = opts.get("field", 1.0);
+  srand(20160606);
+
+  PhaseTimer timer(opts);
+  // h_bond = -Z Z - h (X I + I X) / 2 in the basis |00>, |01>, |10>, |11>
+  double hBond[] = {-1, -field / 2, -field / 2, 0,
+                    -field / 2, 1, 0, -field / 2,
+                    -field / 2, 0, 1, -field / 2,
+                    0, -field / 2, -field / 2, -1};
+  std::vector<Bond> gateBonds;
+  gateBonds.push_back(Bond(BD_IN, 2));
+  gateBonds.push_back(Bond(BD_IN, 2));
+  gateBonds.push_back(Bond(BD_OUT, 2));
+  gateBonds.push_back(Bond(BD_OUT, 2));
+  UniTensor gate(gateBonds, "gate");
+  gate.putBlock(takeExp(-tau, Matrix(4, 4, hBond)));
+  int labelGate[] = {12, 15, 2, 5};
+  gate.setLabel(labelGate);
+
+  // |+> product state
+  Matrix one(1, 1);
+  one[0] = 1;
+  Matrix plus(2, 1);
+  plus[0] = plus[1] = 1 / sqrt(2.0);
+  UniTensor gamma[2] = {gammaTensor(1, 1, plus), gammaTensor(1, 1, plus)};
+  Matrix lambda[2] = {one, one};
+  double energy[2] = {0, 0};
+
+  int labelLB[] = {0, 1}, labelGA[] = {1, 2, 3}, labelLA[] = {3, 4}, labelGB[] = {4, 5, 6}, labelLB2[] = {6, 7};
+  int labelTheta[] = {0, 12, 15, 7};
+  for(int step = 0; step < steps; step++)
+    for(int bond = 0; bond < 2; bond++){
+      int a = bond, b = 1 - bond;
+      size_t chiL = lambda[b].row(), chiR = chiL;
+      UniTensor theta;
+      {
+        PhaseTimer::Scope scope(timer, "gate");
+        UniTensor LB = lambdaTensor(lambda[b], false);
+        UniTensor LA = lambdaTensor(lambda[a], false);
+        LB.setLabel(labelLB);
+        gamma[a].setLabel(labelGA);
+        LA.setLabel(labelLA);
+        gamma[b].setLabel(labelGB);
+        theta = (LB * gamma[a]) * LA;
+        theta *= gamma[b];
+        LB.setLabel(labelLB2);
+        theta = gate * (theta * LB);
+        theta.permute(labelTheta, 2);
+      }
+      std::vector<Matrix> usv;
+      {
+        PhaseTimer::Scope scope(timer, "svd");
+        usv = theta.getBlock().svd();
+      }
+      {
+        PhaseTimer::Scope scope(timer, "update");
+        double norm = usv[1].norm();
+        energy[bond] = -log(norm * norm) / (2 * tau);
+        size_t k = 0;
+        while(k < usv[1].row() && k < (size_t)chiMax && usv[1][k] / norm > 1E-12)
+          k++;
+        usv[0].resize(usv[0].row(), k);
+        usv[1].resize(k, k);
+        usv[2].resize(k, usv[2].col());
+        lambda[a] = usv[1] * (1 / usv[1].norm());
+
+        UniTensor LBinv = lambdaTensor(lambda[b], true);
+        UniTensor X = gammaTensor(chiL, k, usv[0]);
+        int labelX[] = {0, 2, 3}, labelLinv[] = {1, 0}, labelGamma[] = {1, 2, 3};
+        X.setLabel(labelX);
+        LBinv.setLabel(labelLinv);
+        gamma[a] = LBinv * X;
+        gamma[a].permute(labelGamma, 2);
+
+        UniTensor Y = gammaTensor(k, chiR, usv[2], true);
+        int labelY[] = {4, 5, 6}, labelRinv[] = {6, 7}, labelGammaB[] = {4, 5, 7};
+        Y.setLabel(labelY);
+        LBinv.setLabel(labelRinv);
+        gamma[b] = Y * LBinv;
+        gamma[b].permute(labelGammaB, 2);
+      }
+    }
+  timer.result("chi", chiMax);
+  timer.result("steps", steps);
+  timer.result("energy_per_site", (energy[0] + energy[1]) / 2);
+  timer.finish(opts, "e2eITEBD");
+  return 0;
+}
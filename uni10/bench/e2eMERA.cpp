@@ -0,0 +1,123 @@
+/****************************************************************************
+*  @file e2eMERA.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief End-to-end benchmark: ascending and descending superoperators of a ternary MERA
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <vector>
+#include <uni10.hpp>
+#include "e2eUtils.h"
+
+using namespace uni10;
+using namespace uni10bench;
+
+/*
+ * Usage: e2eMERA [--degeneracy 2] [--iterations 20] [--json out.json] [--trace trace.json] [--memory 1]
+ *
+ * One layer of the U1 symmetric ternary MERA of debug/Ascend.cpp, where the
+ * degeneracy multiplies every quantum number: the bottom bonds have dimension
+ * 2n and the top ones 8n. Each iteration ascends the Heisenberg coupling
+ * through the layer, descends a density matrix from the top and evaluates
+ * the energy both ways, tr(rho H1) = tr(rho0 H0).
+ */
+
+int main(int argc, char** argv){
+  Options opts(argc, argv);
+  int n = opts.get("degeneracy", 2);
+  int iterations = opts.get("iterations", 20);
+  srand(20160606);
+
+  PhaseTimer timer(opts);
+  Qnum q10(1, PRT_EVEN), q_10(-1, PRT_EVEN), q30(3, PRT_EVEN);
+  Qnum q_11(-1, PRT_ODD), q11(1, PRT_ODD), q_31(-3, PRT_ODD);
+  std::vector<Qnum> qnums, qnums1;
+  for(int i = 0; i < n; i++){
+    qnums.push_back(q10); qnums.push_back(q_11);
+    qnums1.push_back(q30); qnums1.push_back(q11); qnums1.push_back(q11); qnums1.push_back(q11);
+    qnums1.push_back(q_10); qnums1.push_back(q_10); qnums1.push_back(q_10); qnums1.push_back(q_31);
+  }
+  Bond bdr(BD_IN, qnums), bdc(BD_OUT, qnums), bdr1(BD_IN, qnums1), bdc1(BD_OUT, qnums1);
+  std::vector<Bond> bonds;
+  bonds.push_back(bdr); bonds.push_back(bdr); bonds.push_back(bdc); bonds.push_back(bdc);
+  UniTensor H0(bonds, "Ob");
+  H0.randomize();
+  UniTensor U(bonds, "U");
+  U.orthoRand();
+  bonds.clear();
+  bonds.push_back(bdr1); bonds.push_back(bdc); bonds.push_back(bdc); bonds.push_back(bdc);
+  UniTensor W1(bonds, "W1");
+  W1.orthoRand();
+  UniTensor W2(bonds, "W2");
+  W2.orthoRand();
+  bonds.clear();
+  bonds.push_back(bdr1); bonds.push_back(bdr1); bonds.push_back(bdc1); bonds.push_back(bdc1);
+  UniTensor rho(bonds, "Rho");
+  rho.randomize();
+
+  Network ascend(std::string(UNI10_BENCH_DIR) + "/networks/AscendC.net");
+  Network descend(std::string(UNI10_BENCH_DIR) + "/networks/DescendC.net");
+  double energyUp = 0, energyDown = 0;
+  for(int it = 0; it < iterations; it++){
+    UniTensor H1, rho0;
+    {
+      PhaseTimer::Scope scope(timer, "ascend");
+      ascend.putTensor("W1", W1);
+      ascend.putTensorT("W1T", W1);
+      ascend.putTensor("W2", W2);
+      ascend.putTensorT("W2T", W2);
+      ascend.putTensor("U", U);
+      ascend.putTensorT("UT", U);
+      ascend.putTensor("Ob", H0);
+      H1 = ascend.launch();
+    }
+    {
+      PhaseTimer::Scope scope(timer, "descend");
+      descend.putTensor("W1", W1);
+      descend.putTensorT("W1T", W1);
+      descend.putTensor("W2", W2);
+      descend.putTensorT("W2T", W2);
+      descend.putTensor("U", U);
+      descend.putTensorT("UT", U);
+      descend.putTensor("Rho", rho);
+      rho0 = descend.launch();
+    }
+    {
+      PhaseTimer::Scope scope(timer, "energy");
+      int labelH1[] = {-1, -2, -3, -4}, labelRho[] = {-3, -4, -1, -2};
+      int labelH0[] = {6, 7, 8, 9};
+      H1.setLabel(labelH1);
+      rho.setLabel(labelRho);
+      H0.setLabel(labelH0);
+      energyUp = (H1 * rho)[0];
+      energyDown = (H0 * rho0)[0];
+    }
+  }
+  timer.result("top_dim", 8 * n);
+  timer.result("energy_ascend", energyUp);
+  timer.result("energy_descend", energyDown);
+  timer.finish(opts, "e2eMERA");
+  return 0;
+}
@@ -0,0 +1,216 @@
+/****************************************************************************
+*  @file e2eUtils.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Phase timers and command line options of the end-to-end benchmarks
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef UNI10_E2E_UTILS_H
+#define UNI10_E2E_UTILS_H
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <uni10.hpp>
+
+namespace uni10bench{
+
+  /// @brief Command line options of the form <tt>--name value</tt>
+  class Options{
+    public:
+      Options(int argc, char** argv): args(argv + 1, argv + argc){}
+      int get(const std::string& name, int def)const{
+        std::string val = find(name);
+        return val.size() ? atoi(val.c_str()) : def;
+      }
+      double get(const std::string& name, double def)const{
+        std::string val = find(name);
+        return val.size() ? atof(val.c_str()) : def;
+      }
+      std::string get(const std::string& name, const std::string& def)const{
+        std::string val = find(name);
+        return val.size() ? val : def;
+      }
+    private:
+      std::vector<std::string> args;
+      std::string find(const std::string& name)const{
+        for(size_t i = 0; i + 1 < args.size(); i++)
+          if(args[i] == "--" + name)
+            return args[i + 1];
+        return "";
+      }
+  };
+
+  /// Operations of the library reported by the benchmarks, see uni10::ProfileData
+  const uni10::profOp REPORTED_OPS[] = {uni10::PROF_PERMUTE, uni10::PROF_GEMM, uni10::PROF_SVD, uni10::PROF_ALLOC};
+  const int REPORTED_OP_NUM = sizeof(REPORTED_OPS) / sizeof(REPORTED_OPS[0]);
+
+  /// @brief Accumulates the wall time spent in the phases of a benchmark
+  ///
+  /// Along with the phases, the operation counters of the library (cmake -DBUILD_PROFILING=ON) accumulated
+  /// during the run are reported for permute, GEMM, SVD and allocation.
+  ///
+  /// A phase is timed by a Scope living as long as the phase, e.g.
+  /// \code
+  /// { PhaseTimer::Scope s(timer, "svd"); std::vector<Matrix> usv = M.svd(); }
+  /// \endcode
+  class PhaseTimer{
+    public:
+      typedef std::chrono::steady_clock Clock;
+      class Scope{
+        public:
+          Scope(PhaseTimer& _timer, const std::string& _phase): timer(_timer), phase(_phase), trace(_phase, "phase"),
+            site(uni10::isMemoryTracking() ? _phase : std::string()), start(Clock::now()){}
+          ~Scope(){
+            timer.add(phase, std::chrono::duration<double>(Clock::now() - start).count());
+          }
+        private:
+          PhaseTimer& timer;
+          std::string phase;
+          uni10::TraceScope trace;
+          uni10::MemoryScope site;
+          Clock::time_point start;
+      };
+      /// Starts tracing the phases and the uni10 operations if requested by <tt>--trace file</tt>,
+      /// and tracking the allocations with <tt>--memory 1</tt>
+      PhaseTimer(const Options& opts): traceFile(opts.get("trace", std::string())), memory(opts.get("memory", 0)),
+        start(Clock::now()), opsStart(uni10::profileSnapshot()){
+        if(traceFile.size())
+          uni10::traceBegin();
+        if(memory)
+          uni10::memoryTrackBegin();
+      }
+      void add(const std::string& phase, double sec){
+        if(seconds.find(phase) == seconds.end())
+          phases.push_back(phase);
+        seconds[phase] += sec;
+        calls[phase]++;
+      }
+      /// Records a result of the run, e.g. the ground state energy, printed along with the timings
+      void result(const std::string& name, double val){
+        if(results.find(name) == results.end())
+          resultNames.push_back(name);
+        results[name] = val;
+      }
+      double total()const{
+        return std::chrono::duration<double>(Clock::now() - start).count();
+      }
+      /// Operation counters accumulated since the timer was created
+      uni10::ProfileData operations()const{
+        return uni10::profileSnapshot() - opsStart;
+      }
+      void report(std::ostream& os, const std::string& title)const{
+        double tot = total();
+        os << "===== " << title << " =====\n";
+        for(size_t i = 0; i < resultNames.size(); i++)
+          os << std::setw(16) << std::left << resultNames[i] << std::setprecision(12) << results.find(resultNames[i])->second << "\n";
+        os << std::setw(16) << std::left << "phase" << std::setw(12) << std::right << "calls"
+           << std::setw(14) << "time(s)" << std::setw(10) << "share" << "\n";
+        for(size_t i = 0; i < phases.size(); i++){
+          double sec = seconds.find(phases[i])->second;
+          os << std::setw(16) << std::left << phases[i] << std::setw(12) << std::right << calls.find(phases[i])->second
+             << std::setw(14) << std::fixed << std::setprecision(6) << sec
+             << std::setw(9) << std::setprecision(1) << 100 * sec / tot << "%\n";
+          os.unsetf(std::ios::fixed);
+        }
+        os << std::setw(16) << std::left << "total" << std::setw(26) << std::right << std::fixed << std::setprecision(6) << tot << "\n";
+        os.unsetf(std::ios::fixed);
+        if(!uni10::ProfileData::enabled()){
+          os << "operation counters disabled, rebuild with -DBUILD_PROFILING=ON\n";
+          return;
+        }
+        uni10::ProfileData ops = operations();
+        os << std::setw(16) << std::left << "operation" << std::setw(12) << std::right << "calls"
+           << std::setw(14) << "time(s)" << std::setw(10) << "share" << std::setw(18) << "bytes" << "\n";
+        for(int i = 0; i < REPORTED_OP_NUM; i++){
+          const uni10::OpProfile& op = ops[REPORTED_OPS[i]];
+          os << std::setw(16) << std::left << uni10::ProfileData::opName(REPORTED_OPS[i]) << std::setw(12) << std::right << op.calls
+             << std::setw(14) << std::fixed << std::setprecision(6) << op.seconds
+             << std::setw(9) << std::setprecision(1) << 100 * op.seconds / tot << "%" << std::setw(18) << op.bytes << "\n";
+          os.unsetf(std::ios::fixed);
+        }
+      }
+      void json(std::ostream& os, const std::string& title)const{
+        os << "{\n  \"benchmark\": \"" << title << "\",\n  \"total_s\": " << std::setprecision(12) << total() << ",\n  \"results\": {";
+        for(size_t i = 0; i < resultNames.size(); i++)
+          os << (i ? "," : "") << "\n    \"" << resultNames[i] << "\": " << results.find(resultNames[i])->second;
+        os << "\n  },\n  \"phases\": [";
+        for(size_t i = 0; i < phases.size(); i++)
+          os << (i ? "," : "") << "\n    {\"name\": \"" << phases[i] << "\", \"calls\": " << calls.find(phases[i])->second
+             << ", \"time_s\": " << seconds.find(phases[i])->second << "}";
+        os << "\n  ],\n  \"operations\": [";
+        if(uni10::ProfileData::enabled()){
+          uni10::ProfileData ops = operations();
+          for(int i = 0; i < REPORTED_OP_NUM; i++){
+            const uni10::OpProfile& op = ops[REPORTED_OPS[i]];
+            os << (i ? "," : "") << "\n    {\"name\": \"" << uni10::ProfileData::opName(REPORTED_OPS[i]) << "\", \"calls\": " << op.calls
+               << ", \"time_s\": " << op.seconds << ", \"bytes\": " << op.bytes << ", \"flops\": " << op.flops << "}";
+          }
+        }
+        os << "\n  ]\n}\n";
+      }
+      /// Prints the report and, if requested by <tt>--json file</tt>, writes it out as JSON.
+      /// The trace requested by <tt>--trace file</tt> is saved as Chrome trace JSON and the
+      /// allocations alive at the memory peak are listed with <tt>--memory 1</tt>.
+      void finish(const Options& opts, const std::string& title){
+        if(traceFile.size()){
+          uni10::traceEnd();
+          uni10::traceSave(traceFile);
+        }
+        uni10::MemorySnapshot mem;
+        if(memory){
+          mem = uni10::memorySnapshot();
+          uni10::memoryTrackEnd();
+          result("peak_bytes", mem.peakBytes);
+        }
+        report(std::cout, title);
+        if(memory)
+          std::cout << mem.str();
+        std::string fname = opts.get("json", std::string());
+        if(fname.size()){
+          std::ofstream ofs(fname.c_str());
+          json(ofs, title);
+        }
+      }
+    private:
+      std::string traceFile;
+      int memory;
+      Clock::time_point start;
+      uni10::ProfileData opsStart;
+      std::vector<std::string> phases;
+      std::map<std::string, double> seconds;
+      std::map<std::string, size_t> calls;
+      std::vector<std::string> resultNames;
+      std::map<std::string, double> results;
+  };
+
+};
+
+#endif /* UNI10_E2E_UTILS_H */
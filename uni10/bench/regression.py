@@ -0,0 +1,204 @@
+#!/usr/bin/env python
+###
+#  @file regression.py
+#  @license
+#    Copyright (c) 2013-2016
+#    National Taiwan University
+#    National Tsing-Hua University
+#
+#    This file is part of Uni10, the Universal Tensor Network Library.
+#
+#    Uni10 is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    Uni10 is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+#  @endlicense
+#  @brief Performance regression check against a stored baseline
+#  @author Ying-Jer Kao
+#  @date 2016-06-06
+#  @since 1.0.0
+"""Performance regression check of uni10 against a stored baseline.
+
+  regression.py collect --bindir BIN --out baseline.json
+      Runs the reference benchmarks (permute, contract and Network::launch
+      micro-benchmarks with repetitions, and the end-to-end benchmarks with
+      memory tracking) and stores their statistics.
+
+  regression.py compare baseline.json current.json
+      Reports every benchmark that got slower or every run whose peak memory
+      grew beyond the thresholds, exits with 1 if there is any.
+
+  regression.py check --bindir BIN --baseline baseline.json
+      collect followed by compare, exits with 77 (skipped) if there is no
+      baseline yet.
+
+A time is a regression when its median grew by more than --time-tol (10%)
+AND by more than --sigmas (3) standard deviations of the difference, so that
+noisy benchmarks do not fail spuriously. Peak memory is deterministic and is
+compared with --memory-tol (5%) only. It is tracked by builds with
+-DBUILD_PROFILING=ON alone, other builds report 0 bytes: the memory check is
+then skipped with a warning, or fails with --require-memory. Everything runs
+offline.
+"""
+import argparse
+import json
+import math
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+REFERENCE_FILTER = 'BM_(permute|contract|launch)'
+E2E_RUNS = {
+    'e2eDMRG': ['--chi', '16', '--steps', '20'],
+    'e2eITEBD': ['--chi', '16', '--steps', '200'],
+    'e2eMERA': ['--degeneracy', '2', '--iterations', '5'],
+}
+SKIPPED = 77
+TIME_UNITS = {'ns': 1.0, 'us': 1E3, 'ms': 1E6, 's': 1E9}
+
+
+def run(cmd):
+    sys.stderr.write(' '.join(cmd) + '\n')
+    subprocess.check_call(cmd, stdout=sys.stderr)
+
+
+def min_time_flag(bench, min_time):
+    """--benchmark_min_time in seconds, with the unit suffix that Google Benchmark 1.8 requires
+    unless the binary is built with an older release that rejects it."""
+    flag = '--benchmark_min_time=%gs' % min_time
+    with open(os.devnull, 'w') as null:
+        if subprocess.call([bench, '--benchmark_filter=^$', flag], stdout=null, stderr=null) == 0:
+            return flag
+    return '--benchmark_min_time=%g' % min_time
+
+
+def collect(bindir, repetitions, min_time):
+    """Runs the reference benchmarks, returns {'time': {name: stats}, 'memory': {name: bytes}}."""
+    result = {'time': {}, 'memory': {}}
+    tmpdir = tempfile.mkdtemp(prefix='uni10-regression-')
+    try:
+        gbench = os.path.join(tmpdir, 'micro.json')
+        bench = os.path.join(bindir, 'uni10-bench')
+        run([bench,
+             '--benchmark_filter=' + REFERENCE_FILTER,
+             '--benchmark_repetitions=%d' % repetitions,
+             min_time_flag(bench, min_time),
+             '--benchmark_report_aggregates_only=true',
+             '--benchmark_out=' + gbench, '--benchmark_out_format=json'])
+        with open(gbench) as f:
+            for bm in json.load(f)['benchmarks']:
+                if bm.get('run_type') != 'aggregate':
+                    continue
+                scale = TIME_UNITS[bm.get('time_unit', 'ns')]
+                stats = result['time'].setdefault(bm['run_name'], {})
+                stats[bm['aggregate_name']] = bm['real_time'] * scale
+        for prog, args in sorted(E2E_RUNS.items()):
+            out = os.path.join(tmpdir, prog + '.json')
+            run([os.path.join(bindir, prog)] + args + ['--memory', '1', '--json', out])
+            with open(out) as f:
+                e2e = json.load(f)
+            result['memory'][prog] = e2e['results']['peak_bytes']
+    finally:
+        shutil.rmtree(tmpdir, ignore_errors=True)
+    return result
+
+
+def compare(base, cur, time_tol, sigmas, memory_tol, require_memory=False):
+    """Returns the list of regression messages of cur against base."""
+    regressions = []
+    untracked = []
+    print('%-40s %14s %14s %8s' % ('benchmark', 'baseline', 'current', 'change'))
+    for name in sorted(base['time']):
+        if name not in cur['time']:
+            print('%-40s missing in the current run' % name)
+            continue
+        b, c = base['time'][name], cur['time'][name]
+        change = c['median'] / b['median'] - 1
+        noise = math.sqrt(b.get('stddev', 0) ** 2 + c.get('stddev', 0) ** 2)
+        slower = change > time_tol and c['median'] - b['median'] > sigmas * noise
+        print('%-40s %12.0fns %12.0fns %+7.1f%%%s' % (name, b['median'], c['median'], 100 * change,
+                                                       '  REGRESSION' if slower else ''))
+        if slower:
+            regressions.append('%s is %.1f%% slower' % (name, 100 * change))
+    for name in sorted(base['memory']):
+        if name not in cur['memory']:
+            continue
+        b, c = base['memory'][name], cur['memory'][name]
+        if not b or not c:
+            runs = ' and '.join(run for run, peak in (('baseline', b), ('current', c)) if not peak)
+            runs += ' runs' if not b and not c else ' run'
+            print('%-40s not tracked in the %s' % (name + ' peak memory', runs))
+            untracked.append('%s peak memory is not tracked in the %s' % (name, runs))
+            continue
+        change = float(c) / b - 1
+        grew = change > memory_tol
+        print('%-40s %13dB %13dB %+7.1f%%%s' % (name + ' peak memory', b, c, 100 * change,
+                                                 '  REGRESSION' if grew else ''))
+        if grew:
+            regressions.append('%s peak memory grew by %.1f%%' % (name, 100 * change))
+    if untracked:
+        hint = ', build both with -DBUILD_PROFILING=ON to compare the peak memory'
+        if require_memory:
+            regressions.extend(msg + hint for msg in untracked)
+        else:
+            for msg in untracked:
+                print('WARNING: ' + msg + hint)
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('mode', choices=['collect', 'compare', 'check'])
+    parser.add_argument('files', nargs='*', help='baseline and current results for compare')
+    parser.add_argument('--bindir', default='.', help='directory of uni10-bench and the e2e programs')
+    parser.add_argument('--out', help='output of collect')
+    parser.add_argument('--baseline', help='baseline for check')
+    parser.add_argument('--repetitions', type=int, default=5)
+    parser.add_argument('--min-time', type=float, default=0.1, help='seconds per repetition')
+    parser.add_argument('--time-tol', type=float, default=0.10)
+    parser.add_argument('--sigmas', type=float, default=3.0)
+    parser.add_argument('--memory-tol', type=float, default=0.05)
+    parser.add_argument('--require-memory', action='store_true',
+                        help='fail if the peak memory is not tracked, instead of warning')
+    args = parser.parse_args()
+
+    if args.mode == 'collect':
+        if not args.out:
+            parser.error('collect needs --out')
+        with open(args.out, 'w') as f:
+            json.dump(collect(args.bindir, args.repetitions, args.min_time), f, indent=2, sort_keys=True)
+        return 0
+
+    if args.mode == 'compare':
+        if len(args.files) != 2:
+            parser.error('compare needs the baseline and the current results')
+        with open(args.files[0]) as f:
+            base = json.load(f)
+        with open(args.files[1]) as f:
+            cur = json.load(f)
+    else:
+        if not args.baseline or not os.path.exists(args.baseline):
+            print('No baseline %s, create it with "make bench-baseline"' % args.baseline)
+            return SKIPPED
+        with open(args.baseline) as f:
+            base = json.load(f)
+        cur = collect(args.bindir, args.repetitions, args.min_time)
+
+    regressions = compare(base, cur, args.time_tol, args.sigmas, args.memory_tol, args.require_memory)
+    for msg in regressions:
+        print('REGRESSION: ' + msg)
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -33,5 +33,9 @@
 
 #include <uni10/datatype.hpp>
 #include <uni10/tensor-network.hpp>
+#include <uni10/algorithm.hpp>
+#ifdef UNI10_MPI
+#include <uni10/distributed.hpp>
+#endif
 
 #endif
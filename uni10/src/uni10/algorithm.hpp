@@ -0,0 +1,47 @@
+/****************************************************************************
+*  @file algorithm.hpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Generic header file for the matrix product state algorithms
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef UNI10_ALGORITHM_HPP
+#define UNI10_ALGORITHM_HPP
+
+#include <uni10/algorithm/MPS.h>
+#include <uni10/algorithm/MPO.h>
+#include <uni10/algorithm/Environment.h>
+#include <uni10/algorithm/Solvers.h>
+#include <uni10/algorithm/EffectiveHamiltonian.h>
+#include <uni10/algorithm/DMRG.h>
+#include <uni10/algorithm/TEBD.h>
+#include <uni10/algorithm/TDVP.h>
+#include <uni10/algorithm/CTMRG.h>
+#include <uni10/algorithm/PEPS.h>
+#include <uni10/algorithm/BoundaryMPS.h>
+#include <uni10/algorithm/Compression.h>
+#include <uni10/algorithm/Measurement.h>
+
+#endif
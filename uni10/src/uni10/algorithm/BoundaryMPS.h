@@ -0,0 +1,135 @@
+/****************************************************************************
+*  @file BoundaryMPS.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file for the boundary MPS contraction of a finite PEPS
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef BOUNDARYMPS_H
+#define BOUNDARYMPS_H
+#include <atomic>
+#include <vector>
+#include <uni10/algorithm/PEPS.h>
+namespace uni10{
+
+/// @brief Parameters of BoundaryMPS
+struct BoundaryParams{
+  BoundaryParams();
+  int maxChi;             ///< Largest bond dimension of a boundary (16)
+  Real cutoff;            ///< Largest discarded weight of a truncation (1E-12)
+  int sweeps;             ///< Variational sweeps after the zip-up of a row, 0 for the zip-up alone (1)
+  int threads;            ///< Threads of the columns and of the two boundaries, 0 for one per core (0)
+};
+
+///@class BoundaryMPS
+///@brief Contraction of the norm and of the expectation values of a finite PEPS by boundary MPS
+///
+/// top(r) is the MPS of the rows above row \c r of the double layer network \f$\langle\psi|\psi\rangle\f$,
+/// bottom(r) is the MPS of the rows from \c r on. Column \c c of a boundary is a rank-4 UniTensor with the
+/// bonds <tt>(l, k, b, r)</tt>: \c k and \c b are joined to the vertical bonds of the ket and of the bra
+/// tensors of the next row. The ket and the bra layers are absorbed one after the other and the double
+/// layer tensor is never formed, which saves a factor \f$D^2\f$ of memory over contracting fused tensors.
+///
+/// A row is absorbed by the zip-up: the boundary, the ket and the bra tensors of a column are contracted
+/// into what is left of the previous column and split by a truncated SVD, from the left to the right.
+/// The result, left-normalized, is then improved by BoundaryParams::sweeps variational sweeps, each
+/// solving for one column at a time the best approximation at the bond dimension of the zip-up.
+///
+/// The boundaries are kept until invalidate() is called for a row they contain, so that the expectation
+/// values of different operators and sites share them. The boundaries from the top and from the bottom are
+/// built in parallel, and so are the expectation values of the columns of a row.
+///
+/// Like Environment, a BoundaryMPS refers to the PEPS, which must outlive it.
+/// \code
+/// BoundaryMPS bmps(peps);
+/// std::vector<Real> mz = bmps.expectations(r, sz);   // every column of row r
+/// peps.setSite(r, c, A);
+/// bmps.invalidate(r);
+/// \endcode
+class BoundaryMPS{
+public:
+    BoundaryMPS(const PEPS& peps, const BoundaryParams& params = BoundaryParams());
+
+    /// @brief Boundary from the top, rows <tt>0 .. r-1</tt> absorbed, normalized to unit norm
+    const std::vector<UniTensor>& top(size_t r);
+
+    /// @brief Boundary from the bottom, rows <tt>r .. rows()-1</tt> absorbed, normalized to unit norm
+    const std::vector<UniTensor>& bottom(size_t r);
+
+    /// @brief Logarithm of the norm \f$\langle\psi|\psi\rangle\f$
+    Real logNorm();
+
+    /// @brief Norm \f$\langle\psi|\psi\rangle\f$, which may overflow for large lattices, see logNorm()
+    Real norm();
+
+    /// @brief Expectation value of the one-site operator \c op on site <tt>(r, c)</tt>
+    Real expectation(size_t r, size_t c, const Matrix& op);
+
+    /// @brief Expectation values of the one-site operator \c op on every site of row \c r
+    std::vector<Real> expectations(size_t r, const Matrix& op);
+
+    /// @brief Expectation value of the two-site operator \c op on the sites <tt>(r, c)</tt> and <tt>(r, c+1)</tt>
+    ///
+    /// The rows and columns of \c op are the pairs of physical indices of the two sites, left site first.
+    /// The vertical bonds are the horizontal bonds of PEPS::transpose().
+    Real bondExpectation(size_t r, size_t c, const Matrix& op);
+
+    /// @brief Forgets the boundaries that contain row \c r, after a site of the row changed
+    void invalidate(size_t r);
+
+    /// @brief Forgets all the boundaries
+    void invalidate();
+
+    /// @brief Number of rows absorbed
+    size_t absorptions()const;
+
+    /// @brief Largest discarded weight of the zip-ups
+    Real discarded()const;
+
+private:
+    struct Boundary{
+      std::vector<UniTensor> B;
+      Real logScale;      // logarithm of the norm divided out
+      Real discarded;     // largest discarded weight of the zip-ups of the rows absorbed last
+      bool valid;
+    };
+    const PEPS* peps;
+    BoundaryParams params;
+    std::vector<Boundary> tops;
+    std::vector<Boundary> bottoms;
+    std::atomic<size_t> m_absorptions;
+    BoundaryMPS(const BoundaryMPS&);
+    BoundaryMPS& operator=(const BoundaryMPS&);
+    void checkRow(size_t r)const;
+    void prepare(size_t top, size_t bottom);
+    const Boundary& boundary(bool fromTop, size_t r);
+    Boundary absorb(const Boundary& in, size_t row, bool fromTop)const;
+    void fit(Boundary& out, const Boundary& in, size_t row, bool fromTop)const;
+    std::vector<UniTensor> sandwich(size_t r, std::vector<UniTensor>& rights);
+    UniTensor applied(const UniTensor& A, const Matrix& op)const;
+};
+
+};	/* namespace uni10 */
+#endif /* BOUNDARYMPS_H */
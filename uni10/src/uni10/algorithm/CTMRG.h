@@ -0,0 +1,156 @@
+/****************************************************************************
+*  @file CTMRG.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file for the corner transfer matrix renormalization group
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef CTMRG_H
+#define CTMRG_H
+#include <vector>
+#include <uni10/tensor-network/UniTensor.h>
+namespace uni10{
+
+/// @brief Parameters of CTMRG
+struct CTMRGParams{
+  CTMRGParams();
+  int maxChi;             ///< Largest bond dimension of the environment (32)
+  Real cutoff;            ///< Largest discarded weight of a projector (1E-12)
+  Real tol;               ///< Convergence criterion on the change of the corner spectra (1E-10)
+  int maxIter;            ///< Largest number of sweeps of run() (200)
+  bool randomized;        ///< Projectors from randomized SVDs of the blocks larger than needed (false)
+  int oversampling;       ///< Extra random vectors of a randomized SVD (10)
+  int powerIter;          ///< Power iterations of a randomized SVD (2)
+  int threads;            ///< Threads of the opposite moves, 1 or 2, 0 for two on a multicore machine (0)
+};
+
+///@class CTMRG
+///@brief Corner transfer matrix environment of an infinite square lattice of a single tensor
+///
+/// The lattice is tiled by the tensor \c a with the bonds (left, up, right, down), the double layer
+/// tensor of an iPEPS or the weights of a classical model. The sides are numbered 0 to 3 in the same
+/// order, clockwise, and every tensor of the environment lists its bonds clockwise as well:
+///   - corner(k), between the sides \c k and <tt>k+1</tt>, has the bonds (to edge(k), to edge(k+1)),
+///   - edge(k), on side \c k, has the bonds (to corner(k-1), to \c a, to corner(k)).
+///
+/// A move toward side \c k absorbs a row or column of the lattice into edge(k), corner(k-1) and
+/// corner(k) and truncates it back by projectors. The projectors come from the half of the lattice on
+/// side \c k: its upper and lower quadrants are contracted in an optimal order, at a cost
+/// \f$O(\chi^3D^3 + \chi^2D^6)\f$ for the bonds \f$\chi\f$ of the environment and \f$D\f$ of \c a, and the
+/// product of the two is decomposed block by block, either by a full or by a randomized SVD. The
+/// singular values of all the blocks are truncated together.
+///
+/// The moves toward opposite sides read and write disjoint tensors; a sweep runs the left and right
+/// moves concurrently, then the up and down moves, so that the result does not depend on the threads.
+///
+/// Symmetric tensors are supported: the quantum numbers of the bonds of \c a are carried through the
+/// environment, which stays block diagonal. Bonds that are joined must be compatible as in contract(),
+/// in particular the left and right, and the up and down bonds of \c a. Only real tensors are supported.
+/// \code
+/// CTMRG ctm(a);
+/// ctm.run();
+/// Real e = ctm.expectation(b);   // <b> / <a>, b in place of a single a
+/// \endcode
+class CTMRG{
+public:
+    /// @brief Environment of \c a, started from corners of dimension one and edges of the trivial sector
+    CTMRG(const UniTensor& a, const CTMRGParams& params = CTMRGParams());
+
+    /// @brief Environment of \c a started from the four corners and the four edges given
+    CTMRG(const UniTensor& a, const std::vector<UniTensor>& corners, const std::vector<UniTensor>& edges,
+        const CTMRGParams& params = CTMRGParams());
+
+    /// @brief One move toward \c side, updating edge(side), corner(side-1) and corner(side)
+    /// @return The discarded weight of the projectors
+    Real move(int side);
+
+    /// @brief Moves toward all four sides
+    /// @return The change of the corner spectra, see change()
+    Real sweep();
+
+    /// @brief Sweeps until the corner spectra converge to CTMRGParams::tol or for CTMRGParams::maxIter sweeps
+    /// @return Number of sweeps
+    int run();
+
+    /// @brief \c true if the last sweep changed the corner spectra by less than CTMRGParams::tol
+    bool converged()const;
+
+    /// @brief Largest change, over the four corners, of the sum of the absolute changes of the spectrum in
+    /// the last sweep
+    Real change()const;
+
+    /// @brief Largest discarded weight of the last sweep
+    Real discarded()const;
+
+    /// @brief The tiling tensor
+    const UniTensor& site()const;
+
+    /// @brief Corner \c k, normalized to unit norm
+    const UniTensor& corner(int k)const;
+
+    /// @brief Edge \c k, normalized to unit norm
+    const UniTensor& edge(int k)const;
+
+    /// @brief Dimension of the bond between corner(k) and edge(k)
+    int chi(int k)const;
+
+    /// @brief Singular values of corner \c k in decreasing order as a diagonal matrix, normalized to unit norm
+    Matrix cornerSpectrum(int k)const;
+
+    /// @brief Ratio of the network with \c b in place of one \c a to the network of \c a alone
+    ///
+    /// \c b has the bonds of \c a; both networks are the \f$3\times3\f$ contraction of the environment.
+    Real expectation(const UniTensor& b)const;
+
+    /// @brief Number of moves
+    size_t moves()const;
+
+private:
+    // The tensors that a move updates
+    struct Update{
+      UniTensor prev;       // corner(side-1)
+      UniTensor edge;       // edge(side)
+      UniTensor next;       // corner(side)
+      Real discarded;
+    };
+    CTMRGParams params;
+    UniTensor a;
+    std::vector<UniTensor> C;
+    std::vector<UniTensor> T;
+    std::vector<std::vector<Real> > spectra;
+    Real m_change;
+    Real m_discarded;
+    bool m_converged;
+    size_t m_moves;
+    void check()const;
+    void commit(int side, const Update& up);
+    Update compute(int side)const;
+    std::vector<Real> spectrum(int k)const;
+    Real network(const UniTensor& center)const;
+    std::vector<UniTensor> projectors(UniTensor& upper, UniTensor& lower, Real& discarded)const;
+};
+
+};	/* namespace uni10 */
+#endif /* CTMRG_H */
@@ -0,0 +1,85 @@
+/****************************************************************************
+*  @file Compression.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file of the MPO-MPS product and the compression of MPS
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+#include <vector>
+#include <uni10/algorithm/MPS.h>
+#include <uni10/algorithm/MPO.h>
+namespace uni10{
+
+/// @brief Parameters of applyMPO() and compress()
+struct CompressionParams{
+  CompressionParams();
+  int maxChi;             ///< Largest bond dimension of the result (64)
+  Real cutoff;            ///< Largest discarded weight of a truncation of the zip-up (1E-12)
+  int sweeps;             ///< Largest number of variational sweeps after the zip-up, 0 for the zip-up alone (4)
+  Real tol;               ///< Convergence criterion on the change of the norm of the result in a sweep (1E-10)
+};
+
+/// @brief What applyMPO() and compress() did
+struct CompressionInfo{
+  CompressionInfo();
+  Real discarded;         ///< Largest discarded weight of the zip-up
+  int sweeps;             ///< Variational sweeps done
+  Real change;            ///< Relative change of the norm of the result in the last sweep
+};
+
+/// @brief Approximation of \f$W|\psi\rangle\f$ by an MPS of bond dimension at most CompressionParams::maxChi
+///
+/// The product is never formed at the bond dimension \f$\chi D_W\f$. The zip-up contracts the sites of
+/// \c W and of \c psi, brought to right-canonical form, from the left and truncates each new site by an SVD
+/// of a \f$\chi d \times D_W\chi\f$ matrix, at a cost \f$O(\chi^3 D_W d^2)\f$ instead of the
+/// \f$O(\chi^3 D_W^3 d^3)\f$ SVDs of the product. Variational sweeps then maximize the overlap with
+/// \f$W|\psi\rangle\f$ site by site at the bond dimensions of the zip-up, with the environments of
+/// \f$\langle\phi|W|\psi\rangle\f$ cached in an Environment so that each step contracts one site.
+///
+/// The tensors may be block diagonal: the truncations keep the largest singular values of all the blocks
+/// together and the result carries the quantum numbers of \c W and \c psi. Only real tensors are supported.
+///
+/// The result is not normalized, its center is the last site.
+/// \code
+/// MPS phi = applyMPO(expH, psi, params);
+/// phi.normalize();
+/// \endcode
+/// @param W The MPO, with the bonds <tt>(w_l, s; w_r, s')</tt> joined to \c psi by \c s'
+/// @param psi The MPS
+/// @param params Bond dimension, truncation and sweeps
+/// @param info If not \c NULL, receives what was done
+MPS applyMPO(const MPO& W, const MPS& psi, const CompressionParams& params = CompressionParams(),
+    CompressionInfo* info = NULL);
+
+/// @brief Approximation of \c psi by an MPS of bond dimension at most CompressionParams::maxChi
+///
+/// applyMPO() of the identity: a truncation by SVD from the left followed by variational sweeps, which
+/// do better than the SVDs alone when \c psi is not canonical.
+MPS compress(const MPS& psi, const CompressionParams& params = CompressionParams(), CompressionInfo* info = NULL);
+
+};	/* namespace uni10 */
+#endif /* COMPRESSION_H */
@@ -0,0 +1,120 @@
+/****************************************************************************
+*  @file DMRG.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file for the finite-size DMRG driver
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef DMRG_H
+#define DMRG_H
+#include <string>
+#include <vector>
+#include <uni10/algorithm/MPS.h>
+#include <uni10/algorithm/MPO.h>
+#include <uni10/algorithm/Environment.h>
+namespace uni10{
+
+/// @brief Parameters of DMRG
+struct DMRGParams{
+  DMRGParams();
+  int maxChi;             ///< Largest bond dimension (64)
+  Real cutoff;            ///< Largest discarded weight of a truncation (1E-10)
+  int sweeps;             ///< Largest number of sweeps of DMRG::run (10)
+  Real energyTol;         ///< DMRG::run stops when the energy of two sweeps differ by less (1E-9)
+  bool twoSite;           ///< Two-site updates, otherwise one-site updates with subspace expansion (true)
+  Real expansion;         ///< Mixing factor of the subspace expansion of one-site updates (1E-4)
+  Real expansionDecay;    ///< Factor applied to the mixing factor after each sweep (0.5)
+  size_t lanczosIter;     ///< Largest number of Lanczos iterations per update (100)
+  Real lanczosTol;        ///< Convergence criterion of the Lanczos residual (1E-10)
+  bool verbose;           ///< Prints SweepInfo::str() after each sweep (false)
+};
+
+/// @brief Statistics of one DMRG sweep
+struct SweepInfo{
+  int sweep;              ///< Index of the sweep, from 0
+  Real energy;            ///< Energy at the end of the sweep
+  Real discarded;         ///< Largest discarded weight of the sweep
+  int maxChi;             ///< Largest bond dimension after the sweep
+  size_t matvecs;         ///< Applications of the effective Hamiltonian
+  double seconds;         ///< Wall time of the sweep
+  double eigSeconds;      ///< ... spent in the eigensolver
+  double svdSeconds;      ///< ... spent in the truncated SVDs
+  double envSeconds;      ///< ... spent in the environment updates
+  /// @brief One line summary
+  std::string str()const;
+};
+
+///@class DMRG
+///@brief Ground state search of a finite chain by the density matrix renormalization group
+///
+/// Each sweep goes from the left end to the right end and back. A step finds the ground state of the
+/// effective Hamiltonian of one or two sites around the orthogonality center by the matrix-free Lanczos
+/// method started from the current wavefunction, then splits it by a truncated SVD and moves the center.
+/// One-site updates expand the bond to the next site by the projection of the MPO on the center
+/// (subspace expansion), so that the bond dimension can grow. The environments are cached and updated
+/// one site per step.
+/// \code
+/// MPO H = MPO::heisenberg(L);
+/// MPS psi(L, 2, 8);
+/// DMRGParams params;
+/// params.maxChi = 100;
+/// DMRG dmrg(psi, H, params);
+/// Real E0 = dmrg.run();
+/// \endcode
+/// @see MPS, MPO, Environment, EffectiveHamiltonian
+class DMRG{
+public:
+    /// @brief Prepares the ground state search of \c H starting from \c psi, which is updated in place
+    ///
+    /// The MPS and the MPO must outlive the DMRG.
+    DMRG(MPS& psi, const MPO& H, const DMRGParams& params = DMRGParams());
+
+    /// @brief One sweep, left to right and back
+    SweepInfo sweep();
+
+    /// @brief Sweeps until the energy converges or DMRGParams::sweeps sweeps were done
+    /// @return The energy
+    Real run();
+
+    /// @brief Energy of the last update
+    Real energy()const;
+
+    /// @brief Statistics of the sweeps done
+    const std::vector<SweepInfo>& history()const;
+
+private:
+    MPS& psi;
+    const MPO& H;
+    DMRGParams params;
+    Environment env;
+    std::vector<SweepInfo> infos;
+    Real m_energy;
+    Real expansion;
+    void updateTwoSite(size_t i, bool toRight, SweepInfo& info);
+    void updateOneSite(size_t i, bool toRight, SweepInfo& info);
+};
+
+};	/* namespace uni10 */
+#endif /* DMRG_H */
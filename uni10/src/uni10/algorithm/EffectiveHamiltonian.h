@@ -0,0 +1,92 @@
+/****************************************************************************
+*  @file EffectiveHamiltonian.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file for the matrix-free effective Hamiltonian of MPS algorithms
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef EFFECTIVEHAMILTONIAN_H
+#define EFFECTIVEHAMILTONIAN_H
+#include <string>
+#include <vector>
+#include <uni10/tensor-network/UniTensor.h>
+#include <uni10/algorithm/Solvers.h>
+namespace uni10{
+
+///@class EffectiveHamiltonian
+///@brief Projection of an MPO on the sites around the orthogonality center of an MPS
+///
+/// Built from the left and right environments (see Environment) and the MPO tensors of zero, one or
+/// two sites. The operator is applied to the center tensor without being formed: the pair-wise order of
+/// the contractions is chosen once, as the cheapest one for the bond dimensions of the operands, and
+/// used for every application.
+///
+/// The vectors are the raw elements of the center tensor: <tt>(l, s1, s2, r)</tt> for two sites,
+/// <tt>(l, s, r)</tt> for one site and <tt>(l, r)</tt> for the bond matrix.
+/// @see Environment, lanczosGroundState
+class EffectiveHamiltonian{
+public:
+    /// @brief Two-site effective Hamiltonian of the left environment \c L, the MPO tensors \c W1, \c W2 and the right environment \c R
+    EffectiveHamiltonian(const UniTensor& L, const UniTensor& W1, const UniTensor& W2, const UniTensor& R);
+
+    /// @brief One-site effective Hamiltonian
+    EffectiveHamiltonian(const UniTensor& L, const UniTensor& W, const UniTensor& R);
+
+    /// @brief Zero-site effective Hamiltonian of the bond between the environments \c L and \c R
+    EffectiveHamiltonian(const UniTensor& L, const UniTensor& R);
+
+    /// @brief Dimension of the vectors
+    size_t dim()const;
+
+    /// @brief \c y = H \c x
+    void apply(const Real* x, Real* y);
+
+    /// @brief \c y = H \c x of complex vectors, for complex environments or the real time evolution
+    void apply(const Complex* x, Complex* y);
+
+    /// @brief The operator as a LinearMap, valid as long as this object
+    LinearMap map();
+
+    /// @brief The operator as a ComplexLinearMap, valid as long as this object
+    ComplexLinearMap complexMap();
+
+    /// @brief Contraction order in use, e.g. <tt>((((x L) W1) W2) R)</tt>
+    std::string order()const;
+
+    /// @brief Number of applications so far
+    size_t applications()const;
+
+private:
+    std::vector<UniTensor> ops;
+    std::vector<std::string> names;
+    std::vector<int> sequence;
+    std::vector<int> outLabels;
+    UniTensor x;
+    size_t m_applications;
+    void init(const std::vector<int>& inLabels);
+};
+
+};	/* namespace uni10 */
+#endif /* EFFECTIVEHAMILTONIAN_H */
@@ -0,0 +1,140 @@
+/****************************************************************************
+*  @file Environment.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file for the cache of the MPS environments
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef ENVIRONMENT_H
+#define ENVIRONMENT_H
+#include <string>
+#include <vector>
+#include <uni10/algorithm/MPS.h>
+#include <uni10/algorithm/MPO.h>
+namespace uni10{
+
+///@class Environment
+///@brief Cache of the left and right environments of \f$\langle bra|O|ket\rangle\f$
+///
+/// The left environment left(i) is the contraction of the sites <tt>0 .. i-1</tt> of the bra, the MPO
+/// and the ket, the right environment right(i) the contraction of the sites <tt>i .. L-1</tt>. Both are
+/// rank-3 tensors with the bonds <tt>(ket; w, bra)</tt>. The sites of a complex bra enter complex
+/// conjugated, and the environments are then complex.
+///
+/// Environments are computed from their nearest cached neighbour and kept until a site they depend on
+/// changes, see invalidate(). A sweep that updates one site and moves on therefore contracts one site per
+/// step. With a memory limit the environments farthest from the sites last asked for are written to
+/// disk and read back when they are needed again.
+/// \code
+/// MPS psi(L, 2, 32);
+/// MPO H = MPO::heisenberg(L);
+/// Environment env(psi, H);
+/// for(size_t i = 0; i + 1 < L; i++){
+///   const UniTensor& Li = env.left(i);
+///   const UniTensor& Ri = env.right(i + 1);
+///   ... update the site i of psi ...
+///   env.invalidate(i);
+/// }
+/// \endcode
+///
+/// The Environment keeps pointers to the MPS and the MPO, which must outlive it. It cannot be copied,
+/// its spill files belong to it.
+/// @see MPS, MPO
+class Environment{
+public:
+    /// @brief Environments of \f$\langle\psi|O|\psi\rangle\f$
+    /// @param psi The MPS of the bra and the ket
+    /// @param op The MPO
+    /// @param memLimit Bytes of environments kept in memory, 0 for no limit
+    /// @param spillDir Directory of the environments written to disk, defaults to \c TMPDIR or \c /tmp
+    Environment(const MPS& psi, const MPO& op, size_t memLimit = 0, const std::string& spillDir = "");
+
+    /// @brief Environments of \f$\langle bra|O|ket\rangle\f$
+    Environment(const MPS& bra, const MPO& op, const MPS& ket, size_t memLimit = 0, const std::string& spillDir = "");
+
+    /// @brief Destructor, removes the environments written to disk
+    ~Environment();
+
+    /// @brief Left environment of site \c i, the contraction of the sites left of \c i
+    ///
+    /// The reference stays valid until the next call of left().
+    const UniTensor& left(size_t i);
+
+    /// @brief Right environment of site \c i-1, the contraction of the sites \c i and right of it
+    ///
+    /// The reference stays valid until the next call of right().
+    const UniTensor& right(size_t i);
+
+    /// @brief Forgets the environments that depend on site \c i, to be called when the site changed
+    void invalidate(size_t i);
+
+    /// @brief Forgets all the environments
+    void invalidate();
+
+    /// @brief \f$\langle bra|O|ket\rangle\f$ contracted at the cut between the sites \c i-1 and \c i
+    ///
+    /// Of complex environments the real part is returned.
+    Real expectation(size_t i = 0);
+
+    /// @brief Number of environment updates done, one per site
+    size_t updates()const;
+
+    /// @brief Bytes of the environments in memory
+    size_t memoryBytes()const;
+
+    /// @brief Number of environments on disk
+    size_t spilledNum()const;
+
+private:
+    struct Slot{
+      UniTensor T;
+      bool valid;
+      bool onDisk;
+      Slot(): valid(false), onDisk(false){}
+    };
+    const MPS* bra;
+    const MPO* op;
+    const MPS* ket;
+    std::vector<Slot> lefts;
+    std::vector<Slot> rights;
+    size_t memLimit;
+    std::string spillDir;
+    size_t m_updates;
+    size_t memBytes;
+    int lastLeft;
+    int lastRight;
+    Environment(const Environment&);
+    Environment& operator=(const Environment&);
+    void init();
+    UniTensor edge(size_t b)const;
+    std::string fileName(bool isLeft, size_t i)const;
+    Slot& fetch(bool isLeft, size_t i);
+    void store(bool isLeft, size_t i, const UniTensor& T);
+    void drop(bool isLeft, size_t i);
+    void spill();
+};
+
+};	/* namespace uni10 */
+#endif /* ENVIRONMENT_H */
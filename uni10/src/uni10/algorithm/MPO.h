@@ -0,0 +1,84 @@
+/****************************************************************************
+*  @file MPO.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file for the matrix product operator class
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef MPO_H
+#define MPO_H
+#include <vector>
+#include <uni10/tensor-network/UniTensor.h>
+namespace uni10{
+
+///@class MPO
+///@brief Matrix product operator of a finite chain
+///
+/// Site \c i holds a rank-4 UniTensor \f$W^{[i]}_{w_l s w_r s'}\f$ with the bonds
+/// <tt>(w_l, s; w_r, s')</tt> of the operator \f$\sum W^{[0]}_{s_0 s_0'} \cdots W^{[L-1]}_{s_{L-1} s_{L-1}'}\f$,
+/// where \c s is the index of the bra and \c s' the index of the ket. The left bond of the first site and
+/// the right bond of the last site have dimension one.
+///
+/// @see MPS, Environment
+class MPO{
+public:
+    /// @brief Empty MPO
+    MPO();
+
+    /// @brief Constructs an MPO from its site tensors, in the bond order <tt>(w_l, s; w_r, s')</tt>
+    MPO(const std::vector<UniTensor>& sites);
+
+    /// @brief Finite chain of \c L copies of the lower triangular bulk tensor \c W
+    ///
+    /// The first site keeps the last row of \c W and the last site the first column, the convention of
+    /// \f$ W = \begin{pmatrix} I & 0 \\ C & I \end{pmatrix}\f$ with the completed terms in the lower left corner.
+    static MPO uniform(const UniTensor& W, size_t L);
+
+    /// @brief Spin-1/2 XXZ chain, \f$ H = \sum_i \frac{J}{2}(S^+_i S^-_{i+1} + S^-_i S^+_{i+1}) + J_z S^z_i S^z_{i+1} - h \sum_i S^z_i\f$
+    static MPO heisenberg(size_t L, Real J = 1, Real Jz = 1, Real h = 0);
+
+    /// @brief Transverse field Ising chain, \f$ H = -J \sum_i \sigma^z_i \sigma^z_{i+1} - g \sum_i \sigma^x_i\f$
+    static MPO transverseIsing(size_t L, Real J = 1, Real g = 1);
+
+    /// @brief Number of sites
+    size_t size()const;
+
+    /// @brief Tensor of site \c i
+    const UniTensor& operator[](size_t i)const;
+    /// @overload
+    UniTensor& operator[](size_t i);
+
+    /// @brief Dimension of the bond \c b between the sites \c b-1 and \c b, bond \c 0 and \c size() are the edges
+    int bondDim(size_t b)const;
+
+    /// @brief Physical dimension of site \c i
+    int physDim(size_t i)const;
+
+private:
+    std::vector<UniTensor> W;
+};
+
+};	/* namespace uni10 */
+#endif /* MPO_H */
@@ -0,0 +1,156 @@
+/****************************************************************************
+*  @file MPS.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file for the matrix product state class
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef MPS_H
+#define MPS_H
+#include <vector>
+#include <uni10/tensor-network/Matrix.h>
+#include <uni10/tensor-network/UniTensor.h>
+namespace uni10{
+
+///@class MPS
+///@brief Matrix product state of a finite chain with its canonical form
+///
+/// Site \c i holds a rank-3 UniTensor \f$A^{[i]}_{l s r}\f$ with the bonds <tt>(l, s; r)</tt>. Bond \c b
+/// connects the sites \c b-1 and \c b, the bonds \c 0 and \c size() are the edges of dimension one.
+///
+/// The MPS keeps track of its orthogonality center: the sites left of center() are left-normalized, the
+/// sites right of it are right-normalized, so that the norm and the local expectation values only involve
+/// the center site. Moving the center by one site costs one SVD of a site tensor and records the Schmidt
+/// values of the bond crossed, see lambda().
+///
+/// The site tensors may carry quantum numbers, as the results of applyMPO() do, and norm() takes all
+/// the blocks of the center site into account; canonicalize(), moveCenter() and overlap() work on
+/// tensors without symmetry only and throw on sites of several blocks. The site tensors may also be
+/// complex, as in the real time evolution of TDVP; the Schmidt values stay real.
+/// @see MPO, Environment
+class MPS{
+public:
+    /// @brief Empty MPS
+    MPS();
+
+    /// @brief Constructs an MPS from its site tensors, in the bond order <tt>(l, s; r)</tt>
+    ///
+    /// The canonical form is unknown, center() is -1 until canonicalize() is called.
+    MPS(const std::vector<UniTensor>& sites);
+
+    /// @brief Constructs an MPS in mixed canonical form with the center at site \c center
+    ///
+    /// The sites left of \c center must be left-normalized and the sites right of it right-normalized,
+    /// which is not checked. The Schmidt values are unknown.
+    MPS(const std::vector<UniTensor>& sites, size_t center);
+
+    /// @brief Random normalized MPS of \c L sites of dimension \c d and bonds of dimension up to \c chi
+    ///
+    /// The center is at site 0.
+    MPS(size_t L, int d, int chi);
+
+    /// @brief Normalized product state with the local state \c local on every site, center at site 0
+    static MPS product(size_t L, const std::vector<Real>& local);
+
+    /// @brief Number of sites
+    size_t size()const;
+
+    /// @brief Tensor of site \c i
+    const UniTensor& operator[](size_t i)const;
+
+    /// @brief Replaces the tensor of site \c i
+    ///
+    /// The Schmidt values are forgotten. The center is kept if \c i is the center, otherwise the
+    /// canonical form is lost.
+    void setSite(size_t i, const UniTensor& A);
+
+    /// @brief Replaces the sites \c i and \c i+1 and puts the center on \c center, \c i or \c i+1
+    ///
+    /// For algorithms that update two neighbouring sites at the center, such as two-site DMRG: the site
+    /// that is not the center must be normalized towards it. The Schmidt values are forgotten.
+    void setSites(size_t i, const UniTensor& A, const UniTensor& B, size_t center);
+
+    /// @brief Physical dimension of site \c i
+    int physDim(size_t i)const;
+
+    /// @brief Dimension of the bond \c b
+    int bondDim(size_t b)const;
+
+    /// @brief Largest bond dimension
+    int maxBondDim()const;
+
+    /// @brief Orthogonality center, -1 if the canonical form is unknown
+    int center()const;
+
+    /// @brief Brings the MPS to the mixed canonical form with the center at site \c c
+    ///
+    /// Sweeps through the whole chain. The Schmidt values of the bonds right of \c c are recorded.
+    void canonicalize(size_t c);
+
+    /// @brief Moves the orthogonality center to site \c c
+    ///
+    /// Only the sites between the current center and \c c are touched. If the canonical form is
+    /// unknown this is canonicalize().
+    void moveCenter(size_t c);
+
+    /// @brief Schmidt values of bond \c b, normalized to unit norm
+    ///
+    /// They are recorded each time the center crosses the bond in canonical form, and by setLambda().
+    /// Throws if the Schmidt values of the bond are not known.
+    /// @return Diagonal matrix in decreasing order
+    const Matrix& lambda(size_t b)const;
+
+    /// @brief \c true if the Schmidt values of bond \c b are known
+    bool hasLambda(size_t b)const;
+
+    /// @brief Records the Schmidt values of bond \c b, for algorithms that obtain them from their own SVD
+    void setLambda(size_t b, const Matrix& lambda);
+
+    /// @brief Norm \f$\sqrt{\langle\psi|\psi\rangle}\f$
+    Real norm()const;
+
+    /// @brief Divides the MPS by its norm
+    void normalize();
+
+    /// @brief Overlap \f$\langle this|\phi\rangle\f$ with the MPS \c phi of the same sites, both real
+    Real overlap(const MPS& phi)const;
+
+    /// @brief Site tensor <tt>(l, s; r)</tt> holding the matrix \c m, whose rows are the first \c inBondNum bonds
+    ///
+    /// The tensor is complex if \c m is.
+    static UniTensor siteTensor(int l, int d, int r, const Matrix& m, int inBondNum = 2);
+
+private:
+    std::vector<UniTensor> A;
+    std::vector<Matrix> lambdas;
+    int m_center;
+    void check(size_t i)const;
+    static void checkSingleBlock(const UniTensor& T, size_t i);
+    void shiftRight(size_t i, bool exact);
+    void shiftLeft(size_t i, bool exact);
+};
+
+};	/* namespace uni10 */
+#endif /* MPS_H */
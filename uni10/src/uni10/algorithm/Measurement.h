@@ -0,0 +1,132 @@
+/****************************************************************************
+*  @file Measurement.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file of the batched measurements of an MPS
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef MEASUREMENT_H
+#define MEASUREMENT_H
+#include <vector>
+#include <uni10/tensor-network/Matrix.h>
+#include <uni10/algorithm/MPS.h>
+namespace uni10{
+
+/// @brief Parameters of Measurement
+struct MeasurementParams{
+  MeasurementParams();
+  int threads;            ///< Threads of the independent measurements, 0 for one per core (0)
+};
+
+/// @brief Two-point function \f$\langle L_i\,S_{i+1}\cdots S_{j-1}\,R_j\rangle\f$ of single-site operators
+struct Correlator{
+  Correlator();
+  /// @param left Operator on the left site
+  /// @param right Operator on the right site
+  /// @param string Operator on the sites in between, an empty matrix for the identity
+  Correlator(const Matrix& left, const Matrix& right, const Matrix& string = Matrix());
+  Matrix left;
+  Matrix right;
+  Matrix string;
+};
+
+///@class Measurement
+///@brief One- and two-point functions and entanglement entropies of a finite MPS
+///
+/// The transfer matrices of the chain are multiplied once from each end when the measurement is set up, so
+/// that every environment \f$E^L_i\f$ of the sites left of \c i and \f$E^R_i\f$ of the sites from \c i on is
+/// at hand. A one-point function then costs one transfer matrix per site, and the correlators of a left
+/// site \c i with all the sites right of it share a single sweep to the right, which extends the product
+/// of transfer matrices by one site per step and closes it with \f$E^R\f$. All the correlators of the same
+/// left operator and string are measured in the same sweep, and the sweeps of different left sites run
+/// in parallel. The state need not be normalized or in canonical form; the values are divided by
+/// \f$\langle\psi|\psi\rangle\f$.
+///
+/// The operators are \c d x \c d matrices acting on the physical index, row index out.
+/// \code
+/// Measurement m(psi);
+/// std::vector<Real> mz = m.local(sz);
+/// std::vector<Correlator> corrs;
+/// corrs.push_back(Correlator(sz, sz));
+/// corrs.push_back(Correlator(sp, sm));
+/// std::vector<Matrix> c = m.correlations(corrs);   // c[0](i, j) = <sz_i sz_j>, i <= j
+/// std::vector<Real> S = m.entropies();
+/// \endcode
+/// @see MPS
+class Measurement{
+public:
+    /// @brief Measurement of \c psi, of real tensors without symmetry
+    Measurement(const MPS& psi, const MeasurementParams& params = MeasurementParams());
+
+    /// @brief Number of sites
+    size_t size()const;
+
+    /// @brief Norm \f$\sqrt{\langle\psi|\psi\rangle}\f$
+    Real norm()const;
+
+    /// @brief \f$\langle O_i\rangle\f$ of every site \c i
+    std::vector<Real> local(const Matrix& op)const;
+
+    /// @brief \f$\langle O_i\rangle\f$ of every operator of \c ops and every site \c i
+    /// @return One vector of values per operator
+    std::vector<std::vector<Real> > local(const std::vector<Matrix>& ops)const;
+
+    /// @brief Expectation value of a product of single-site operators, \c ops[k] on site \c first+k
+    Real product(size_t first, const std::vector<Matrix>& ops)const;
+
+    /// @brief Two-point functions of all pairs of sites
+    /// @return For each correlator a size() x size() matrix \c C: <tt>C(i, j)</tt> is
+    /// \f$\langle L_i\,S_{i+1}\cdots S_{j-1}\,R_j\rangle\f$ for \c i < \c j, <tt>C(i, i)</tt> is
+    /// \f$\langle (LR)_i\rangle\f$ and the entries below the diagonal are zero
+    std::vector<Matrix> correlations(const std::vector<Correlator>& corrs)const;
+    /// @overload
+    Matrix correlation(const Correlator& corr)const;
+
+    /// @brief Squares of the Schmidt values of the bond \c b, in decreasing order
+    std::vector<Real> spectrum(size_t b)const;
+
+    /// @brief Von Neumann entropy \f$-\sum_k p_k\ln p_k\f$ of the bond \c b
+    Real entropy(size_t b)const;
+
+    /// @brief Entropies of all the bonds, the edge bonds \c 0 and \c size() have none
+    /// @return size()+1 values
+    std::vector<Real> entropies()const;
+
+private:
+    MeasurementParams params;
+    std::vector<int> dims;
+    std::vector<int> chis;
+    std::vector<std::vector<Real> > sites;  // (l, s, r) row-major
+    std::vector<std::vector<Real> > lefts;  // E^L_i, chi_i x chi_i, bra row
+    std::vector<std::vector<Real> > rights; // E^R_i, chi_i x chi_i, bra row
+    Real norm2;
+    void checkOp(size_t i, const std::vector<Real>& op)const;
+    void transferLeft(size_t i, const Real* E, const Real* op, Real* out, std::vector<Real>& work)const;
+    void transferRight(size_t i, const Real* E, const Real* op, Real* out, std::vector<Real>& work)const;
+    Real close(size_t b, const Real* E)const;
+};
+
+};	/* namespace uni10 */
+#endif /* MEASUREMENT_H */
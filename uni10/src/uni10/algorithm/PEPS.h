@@ -0,0 +1,92 @@
+/****************************************************************************
+*  @file PEPS.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file for the projected entangled pair states of a finite lattice
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef PEPS_H
+#define PEPS_H
+#include <vector>
+#include <uni10/tensor-network/Matrix.h>
+#include <uni10/tensor-network/UniTensor.h>
+namespace uni10{
+
+///@class PEPS
+///@brief Projected entangled pair state of a finite square lattice
+///
+/// Site <tt>(r, c)</tt>, row \c r from the top and column \c c from the left, holds a rank-5 UniTensor with
+/// the bonds <tt>(l, u, s; r, d)</tt>: left, up, physical, right and down. The bonds on the edges of the
+/// lattice have dimension one. The site tensors are real and have no symmetry.
+/// @see BoundaryMPS
+class PEPS{
+public:
+    /// @brief Empty PEPS
+    PEPS();
+
+    /// @brief PEPS of \c rows x \c cols sites from their tensors, listed row by row
+    PEPS(size_t rows, size_t cols, const std::vector<UniTensor>& sites);
+
+    /// @brief Random PEPS with sites of dimension \c d and inner bonds of dimension \c D
+    ///
+    /// The elements are uniform in [0, 1), as from Matrix::randomize().
+    PEPS(size_t rows, size_t cols, int d, int D);
+
+    /// @brief Product state with the local state \c local on every site
+    static PEPS product(size_t rows, size_t cols, const std::vector<Real>& local);
+
+    /// @brief Number of rows
+    size_t rows()const;
+
+    /// @brief Number of columns
+    size_t cols()const;
+
+    /// @brief Tensor of site <tt>(r, c)</tt>
+    const UniTensor& operator()(size_t r, size_t c)const;
+
+    /// @brief Replaces the tensor of site <tt>(r, c)</tt>
+    void setSite(size_t r, size_t c, const UniTensor& A);
+
+    /// @brief Physical dimension of site <tt>(r, c)</tt>
+    int physDim(size_t r, size_t c)const;
+
+    /// @brief The PEPS of the transposed lattice, site <tt>(r, c)</tt> moves to <tt>(c, r)</tt>
+    ///
+    /// The vertical bonds become horizontal ones, so that their expectation values can be taken row by row.
+    PEPS transpose()const;
+
+    /// @brief Site tensor <tt>(l, u, s; r, d)</tt> holding the matrix \c m of <tt>l*u*d</tt> rows and
+    /// <tt>r*dn</tt> columns
+    static UniTensor siteTensor(int l, int u, int d, int r, int dn, const Matrix& m);
+
+private:
+    size_t m_rows;
+    size_t m_cols;
+    std::vector<UniTensor> A;
+    void check(size_t r, size_t c)const;
+};
+
+};	/* namespace uni10 */
+#endif /* PEPS_H */
@@ -0,0 +1,114 @@
+/****************************************************************************
+*  @file Solvers.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file for the matrix-free eigensolver and the truncated SVD
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef SOLVERS_H
+#define SOLVERS_H
+#include <functional>
+#include <vector>
+#include <uni10/tensor-network/Matrix.h>
+#include <uni10/tensor-network/UniTensor.h>
+namespace uni10{
+
+/// @brief Linear operator applied to a vector, \c y = A \c x
+typedef std::function<void(const Real* x, Real* y)> LinearMap;
+
+/// @brief Linear operator applied to a complex vector, \c y = A \c x
+typedef std::function<void(const Complex* x, Complex* y)> ComplexLinearMap;
+
+/// @brief Lowest eigenpair of the real symmetric operator \c A of dimension \c dim by the Lanczos method
+///
+/// The operator is only applied to vectors, it is never formed. \c psi is the starting vector, a good
+/// guess such as the wavefunction of the previous step converges in a few iterations, and is replaced by
+/// the eigenvector. The Krylov space is restarted from the current Ritz vector every \c krylovDim
+/// iterations to bound the memory.
+/// @param A The operator
+/// @param dim Dimension of the vectors
+/// @param psi Starting vector on input, normalized eigenvector on output
+/// @param E0 Lowest eigenvalue
+/// @param maxIter Largest number of applications of \c A
+/// @param tol Convergence criterion on the residual norm
+/// @param krylovDim Largest dimension of the Krylov space
+/// @return Number of applications of \c A
+size_t lanczosGroundState(const LinearMap& A, size_t dim, Real* psi, Real& E0, size_t maxIter = 100, Real tol = 1E-10,
+    size_t krylovDim = 40);
+
+/// @brief \f$e^{tA}\psi\f$ of the real symmetric operator \c A by the Lanczos method
+///
+/// The exponential of the tridiagonal projection of \c A on the Krylov space of \c psi is used. The space
+/// grows until the error estimate \f$\beta_k |c_k|\f$ of the relative error drops below \c tol; if
+/// \c krylovDim vectors are not enough, the time is split into shorter steps. Imaginary time evolution
+/// is \c t < 0, the norm of \c psi is not preserved.
+/// @param A The operator
+/// @param dim Dimension of the vectors
+/// @param psi Vector, replaced by the result
+/// @param t Time
+/// @param tol Largest relative error
+/// @param krylovDim Largest dimension of the Krylov space
+/// @return Number of applications of \c A
+size_t lanczosExpm(const LinearMap& A, size_t dim, Real* psi, Real t, Real tol = 1E-12, size_t krylovDim = 30);
+
+/// @brief \f$e^{-itA}\psi\f$ of the Hermitian operator \c A, the real time evolution
+///
+/// The same Krylov method as the real overload, on complex vectors. The evolution is unitary, the norm of
+/// \c psi is preserved up to \c tol.
+size_t lanczosExpm(const ComplexLinearMap& A, size_t dim, Complex* psi, Real t, Real tol = 1E-12, size_t krylovDim = 30);
+
+/// @brief Number of singular values kept by a truncation
+///
+/// The fewest of the \c num singular values \c s, in decreasing order, whose discarded weight
+/// \f$\sum_{j\ge k} s_j^2 / \sum_j s_j^2\f$ is at most \c cutoff, and at most \c maxChi of them.
+/// @param discarded Discarded weight
+size_t truncationRank(const Real* s, size_t num, int maxChi, Real cutoff, Real& discarded);
+
+/// @brief Truncated singular value decomposition
+///
+/// Keeps the singular values chosen by truncationRank().
+/// @param M The matrix, or a view of a block of a tensor
+/// @param maxChi Largest number of singular values kept
+/// @param cutoff Largest discarded weight
+/// @param discarded Discarded weight
+/// @return Matrices \f$[U, S, V^T]\f$ of the kept singular values, \c S is diagonal and not renormalized
+std::vector<Matrix> truncatedSvd(const Block& M, int maxChi, Real cutoff, Real& discarded);
+
+/// @brief Truncated singular value decomposition of a block diagonal tensor
+///
+/// Decomposes \c T, its incoming bonds as the rows and its outgoing bonds as the columns, block by block.
+/// The singular values of all the blocks are truncated together by truncationRank(), each block keeps its
+/// largest ones. The new bond carries the quantum numbers of the blocks of the values kept, so that the
+/// factors stay block diagonal.
+/// @param T The tensor, real
+/// @param maxChi Largest number of singular values kept
+/// @param cutoff Largest discarded weight
+/// @param discarded Discarded weight
+/// @return Tensors \f$[U, S, V^T]\f$: \c U has the incoming bonds of \c T and the new outgoing bond,
+/// \c S the new bond twice, diagonal, and \f$V^T\f$ the new incoming bond and the outgoing bonds of \c T
+std::vector<UniTensor> truncatedSvd(const UniTensor& T, int maxChi, Real cutoff, Real& discarded);
+
+};	/* namespace uni10 */
+#endif /* SOLVERS_H */
@@ -0,0 +1,133 @@
+/****************************************************************************
+*  @file TDVP.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file for the TDVP time evolution of an MPS
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef TDVP_H
+#define TDVP_H
+#include <vector>
+#include <uni10/algorithm/MPS.h>
+#include <uni10/algorithm/MPO.h>
+#include <uni10/algorithm/Environment.h>
+#include <uni10/algorithm/Solvers.h>
+namespace uni10{
+
+class EffectiveHamiltonian;
+
+/// @brief Parameters of TDVP
+struct TDVPParams{
+  TDVPParams();
+  int maxChi;             ///< Largest bond dimension of the two-site integrator (64)
+  Real cutoff;            ///< Largest discarded weight of a truncation (1E-10)
+  bool twoSite;           ///< Two-site integrator, otherwise one-site at fixed bond dimensions (true)
+  Real krylovTol;         ///< Largest error of a Krylov exponential (1E-12)
+  size_t krylovDim;       ///< Largest Krylov space of an exponential (30)
+};
+
+///@class TDVP
+///@brief Real and imaginary time evolution of an MPS by the time-dependent variational principle
+///
+/// A step is a second order integrator: a sweep from the left to the right end and one back, each
+/// over half the time step. At every site (one-site) or pair of sites (two-site) the center tensor is
+/// evolved forward by the exponential of the effective Hamiltonian, then, after it was split to move the
+/// center on, the part left at the next site or bond is evolved backward by the effective Hamiltonian of
+/// one site (two-site) or of the bond (one-site). The exponentials are matrix-free Krylov exponentials
+/// (lanczosExpm) of EffectiveHamiltonian, and the environments are cached and updated one site per
+/// sub-step.
+///
+/// The MPO can hold long-range terms, TDVP only sees it through the environments. The one-site
+/// integrator keeps the bond dimensions of the MPS and is cheaper, the two-site integrator grows them up
+/// to TDVPParams::maxChi.
+///
+/// step() is the imaginary time evolution \f$e^{-\tau H}|\psi\rangle\f$, normalized, of a real MPS.
+/// realTimeStep() is the real time evolution \f$e^{-iHt}|\psi\rangle\f$ by the one-site integrator: the
+/// sites become complex and the exponentials are the complex lanczosExpm. With long-range terms in the MPO
+/// this replaces the Trotter gates of TEBD and their swaps.
+/// \code
+/// MPO H = MPO::heisenberg(L);
+/// MPS psi(L, 2, 32);
+/// TDVPParams params;
+/// params.twoSite = false;
+/// TDVP tdvp(psi, H, params);
+/// for(int n = 0; n < 100; n++)
+///   tdvp.realTimeStep(0.05);
+/// \endcode
+/// @see MPS, MPO, EffectiveHamiltonian, lanczosExpm
+class TDVP{
+public:
+    /// @brief Prepares the evolution of \c psi, updated in place, by \c H
+    ///
+    /// The MPS and the MPO must outlive the TDVP.
+    TDVP(MPS& psi, const MPO& H, const TDVPParams& params = TDVPParams());
+
+    /// @brief Evolves the state by \f$e^{-\tau H}\f$ and normalizes it
+    ///
+    /// The MPS must be real, that is, not evolved in real time before.
+    /// @return The energy after the step
+    Real step(Real tau);
+
+    /// @brief Evolves the state by \f$e^{-iH\,dt}\f$
+    ///
+    /// Needs the one-site integrator, TDVPParams::twoSite false, whose bond dimensions are those of the
+    /// MPS. The sites of the MPS become complex on the first call.
+    /// @return The energy after the step, constant up to the errors of the integrator
+    Real realTimeStep(Real dt);
+
+    /// @brief Energy after the last step
+    Real energy()const;
+
+    /// @brief Imaginary time evolved so far
+    Real time()const;
+
+    /// @brief Real time evolved so far
+    Real realTime()const;
+
+    /// @brief Largest discarded weight of the last step
+    Real discarded()const;
+
+    /// @brief Applications of the effective Hamiltonians so far
+    size_t matvecs()const;
+
+private:
+    MPS& psi;
+    const MPO& H;
+    TDVPParams params;
+    Environment env;
+    Real m_energy;
+    Real m_time;
+    Real m_realTime;
+    Real m_discarded;
+    size_t m_matvecs;
+    void evolve(EffectiveHamiltonian& Heff, std::vector<Real>& v, Real t);
+    void evolve(EffectiveHamiltonian& Heff, std::vector<Complex>& v, Real t);
+    void sweepTwoSite(Real tau, bool toRight);
+    template<typename T>
+    void sweepOneSite(Real tau, bool toRight);
+};
+
+};	/* namespace uni10 */
+#endif /* TDVP_H */
@@ -0,0 +1,173 @@
+/****************************************************************************
+*  @file TEBD.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file for the TEBD and iTEBD time evolution
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef TEBD_H
+#define TEBD_H
+#include <vector>
+#include <uni10/tensor-network/Matrix.h>
+#include <uni10/algorithm/MPS.h>
+namespace uni10{
+
+/// @brief Parameters of TEBD
+struct TEBDParams{
+  TEBDParams();
+  int maxChi;             ///< Largest bond dimension (64)
+  Real cutoff;            ///< Largest discarded weight of a truncation (1E-10)
+  int threads;            ///< Threads applying the gates of a layer, 0 for one per core (0)
+};
+
+///@class TEBD
+///@brief Time evolution of a chain in Vidal's form by two-site gates
+///
+/// The state is stored as \f$\lambda^{[0]}\Gamma^{[0]}\lambda^{[1]}\Gamma^{[1]}\cdots\f$, the Schmidt values
+/// \f$\lambda^{[b]}\f$ sit on the bond between the sites <tt>b-1</tt> and \c b as in MPS::lambda(). A finite
+/// chain has the edge bonds \c 0 and \c size() of dimension one. An infinite chain (iTEBD) repeats a unit
+/// cell of size() sites, the bond \c 0 connects the last site of a cell to the first site of the next.
+///
+/// A gate on the sites \c i and <tt>i+1</tt> is applied by fused kernels on buffers that are kept from
+/// gate to gate: the Schmidt values are multiplied in while the site tensors are copied, the two sites are
+/// joined by a single GEMM, the gate is applied to the physical indices in place and the result is split
+/// by an SVD on the same buffers. The gates of a layer act on disjoint bonds and are applied in parallel.
+///
+/// The state is real until a complex gate is applied, realTimeGate() gives complex gates.
+/// \code
+/// TEBD tebd(psi);   // finite MPS
+/// std::vector<Matrix> half(L - 1, TEBD::realTimeGate(h, dt / 2)), full(L - 1, TEBD::realTimeGate(h, dt));
+/// for(int n = 0; n < steps; n++){   // second order Trotter steps
+///   tebd.applyLayer(half, 0);
+///   tebd.applyLayer(full, 1);
+///   tebd.applyLayer(half, 0);
+/// }
+/// \endcode
+/// @see MPS
+class TEBD{
+public:
+    /// @brief Finite chain in the state \c psi
+    TEBD(const MPS& psi, const TEBDParams& params = TEBDParams());
+
+    /// @brief Infinite chain with a unit cell of \c n sites in the product state \c local on every site
+    ///
+    /// \c n must be even and at least two, so that the unit cell splits into two layers of gates.
+    static TEBD infinite(size_t n, const std::vector<Real>& local, const TEBDParams& params = TEBDParams());
+
+    /// @brief Number of sites, of the unit cell for an infinite chain
+    size_t size()const;
+
+    /// @brief \c true for an infinite chain
+    bool isInfinite()const;
+
+    /// @brief \c true once a complex gate was applied
+    bool isComplex()const;
+
+    /// @brief Physical dimension of site \c i
+    int physDim(size_t i)const;
+
+    /// @brief Dimension of the bond \c b
+    int bondDim(size_t b)const;
+
+    /// @brief Schmidt values of the bond \c b as a diagonal matrix, normalized to unit norm
+    Matrix lambda(size_t b)const;
+
+    /// @brief Number of gates, \c size()-1 for a finite chain and \c size() for an infinite chain
+    size_t gateNum()const;
+
+    /// @brief Applies \c gate to the sites \c i and <tt>i+1</tt> and truncates their bond
+    ///
+    /// The gate is a square matrix of the dimension of the two sites, its rows and columns are the pairs
+    /// of physical indices <tt>(s_i, s_{i+1})</tt> of the output and of the input. The state is
+    /// normalized again.
+    /// @return The discarded weight
+    Real applyGate(size_t i, const Matrix& gate);
+
+    /// @brief Applies the gates of the layer \c parity, to the sites \c i and <tt>i+1</tt> for every
+    /// <tt>i % 2 == parity</tt>
+    ///
+    /// The gates act on disjoint pairs of sites and are applied in parallel by TEBDParams::threads threads.
+    /// @param gates One gate per pair of sites, indexed by \c i, or a single gate for every pair
+    /// @param parity \c 0 or \c 1
+    /// @return The largest discarded weight
+    Real applyLayer(const std::vector<Matrix>& gates, int parity);
+
+    /// @brief One first order Trotter step, the layers \c 0 and \c 1
+    /// @return The largest discarded weight
+    Real step(const std::vector<Matrix>& gates);
+
+    /// @brief Expectation value of the one-site operator \c op on site \c i
+    ///
+    /// Assumes the canonical form, which holds up to the truncation error after real time gates and up to
+    /// the Trotter error after imaginary time gates.
+    Real expectation(size_t i, const Matrix& op)const;
+
+    /// @brief Expectation value of the two-site operator \c op on the sites \c i and <tt>i+1</tt>
+    ///
+    /// \c op is laid out as a gate. This is the energy of a bond when \c op is its Hamiltonian.
+    Real bondExpectation(size_t i, const Matrix& op)const;
+
+    /// @brief The state as a normalized MPS in canonical form with the center on the last site
+    ///
+    /// Only for a real finite chain. The canonical form is computed anew, so that the MPS is exact even
+    /// when imaginary time gates spoiled the canonical form of the Vidal tensors.
+    MPS toMPS()const;
+
+    /// @brief Number of gates applied
+    size_t applications()const;
+
+    /// @brief Imaginary time gate \f$e^{-\tau h}\f$ of the real symmetric bond Hamiltonian \c h
+    static Matrix imaginaryTimeGate(const Matrix& h, Real tau);
+
+    /// @brief Real time gate \f$e^{-i\,dt\,h}\f$ of the real symmetric bond Hamiltonian \c h
+    static Matrix realTimeGate(const Matrix& h, Real dt);
+
+private:
+    // Buffers of the gate kernels of one thread, reused from gate to gate
+    struct Workspace{
+      std::vector<std::vector<Real> > real;
+      std::vector<std::vector<Complex> > complex;
+      std::vector<Real> S;
+      std::vector<Real> rwork;
+      std::vector<int> iwork;
+    };
+    TEBDParams params;
+    bool m_infinite;
+    bool m_complex;
+    std::vector<int> dims;
+    std::vector<std::vector<Real> > lambdas;
+    std::vector<std::vector<Real> > gammaR;
+    std::vector<std::vector<Complex> > gammaC;
+    std::vector<Workspace> work;
+    size_t m_applications;
+    TEBD();
+    void checkGate(size_t i, const Matrix& gate)const;
+    void toComplex();
+    const std::vector<Real>& lambdaOf(size_t b)const;
+    Real apply(size_t i, const Matrix& gate, Workspace& ws);
+};
+
+};	/* namespace uni10 */
+#endif /* TEBD_H */
@@ -0,0 +1,523 @@
+/****************************************************************************
+*  @file BoundaryMPS.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file of the boundary MPS contraction of a finite PEPS
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/algorithm/BoundaryMPS.h>
+#include <uni10/algorithm/Solvers.h>
+#include <uni10/tools/uni10_tools.h>
+#include <uni10/tools/uni10_trace.h>
+#include <algorithm>
+#include <cmath>
+#include <exception>
+namespace uni10{
+
+namespace{
+  // Singular values of a two-site operator below this fraction of the largest are dropped
+  const Real OPERATOR_EPS = 1E-14;
+
+  // Tensor of rank bonds of dimension one holding 1, the edge of a boundary or of an environment
+  UniTensor unit(int rank){
+    std::vector<Bond> bonds(rank - 1, Bond(BD_IN, 1));
+    bonds.push_back(Bond(BD_OUT, 1));
+    UniTensor T(bonds);
+    T.identity();
+    return T;
+  }
+
+  // Tensor with the bonds of dimensions dims, the first inBondNum of them incoming, holding the matrix m
+  UniTensor tensor(const std::vector<int>& dims, int inBondNum, const Matrix& m){
+    std::vector<Bond> bonds;
+    for(size_t i = 0; i < dims.size(); i++)
+      bonds.push_back(Bond((int)i < inBondNum ? BD_IN : BD_OUT, dims[i]));
+    UniTensor T(bonds);
+    T.putBlock(m);
+    return T;
+  }
+
+  UniTensor labelled(const UniTensor& T, const int* label){
+    UniTensor L(T);
+    L.setLabel(const_cast<int*>(label));
+    return L;
+  }
+
+  // Site tensors labelled by (l, u, s, r, d); from the bottom the roles of the up and down bonds swap
+  UniTensor labelledSite(const UniTensor& A, bool fromTop, const int* roles){
+    int label[] = {roles[0], roles[1], roles[2], roles[3], roles[4]};
+    if(!fromTop)
+      std::swap(label[1], label[4]);
+    return labelled(A, label);
+  }
+
+  // One column of the sandwich of a row between the boundaries top and bottom: the environment E
+  // (t, L, L', b) from the left is moved to the right of the column, or from the right to the left
+  UniTensor transfer(const UniTensor& E, const UniTensor& top, const UniTensor& bottom, const UniTensor& ket,
+      const UniTensor& bra, bool toRight){
+    int labelE[] = {1, 2, 3, 4}, labelRight[] = {7, 9, 11, 13};
+    int labelTop[] = {1, 5, 6, 7}, labelKet[] = {2, 5, 8, 9, 10}, labelBra[] = {3, 6, 8, 11, 12}, labelBottom[] = {4, 10, 12, 13};
+    UniTensor T = labelled(E, toRight ? labelE : labelRight);
+    UniTensor Top = labelled(top, labelTop), K = labelled(ket, labelKet), B = labelled(bra, labelBra);
+    UniTensor Bottom = labelled(bottom, labelBottom);
+    T = contract(T, Top, true);
+    T = contract(T, K, true);
+    T = contract(T, B, true);
+    T = contract(T, Bottom, true);
+    T.permute(toRight ? labelRight : labelE, 2);
+    return T;
+  }
+
+  Real scalar(UniTensor& L, UniTensor& R){
+    UniTensor S = contract(L, R, true);
+    return S.getElem()[0];
+  }
+};
+
+BoundaryParams::BoundaryParams(): maxChi(16), cutoff(1E-12), sweeps(1), threads(0){}
+
+BoundaryMPS::BoundaryMPS(const PEPS& _peps, const BoundaryParams& _params): peps(&_peps), params(_params),
+  tops(_peps.rows() + 1), bottoms(_peps.rows() + 1), m_absorptions(0){
+  try{
+    if(!peps->rows() || !peps->cols()){
+      std::ostringstream err;
+      err<<"The PEPS is empty.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    invalidate();
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor BoundaryMPS::BoundaryMPS(uni10::PEPS&, uni10::BoundaryParams&):");
+  }
+}
+
+void BoundaryMPS::invalidate(size_t r){
+  checkRow(r);
+  for(size_t j = r + 1; j <= peps->rows(); j++)
+    tops[j].valid = false;
+  for(size_t j = 0; j <= r; j++)
+    bottoms[j].valid = false;
+}
+
+void BoundaryMPS::invalidate(){
+  size_t rows = peps->rows();
+  for(size_t j = 0; j <= rows; j++){
+    tops[j].valid = false;
+    bottoms[j].valid = false;
+  }
+  // the edges, the bonds outside the lattice have dimension one
+  Boundary edge;
+  edge.B.assign(peps->cols(), unit(4));
+  edge.logScale = 0;
+  edge.discarded = 0;
+  edge.valid = true;
+  tops[0] = edge;
+  bottoms[rows] = edge;
+}
+
+void BoundaryMPS::checkRow(size_t r)const{
+  if(r >= peps->rows()){
+    std::ostringstream err;
+    err<<"Row " << r << " is out of the PEPS of " << peps->rows() << " rows.";
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+}
+
+BoundaryMPS::Boundary BoundaryMPS::absorb(const Boundary& in, size_t row, bool fromTop)const{
+  UNI10_TRACE_SCOPE(trace, "boundary mps absorb", "peps");
+  size_t n = peps->cols();
+  Boundary out;
+  out.B.resize(n);
+  out.logScale = in.logScale;
+  out.discarded = 0;
+  out.valid = true;
+  // zip-up: Z (x, l, L, L') is what is left of the columns on the left, x the bond of the new boundary
+  int labelZ[] = {1, 2, 3, 4}, labelB[] = {2, 5, 6, 7}, roleKet[] = {3, 5, 8, 9, 10}, roleBra[] = {4, 6, 8, 11, 12};
+  int labelSplit[] = {1, 10, 12, 7, 9, 11};
+  UniTensor Z = unit(4);
+  for(size_t c = 0; c < n; c++){
+    Z.setLabel(labelZ);
+    UniTensor B = labelled(in.B[c], labelB);
+    UniTensor ket = labelledSite((*peps)(row, c), fromTop, roleKet), bra = labelledSite((*peps)(row, c), fromTop, roleBra);
+    Z = contract(Z, B, true);
+    Z = contract(Z, ket, true);
+    Z = contract(Z, bra, true);
+    Z.permute(labelSplit, 3);
+    std::vector<int> dims(6);
+    for(int i = 0; i < 6; i++)
+      dims[i] = Z.bond(i).dim();
+    Real discarded;
+    std::vector<Matrix> usv = truncatedSvd(Z.const_getBlock(), params.maxChi, params.cutoff, discarded);
+    out.discarded = std::max(out.discarded, discarded);
+    int chi = usv[1].row();
+    std::vector<int> left(dims.begin(), dims.begin() + 3), right(1, chi);
+    left.push_back(chi);
+    right.insert(right.end(), dims.begin() + 3, dims.end());
+    out.B[c] = tensor(left, 3, usv[0]);
+    Z = tensor(right, 1, usv[1] * usv[2]);
+  }
+  // the bonds right of the last column have dimension one, the norm of the boundary is left
+  Real s = Z.getElem()[0];
+  if(s == 0){
+    std::ostringstream err;
+    err<<"The boundary vanishes after row " << row << ".";
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+  if(s < 0)
+    out.B[n - 1] *= -1.0;
+  out.logScale += std::log(std::fabs(s));
+  for(int sweep = 0; sweep < params.sweeps; sweep++)
+    fit(out, in, row, fromTop);
+  return out;
+}
+
+void BoundaryMPS::fit(Boundary& out, const Boundary& in, size_t row, bool fromTop)const{
+  // One sweep from the right and back of the best approximation out of in with the row absorbed. out is
+  // left-normalized on entry and on exit, with the norm in logScale.
+  UNI10_TRACE_SCOPE(trace, "boundary mps fit", "peps");
+  size_t n = peps->cols();
+  int labelF[] = {1, 2, 3, 4}, labelG[] = {21, 7, 9, 11}, labelB[] = {2, 5, 6, 7};
+  int roleKet[] = {3, 5, 8, 9, 10}, roleBra[] = {4, 6, 8, 11, 12};
+  int labelXl[] = {1, 10, 12, 13}, labelXr[] = {1, 10, 12, 21}, labelFout[] = {13, 7, 9, 11}, labelGout[] = {1, 2, 3, 4};
+  std::vector<UniTensor> F(n + 1), G(n + 1);
+  F[0] = unit(4);
+  G[n] = unit(4);
+  // the column c of the target, the row absorbed into in, contracted with the environments
+  auto local = [&](size_t c){
+    UniTensor T = labelled(F[c], labelF);
+    UniTensor B = labelled(in.B[c], labelB), R = labelled(G[c + 1], labelG);
+    UniTensor ket = labelledSite((*peps)(row, c), fromTop, roleKet), bra = labelledSite((*peps)(row, c), fromTop, roleBra);
+    T = contract(T, B, true);
+    T = contract(T, ket, true);
+    T = contract(T, bra, true);
+    T = contract(T, R, true);
+    T.permute(labelXr, 3);
+    return T;
+  };
+  auto leftStep = [&](size_t c){
+    UniTensor T = labelled(F[c], labelF);
+    UniTensor B = labelled(in.B[c], labelB), X = labelled(out.B[c], labelXl);
+    UniTensor ket = labelledSite((*peps)(row, c), fromTop, roleKet), bra = labelledSite((*peps)(row, c), fromTop, roleBra);
+    T = contract(T, B, true);
+    T = contract(T, ket, true);
+    T = contract(T, bra, true);
+    T = contract(T, X, true);
+    T.permute(labelFout, 3);
+    F[c + 1] = T;
+  };
+  auto rightStep = [&](size_t c){
+    UniTensor T = labelled(G[c + 1], labelG);
+    UniTensor B = labelled(in.B[c], labelB), X = labelled(out.B[c], labelXr);
+    UniTensor ket = labelledSite((*peps)(row, c), fromTop, roleKet), bra = labelledSite((*peps)(row, c), fromTop, roleBra);
+    T = contract(T, B, true);
+    T = contract(T, ket, true);
+    T = contract(T, bra, true);
+    T = contract(T, X, true);
+    T.permute(labelGout, 1);
+    G[c] = T;
+  };
+  for(size_t c = 0; c + 1 < n; c++)
+    leftStep(c);
+  for(size_t c = n - 1; c > 0; c--){
+    UniTensor X = local(c);
+    X.permute(1);
+    std::vector<Matrix> usv = X.const_getBlock().svd();
+    std::vector<int> dims(1, usv[2].row());
+    for(int i = 1; i < 4; i++)
+      dims.push_back(X.bond(i).dim());
+    out.B[c] = tensor(dims, 1, usv[2]);
+    out.B[c].permute(3);
+    rightStep(c);
+  }
+  for(size_t c = 0; c + 1 < n; c++){
+    UniTensor X = local(c);
+    std::vector<Matrix> usv = X.const_getBlock().svd();
+    std::vector<int> dims;
+    for(int i = 0; i < 3; i++)
+      dims.push_back(X.bond(i).dim());
+    dims.push_back(usv[0].col());
+    out.B[c] = tensor(dims, 3, usv[0]);
+    leftStep(c);
+  }
+  UniTensor X = local(n - 1);
+  Real norm = X.norm();
+  if(norm == 0){
+    std::ostringstream err;
+    err<<"The boundary vanishes after row " << row << ".";
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+  X *= 1 / norm;
+  out.B[n - 1] = X;
+  out.logScale = in.logScale + std::log(norm);
+}
+
+const BoundaryMPS::Boundary& BoundaryMPS::boundary(bool fromTop, size_t r){
+  if(fromTop){
+    size_t j = r;
+    while(!tops[j].valid)
+      j--;
+    for(; j < r; j++){
+      tops[j + 1] = absorb(tops[j], j, true);
+      m_absorptions++;
+    }
+    return tops[r];
+  }
+  size_t j = r;
+  while(!bottoms[j].valid)
+    j++;
+  for(; j > r; j--){
+    bottoms[j - 1] = absorb(bottoms[j], j - 1, false);
+    m_absorptions++;
+  }
+  return bottoms[r];
+}
+
+void BoundaryMPS::prepare(size_t top, size_t bottom){
+  // the boundaries from the top and from the bottom are independent
+  size_t threadNum = !tops[top].valid && !bottoms[bottom].valid ? taskThreads(params.threads, 2) : 1;
+  parallelTasks(2, threadNum, [&](size_t k, size_t){
+    if(k == 0)
+      boundary(true, top);
+    else
+      boundary(false, bottom);
+  });
+}
+
+const std::vector<UniTensor>& BoundaryMPS::top(size_t r){
+  try{
+    if(r > peps->rows())
+      checkRow(r);
+    boundary(true, r);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function BoundaryMPS::top(size_t):");
+  }
+  return tops[r].B;
+}
+
+const std::vector<UniTensor>& BoundaryMPS::bottom(size_t r){
+  try{
+    if(r > peps->rows())
+      checkRow(r);
+    boundary(false, r);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function BoundaryMPS::bottom(size_t):");
+  }
+  return bottoms[r].B;
+}
+
+Real BoundaryMPS::logNorm(){
+  Real val = 0;
+  try{
+    size_t r = peps->rows() / 2;
+    prepare(r, r);
+    int labelE[] = {1, 2}, labelTop[] = {1, 3, 4, 5}, labelBottom[] = {2, 3, 4, 6}, labelOut[] = {5, 6};
+    UniTensor E = unit(2);
+    for(size_t c = 0; c < peps->cols(); c++){
+      E.setLabel(labelE);
+      UniTensor T = labelled(tops[r].B[c], labelTop), B = labelled(bottoms[r].B[c], labelBottom);
+      E = contract(E, T, true);
+      E = contract(E, B, true);
+      E.permute(labelOut, 1);
+    }
+    val = std::log(std::fabs(E.getElem()[0])) + tops[r].logScale + bottoms[r].logScale;
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function BoundaryMPS::logNorm():");
+  }
+  return val;
+}
+
+Real BoundaryMPS::norm(){
+  return std::exp(logNorm());
+}
+
+std::vector<UniTensor> BoundaryMPS::sandwich(size_t r, std::vector<UniTensor>& rights){
+  // the environments of row r between top(r) and bottom(r+1), from the left of every column and from the
+  // right of every column
+  prepare(r, r + 1);
+  size_t n = peps->cols();
+  std::vector<UniTensor> lefts(n + 1);
+  rights.assign(n + 1, UniTensor());
+  lefts[0] = unit(4);
+  rights[n] = unit(4);
+  for(size_t c = 0; c < n; c++)
+    lefts[c + 1] = transfer(lefts[c], tops[r].B[c], bottoms[r + 1].B[c], (*peps)(r, c), (*peps)(r, c), true);
+  for(size_t c = n; c > 0; c--)
+    rights[c - 1] = transfer(rights[c], tops[r].B[c - 1], bottoms[r + 1].B[c - 1], (*peps)(r, c - 1), (*peps)(r, c - 1), false);
+  return lefts;
+}
+
+UniTensor BoundaryMPS::applied(const UniTensor& A, const Matrix& op)const{
+  int d = A.bond(2).dim();
+  if((int)op.row() != d || (int)op.col() != d){
+    std::ostringstream err;
+    err<<"The operator must be " << d << " x " << d << " for a site of dimension " << d << ".";
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+  int labelA[] = {1, 2, 3, 4, 5}, labelOp[] = {6, 3}, labelOut[] = {1, 2, 6, 4, 5};
+  std::vector<int> dims(2, d);
+  UniTensor T = labelled(A, labelA), O = tensor(dims, 1, op);
+  O.setLabel(labelOp);
+  T = contract(T, O, true);
+  T.permute(labelOut, 3);
+  T.setLabel(labelA);
+  return T;
+}
+
+std::vector<Real> BoundaryMPS::expectations(size_t r, const Matrix& op){
+  std::vector<Real> vals;
+  try{
+    checkRow(r);
+    size_t n = peps->cols();
+    std::vector<UniTensor> rights;
+    std::vector<UniTensor> lefts = sandwich(r, rights);
+    UniTensor N = lefts[n];
+    Real norm = N.getElem()[0];
+    vals.assign(n, 0);
+    std::vector<UniTensor> kets(n);
+    for(size_t c = 0; c < n; c++)
+      kets[c] = applied((*peps)(r, c), op);
+    // the columns only read the shared environments
+    int label[] = {7, 9, 11, 13};
+    parallelTasks(n, taskThreads(params.threads, n), [&](size_t c, size_t){
+      UniTensor E = transfer(lefts[c], tops[r].B[c], bottoms[r + 1].B[c], kets[c], (*peps)(r, c), true);
+      UniTensor R = labelled(rights[c + 1], label);
+      E.setLabel(label);
+      vals[c] = scalar(E, R) / norm;
+    });
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function BoundaryMPS::expectations(size_t, uni10::Matrix&):");
+  }
+  return vals;
+}
+
+Real BoundaryMPS::expectation(size_t r, size_t c, const Matrix& op){
+  Real val = 0;
+  try{
+    checkRow(r);
+    if(c >= peps->cols()){
+      std::ostringstream err;
+      err<<"Column " << c << " is out of the PEPS of " << peps->cols() << " columns.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    std::vector<UniTensor> rights;
+    std::vector<UniTensor> lefts = sandwich(r, rights);
+    int label[] = {7, 9, 11, 13};
+    UniTensor N = lefts[peps->cols()];
+    UniTensor E = transfer(lefts[c], tops[r].B[c], bottoms[r + 1].B[c], applied((*peps)(r, c), op), (*peps)(r, c), true);
+    UniTensor R = labelled(rights[c + 1], label);
+    E.setLabel(label);
+    val = scalar(E, R) / N.getElem()[0];
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function BoundaryMPS::expectation(size_t, size_t, uni10::Matrix&):");
+  }
+  return val;
+}
+
+Real BoundaryMPS::bondExpectation(size_t r, size_t c, const Matrix& op){
+  Real val = 0;
+  try{
+    checkRow(r);
+    if(c + 1 >= peps->cols()){
+      std::ostringstream err;
+      err<<"No bond right of column " << c << " in the PEPS of " << peps->cols() << " columns.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    const UniTensor& A1 = (*peps)(r, c);
+    const UniTensor& A2 = (*peps)(r, c + 1);
+    int d1 = A1.bond(2).dim(), d2 = A2.bond(2).dim();
+    if((int)op.row() != d1 * d2 || (int)op.col() != d1 * d2){
+      std::ostringstream err;
+      err<<"The operator must be " << d1 * d2 << " x " << d1 * d2 << " for sites of dimensions " << d1 << " and " << d2 << ".";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    // op = sum_k O1_k x O2_k, the ket tensors of the two sites get the index k on the bond between them
+    int dimsOp[] = {d1, d2, d1, d2};
+    int labelOp[] = {1, 2, 3, 4}, labelSplit[] = {1, 3, 2, 4};
+    UniTensor O = tensor(std::vector<int>(dimsOp, dimsOp + 4), 2, op);
+    O.setLabel(labelOp);
+    O.permute(labelSplit, 2);
+    std::vector<Matrix> usv = O.const_getBlock().svd();
+    size_t K = 0;
+    while(K < usv[1].row() && usv[1][K] > OPERATOR_EPS * usv[1][0])
+      K++;
+    usv[0].resize(usv[0].row(), K);
+    usv[1].resize(K, K);
+    usv[2].resize(K, usv[2].col());
+    for(size_t k = 0; k < K; k++)
+      usv[1][k] = std::sqrt(usv[1][k]);
+    int dims1[] = {d1, d1, (int)K}, dims2[] = {(int)K, d2, d2};
+    UniTensor O1 = tensor(std::vector<int>(dims1, dims1 + 3), 2, usv[0] * usv[1]);
+    UniTensor O2 = tensor(std::vector<int>(dims2, dims2 + 3), 1, usv[1] * usv[2]);
+    int labelA[] = {1, 2, 3, 4, 5}, labelO1[] = {6, 3, 7}, labelO2[] = {7, 6, 3}, labelOut[] = {1, 2, 6, 4, 5};
+    UniTensor K1 = labelled(A1, labelA), K2 = labelled(A2, labelA);
+    O1.setLabel(labelO1);
+    O2.setLabel(labelO2);
+    K1 = contract(K1, O1, true);
+    std::vector<int> join(2, 4);
+    join[1] = 7;
+    K1.combineBond(join);
+    K1.permute(labelOut, 3);
+    K2 = contract(K2, O2, true);
+    join[0] = 1;
+    K2.combineBond(join);
+    K2.permute(labelOut, 3);
+
+    std::vector<UniTensor> rights;
+    std::vector<UniTensor> lefts = sandwich(r, rights);
+    int label[] = {7, 9, 11, 13};
+    UniTensor N = lefts[peps->cols()];
+    UniTensor E = transfer(lefts[c], tops[r].B[c], bottoms[r + 1].B[c], K1, A1, true);
+    E = transfer(E, tops[r].B[c + 1], bottoms[r + 1].B[c + 1], K2, A2, true);
+    UniTensor R = labelled(rights[c + 2], label);
+    E.setLabel(label);
+    val = scalar(E, R) / N.getElem()[0];
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function BoundaryMPS::bondExpectation(size_t, size_t, uni10::Matrix&):");
+  }
+  return val;
+}
+
+size_t BoundaryMPS::absorptions()const{
+  return m_absorptions;
+}
+
+Real BoundaryMPS::discarded()const{
+  Real discarded = 0;
+  for(size_t j = 0; j < tops.size(); j++){
+    if(tops[j].valid)
+      discarded = std::max(discarded, tops[j].discarded);
+    if(bottoms[j].valid)
+      discarded = std::max(discarded, bottoms[j].discarded);
+  }
+  return discarded;
+}
+
+};	/* namespace uni10 */
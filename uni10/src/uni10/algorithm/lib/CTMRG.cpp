@@ -0,0 +1,550 @@
+/****************************************************************************
+*  @file CTMRG.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file of the corner transfer matrix renormalization group
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/algorithm/CTMRG.h>
+#include <uni10/algorithm/Solvers.h>
+#include <uni10/numeric/lapack/uni10_lapack.h>
+#include <uni10/tools/uni10_tools.h>
+#include <uni10/tools/uni10_trace.h>
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <functional>
+#include <random>
+#include <thread>
+namespace uni10{
+
+namespace{
+  // Singular values below this fraction of the largest are not inverted into the projectors
+  const Real SPECTRUM_EPS = 1E-12;
+  // Seed of the random vectors of the randomized SVDs, fixed so that the runs are reproducible
+  const unsigned RANDOM_SEED = 20160606;
+
+  // Divide and conquer SVD of the m x n matrix M, which is destroyed
+  void svd(Real* M, int m, int n, Real* U, Real* S, Real* vT){
+    std::vector<int> iwork(8 * std::min(m, n));
+    Real size;
+    matrixSVD(M, m, n, U, S, vT, &size, -1, &iwork[0], false);
+    std::vector<Real> work((size_t)size);
+    matrixSVD(M, m, n, U, S, vT, &work[0], (int)work.size(), &iwork[0], false);
+  }
+
+  // Leading singular triplets of a block, U is m x r and vT is r x n
+  struct BlockSvd{
+    int m, n, r;
+    std::vector<Real> U, S, vT;
+  };
+
+  void fullSvd(const Block& M, BlockSvd& out){
+    out.m = M.row();
+    out.n = M.col();
+    out.r = std::min(out.m, out.n);
+    std::vector<Real> elem(M.getElem(), M.getElem() + M.elemNum());
+    out.U.resize((size_t)out.m * out.r);
+    out.S.resize(out.r);
+    out.vT.resize((size_t)out.r * out.n);
+    svd(&elem[0], out.m, out.n, &out.U[0], &out.S[0], &out.vT[0]);
+  }
+
+  // Orthonormal basis of the columns of the m x r matrix Y, in place
+  void orthonormalize(std::vector<Real>& Y, int m, int r){
+    std::vector<Real> R((size_t)r * r);
+    std::vector<Real> Q(Y.size());
+    matrixQR(&Y[0], m, r, &Q[0], &R[0], false);
+    Y.swap(Q);
+  }
+
+  // Randomized SVD of rank r: the range of M is found by r random vectors and powerIter power iterations,
+  // then M is decomposed on it
+  void randomizedSvd(const Block& M, int r, int powerIter, BlockSvd& out){
+    int m = M.row(), n = M.col();
+    Real* A = M.getElem();
+    std::mt19937 rng(RANDOM_SEED);
+    std::normal_distribution<Real> normal;
+    std::vector<Real> omega((size_t)n * r), Y((size_t)m * r), Z((size_t)n * r);
+    for(size_t i = 0; i < omega.size(); i++)
+      omega[i] = normal(rng);
+    matrixMul(A, &omega[0], m, r, n, &Y[0], false, false, false);
+    for(int p = 0; p < powerIter; p++){
+      orthonormalize(Y, m, r);
+      matrixMul(A, &Y[0], n, r, m, &Z[0], true, false, false, false, false);
+      orthonormalize(Z, n, r);
+      matrixMul(A, &Z[0], m, r, n, &Y[0], false, false, false);
+    }
+    orthonormalize(Y, m, r);
+    std::vector<Real> B((size_t)r * n), Ub((size_t)r * r);
+    matrixMul(&Y[0], A, r, n, m, &B[0], true, false, false, false, false);
+    out.m = m;
+    out.n = n;
+    out.r = r;
+    out.U.resize((size_t)m * r);
+    out.S.resize(r);
+    out.vT.resize((size_t)r * n);
+    svd(&B[0], r, n, &Ub[0], &out.S[0], &out.vT[0]);
+    matrixMul(&Y[0], &Ub[0], m, r, r, &out.U[0], false, false, false);
+  }
+
+  // The bond joined to bd, as an incoming bond
+  Bond dualBond(const Bond& bd){
+    Bond dual(bd);
+    dual.dummy_change(bd.type() == BD_IN ? BD_OUT : BD_IN);
+    dual.change(BD_IN);
+    return dual;
+  }
+
+  // The tiling tensor labelled by the roles of its bonds in the frame of a move toward side
+  UniTensor rotated(const UniTensor& a, int side, int left, int up, int right, int down){
+    int roles[] = {left, up, right, down};
+    int label[4];
+    for(int k = 0; k < 4; k++)
+      label[(side + k) % 4] = roles[k];
+    UniTensor T(a);
+    T.setLabel(label);
+    return T;
+  }
+
+  UniTensor labelled(const UniTensor& T, int* label){
+    UniTensor L(T);
+    L.setLabel(label);
+    return L;
+  }
+};
+
+CTMRGParams::CTMRGParams(): maxChi(32), cutoff(1E-12), tol(1E-10), maxIter(200), randomized(false), oversampling(10),
+  powerIter(2), threads(0){}
+
+CTMRG::CTMRG(const UniTensor& _a, const CTMRGParams& _params): params(_params), a(_a), C(4), T(4), spectra(4),
+  m_change(0), m_discarded(0), m_converged(false), m_moves(0){
+  try{
+    check();
+    std::vector<Qnum> trivial(1, Qnum());
+    for(int k = 0; k < 4; k++){
+      std::vector<Bond> bonds;
+      bonds.push_back(Bond(BD_IN, trivial));
+      bonds.push_back(Bond(BD_OUT, trivial));
+      C[k] = UniTensor(RTYPE, bonds);
+      C[k].identity();
+      bonds.insert(bonds.begin() + 1, dualBond(a.bond(k)));
+      T[k] = UniTensor(RTYPE, bonds);
+      T[k].set_zero();
+      std::vector<Qnum> qnums = T[k].blockQnum();
+      if(std::find(qnums.begin(), qnums.end(), Qnum()) == qnums.end()){
+        std::ostringstream err;
+        err<<"The bond " << k << " of the tensor has no state of the trivial sector to start the environment from.";
+        throw std::runtime_error(exception_msg(err.str()));
+      }
+      BlockView ones = T[k].getBlockView(Qnum());
+      std::fill(ones.getElem(), ones.getElem() + ones.elemNum(), 1);
+    }
+    for(int k = 0; k < 4; k++)
+      spectra[k] = spectrum(k);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor CTMRG::CTMRG(uni10::UniTensor&, uni10::CTMRGParams&):");
+  }
+}
+
+CTMRG::CTMRG(const UniTensor& _a, const std::vector<UniTensor>& corners, const std::vector<UniTensor>& edges,
+    const CTMRGParams& _params): params(_params), a(_a), C(corners), T(edges), spectra(4), m_change(0), m_discarded(0),
+    m_converged(false), m_moves(0){
+  try{
+    check();
+    if(C.size() != 4 || T.size() != 4){
+      std::ostringstream err;
+      err<<"The environment needs four corners and four edges, not " << C.size() << " and " << T.size() << ".";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    for(int k = 0; k < 4; k++)
+      if(C[k].bondNum() != 2 || T[k].bondNum() != 3 || T[k].bond(1).dim() != a.bond(k).dim()){
+        std::ostringstream err;
+        err<<"The corner " << k << " needs two bonds and the edge " << k << " three, the middle one of the dimension of "
+          << "the bond " << k << " of the tensor.";
+        throw std::runtime_error(exception_msg(err.str()));
+      }
+    for(int k = 0; k < 4; k++)
+      spectra[k] = spectrum(k);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor CTMRG::CTMRG(uni10::UniTensor&, std::vector<uni10::UniTensor>&, std::vector<uni10::UniTensor>&, uni10::CTMRGParams&):");
+  }
+}
+
+void CTMRG::check()const{
+  if(a.bondNum() != 4){
+    std::ostringstream err;
+    err<<"The tensor needs four bonds (left, up, right, down), not " << a.bondNum() << ".";
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+  if(a.typeID() != 1){
+    std::ostringstream err;
+    err<<"Only real tensors are supported.";
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+  if(a.bond(0).dim() != a.bond(2).dim() || a.bond(1).dim() != a.bond(3).dim()){
+    std::ostringstream err;
+    err<<"The left and right, and the up and down bonds of the tensor must have the same dimensions.";
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+}
+
+std::vector<UniTensor> CTMRG::projectors(UniTensor& upper, UniTensor& lower, Real& discarded)const{
+  // upper and lower are the quadrants of the half lattice, labelled (21, 22) on the cut between them and
+  // (23, 24) and (25, 26) on the open bonds; the projectors are labelled (21, 22, 31) and (21, 22, 32)
+  UNI10_TRACE_SCOPE(trace, "ctmrg projectors", "ctmrg");
+  int labelM[] = {23, 24, 25, 26}, labelU[] = {31, 23, 24}, labelV[] = {25, 26, 32};
+  int labelPt[] = {21, 22, 31}, labelP[] = {21, 22, 32};
+  UniTensor M = contract(upper, lower, true);
+  M.permute(labelM, 2);
+  std::vector<Qnum> qnums = M.blockQnum();
+  std::vector<BlockSvd> blocks(qnums.size());
+  std::vector<std::pair<Real, size_t> > values;
+  {
+    UNI10_TRACE_SCOPE(trace, "ctmrg svd", "ctmrg");
+    for(size_t b = 0; b < qnums.size(); b++){
+      const Block& blk = M.const_getBlock(qnums[b]);
+      int rank = params.maxChi + params.oversampling;
+      if(params.randomized && 2 * rank < (int)std::min(blk.row(), blk.col()))
+        randomizedSvd(blk, rank, params.powerIter, blocks[b]);
+      else if(blk.row() && blk.col())
+        fullSvd(blk, blocks[b]);
+      else
+        blocks[b].r = 0;
+      for(int i = 0; i < blocks[b].r; i++)
+        values.push_back(std::make_pair(blocks[b].S[i], b));
+    }
+  }
+  std::sort(values.begin(), values.end(), std::greater<std::pair<Real, size_t> >());
+  std::vector<Real> s(values.size());
+  for(size_t i = 0; i < values.size(); i++)
+    s[i] = values[i].first;
+  if(s.empty() || s[0] <= 0){
+    std::ostringstream err;
+    err<<"The half of the lattice vanishes, no projector can be found.";
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+  size_t keep = truncationRank(&s[0], s.size(), params.maxChi, params.cutoff, discarded);
+  while(keep > 1 && s[keep - 1] < SPECTRUM_EPS * s[0])
+    keep--;
+  // the values of a block are in decreasing order, the first ones of each block are kept
+  std::vector<size_t> kept(qnums.size(), 0);
+  for(size_t i = 0; i < keep; i++)
+    kept[values[i].second]++;
+  std::vector<Qnum> kqnums;
+  for(size_t b = 0; b < qnums.size(); b++)
+    kqnums.insert(kqnums.end(), kept[b], qnums[b]);
+
+  // U^T and V, scaled by the inverse square roots of the singular values, on the bonds joined to the rows
+  // and to the columns of M
+  std::vector<Bond> bondU, bondV;
+  bondU.push_back(Bond(BD_IN, kqnums));
+  bondU.push_back(Bond(M.bond(0)).dummy_change(BD_OUT));
+  bondU.push_back(Bond(M.bond(1)).dummy_change(BD_OUT));
+  bondV.push_back(Bond(M.bond(2)).dummy_change(BD_IN));
+  bondV.push_back(Bond(M.bond(3)).dummy_change(BD_IN));
+  bondV.push_back(Bond(BD_OUT, kqnums));
+  UniTensor Ut(RTYPE, bondU, labelU), V(RTYPE, bondV, labelV);
+  Ut.set_zero();
+  V.set_zero();
+  for(size_t b = 0; b < qnums.size(); b++){
+    size_t k = kept[b];
+    if(k == 0)
+      continue;
+    const BlockSvd& blk = blocks[b];
+    Real* elemU = Ut.getBlockView(qnums[b]).getElem();
+    Real* elemV = V.getBlockView(qnums[b]).getElem();
+    for(size_t i = 0; i < k; i++){
+      Real scale = 1 / std::sqrt(blk.S[i]);
+      for(int j = 0; j < blk.m; j++)
+        elemU[i * blk.m + j] = blk.U[(size_t)j * blk.r + i] * scale;
+      for(int j = 0; j < blk.n; j++)
+        elemV[(size_t)j * k + i] = blk.vT[i * blk.n + j] * scale;
+    }
+  }
+  std::vector<UniTensor> P;
+  P.push_back(contract(upper, Ut, true));
+  P.push_back(contract(lower, V, true));
+  P[0].permute(labelPt, 2);
+  P[1].permute(labelP, 2);
+  return P;
+}
+
+CTMRG::Update CTMRG::compute(int side)const{
+  Update update;
+  try{
+    UNI10_TRACE_SCOPE(trace, "ctmrg move", "ctmrg");
+    int L = side, U = (side + 1) % 4, D = (side + 3) % 4;
+    // upper quadrant: corner(L), edge(U), edge(L) and a, cut at (edge(L) below, a down)
+    int labelCL[] = {1, 2}, labelTU[] = {2, 3, 4}, labelTL[] = {5, 6, 1};
+    int labelUpper[] = {5, 8, 4, 7}, labelCut[] = {21, 22, 23, 24};
+    UniTensor CL = labelled(C[L], labelCL), TU = labelled(T[U], labelTU), TL = labelled(T[L], labelTL);
+    UniTensor A = rotated(a, side, 6, 3, 7, 8);
+    UniTensor X = contract(CL, TU, true);
+    UniTensor upper = contract(X, TL, true);
+    upper = contract(upper, A, true);
+    upper.permute(labelUpper, 2);
+    upper.setLabel(labelCut);
+    // lower quadrant: corner(D), edge(D), edge(L) and a, cut at (edge(L) above, a up)
+    int labelCD[] = {11, 12}, labelTD[] = {15, 16, 11}, labelTL2[] = {12, 13, 14};
+    int labelLower[] = {14, 17, 15, 18}, labelCut2[] = {21, 22, 25, 26};
+    UniTensor CD = labelled(C[D], labelCD), TD = labelled(T[D], labelTD), TL2 = labelled(T[L], labelTL2);
+    UniTensor A2 = rotated(a, side, 13, 17, 18, 16);
+    UniTensor Z = contract(CD, TD, true);
+    UniTensor lower = contract(Z, TL2, true);
+    lower = contract(lower, A2, true);
+    lower.permute(labelLower, 2);
+    lower.setLabel(labelCut2);
+
+    std::vector<UniTensor> P = projectors(upper, lower, update.discarded);
+
+    // corner(L): the corner with the edge above, projected from below
+    int labelP1[] = {1, 3, 32}, labelNext[] = {32, 4};
+    UniTensor P1 = labelled(P[1], labelP1);
+    update.next = contract(X, P1, true);
+    update.next.permute(labelNext, 1);
+    // edge(L): the edge with a, projected from above and below
+    int labelTL3[] = {41, 42, 43}, labelPt1[] = {43, 44, 31}, labelP2[] = {41, 46, 32}, labelEdge[] = {32, 45, 31};
+    UniTensor TL3 = labelled(T[L], labelTL3), Pt1 = labelled(P[0], labelPt1), P2 = labelled(P[1], labelP2);
+    UniTensor A3 = rotated(a, side, 42, 44, 45, 46);
+    update.edge = contract(Pt1, TL3, true);
+    update.edge = contract(update.edge, A3, true);
+    update.edge = contract(update.edge, P2, true);
+    update.edge.permute(labelEdge, 2);
+    // corner(D): the corner with the edge below, projected from above
+    int labelPt2[] = {12, 16, 31}, labelPrev[] = {15, 31};
+    UniTensor Pt2 = labelled(P[0], labelPt2);
+    update.prev = contract(Z, Pt2, true);
+    update.prev.permute(labelPrev, 1);
+
+    update.next.normalize();
+    update.edge.normalize();
+    update.prev.normalize();
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function CTMRG::compute(int):");
+  }
+  return update;
+}
+
+void CTMRG::commit(int side, const Update& update){
+  C[(side + 3) % 4] = update.prev;
+  T[side] = update.edge;
+  C[side] = update.next;
+  m_moves++;
+}
+
+Real CTMRG::move(int side){
+  Real discarded = 0;
+  try{
+    if(side < 0 || side > 3){
+      std::ostringstream err;
+      err<<"The side of a move is 0 (left), 1 (up), 2 (right) or 3 (down), not " << side << ".";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    Update update = compute(side);
+    commit(side, update);
+    discarded = update.discarded;
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function CTMRG::move(int):");
+  }
+  return discarded;
+}
+
+Real CTMRG::sweep(){
+  try{
+    UNI10_TRACE_SCOPE(trace, "ctmrg sweep", "ctmrg");
+    int threadNum = params.threads > 0 ? params.threads : (std::thread::hardware_concurrency() > 1 ? 2 : 1);
+    m_discarded = 0;
+    // the moves toward opposite sides neither read nor write the tensors that the other one writes
+    for(int side = 0; side < 2; side++){
+      Update updates[2];
+      if(threadNum > 1){
+        std::exception_ptr error;
+        std::thread worker([&](){
+          try{
+            updates[1] = compute(side + 2);
+          }
+          catch(...){
+            error = std::current_exception();
+          }
+        });
+        try{
+          updates[0] = compute(side);
+        }
+        catch(...){
+          worker.join();
+          throw;
+        }
+        worker.join();
+        if(error)
+          std::rethrow_exception(error);
+      }
+      else{
+        updates[0] = compute(side);
+        updates[1] = compute(side + 2);
+      }
+      commit(side, updates[0]);
+      commit(side + 2, updates[1]);
+      m_discarded = std::max(m_discarded, std::max(updates[0].discarded, updates[1].discarded));
+    }
+    m_change = 0;
+    for(int k = 0; k < 4; k++){
+      std::vector<Real> s = spectrum(k);
+      size_t num = std::max(s.size(), spectra[k].size());
+      Real diff = 0;
+      for(size_t i = 0; i < num; i++)
+        diff += std::fabs((i < s.size() ? s[i] : 0) - (i < spectra[k].size() ? spectra[k][i] : 0));
+      m_change = std::max(m_change, diff);
+      spectra[k].swap(s);
+    }
+    m_converged = m_change < params.tol;
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function CTMRG::sweep():");
+  }
+  return m_change;
+}
+
+int CTMRG::run(){
+  int iter = 0;
+  try{
+    while(iter < params.maxIter){
+      sweep();
+      iter++;
+      if(m_converged)
+        break;
+    }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function CTMRG::run():");
+  }
+  return iter;
+}
+
+bool CTMRG::converged()const{
+  return m_converged;
+}
+
+Real CTMRG::change()const{
+  return m_change;
+}
+
+Real CTMRG::discarded()const{
+  return m_discarded;
+}
+
+const UniTensor& CTMRG::site()const{
+  return a;
+}
+
+const UniTensor& CTMRG::corner(int k)const{
+  return C[k % 4];
+}
+
+const UniTensor& CTMRG::edge(int k)const{
+  return T[k % 4];
+}
+
+int CTMRG::chi(int k)const{
+  return C[k % 4].bond(0).dim();
+}
+
+std::vector<Real> CTMRG::spectrum(int k)const{
+  UniTensor Ck(C[k]);
+  Ck.permute(1);
+  std::vector<Real> s;
+  const std::map<Qnum, Block>& blocks = Ck.const_getBlocks();
+  for(std::map<Qnum, Block>::const_iterator it = blocks.begin(); it != blocks.end(); ++it){
+    if(!it->second.row() || !it->second.col())
+      continue;
+    BlockSvd blk;
+    fullSvd(it->second, blk);
+    s.insert(s.end(), blk.S.begin(), blk.S.end());
+  }
+  std::sort(s.begin(), s.end(), std::greater<Real>());
+  Real norm = 0;
+  for(size_t i = 0; i < s.size(); i++)
+    norm += s[i] * s[i];
+  norm = std::sqrt(norm);
+  for(size_t i = 0; i < s.size() && norm > 0; i++)
+    s[i] /= norm;
+  return s;
+}
+
+Matrix CTMRG::cornerSpectrum(int k)const{
+  std::vector<Real> s = spectrum(k % 4);
+  return Matrix(s.size(), s.size(), &s[0], true);
+}
+
+Real CTMRG::network(const UniTensor& center)const{
+  int labelC0[] = {1, 2}, labelT1[] = {2, 10, 3}, labelC1[] = {3, 4}, labelT2[] = {4, 11, 5};
+  int labelC2[] = {5, 6}, labelT3[] = {6, 12, 7}, labelC3[] = {7, 8}, labelT0[] = {8, 13, 1};
+  int labelX[] = {13, 10, 11, 12};
+  UniTensor C0 = labelled(C[0], labelC0), T1 = labelled(T[1], labelT1), C1 = labelled(C[1], labelC1);
+  UniTensor T2 = labelled(T[2], labelT2), C2 = labelled(C[2], labelC2), T3 = labelled(T[3], labelT3);
+  UniTensor C3 = labelled(C[3], labelC3), T0 = labelled(T[0], labelT0), X = labelled(center, labelX);
+  UniTensor top = contract(C0, T1, true);
+  top = contract(top, C1, true);
+  top = contract(top, T0, true);
+  top = contract(top, X, true);
+  UniTensor bottom = contract(T2, C2, true);
+  bottom = contract(bottom, T3, true);
+  bottom = contract(bottom, C3, true);
+  UniTensor S = contract(top, bottom, true);
+  return S.getElem()[0];
+}
+
+Real CTMRG::expectation(const UniTensor& b)const{
+  Real val = 0;
+  try{
+    if(b.bondNum() != 4){
+      std::ostringstream err;
+      err<<"The tensor in place of the tiling tensor needs its four bonds.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    for(int k = 0; k < 4; k++)
+      if(b.bond(k).dim() != a.bond(k).dim()){
+        std::ostringstream err;
+        err<<"The bond " << k << " of the tensor in place of the tiling tensor has the dimension " << b.bond(k).dim()
+          << " instead of " << a.bond(k).dim() << ".";
+        throw std::runtime_error(exception_msg(err.str()));
+      }
+    val = network(b) / network(a);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function CTMRG::expectation(uni10::UniTensor&):");
+  }
+  return val;
+}
+
+size_t CTMRG::moves()const{
+  return m_moves;
+}
+
+};	/* namespace uni10 */
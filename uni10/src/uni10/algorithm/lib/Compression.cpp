@@ -0,0 +1,247 @@
+/****************************************************************************
+*  @file Compression.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file of the MPO-MPS product and the compression of MPS
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/algorithm/Compression.h>
+#include <uni10/algorithm/Environment.h>
+#include <uni10/algorithm/Solvers.h>
+#include <uni10/tools/uni10_tools.h>
+#include <uni10/tools/uni10_trace.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+namespace uni10{
+
+namespace{
+  const int ALL = std::numeric_limits<int>::max();
+
+  UniTensor labelled(const UniTensor& T, const int* label){
+    UniTensor L(T);
+    L.setLabel(const_cast<int*>(label));
+    return L;
+  }
+
+  // Bond of type tp joined to bd, which has the same quantum numbers with the opposite type
+  Bond dual(const Bond& bd, bondType tp){
+    Bond d(bd);
+    d.dummy_change(bd.type() == BD_IN ? BD_OUT : BD_IN);
+    d.change(tp);
+    return d;
+  }
+
+  // T with the quantum numbers of all its bonds negated. An Environment joins the bra to the operator
+  // without conjugating it, the sweeps keep the bra in this form so that the blocks of the bra match those
+  // of the ket; the local tensors come out with the quantum numbers of the result.
+  UniTensor conjugate(const UniTensor& T){
+    std::vector<Bond> bonds;
+    for(size_t i = 0; i < T.bondNum(); i++){
+      Bond bd(T.bond(i));
+      bondType tp = bd.type();
+      bd.change(tp == BD_IN ? BD_OUT : BD_IN);
+      bd.dummy_change(tp);
+      bonds.push_back(bd);
+    }
+    UniTensor C(bonds);
+    C.setRawElem(T.getRawElem());
+    return C;
+  }
+
+  // The sites of psi brought to right-canonical form by SVDs block by block, the norm in the first site
+  std::vector<UniTensor> rightCanonical(const MPS& psi){
+    size_t L = psi.size();
+    std::vector<UniTensor> A(L);
+    for(size_t i = 0; i < L; i++)
+      A[i] = psi[i];
+    if(psi.center() == 0)
+      return A;
+    int labelA[] = {1, 2, 3}, labelU[] = {3, 5}, labelS[] = {5, 4}, labelOut[] = {1, 2, 4};
+    for(size_t i = L - 1; i > 0; i--){
+      A[i].permute(1);
+      Real discarded;
+      std::vector<UniTensor> usv = truncatedSvd(A[i], ALL, 0, discarded);
+      A[i] = usv[2];
+      A[i].permute(2);
+      UniTensor U = labelled(usv[0], labelU), S = labelled(usv[1], labelS);
+      UniTensor US = contract(U, S, true);
+      A[i - 1].setLabel(labelA);
+      A[i - 1] = contract(A[i - 1], US, true);
+      A[i - 1].permute(labelOut, 2);
+    }
+    return A;
+  }
+
+  // Zip-up of W and the right-canonical sites A, the result left-normalized but for the last site
+  std::vector<UniTensor> zipUp(const MPO& W, const std::vector<UniTensor>& A, const CompressionParams& params,
+      Real& discarded){
+    UNI10_TRACE_SCOPE(trace, "compression zip-up", "mps");
+    size_t L = A.size();
+    std::vector<UniTensor> B(L);
+    // C (x; w, a) is what is left of the sites on the left, x the bond of the result; on the left edge x
+    // carries the quantum numbers of the edges of W and of psi
+    std::vector<Bond> bonds;
+    bonds.push_back(dual(W[0].bond(0), BD_OUT));
+    bonds.push_back(dual(A[0].bond(0), BD_OUT));
+    Bond x(bonds[0]);
+    x.combine(bonds[1]);
+    x.dummy_change(BD_IN);
+    bonds.insert(bonds.begin(), x);
+    UniTensor C(bonds);
+    C.setRawElem(std::vector<Real>(C.elemNum(), 1.0));
+    int labelC[] = {1, 2, 3}, labelW[] = {2, 5, 11, 4}, labelA[] = {3, 4, 10}, labelSplit[] = {1, 5, 11, 10};
+    int labelS[] = {20, 21}, labelVT[] = {21, 11, 10}, labelC2[] = {20, 11, 10}, labelU[] = {1, 5, 20};
+    int labelLast[] = {1, 5, 11};
+    discarded = 0;
+    for(size_t i = 0; i < L; i++){
+      C.setLabel(labelC);
+      UniTensor Wi = labelled(W[i], labelW), Ai = labelled(A[i], labelA);
+      UniTensor T = contract(C, Wi, true);
+      T = contract(T, Ai, true);
+      T.permute(labelSplit, 2);
+      Real d;
+      std::vector<UniTensor> usv = truncatedSvd(T, params.maxChi, params.cutoff, d);
+      discarded = std::max(discarded, d);
+      B[i] = usv[0];
+      UniTensor S = labelled(usv[1], labelS), VT = labelled(usv[2], labelVT);
+      C = contract(S, VT, true);
+      C.permute(1);
+    }
+    // the bonds right of the last site have dimension one, they become the right edge of the result
+    UniTensor U = labelled(B[L - 1], labelU);
+    C.setLabel(labelC2);
+    B[L - 1] = contract(U, C, true);
+    std::vector<int> edge(labelC2 + 1, labelC2 + 3);
+    B[L - 1].combineBond(edge);
+    B[L - 1].permute(labelLast, 2);
+    return B;
+  }
+};
+
+CompressionParams::CompressionParams(): maxChi(64), cutoff(1E-12), sweeps(4), tol(1E-10){}
+
+CompressionInfo::CompressionInfo(): discarded(0), sweeps(0), change(0){}
+
+MPS applyMPO(const MPO& W, const MPS& psi, const CompressionParams& params, CompressionInfo* info){
+  MPS phi;
+  try{
+    size_t L = psi.size();
+    if(!L || W.size() != L){
+      std::ostringstream err;
+      err<<"The MPO of " << W.size() << " sites cannot be applied to the MPS of " << L << " sites.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    if(params.maxChi < 1){
+      std::ostringstream err;
+      err<<"The bond dimension must be positive.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    CompressionInfo done;
+    std::vector<UniTensor> A = rightCanonical(psi);
+    MPS ket(A, 0);
+    std::vector<UniTensor> B = zipUp(W, A, params, done.discarded);
+    Real norm = B[L - 1].norm();
+
+    // single-site variational sweeps, from the right and back, maximizing <phi|W|psi> site by site
+    std::vector<UniTensor> bra(L);
+    for(size_t i = 0; i < L; i++)
+      bra[i] = conjugate(B[i]);
+    phi = MPS(bra);
+    Environment env(phi, W, ket);
+    int labelL[] = {1, 2, 3}, labelA[] = {1, 4, 10}, labelW[] = {2, 5, 11, 4}, labelR[] = {10, 11, 13};
+    int labelOut[] = {3, 5, 13};
+    auto local = [&](size_t i){
+      UniTensor E = labelled(env.left(i), labelL);
+      UniTensor Ai = labelled(ket[i], labelA), Wi = labelled(W[i], labelW);
+      UniTensor R = labelled(env.right(i + 1), labelR);
+      E = contract(E, Ai, true);
+      E = contract(E, Wi, true);
+      E = contract(E, R, true);
+      E.permute(labelOut, 2);
+      return E;
+    };
+    auto update = [&](size_t i, const UniTensor& X){
+      B[i] = X;
+      phi.setSite(i, conjugate(X));
+      env.invalidate(i);
+    };
+    for(int sweep = 0; sweep < params.sweeps; sweep++){
+      UNI10_TRACE_SCOPE(trace, "compression sweep", "mps");
+      for(size_t i = L - 1; i > 0; i--){
+        UniTensor X = local(i);
+        X.permute(1);
+        Real discarded;
+        std::vector<UniTensor> usv = truncatedSvd(X, ALL, 0, discarded);
+        usv[2].permute(2);
+        update(i, usv[2]);
+      }
+      for(size_t i = 0; i + 1 < L; i++){
+        Real discarded;
+        std::vector<UniTensor> usv = truncatedSvd(local(i), ALL, 0, discarded);
+        update(i, usv[0]);
+      }
+      UniTensor X = local(L - 1);
+      update(L - 1, X);
+      Real prev = norm;
+      norm = X.norm();
+      done.sweeps = sweep + 1;
+      done.change = norm > 0 ? std::fabs(norm - prev) / norm : 0;
+      if(done.change < params.tol)
+        break;
+    }
+    phi = MPS(B, L - 1);
+    if(info)
+      *info = done;
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function applyMPO(uni10::MPO&, uni10::MPS&, uni10::CompressionParams&, uni10::CompressionInfo*):");
+  }
+  return phi;
+}
+
+MPS compress(const MPS& psi, const CompressionParams& params, CompressionInfo* info){
+  MPS phi;
+  try{
+    // the identity, with bonds of dimension one between the sites
+    std::vector<UniTensor> W(psi.size());
+    for(size_t i = 0; i < psi.size(); i++){
+      std::vector<Bond> bonds;
+      bonds.push_back(Bond(BD_IN, 1));
+      bonds.push_back(psi[i].bond(1));
+      bonds.push_back(Bond(BD_OUT, 1));
+      bonds.push_back(dual(psi[i].bond(1), BD_OUT));
+      W[i] = UniTensor(bonds);
+      W[i].identity();
+    }
+    phi = applyMPO(MPO(W), psi, params, info);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function compress(uni10::MPS&, uni10::CompressionParams&, uni10::CompressionInfo*):");
+  }
+  return phi;
+}
+
+};	/* namespace uni10 */
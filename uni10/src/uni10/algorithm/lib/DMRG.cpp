@@ -0,0 +1,251 @@
+/****************************************************************************
+*  @file DMRG.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file for the finite-size DMRG driver
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/algorithm/DMRG.h>
+#include <uni10/algorithm/EffectiveHamiltonian.h>
+#include <uni10/algorithm/Solvers.h>
+#include <uni10/tools/uni10_tools.h>
+#include <uni10/tools/uni10_trace.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+namespace uni10{
+
+namespace{
+  typedef std::chrono::steady_clock Clock;
+
+  double since(const Clock::time_point& start){
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  }
+};
+
+DMRGParams::DMRGParams(): maxChi(64), cutoff(1E-10), sweeps(10), energyTol(1E-9), twoSite(true), expansion(1E-4),
+  expansionDecay(0.5), lanczosIter(100), lanczosTol(1E-10), verbose(false){}
+
+std::string SweepInfo::str()const{
+  char buf[256];
+  sprintf(buf, "sweep %3d  E = %.12f  discarded %.2e  chi %4d  matvecs %6zu  %.3fs (eig %.3f, svd %.3f, env %.3f)",
+      sweep, energy, discarded, maxChi, matvecs, seconds, eigSeconds, svdSeconds, envSeconds);
+  return buf;
+}
+
+DMRG::DMRG(MPS& _psi, const MPO& _H, const DMRGParams& _params): psi(_psi), H(_H), params(_params),
+  env(_psi, _H), m_energy(0), expansion(_params.expansion){
+  try{
+    if(psi.size() != H.size() || psi.size() < 2){
+      std::ostringstream err;
+      err<<"DMRG needs an MPS and an MPO of the same number of sites, at least two.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    if(psi.center() != 0)
+      psi.moveCenter(0);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor DMRG::DMRG(uni10::MPS&, uni10::MPO&, uni10::DMRGParams&):");
+  }
+}
+
+// Optimizes the sites i and i + 1 and leaves the center on i + 1 (toRight) or i
+void DMRG::updateTwoSite(size_t i, bool toRight, SweepInfo& info){
+  Clock::time_point start = Clock::now();
+  EffectiveHamiltonian Heff(env.left(i), H[i], H[i + 1], env.right(i + 2));
+  info.envSeconds += since(start);
+  int labelA[] = {1, 2, 100}, labelB[] = {100, 3, 4}, labelTheta[] = {1, 2, 3, 4};
+  UniTensor A = psi[i], B = psi[i + 1];
+  A.setLabel(labelA);
+  B.setLabel(labelB);
+  UniTensor theta = contract(A, B, true);
+  theta.permute(labelTheta, 2);
+
+  start = Clock::now();
+  std::vector<Real> v(theta.getElem(), theta.getElem() + theta.elemNum());
+  {
+    UNI10_TRACE_SCOPE(trace, "dmrg eigensolver", "dmrg");
+    info.matvecs += lanczosGroundState(Heff.map(), v.size(), &v[0], m_energy, params.lanczosIter, params.lanczosTol);
+  }
+  info.eigSeconds += since(start);
+
+  start = Clock::now();
+  {
+    UNI10_TRACE_SCOPE(trace, "dmrg svd", "dmrg");
+    int l = psi.bondDim(i), d1 = psi.physDim(i), d2 = psi.physDim(i + 1), r = psi.bondDim(i + 2);
+    Real discarded;
+    std::vector<Matrix> usv = truncatedSvd(Matrix(l * d1, d2 * r, &v[0]), params.maxChi, params.cutoff, discarded);
+    usv[1] *= 1.0 / usv[1].norm();
+    int k = usv[1].row();
+    if(toRight)
+      psi.setSites(i, MPS::siteTensor(l, d1, k, usv[0]), MPS::siteTensor(k, d2, r, usv[1] * usv[2], 1), i + 1);
+    else
+      psi.setSites(i, MPS::siteTensor(l, d1, k, usv[0] * usv[1]), MPS::siteTensor(k, d2, r, usv[2], 1), i);
+    psi.setLambda(i + 1, usv[1]);
+    info.discarded = std::max(info.discarded, discarded);
+  }
+  env.invalidate(i);
+  env.invalidate(i + 1);
+  info.svdSeconds += since(start);
+}
+
+// Optimizes site i, expands its bond towards the next site and moves the center there
+void DMRG::updateOneSite(size_t i, bool toRight, SweepInfo& info){
+  Clock::time_point start = Clock::now();
+  EffectiveHamiltonian Heff(env.left(i), H[i], env.right(i + 1));
+  info.envSeconds += since(start);
+
+  start = Clock::now();
+  UniTensor theta = psi[i];
+  std::vector<Real> v(theta.getElem(), theta.getElem() + theta.elemNum());
+  {
+    UNI10_TRACE_SCOPE(trace, "dmrg eigensolver", "dmrg");
+    info.matvecs += lanczosGroundState(Heff.map(), v.size(), &v[0], m_energy, params.lanczosIter, params.lanczosTol);
+  }
+  theta.setRawElem(v);
+  info.eigSeconds += since(start);
+
+  start = Clock::now();
+  {
+    UNI10_TRACE_SCOPE(trace, "dmrg svd", "dmrg");
+    int l = psi.bondDim(i), d = psi.physDim(i), r = psi.bondDim(i + 1);
+    int w = toRight ? H.bondDim(i + 1) : H.bondDim(i);
+    int labelL[] = {1, 10, -1}, labelTheta[] = {1, 2, 4}, labelR[] = {4, 12, -4};
+    int labelW[] = {10, -2, 12, 2};
+    UniTensor W = H[i];
+    theta.setLabel(labelTheta);
+    W.setLabel(labelW);
+    Matrix M;
+    if(toRight){
+      M = Matrix(l * d, r, &v[0]);
+      if(expansion > 0){
+        // [theta, a L theta W] as (l s) x (r + w r)
+        UniTensor L = env.left(i);
+        L.setLabel(labelL);
+        UniTensor P = contract(L, theta, true);
+        P = contract(P, W, true);
+        int labelP[] = {-1, -2, 12, 4};
+        P.permute(labelP, 2);
+        M.resize(l * d, r + w * r);
+        for(int row = 0; row < l * d; row++)
+          for(int col = 0; col < w * r; col++)
+            M.at(row, r + col) = expansion * P.getElem()[row * w * r + col];
+      }
+    }
+    else{
+      M = Matrix(l, d * r, &v[0]);
+      if(expansion > 0){
+        // [theta; a theta W R] as (l + l w) x (s r)
+        UniTensor R = env.right(i + 1);
+        R.setLabel(labelR);
+        UniTensor P = contract(theta, W, true);
+        P = contract(P, R, true);
+        int labelP[] = {1, 10, -2, -4};
+        P.permute(labelP, 2);
+        M.resize(l + l * w, d * r);
+        memcpy(M.getElem() + l * d * r, P.getElem(), P.elemNum() * sizeof(Real));
+      }
+    }
+    Real discarded;
+    std::vector<Matrix> usv = truncatedSvd(M, params.maxChi, params.cutoff, discarded);
+    int k = usv[1].row();
+    if(toRight){
+      Matrix SV = usv[1] * usv[2];
+      SV.resize(k, r);
+      UniTensor next = psi[i + 1];
+      next.permute(1);
+      psi.setSites(i, MPS::siteTensor(l, d, k, usv[0]),
+          MPS::siteTensor(k, psi.physDim(i + 1), psi.bondDim(i + 2), SV * next.const_getBlock(), 1), i + 1);
+    }
+    else{
+      Matrix US = usv[0] * usv[1];
+      US.resize(l, k);
+      psi.setSites(i - 1, MPS::siteTensor(psi.bondDim(i - 1), psi.physDim(i - 1), k, psi[i - 1].const_getBlock() * US),
+          MPS::siteTensor(k, d, r, usv[2], 1), i - 1);
+    }
+    psi.normalize();
+    info.discarded = std::max(info.discarded, discarded);
+  }
+  env.invalidate(i);
+  env.invalidate(toRight ? i + 1 : i - 1);
+  info.svdSeconds += since(start);
+}
+
+SweepInfo DMRG::sweep(){
+  SweepInfo info;
+  memset(&info, 0, sizeof(info));
+  info.sweep = infos.size();
+  try{
+    UNI10_TRACE_SCOPE(trace, "dmrg sweep", "dmrg");
+    Clock::time_point start = Clock::now();
+    size_t L = psi.size();
+    if(psi.center() != 0)
+      psi.moveCenter(0);
+    if(params.twoSite){
+      for(size_t i = 0; i + 1 < L; i++)
+        updateTwoSite(i, true, info);
+      for(size_t i = L - 1; i-- > 0;)
+        updateTwoSite(i, false, info);
+    }
+    else{
+      for(size_t i = 0; i + 1 < L; i++)
+        updateOneSite(i, true, info);
+      for(size_t i = L - 1; i > 0; i--)
+        updateOneSite(i, false, info);
+      expansion *= params.expansionDecay;
+    }
+    info.energy = m_energy;
+    info.maxChi = psi.maxBondDim();
+    info.seconds = since(start);
+    infos.push_back(info);
+    if(params.verbose)
+      std::cout << info.str() << std::endl;
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function DMRG::sweep():");
+  }
+  return info;
+}
+
+Real DMRG::run(){
+  for(int s = 0; s < params.sweeps; s++){
+    Real last = m_energy;
+    sweep();
+    if(s > 0 && std::fabs(m_energy - last) < params.energyTol)
+      break;
+  }
+  return m_energy;
+}
+
+Real DMRG::energy()const{
+  return m_energy;
+}
+
+const std::vector<SweepInfo>& DMRG::history()const{
+  return infos;
+}
+
+};	/* namespace uni10 */
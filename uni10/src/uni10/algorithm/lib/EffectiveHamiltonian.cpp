@@ -0,0 +1,198 @@
+/****************************************************************************
+*  @file EffectiveHamiltonian.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file for the matrix-free effective Hamiltonian of MPS algorithms
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/algorithm/EffectiveHamiltonian.h>
+#include <uni10/tools/uni10_tools.h>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <set>
+namespace uni10{
+
+// The center tensor carries the ket labels 1 (l), 2 (s1), 3 (s2), 4 (r); the bra labels are their
+// negatives and the MPO bonds are labeled from 10.
+
+EffectiveHamiltonian::EffectiveHamiltonian(const UniTensor& L, const UniTensor& W1, const UniTensor& W2, const UniTensor& R){
+  int labelL[] = {1, 10, -1}, labelW1[] = {10, -2, 11, 2}, labelW2[] = {11, -3, 12, 3}, labelR[] = {4, 12, -4};
+  ops.push_back(L);
+  ops.push_back(W1);
+  ops.push_back(W2);
+  ops.push_back(R);
+  ops[0].setLabel(labelL);
+  ops[1].setLabel(labelW1);
+  ops[2].setLabel(labelW2);
+  ops[3].setLabel(labelR);
+  names.push_back("L");
+  names.push_back("W1");
+  names.push_back("W2");
+  names.push_back("R");
+  int in[] = {1, 2, 3, 4};
+  init(std::vector<int>(in, in + 4));
+}
+
+EffectiveHamiltonian::EffectiveHamiltonian(const UniTensor& L, const UniTensor& W, const UniTensor& R){
+  int labelL[] = {1, 10, -1}, labelW[] = {10, -2, 12, 2}, labelR[] = {4, 12, -4};
+  ops.push_back(L);
+  ops.push_back(W);
+  ops.push_back(R);
+  ops[0].setLabel(labelL);
+  ops[1].setLabel(labelW);
+  ops[2].setLabel(labelR);
+  names.push_back("L");
+  names.push_back("W");
+  names.push_back("R");
+  int in[] = {1, 2, 4};
+  init(std::vector<int>(in, in + 3));
+}
+
+EffectiveHamiltonian::EffectiveHamiltonian(const UniTensor& L, const UniTensor& R){
+  int labelL[] = {1, 10, -1}, labelR[] = {4, 10, -4};
+  ops.push_back(L);
+  ops.push_back(R);
+  ops[0].setLabel(labelL);
+  ops[1].setLabel(labelR);
+  names.push_back("L");
+  names.push_back("R");
+  int in[] = {1, 4};
+  init(std::vector<int>(in, in + 2));
+}
+
+// Builds the center tensor and picks the cheapest order of the contractions with the operands
+void EffectiveHamiltonian::init(const std::vector<int>& inLabels){
+  try{
+    m_applications = 0;
+    std::map<int, size_t> dims;
+    for(size_t k = 0; k < ops.size(); k++){
+      std::vector<int> labels = ops[k].label();
+      for(size_t b = 0; b < labels.size(); b++)
+        dims[labels[b]] = ops[k].bond(b).dim();
+    }
+    std::vector<Bond> bonds;
+    for(size_t b = 0; b < inLabels.size(); b++){
+      bonds.push_back(Bond(b < (inLabels.size() + 1) / 2 ? BD_IN : BD_OUT, dims[inLabels[b]]));
+      outLabels.push_back(-inLabels[b]);
+    }
+    x = UniTensor(bonds);
+    x.setLabel(inLabels);
+
+    std::vector<int> perm(ops.size());
+    for(size_t k = 0; k < perm.size(); k++)
+      perm[k] = k;
+    double bestCost = -1;
+    do{
+      std::set<int> cur(inLabels.begin(), inLabels.end());
+      double cost = 0;
+      bool connected = true;
+      for(size_t k = 0; k < perm.size() && connected; k++){
+        std::vector<int> labels = ops[perm[k]].label();
+        std::set<int> next = cur;
+        double flops = 1;
+        connected = false;
+        for(size_t b = 0; b < labels.size(); b++){
+          if(cur.count(labels[b])){
+            connected = true;
+            next.erase(labels[b]);
+          }
+          else
+            next.insert(labels[b]);
+        }
+        std::set<int> all = cur;
+        all.insert(labels.begin(), labels.end());
+        for(std::set<int>::iterator it = all.begin(); it != all.end(); it++)
+          flops *= dims[*it];
+        cost += flops;
+        cur = next;
+      }
+      if(connected && (bestCost < 0 || cost < bestCost)){
+        bestCost = cost;
+        sequence = perm;
+      }
+    }while(std::next_permutation(perm.begin(), perm.end()));
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function EffectiveHamiltonian::init(std::vector<int>&):");
+  }
+}
+
+size_t EffectiveHamiltonian::dim()const{
+  return x.elemNum();
+}
+
+void EffectiveHamiltonian::apply(const Real* in, Real* out){
+  try{
+    x.setRawElem(in);
+    UniTensor y = x;
+    for(size_t k = 0; k < sequence.size(); k++)
+      y = contract(y, ops[sequence[k]], true);
+    y.permute(outLabels, x.inBondNum());
+    memcpy(out, y.getElem(), y.elemNum() * sizeof(Real));
+    m_applications++;
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function EffectiveHamiltonian::apply(uni10::Real*, uni10::Real*):");
+  }
+}
+
+void EffectiveHamiltonian::apply(const Complex* in, Complex* out){
+  try{
+    UniTensor y = x;
+    if(y.typeID() == 1)
+      RtoC(y);
+    y.setRawElem(in);
+    for(size_t k = 0; k < sequence.size(); k++)
+      y = contract(y, ops[sequence[k]], true);
+    y.permute(outLabels, x.inBondNum());
+    memcpy(out, y.getElem(CTYPE), y.elemNum() * sizeof(Complex));
+    m_applications++;
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function EffectiveHamiltonian::apply(uni10::Complex*, uni10::Complex*):");
+  }
+}
+
+LinearMap EffectiveHamiltonian::map(){
+  return [this](const Real* in, Real* out){ apply(in, out); };
+}
+
+ComplexLinearMap EffectiveHamiltonian::complexMap(){
+  return [this](const Complex* in, Complex* out){ apply(in, out); };
+}
+
+std::string EffectiveHamiltonian::order()const{
+  std::string str = "x";
+  for(size_t k = 0; k < sequence.size(); k++)
+    str = "(" + str + " " + names[sequence[k]] + ")";
+  return str;
+}
+
+size_t EffectiveHamiltonian::applications()const{
+  return m_applications;
+}
+
+};	/* namespace uni10 */
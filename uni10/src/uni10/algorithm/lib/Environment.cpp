@@ -0,0 +1,320 @@
+/****************************************************************************
+*  @file Environment.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file for the cache of the MPS environments
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/algorithm/Environment.h>
+#include <uni10/tools/uni10_tools.h>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+namespace uni10{
+
+namespace{
+  // Bytes of the elements of T, complex environments take twice as much
+  size_t elemBytes(const UniTensor& T){
+    return T.elemNum() * (T.typeID() == 2 ? sizeof(Complex) : sizeof(Real));
+  }
+
+  // Site of the bra, complex conjugated
+  UniTensor conjugate(const UniTensor& T){
+    UniTensor C(T);
+    if(C.typeID() == 2){
+      Complex* elem = C.getElem(CTYPE);
+      for(size_t k = 0; k < C.elemNum(); k++)
+        elem[k] = std::conj(elem[k]);
+    }
+    return C;
+  }
+};
+
+Environment::Environment(const MPS& psi, const MPO& _op, size_t _memLimit, const std::string& _spillDir):
+  bra(&psi), op(&_op), ket(&psi), memLimit(_memLimit), spillDir(_spillDir){
+  init();
+}
+
+Environment::Environment(const MPS& _bra, const MPO& _op, const MPS& _ket, size_t _memLimit, const std::string& _spillDir):
+  bra(&_bra), op(&_op), ket(&_ket), memLimit(_memLimit), spillDir(_spillDir){
+  init();
+}
+
+Environment::~Environment(){
+  for(size_t i = 0; i < lefts.size(); i++){
+    if(lefts[i].onDisk)
+      remove(fileName(true, i).c_str());
+    if(rights[i].onDisk)
+      remove(fileName(false, i).c_str());
+  }
+}
+
+void Environment::init(){
+  try{
+    if(bra->size() != op->size() || ket->size() != op->size()){
+      std::ostringstream err;
+      err<<"The MPS and the MPO of an Environment must have the same number of sites.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    if(spillDir.empty()){
+      const char* tmp = getenv("TMPDIR");
+      spillDir = tmp ? tmp : "/tmp";
+    }
+    m_updates = 0;
+    memBytes = 0;
+    lastLeft = -1;
+    lastRight = -1;
+    lefts.assign(op->size() + 1, Slot());
+    rights.assign(op->size() + 1, Slot());
+    store(true, 0, edge(0));
+    store(false, op->size(), edge(op->size()));
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor Environment::Environment(uni10::MPS&, uni10::MPO&, ...):");
+  }
+}
+
+namespace{
+  // Bond of type tp joined to bd, which has the same quantum numbers with the opposite type
+  Bond dual(const Bond& bd, bondType tp){
+    Bond d(bd);
+    d.dummy_change(bd.type() == BD_IN ? BD_OUT : BD_IN);
+    d.change(tp);
+    return d;
+  }
+};
+
+// Trivial environment of the edge bond b, joined to the edge bonds of the tensors
+UniTensor Environment::edge(size_t b)const{
+  size_t i = b < op->size() ? b : b - 1;
+  int k = b < op->size() ? 0 : 2;
+  std::vector<Bond> bonds;
+  bonds.push_back(dual((*ket)[i].bond(k), BD_IN));
+  bonds.push_back(dual((*op)[i].bond(k), BD_OUT));
+  bonds.push_back(dual((*bra)[i].bond(k), BD_OUT));
+  UniTensor E(bonds);
+  E.setRawElem(std::vector<Real>(E.elemNum(), 1.0));
+  return E;
+}
+
+std::string Environment::fileName(bool isLeft, size_t i)const{
+  std::ostringstream os;
+  os << spillDir << "/uni10_env_" << getpid() << "_" << this << (isLeft ? "_L" : "_R") << i;
+  return os.str();
+}
+
+Environment::Slot& Environment::fetch(bool isLeft, size_t i){
+  Slot& slot = isLeft ? lefts[i] : rights[i];
+  if(slot.onDisk){
+    std::string fname = fileName(isLeft, i);
+    slot.T = UniTensor(fname);
+    remove(fname.c_str());
+    slot.onDisk = false;
+    memBytes += elemBytes(slot.T);
+  }
+  return slot;
+}
+
+void Environment::store(bool isLeft, size_t i, const UniTensor& T){
+  drop(isLeft, i);
+  Slot& slot = isLeft ? lefts[i] : rights[i];
+  slot.T = T;
+  slot.valid = true;
+  memBytes += elemBytes(T);
+}
+
+void Environment::drop(bool isLeft, size_t i){
+  Slot& slot = isLeft ? lefts[i] : rights[i];
+  if(!slot.valid)
+    return;
+  if(slot.onDisk)
+    remove(fileName(isLeft, i).c_str());
+  else
+    memBytes -= elemBytes(slot.T);
+  slot.T = UniTensor();
+  slot.valid = false;
+  slot.onDisk = false;
+}
+
+// Writes the environments farthest from the last ones asked for to disk until the limit is met
+void Environment::spill(){
+  while(memLimit > 0 && memBytes > memLimit){
+    bool spillLeft = false;
+    int far = -1, farDist = 0;
+    for(size_t i = 0; i < lefts.size(); i++){
+      if(lefts[i].valid && !lefts[i].onDisk && (int)i != lastLeft){
+        int dist = std::abs((int)i - lastLeft);
+        if(dist > farDist){
+          farDist = dist;
+          far = i;
+          spillLeft = true;
+        }
+      }
+      if(rights[i].valid && !rights[i].onDisk && (int)i != lastRight){
+        int dist = std::abs((int)i - lastRight);
+        if(dist > farDist){
+          farDist = dist;
+          far = i;
+          spillLeft = false;
+        }
+      }
+    }
+    if(far < 0)
+      break;
+    Slot& slot = spillLeft ? lefts[far] : rights[far];
+    slot.T.save(fileName(spillLeft, far));
+    memBytes -= elemBytes(slot.T);
+    slot.T = UniTensor();
+    slot.onDisk = true;
+  }
+}
+
+const UniTensor& Environment::left(size_t i){
+  try{
+    if(i >= lefts.size()){
+      std::ostringstream err;
+      err<<"No left environment of site " << i << " in a chain of " << op->size() << " sites.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    size_t j = i;
+    while(!lefts[j].valid)
+      j--;
+    int labelE[] = {1, 2, 3}, labelKet[] = {1, 4, 10}, labelW[] = {2, 5, 11, 4}, labelBra[] = {3, 5, 12};
+    int labelOut[] = {10, 11, 12};
+    for(; j < i; j++){
+      lastLeft = j + 1;
+      UniTensor E = fetch(true, j).T;
+      UniTensor K = (*ket)[j], W = (*op)[j], B = conjugate((*bra)[j]);
+      E.setLabel(labelE);
+      K.setLabel(labelKet);
+      W.setLabel(labelW);
+      B.setLabel(labelBra);
+      E = contract(E, K, true);
+      E = contract(E, W, true);
+      E = contract(E, B, true);
+      E.permute(labelOut, 1);
+      store(true, j + 1, E);
+      m_updates++;
+      spill();
+    }
+    lastLeft = i;
+    fetch(true, i);
+    spill();
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function Environment::left(size_t):");
+  }
+  return lefts[i].T;
+}
+
+const UniTensor& Environment::right(size_t i){
+  try{
+    if(i >= rights.size()){
+      std::ostringstream err;
+      err<<"No right environment of site " << i << " in a chain of " << op->size() << " sites.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    size_t j = i;
+    while(!rights[j].valid)
+      j++;
+    int labelE[] = {1, 2, 3}, labelKet[] = {10, 4, 1}, labelW[] = {11, 5, 2, 4}, labelBra[] = {12, 5, 3};
+    int labelOut[] = {10, 11, 12};
+    for(; j > i; j--){
+      lastRight = j - 1;
+      UniTensor E = fetch(false, j).T;
+      UniTensor K = (*ket)[j - 1], W = (*op)[j - 1], B = conjugate((*bra)[j - 1]);
+      E.setLabel(labelE);
+      K.setLabel(labelKet);
+      W.setLabel(labelW);
+      B.setLabel(labelBra);
+      E = contract(E, K, true);
+      E = contract(E, W, true);
+      E = contract(E, B, true);
+      E.permute(labelOut, 1);
+      store(false, j - 1, E);
+      m_updates++;
+      spill();
+    }
+    lastRight = i;
+    fetch(false, i);
+    spill();
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function Environment::right(size_t):");
+  }
+  return rights[i].T;
+}
+
+void Environment::invalidate(size_t i){
+  for(size_t j = i + 1; j < lefts.size(); j++)
+    drop(true, j);
+  for(size_t j = 0; j <= i && j + 1 < rights.size(); j++)
+    drop(false, j);
+}
+
+void Environment::invalidate(){
+  for(size_t j = 1; j < lefts.size(); j++)
+    drop(true, j);
+  for(size_t j = 0; j + 1 < rights.size(); j++)
+    drop(false, j);
+  // the edges may have changed as well
+  store(true, 0, edge(0));
+  store(false, op->size(), edge(op->size()));
+}
+
+Real Environment::expectation(size_t i){
+  Real val = 0;
+  try{
+    UniTensor L = left(i);
+    UniTensor R = right(i);
+    int label[] = {1, 2, 3};
+    L.setLabel(label);
+    R.setLabel(label);
+    UniTensor S = contract(L, R, true);
+    // the real part, which is the whole value for a Hermitian O and bra == ket
+    val = S.typeID() == 2 ? S.getElem(CTYPE)[0].real() : S.getElem()[0];
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function Environment::expectation(size_t):");
+  }
+  return val;
+}
+
+size_t Environment::updates()const{
+  return m_updates;
+}
+
+size_t Environment::memoryBytes()const{
+  return memBytes;
+}
+
+size_t Environment::spilledNum()const{
+  size_t num = 0;
+  for(size_t i = 0; i < lefts.size(); i++)
+    num += lefts[i].onDisk + rights[i].onDisk;
+  return num;
+}
+
+};	/* namespace uni10 */
@@ -0,0 +1,169 @@
+/****************************************************************************
+*  @file MPO.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file for the matrix product operator class
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/algorithm/MPO.h>
+#include <uni10/tools/uni10_tools.h>
+namespace uni10{
+
+namespace{
+  // Rank-4 tensor (w_l, s; w_r, s') from the d x d operators ops[w_l * wr + w_r], NULL for zero
+  UniTensor mpoTensor(int wl, int wr, int d, const std::vector<const Real*>& ops){
+    std::vector<Bond> bonds;
+    bonds.push_back(Bond(BD_IN, wl));
+    bonds.push_back(Bond(BD_IN, d));
+    bonds.push_back(Bond(BD_OUT, wr));
+    bonds.push_back(Bond(BD_OUT, d));
+    std::vector<Real> elem(wl * d * wr * d, 0);
+    for(int l = 0; l < wl; l++)
+      for(int r = 0; r < wr; r++)
+        if(ops[l * wr + r] != NULL)
+          for(int s = 0; s < d; s++)
+            for(int sp = 0; sp < d; sp++)
+              elem[((l * d + s) * wr + r) * d + sp] = ops[l * wr + r][s * d + sp];
+    UniTensor W(bonds, "W");
+    W.setRawElem(elem);
+    return W;
+  }
+
+  // Rows [r0, r1) and columns [c0, c1) of the bulk tensor W
+  UniTensor mpoSlice(const UniTensor& W, int r0, int r1, int c0, int c1){
+    int d = W.bond(1).dim(), wr = W.bond(2).dim();
+    std::vector<Bond> bonds = W.bond();
+    bonds[0] = Bond(BD_IN, r1 - r0);
+    bonds[2] = Bond(BD_OUT, c1 - c0);
+    UniTensor cW = W;
+    cW.permute(2);
+    const Real* src = cW.getElem();
+    std::vector<Real> elem;
+    for(int l = r0; l < r1; l++)
+      for(int s = 0; s < d; s++)
+        for(int r = c0; r < c1; r++)
+          for(int sp = 0; sp < d; sp++)
+            elem.push_back(src[((l * d + s) * wr + r) * d + sp]);
+    UniTensor slice(bonds, W.getName());
+    slice.setRawElem(elem);
+    return slice;
+  }
+};
+
+MPO::MPO(){}
+
+MPO::MPO(const std::vector<UniTensor>& sites): W(sites){
+  try{
+    for(size_t i = 0; i < W.size(); i++){
+      if(W[i].bondNum() != 4){
+        std::ostringstream err;
+        err<<"The tensor of site " << i << " of an MPO must have four bonds (w_l, s; w_r, s').";
+        throw std::runtime_error(exception_msg(err.str()));
+      }
+      if(W[i].inBondNum() != 2)
+        W[i].permute(2);
+      if(i > 0 && W[i].bond(0).dim() != W[i - 1].bond(2).dim()){
+        std::ostringstream err;
+        err<<"The bond between the sites " << i - 1 << " and " << i << " of the MPO does not match.";
+        throw std::runtime_error(exception_msg(err.str()));
+      }
+    }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor MPO::MPO(std::vector<uni10::UniTensor>&):");
+  }
+}
+
+MPO MPO::uniform(const UniTensor& W, size_t L){
+  std::vector<UniTensor> sites;
+  try{
+    int w = W.bond(0).dim();
+    if(L == 1)
+      sites.push_back(mpoSlice(W, w - 1, w, 0, 1));
+    else
+      for(size_t i = 0; i < L; i++){
+        if(i == 0)
+          sites.push_back(mpoSlice(W, w - 1, w, 0, w));
+        else if(i == L - 1)
+          sites.push_back(mpoSlice(W, 0, w, 0, 1));
+        else
+          sites.push_back(W);
+      }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function MPO::uniform(uni10::UniTensor&, size_t):");
+  }
+  return MPO(sites);
+}
+
+MPO MPO::heisenberg(size_t L, Real J, Real Jz, Real h){
+  Real I[] = {1, 0, 0, 1};
+  Real Sp[] = {0, 1, 0, 0};
+  Real Sm[] = {0, 0, 1, 0};
+  Real Sz[] = {0.5, 0, 0, -0.5};
+  Real hSp[] = {0, J / 2, 0, 0};
+  Real hSm[] = {0, 0, J / 2, 0};
+  Real JSz[] = {Jz / 2, 0, 0, -Jz / 2};
+  Real hSz[] = {-h / 2, 0, 0, h / 2};
+  const Real* ops[] = {I, NULL, NULL, NULL, NULL,
+                       Sp, NULL, NULL, NULL, NULL,
+                       Sm, NULL, NULL, NULL, NULL,
+                       Sz, NULL, NULL, NULL, NULL,
+                       hSz, hSm, hSp, JSz, I};
+  return uniform(mpoTensor(5, 5, 2, std::vector<const Real*>(ops, ops + 25)), L);
+}
+
+MPO MPO::transverseIsing(size_t L, Real J, Real g){
+  Real I[] = {1, 0, 0, 1};
+  Real Z[] = {1, 0, 0, -1};
+  Real gX[] = {0, -g, -g, 0};
+  Real JZ[] = {-J, 0, 0, J};
+  const Real* ops[] = {I, NULL, NULL,
+                       Z, NULL, NULL,
+                       gX, JZ, I};
+  return uniform(mpoTensor(3, 3, 2, std::vector<const Real*>(ops, ops + 9)), L);
+}
+
+size_t MPO::size()const{
+  return W.size();
+}
+
+const UniTensor& MPO::operator[](size_t i)const{
+  return W[i];
+}
+
+UniTensor& MPO::operator[](size_t i){
+  return W[i];
+}
+
+int MPO::bondDim(size_t b)const{
+  return b < W.size() ? W[b].bond(0).dim() : W[b - 1].bond(2).dim();
+}
+
+int MPO::physDim(size_t i)const{
+  return W[i].bond(1).dim();
+}
+
+};	/* namespace uni10 */
@@ -0,0 +1,348 @@
+/****************************************************************************
+*  @file MPS.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file for the matrix product state class
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/algorithm/MPS.h>
+#include <uni10/tools/uni10_tools.h>
+#include <cmath>
+namespace uni10{
+
+namespace{
+  // The singular values S of a real or complex SVD as a real diagonal matrix of unit norm
+  Matrix schmidtValues(const Matrix& S){
+    if(S.typeID() == 1)
+      return S * (1.0 / S.norm());
+    std::vector<Real> s(S.row());
+    for(size_t j = 0; j < s.size(); j++)
+      s[j] = S.getElem(CTYPE)[j].real();
+    Matrix lambda(s.size(), s.size(), &s[0], true);
+    return lambda * (1.0 / lambda.norm());
+  }
+};
+
+MPS::MPS(): m_center(-1){}
+
+MPS::MPS(const std::vector<UniTensor>& sites): A(sites), lambdas(sites.size() + 1), m_center(-1){
+  try{
+    for(size_t i = 0; i < A.size(); i++){
+      if(A[i].bondNum() != 3){
+        std::ostringstream err;
+        err<<"The tensor of site " << i << " of an MPS must have three bonds (l, s; r).";
+        throw std::runtime_error(exception_msg(err.str()));
+      }
+      if(A[i].inBondNum() != 2)
+        A[i].permute(2);
+      if(i > 0 && A[i].bond(0).dim() != A[i - 1].bond(2).dim()){
+        std::ostringstream err;
+        err<<"The bond between the sites " << i - 1 << " and " << i << " of the MPS does not match.";
+        throw std::runtime_error(exception_msg(err.str()));
+      }
+    }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor MPS::MPS(std::vector<uni10::UniTensor>&):");
+  }
+}
+
+MPS::MPS(const std::vector<UniTensor>& sites, size_t center): m_center(-1){
+  try{
+    *this = MPS(sites);
+    check(center);
+    m_center = center;
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor MPS::MPS(std::vector<uni10::UniTensor>&, size_t):");
+  }
+}
+
+MPS::MPS(size_t L, int d, int chi): A(L), lambdas(L + 1), m_center(-1){
+  try{
+    std::vector<int> dims(L + 1, 1);
+    for(size_t b = 1; b < L; b++){
+      double full = std::min(std::pow((double)d, (double)b), std::pow((double)d, (double)(L - b)));
+      dims[b] = full < chi ? (int)full : chi;
+    }
+    for(size_t i = 0; i < L; i++){
+      Matrix m(dims[i] * d, dims[i + 1]);
+      m.randomize();
+      A[i] = siteTensor(dims[i], d, dims[i + 1], m);
+    }
+    canonicalize(0);
+    normalize();
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor MPS::MPS(size_t, int, int):");
+  }
+}
+
+MPS MPS::product(size_t L, const std::vector<Real>& local){
+  Matrix m(local.size(), 1, &local[0]);
+  m *= 1.0 / m.norm();
+  std::vector<UniTensor> sites(L, siteTensor(1, local.size(), 1, m));
+  MPS psi(sites);
+  psi.m_center = 0;
+  Real one = 1;
+  for(size_t b = 1; b < L; b++)
+    psi.lambdas[b] = Matrix(1, 1, &one, true);
+  return psi;
+}
+
+UniTensor MPS::siteTensor(int l, int d, int r, const Matrix& m, int inBondNum){
+  std::vector<Bond> bonds;
+  bonds.push_back(Bond(BD_IN, l));
+  bonds.push_back(Bond(inBondNum > 1 ? BD_IN : BD_OUT, d));
+  bonds.push_back(Bond(BD_OUT, r));
+  UniTensor T(bonds);
+  T.putBlock(m, true);  // a complex m makes a complex site
+  if(inBondNum != 2)
+    T.permute(2);
+  return T;
+}
+
+size_t MPS::size()const{
+  return A.size();
+}
+
+void MPS::check(size_t i)const{
+  if(i >= A.size()){
+    std::ostringstream err;
+    err<<"Site " << i << " is out of the MPS of " << A.size() << " sites.";
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+}
+
+void MPS::checkSingleBlock(const UniTensor& T, size_t i){
+  if(T.blockNum() > 1){
+    std::ostringstream err;
+    err<<"The tensor of site " << i << " has " << T.blockNum() << " blocks, the canonical form and the overlap "
+      << "need MPS without symmetry.";
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+}
+
+const UniTensor& MPS::operator[](size_t i)const{
+  return A[i];
+}
+
+void MPS::setSite(size_t i, const UniTensor& T){
+  try{
+    check(i);
+    A[i] = UniTensor(T);  // T may be A[i] itself
+    if(A[i].inBondNum() != 2)
+      A[i].permute(2);
+    if((int)i != m_center)
+      m_center = -1;
+    lambdas.assign(A.size() + 1, Matrix());
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function MPS::setSite(size_t, uni10::UniTensor&):");
+  }
+}
+
+void MPS::setSites(size_t i, const UniTensor& TA, const UniTensor& TB, size_t c){
+  try{
+    check(i + 1);
+    if(c != i && c != i + 1){
+      std::ostringstream err;
+      err<<"The center " << c << " must be one of the updated sites " << i << " and " << i + 1 << ".";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    bool atCenter = m_center == (int)i || m_center == (int)i + 1;
+    A[i] = UniTensor(TA);
+    A[i + 1] = UniTensor(TB);
+    for(size_t j = i; j <= i + 1; j++)
+      if(A[j].inBondNum() != 2)
+        A[j].permute(2);
+    m_center = atCenter ? c : -1;
+    lambdas.assign(A.size() + 1, Matrix());
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function MPS::setSites(size_t, uni10::UniTensor&, uni10::UniTensor&, size_t):");
+  }
+}
+
+int MPS::physDim(size_t i)const{
+  return A[i].bond(1).dim();
+}
+
+int MPS::bondDim(size_t b)const{
+  return b < A.size() ? A[b].bond(0).dim() : A[b - 1].bond(2).dim();
+}
+
+int MPS::maxBondDim()const{
+  int chi = 1;
+  for(size_t b = 1; b < A.size(); b++)
+    chi = std::max(chi, bondDim(b));
+  return chi;
+}
+
+int MPS::center()const{
+  return m_center;
+}
+
+// Splits site i by SVD into a left-normalized site i and S * VT absorbed into site i + 1
+void MPS::shiftRight(size_t i, bool exact){
+  checkSingleBlock(A[i], i);
+  checkSingleBlock(A[i + 1], i + 1);
+  int l = bondDim(i), d = physDim(i);
+  std::vector<Matrix> usv = A[i].const_getBlock().svd();
+  int k = usv[1].row();
+  A[i] = siteTensor(l, d, k, usv[0]);
+  UniTensor next = A[i + 1];
+  next.permute(1);
+  Matrix SV = usv[1] * usv[2];
+  A[i + 1] = siteTensor(k, physDim(i + 1), bondDim(i + 2), SV * next.const_getBlock(), 1);
+  lambdas[i + 1] = exact ? schmidtValues(usv[1]) : Matrix();
+}
+
+// Splits site i by SVD into a right-normalized site i and U * S absorbed into site i - 1
+void MPS::shiftLeft(size_t i, bool exact){
+  checkSingleBlock(A[i - 1], i - 1);
+  checkSingleBlock(A[i], i);
+  int d = physDim(i), r = bondDim(i + 1);
+  UniTensor cur = A[i];
+  cur.permute(1);
+  std::vector<Matrix> usv = cur.const_getBlock().svd();
+  int k = usv[1].row();
+  A[i] = siteTensor(k, d, r, usv[2], 1);
+  Matrix US = usv[0] * usv[1];
+  A[i - 1] = siteTensor(bondDim(i - 1), physDim(i - 1), k, A[i - 1].const_getBlock() * US);
+  lambdas[i] = exact ? schmidtValues(usv[1]) : Matrix();
+}
+
+void MPS::canonicalize(size_t c){
+  try{
+    check(c);
+    for(size_t i = 0; i + 1 < A.size(); i++)
+      shiftRight(i, false);
+    for(size_t i = A.size() - 1; i > c; i--)
+      shiftLeft(i, true);
+    m_center = c;
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function MPS::canonicalize(size_t):");
+  }
+}
+
+void MPS::moveCenter(size_t c){
+  try{
+    check(c);
+    if(m_center < 0){
+      canonicalize(c);
+      return;
+    }
+    for(; (size_t)m_center < c; m_center++)
+      shiftRight(m_center, true);
+    for(; (size_t)m_center > c; m_center--)
+      shiftLeft(m_center, true);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function MPS::moveCenter(size_t):");
+  }
+}
+
+const Matrix& MPS::lambda(size_t b)const{
+  try{
+    if(!hasLambda(b)){
+      std::ostringstream err;
+      err<<"The Schmidt values of bond " << b << " are not known, move the center across the bond first.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function MPS::lambda(size_t):");
+  }
+  return lambdas[b];
+}
+
+bool MPS::hasLambda(size_t b)const{
+  return b < lambdas.size() && lambdas[b].elemNum() > 0;
+}
+
+void MPS::setLambda(size_t b, const Matrix& lambda){
+  lambdas[b] = lambda;
+}
+
+Real MPS::norm()const{
+  if(m_center >= 0)
+    return A[m_center].norm();
+  return std::sqrt(std::fabs(overlap(*this)));
+}
+
+void MPS::normalize(){
+  Real nrm = norm();
+  if(m_center >= 0)
+    A[m_center] *= 1.0 / nrm;
+  else{
+    Real scale = std::pow(nrm, -1.0 / A.size());
+    for(size_t i = 0; i < A.size(); i++)
+      A[i] *= scale;
+  }
+}
+
+Real MPS::overlap(const MPS& phi)const{
+  Real val = 0;
+  try{
+    if(phi.size() != A.size()){
+      std::ostringstream err;
+      err<<"The overlap of MPS of " << A.size() << " and " << phi.size() << " sites.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    for(size_t i = 0; i < A.size(); i++){
+      checkSingleBlock(A[i], i);
+      checkSingleBlock(phi.A[i], i);
+      if(A[i].typeID() == 2 || phi.A[i].typeID() == 2){
+        std::ostringstream err;
+        err<<"The overlap of complex MPS is complex, only the overlap of real MPS is supported.";
+        throw std::runtime_error(exception_msg(err.str()));
+      }
+    }
+    std::vector<Bond> bonds;
+    bonds.push_back(Bond(BD_IN, bondDim(0)));
+    bonds.push_back(Bond(BD_OUT, phi.bondDim(0)));
+    UniTensor E(bonds);
+    E.identity();
+    int labelE[] = {1, 2}, labelBra[] = {1, 3, 4}, labelKet[] = {2, 3, 5}, labelOut[] = {4, 5};
+    for(size_t i = 0; i < A.size(); i++){
+      UniTensor bra = A[i], ket = phi.A[i];
+      E.setLabel(labelE);
+      bra.setLabel(labelBra);
+      ket.setLabel(labelKet);
+      E = contract(E, bra, true);
+      E = contract(E, ket, true);
+      E.permute(labelOut, 1);
+    }
+    val = E.const_getBlock().trace();
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function MPS::overlap(uni10::MPS&):");
+  }
+  return val;
+}
+
+};	/* namespace uni10 */
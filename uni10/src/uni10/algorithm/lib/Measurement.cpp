@@ -0,0 +1,434 @@
+/****************************************************************************
+*  @file Measurement.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file of the Measurement class
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/algorithm/Measurement.h>
+#include <uni10/numeric/lapack/uni10_lapack.h>
+#include <uni10/tools/uni10_tools.h>
+#include <uni10/tools/uni10_trace.h>
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <functional>
+namespace uni10{
+
+namespace{
+  // Elements of a real single-site operator, row-major and dense; empty for an empty matrix
+  std::vector<Real> dense(const Matrix& op){
+    std::vector<Real> elem;
+    if(op.elemNum() == 0)
+      return elem;
+    if(op.typeID() != 1 || op.row() != op.col()){
+      std::ostringstream err;
+      err<<"The operators must be real square matrices.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    size_t d = op.row();
+    elem.assign(d * d, 0);
+    if(op.isDiag())
+      for(size_t s = 0; s < d; s++)
+        elem[s * d + s] = op.getElem()[s];
+    else
+      std::copy(op.getElem(), op.getElem() + d * d, elem.begin());
+    return elem;
+  }
+
+  // Correlators of the same left operator and string, measured in the same sweeps
+  struct Group{
+    std::vector<Real> left;
+    std::vector<Real> string;
+    std::vector<size_t> members;
+  };
+};
+
+MeasurementParams::MeasurementParams(): threads(0){}
+
+Correlator::Correlator(){}
+
+Correlator::Correlator(const Matrix& _left, const Matrix& _right, const Matrix& _string): left(_left), right(_right), string(_string){}
+
+Measurement::Measurement(const MPS& psi, const MeasurementParams& _params): params(_params), norm2(0){
+  try{
+    size_t L = psi.size();
+    if(L == 0){
+      std::ostringstream err;
+      err<<"Cannot measure an empty MPS.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    for(size_t i = 0; i < L; i++){
+      const UniTensor& A = psi[i];
+      if(A.bondNum() != 3 || A.typeID() != 1){
+        std::ostringstream err;
+        err<<"The tensor of site " << i << " must be a real tensor of the bonds (l, s; r).";
+        throw std::runtime_error(exception_msg(err.str()));
+      }
+      if(i && A.bond(0).dim() != chis.back()){
+        std::ostringstream err;
+        err<<"The bond between the sites " << i - 1 << " and " << i << " has the dimensions " << chis.back()
+          << " and " << A.bond(0).dim() << ".";
+        throw std::runtime_error(exception_msg(err.str()));
+      }
+      if(i == 0)
+        chis.push_back(A.bond(0).dim());
+      dims.push_back(A.bond(1).dim());
+      chis.push_back(A.bond(2).dim());
+      Matrix raw = A.getRawElem();
+      sites.push_back(std::vector<Real>(raw.getElem(), raw.getElem() + raw.elemNum()));
+    }
+    lefts.resize(L + 1);
+    rights.resize(L + 1);
+    lefts[0].assign(chis[0] * chis[0], 0);
+    for(int l = 0; l < chis[0]; l++)
+      lefts[0][l * chis[0] + l] = 1;
+    rights[L].assign(chis[L] * chis[L], 0);
+    for(int r = 0; r < chis[L]; r++)
+      rights[L][r * chis[L] + r] = 1;
+    std::vector<Real> work;
+    for(size_t i = 0; i < L; i++){
+      lefts[i + 1].resize(chis[i + 1] * chis[i + 1]);
+      transferLeft(i, &lefts[i][0], NULL, &lefts[i + 1][0], work);
+    }
+    for(size_t i = L; i-- > 0;){
+      rights[i].resize(chis[i] * chis[i]);
+      transferRight(i, &rights[i + 1][0], NULL, &rights[i][0], work);
+    }
+    norm2 = close(L, &lefts[L][0]);
+    if(!(norm2 > 0)){
+      std::ostringstream err;
+      err<<"The MPS has zero norm.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor Measurement::Measurement(uni10::MPS&, uni10::MeasurementParams&):");
+  }
+}
+
+size_t Measurement::size()const{
+  return sites.size();
+}
+
+Real Measurement::norm()const{
+  return std::sqrt(norm2);
+}
+
+void Measurement::checkOp(size_t i, const std::vector<Real>& op)const{
+  if(op.size() && op.size() != (size_t)dims[i] * dims[i]){
+    std::ostringstream err;
+    err<<"The operator on site " << i << " must be a " << dims[i] << " x " << dims[i] << " matrix.";
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+}
+
+// E' = sum A^* op A E over site i, from the bond i to the bond i+1; op NULL for the identity
+void Measurement::transferLeft(size_t i, const Real* E, const Real* op, Real* out, std::vector<Real>& work)const{
+  int l = chis[i], d = dims[i], r = chis[i + 1];
+  Real* A = const_cast<Real*>(&sites[i][0]);
+  work.resize(2 * (size_t)l * d * r);
+  Real* T1 = &work[0];
+  Real* T2 = T1 + (size_t)l * d * r;
+  matrixMul(const_cast<Real*>(E), A, l, d * r, l, T1, false, false, false);   // (l_bra, s', r_ket)
+  if(op){
+    for(int x = 0; x < l; x++)
+      matrixMul(const_cast<Real*>(op), T1 + (size_t)x * d * r, d, r, d, T2 + (size_t)x * d * r, false, false, false);
+    T1 = T2;
+  }
+  matrixMul(A, T1, r, r, l * d, out, true, false, false, false, false);
+}
+
+// E' = sum A^* op A E over site i, from the bond i+1 to the bond i
+void Measurement::transferRight(size_t i, const Real* E, const Real* op, Real* out, std::vector<Real>& work)const{
+  int l = chis[i], d = dims[i], r = chis[i + 1];
+  Real* A = const_cast<Real*>(&sites[i][0]);
+  work.resize(2 * (size_t)l * d * r);
+  Real* T1 = &work[0];
+  Real* T2 = T1 + (size_t)l * d * r;
+  matrixMul(A, const_cast<Real*>(E), l * d, r, r, T1, false, true, false, false, false);   // (l_ket, s', r_bra)
+  if(op){
+    for(int x = 0; x < l; x++)
+      matrixMul(const_cast<Real*>(op), T1 + (size_t)x * d * r, d, r, d, T2 + (size_t)x * d * r, false, false, false);
+    T1 = T2;
+  }
+  matrixMul(A, T1, l, l, d * r, out, false, true, false, false, false);
+}
+
+// <E^L_b, E^R_b>
+Real Measurement::close(size_t b, const Real* E)const{
+  const std::vector<Real>& R = rights[b];
+  Real val = 0;
+  for(size_t x = 0; x < R.size(); x++)
+    val += E[x] * R[x];
+  return val;
+}
+
+namespace{
+  // Reduced density matrix rho(s_bra, s_ket) of site i between the environments EL and ER
+  void density(const std::vector<Real>& A, int l, int d, int r, const Real* EL, const Real* ER, Real* rho,
+      std::vector<Real>& work){
+    work.resize(2 * (size_t)l * d * r);
+    Real* T1 = &work[0];
+    Real* X = T1 + (size_t)l * d * r;
+    Real* pA = const_cast<Real*>(&A[0]);
+    matrixMul(const_cast<Real*>(EL), pA, l, d * r, l, T1, false, false, false);                  // (l_bra, s', r_ket)
+    matrixMul(T1, const_cast<Real*>(ER), l * d, r, r, X, false, true, false, false, false);       // (l_bra, s', r_bra)
+    std::fill(rho, rho + d * d, 0);
+    for(int x = 0; x < l; x++)
+      for(int s = 0; s < d; s++){
+        const Real* a = pA + ((size_t)x * d + s) * r;
+        for(int t = 0; t < d; t++){
+          const Real* y = X + ((size_t)x * d + t) * r;
+          Real sum = 0;
+          for(int z = 0; z < r; z++)
+            sum += a[z] * y[z];
+          rho[s * d + t] += sum;
+        }
+      }
+  }
+
+  Real traceOp(const std::vector<Real>& op, const Real* rho){
+    Real val = 0;
+    for(size_t x = 0; x < op.size(); x++)
+      val += op[x] * rho[x];
+    return val;
+  }
+
+  std::vector<Real> times(const std::vector<Real>& a, const std::vector<Real>& b, int d){
+    std::vector<Real> c(d * d, 0);
+    for(int s = 0; s < d; s++)
+      for(int k = 0; k < d; k++)
+        for(int t = 0; t < d; t++)
+          c[s * d + t] += a[s * d + k] * b[k * d + t];
+    return c;
+  }
+};
+
+std::vector<Real> Measurement::local(const Matrix& op)const{
+  std::vector<std::vector<Real> > vals;
+  try{
+    vals = local(std::vector<Matrix>(1, op));
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function Measurement::local(uni10::Matrix&):");
+  }
+  return vals.size() ? vals[0] : std::vector<Real>();
+}
+
+std::vector<std::vector<Real> > Measurement::local(const std::vector<Matrix>& ops)const{
+  size_t L = sites.size();
+  std::vector<std::vector<Real> > vals(ops.size(), std::vector<Real>(L, 0));
+  try{
+    UNI10_TRACE_SCOPE(trace, "local", "measurement");
+    std::vector<std::vector<Real> > elems;
+    for(size_t k = 0; k < ops.size(); k++){
+      elems.push_back(dense(ops[k]));
+      for(size_t i = 0; i < L; i++)
+        checkOp(i, elems[k]);
+    }
+    double cost = 0;
+    for(size_t i = 0; i < L; i++)
+      cost += 2.0 * chis[i] * dims[i] * chis[i + 1] * std::max(chis[i], chis[i + 1]);
+    // one density matrix per site serves all the operators
+    parallelTasks(L, taskThreads(params.threads, L, cost), [&](size_t i, size_t){
+      std::vector<Real> work, rho(dims[i] * dims[i]);
+      density(sites[i], chis[i], dims[i], chis[i + 1], &lefts[i][0], &rights[i + 1][0], &rho[0], work);
+      for(size_t k = 0; k < elems.size(); k++)
+        vals[k][i] = elems[k].size() ? traceOp(elems[k], &rho[0]) / norm2 : 1;
+    });
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function Measurement::local(std::vector<uni10::Matrix>&):");
+  }
+  return vals;
+}
+
+Real Measurement::product(size_t first, const std::vector<Matrix>& ops)const{
+  Real val = 0;
+  try{
+    if(first + ops.size() > sites.size()){
+      std::ostringstream err;
+      err<<"The operators on the sites " << first << " to " << first + ops.size() << " exceed the " << sites.size() << " sites.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    std::vector<Real> E = lefts[first], next, work;
+    for(size_t k = 0; k < ops.size(); k++){
+      size_t i = first + k;
+      std::vector<Real> op = dense(ops[k]);
+      checkOp(i, op);
+      next.resize(chis[i + 1] * chis[i + 1]);
+      transferLeft(i, &E[0], op.size() ? &op[0] : NULL, &next[0], work);
+      E.swap(next);
+    }
+    val = close(first + ops.size(), &E[0]) / norm2;
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function Measurement::product(size_t, std::vector<uni10::Matrix>&):");
+  }
+  return val;
+}
+
+std::vector<Matrix> Measurement::correlations(const std::vector<Correlator>& corrs)const{
+  size_t L = sites.size();
+  std::vector<Matrix> vals(corrs.size(), Matrix(L, L));
+  try{
+    UNI10_TRACE_SCOPE(trace, "correlations", "measurement");
+    std::vector<Group> groups;
+    std::vector<std::vector<Real> > rights_(corrs.size()), diags(corrs.size());
+    for(size_t c = 0; c < corrs.size(); c++){
+      std::vector<Real> left = dense(corrs[c].left), string = dense(corrs[c].string);
+      rights_[c] = dense(corrs[c].right);
+      if(left.empty() || rights_[c].empty() || left.size() != rights_[c].size()){
+        std::ostringstream err;
+        err<<"The left and right operators of correlator " << c << " must be matrices of the same dimension.";
+        throw std::runtime_error(exception_msg(err.str()));
+      }
+      for(size_t i = 0; i < L; i++){
+        checkOp(i, left);
+        checkOp(i, string);
+      }
+      diags[c] = times(left, rights_[c], dims[0]);
+      size_t g = 0;
+      while(g < groups.size() && !(groups[g].left == left && groups[g].string == string))
+        g++;
+      if(g == groups.size()){
+        groups.push_back(Group());
+        groups[g].left = left;
+        groups[g].string = string;
+      }
+      groups[g].members.push_back(c);
+    }
+    double cost = 0;
+    for(size_t i = 0; i < L; i++)
+      cost += 4.0 * groups.size() * (L - i) * chis[i] * dims[i] * chis[i + 1] * std::max(chis[i], chis[i + 1]);
+    // each left site is a sweep to the right end, the sweeps of a site share its density matrix
+    parallelTasks(L, taskThreads(params.threads, L, cost / L), [&](size_t i, size_t){
+      int d = dims[i];
+      std::vector<Real> work, rho(d * d), E, next;
+      density(sites[i], chis[i], d, chis[i + 1], &lefts[i][0], &rights[i + 1][0], &rho[0], work);
+      for(size_t c = 0; c < corrs.size(); c++)
+        vals[c][i * L + i] = traceOp(diags[c], &rho[0]) / norm2;
+      for(size_t g = 0; g < groups.size(); g++){
+        const Group& grp = groups[g];
+        E.resize(chis[i + 1] * chis[i + 1]);
+        transferLeft(i, &lefts[i][0], &grp.left[0], &E[0], work);
+        for(size_t j = i + 1; j < L; j++){
+          rho.resize(dims[j] * dims[j]);
+          density(sites[j], chis[j], dims[j], chis[j + 1], &E[0], &rights[j + 1][0], &rho[0], work);
+          for(size_t m = 0; m < grp.members.size(); m++){
+            size_t c = grp.members[m];
+            vals[c][i * L + j] = traceOp(rights_[c], &rho[0]) / norm2;
+          }
+          if(j + 1 < L){
+            next.resize(chis[j + 1] * chis[j + 1]);
+            transferLeft(j, &E[0], grp.string.size() ? &grp.string[0] : NULL, &next[0], work);
+            E.swap(next);
+          }
+        }
+      }
+    });
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function Measurement::correlations(std::vector<uni10::Correlator>&):");
+  }
+  return vals;
+}
+
+Matrix Measurement::correlation(const Correlator& corr)const{
+  std::vector<Matrix> vals;
+  try{
+    vals = correlations(std::vector<Correlator>(1, corr));
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function Measurement::correlation(uni10::Correlator&):");
+  }
+  return vals.size() ? vals[0] : Matrix();
+}
+
+std::vector<Real> Measurement::spectrum(size_t b)const{
+  std::vector<Real> p;
+  try{
+    if(b == 0 || b >= sites.size()){
+      std::ostringstream err;
+      err<<"Bond " << b << " is not between two of the " << sites.size() << " sites.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    // the squared Schmidt values are the eigenvalues of sqrt(E^L) E^R sqrt(E^L) / <psi|psi>
+    int chi = chis[b];
+    std::vector<Real> EL = lefts[b], ER = rights[b], w(chi), V(chi * chi), S(chi * chi, 0), T(chi * chi), M(chi * chi);
+    eigSyDecompose(&EL[0], chi, &w[0], &V[0], false);
+    for(int k = 0; k < chi; k++){
+      Real sq = std::sqrt(std::max(w[k], (Real)0));
+      for(int x = 0; x < chi; x++)
+        for(int y = 0; y < chi; y++)
+          S[x * chi + y] += V[k * chi + x] * sq * V[k * chi + y];
+    }
+    matrixMul(&S[0], &ER[0], chi, chi, chi, &T[0], false, false, false);
+    matrixMul(&T[0], &S[0], chi, chi, chi, &M[0], false, false, false);
+    eigSyDecompose(&M[0], chi, &w[0], &V[0], false);
+    for(int k = chi - 1; k >= 0; k--)
+      if(w[k] > 0)
+        p.push_back(w[k] / norm2);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function Measurement::spectrum(size_t):");
+  }
+  return p;
+}
+
+Real Measurement::entropy(size_t b)const{
+  Real S = 0;
+  try{
+    std::vector<Real> p = spectrum(b);
+    for(size_t k = 0; k < p.size(); k++)
+      if(p[k] > 1E-300)
+        S -= p[k] * std::log(p[k]);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function Measurement::entropy(size_t):");
+  }
+  return S;
+}
+
+std::vector<Real> Measurement::entropies()const{
+  size_t L = sites.size();
+  std::vector<Real> S(L + 1, 0);
+  try{
+    double cost = 0;
+    for(size_t b = 1; b < L; b++)
+      cost += 10.0 * chis[b] * chis[b] * chis[b];
+    size_t bonds = L > 1 ? L - 1 : 0;
+    parallelTasks(bonds, taskThreads(params.threads, bonds, cost), [&](size_t k, size_t){
+      S[k + 1] = entropy(k + 1);
+    });
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function Measurement::entropies():");
+  }
+  return S;
+}
+
+};	/* namespace uni10 */
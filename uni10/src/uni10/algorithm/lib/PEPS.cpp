@@ -0,0 +1,146 @@
+/****************************************************************************
+*  @file PEPS.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file of the projected entangled pair states of a finite lattice
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/algorithm/PEPS.h>
+#include <uni10/tools/uni10_tools.h>
+namespace uni10{
+
+PEPS::PEPS(): m_rows(0), m_cols(0){}
+
+PEPS::PEPS(size_t rows, size_t cols, const std::vector<UniTensor>& sites): m_rows(rows), m_cols(cols), A(sites){
+  try{
+    if(sites.size() != rows * cols){
+      std::ostringstream err;
+      err<<"A PEPS of " << rows << " x " << cols << " sites needs " << rows * cols << " tensors, not " << sites.size() << ".";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    for(size_t r = 0; r < rows; r++)
+      for(size_t c = 0; c < cols; c++)
+        setSite(r, c, sites[r * cols + c]);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor PEPS::PEPS(size_t, size_t, std::vector<uni10::UniTensor>&):");
+  }
+}
+
+PEPS::PEPS(size_t rows, size_t cols, int d, int D): m_rows(rows), m_cols(cols), A(rows * cols){
+  try{
+    for(size_t r = 0; r < rows; r++)
+      for(size_t c = 0; c < cols; c++){
+        int l = c > 0 ? D : 1, u = r > 0 ? D : 1, rt = c + 1 < cols ? D : 1, dn = r + 1 < rows ? D : 1;
+        Matrix m(l * u * d, rt * dn);
+        m.randomize();
+        A[r * cols + c] = siteTensor(l, u, d, rt, dn, m);
+      }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor PEPS::PEPS(size_t, size_t, int, int):");
+  }
+}
+
+PEPS PEPS::product(size_t rows, size_t cols, const std::vector<Real>& local){
+  Matrix m(local.size(), 1, &local[0]);
+  m *= 1.0 / m.norm();
+  return PEPS(rows, cols, std::vector<UniTensor>(rows * cols, siteTensor(1, 1, local.size(), 1, 1, m)));
+}
+
+UniTensor PEPS::siteTensor(int l, int u, int d, int r, int dn, const Matrix& m){
+  std::vector<Bond> bonds;
+  bonds.push_back(Bond(BD_IN, l));
+  bonds.push_back(Bond(BD_IN, u));
+  bonds.push_back(Bond(BD_IN, d));
+  bonds.push_back(Bond(BD_OUT, r));
+  bonds.push_back(Bond(BD_OUT, dn));
+  UniTensor T(bonds);
+  T.putBlock(m);
+  return T;
+}
+
+size_t PEPS::rows()const{
+  return m_rows;
+}
+
+size_t PEPS::cols()const{
+  return m_cols;
+}
+
+void PEPS::check(size_t r, size_t c)const{
+  if(r >= m_rows || c >= m_cols){
+    std::ostringstream err;
+    err<<"Site (" << r << ", " << c << ") is out of the PEPS of " << m_rows << " x " << m_cols << " sites.";
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+}
+
+const UniTensor& PEPS::operator()(size_t r, size_t c)const{
+  return A[r * m_cols + c];
+}
+
+void PEPS::setSite(size_t r, size_t c, const UniTensor& T){
+  try{
+    check(r, c);
+    if(T.bondNum() != 5){
+      std::ostringstream err;
+      err<<"A PEPS site needs the five bonds (l, u, s; r, d), not " << T.bondNum() << ".";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    if((c == 0 && T.bond(0).dim() != 1) || (r == 0 && T.bond(1).dim() != 1) ||
+        (c + 1 == m_cols && T.bond(3).dim() != 1) || (r + 1 == m_rows && T.bond(4).dim() != 1)){
+      std::ostringstream err;
+      err<<"The bonds of site (" << r << ", " << c << ") on the edges of the lattice must have dimension one.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    A[r * m_cols + c] = UniTensor(T);  // T may be the site itself
+    if(A[r * m_cols + c].inBondNum() != 3)
+      A[r * m_cols + c].permute(3);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function PEPS::setSite(size_t, size_t, uni10::UniTensor&):");
+  }
+}
+
+int PEPS::physDim(size_t r, size_t c)const{
+  return (*this)(r, c).bond(2).dim();
+}
+
+PEPS PEPS::transpose()const{
+  std::vector<UniTensor> sites(A.size());
+  int label[] = {0, 1, 2, 3, 4}, swapped[] = {1, 0, 2, 4, 3};
+  for(size_t r = 0; r < m_rows; r++)
+    for(size_t c = 0; c < m_cols; c++){
+      UniTensor T = (*this)(r, c);
+      T.setLabel(label);
+      T.permute(swapped, 3);
+      T.setLabel(label);
+      sites[c * m_rows + r] = T;
+    }
+  return PEPS(m_cols, m_rows, sites);
+}
+
+};	/* namespace uni10 */
@@ -0,0 +1,355 @@
+/****************************************************************************
+*  @file Solvers.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file for the matrix-free eigensolver and the truncated SVD
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/algorithm/Solvers.h>
+#include <uni10/tools/uni10_tools.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <map>
+namespace uni10{
+
+namespace{
+  Real dot(const Real* x, const Real* y, size_t dim){
+    Real sum = 0;
+    for(size_t i = 0; i < dim; i++)
+      sum += x[i] * y[i];
+    return sum;
+  }
+
+  // <x|y> of complex vectors
+  Complex dot(const Complex* x, const Complex* y, size_t dim){
+    Complex sum = 0;
+    for(size_t i = 0; i < dim; i++)
+      sum += std::conj(x[i]) * y[i];
+    return sum;
+  }
+
+  // x -= <v|x> v for every Krylov vector v
+  template<typename T>
+  void orthogonalize(T* x, const std::vector<std::vector<T> >& basis, size_t num, size_t dim){
+    for(size_t k = 0; k < num; k++){
+      T proj = dot(&basis[k][0], x, dim);
+      for(size_t i = 0; i < dim; i++)
+        x[i] -= proj * basis[k][i];
+    }
+  }
+
+  // e^{t lambda} of the imaginary time evolution and e^{-i t lambda} of the real time evolution
+  Real expFactor(Real lambda, Real t, const Real*){
+    return std::exp(t * lambda);
+  }
+  Complex expFactor(Real lambda, Real t, const Complex*){
+    return std::exp(Complex(0, -t * lambda));
+  }
+
+  // c = f(T) e_0 of the tridiagonal T = U^T D U, with the eigenvectors of T as the rows of U, where f is
+  // the exponential of expFactor()
+  template<typename T>
+  void expCoefficients(const std::vector<Matrix>& eig, size_t k, Real t, std::vector<T>& c){
+    const Real* D = eig[0].getElem();
+    const Real* U = eig[1].getElem();
+    c.assign(k, T(0));
+    for(size_t m = 0; m < k; m++){
+      T f = expFactor(D[m], t, (const T*)NULL) * U[m * k];
+      for(size_t j = 0; j < k; j++)
+        c[j] += U[m * k + j] * f;
+    }
+  }
+
+  // A is symmetric or Hermitian, so that its projection on the Krylov space is real tridiagonal
+  template<typename T, typename Map>
+  size_t krylovExpm(const Map& A, size_t dim, T* psi, Real t, Real tol, size_t krylovDim){
+    size_t matvecs = 0;
+    Real nrm = std::sqrt(std::abs(dot(psi, psi, dim)));
+    if(dim == 0 || nrm == 0 || t == 0)
+      return 0;
+    krylovDim = std::max((size_t)1, std::min(krylovDim, dim));
+    std::vector<std::vector<T> > basis(krylovDim + 1, std::vector<T>(dim));
+    std::vector<Real> alpha, beta;
+    std::vector<T> c;
+    Real done = 0;
+    while(std::fabs(done) < std::fabs(t)){
+      Real step = t - done;
+      for(size_t i = 0; i < dim; i++)
+        basis[0][i] = psi[i] / nrm;
+      alpha.clear();
+      beta.clear();
+      std::vector<Matrix> eig;
+      size_t k = 0;
+      Real b = 0;
+      while(k < krylovDim){
+        std::vector<T>& w = basis[k + 1];
+        A(&basis[k][0], &w[0]);
+        matvecs++;
+        alpha.push_back(std::real(dot(&basis[k][0], &w[0], dim)));
+        orthogonalize(&w[0], basis, k + 1, dim);
+        orthogonalize(&w[0], basis, k + 1, dim);
+        b = std::sqrt(std::abs(dot(&w[0], &w[0], dim)));
+        k++;
+        Matrix Tk(k, k);
+        Tk.set_zero();
+        for(size_t j = 0; j < k; j++){
+          Tk.at(j, j) = alpha[j];
+          if(j + 1 < k)
+            Tk.at(j, j + 1) = Tk.at(j + 1, j) = beta[j];
+        }
+        eig = Tk.eigh();
+        // invariant subspace, the projection is exact
+        if(b < 1E-14 || k == dim){
+          b = 0;
+          break;
+        }
+        expCoefficients(eig, k, step, c);
+        if(b * std::abs(c[k - 1]) < tol)
+          break;
+        beta.push_back(b);
+        for(size_t i = 0; i < dim; i++)
+          w[i] /= b;
+      }
+      // the space is too small for the remaining time: shorten the step on the same space
+      expCoefficients(eig, k, step, c);
+      while(b * std::abs(c[k - 1]) >= tol && std::fabs(step) > std::fabs(t) * 1E-8){
+        step /= 2;
+        expCoefficients(eig, k, step, c);
+      }
+      for(size_t i = 0; i < dim; i++){
+        T sum = 0;
+        for(size_t j = 0; j < k; j++)
+          sum += c[j] * basis[j][i];
+        psi[i] = nrm * sum;
+      }
+      nrm = std::sqrt(std::abs(dot(psi, psi, dim)));
+      done += step;
+    }
+    return matvecs;
+  }
+};
+
+size_t lanczosGroundState(const LinearMap& A, size_t dim, Real* psi, Real& E0, size_t maxIter, Real tol, size_t krylovDim){
+  size_t matvecs = 0;
+  try{
+    if(dim == 0){
+      std::ostringstream err;
+      err<<"The Lanczos method needs a vector of non-zero dimension.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    krylovDim = std::max((size_t)2, std::min(krylovDim, dim));
+    Real nrm = std::sqrt(dot(psi, psi, dim));
+    if(nrm == 0){
+      elemRand(psi, dim, false);
+      nrm = std::sqrt(dot(psi, psi, dim));
+    }
+    for(size_t i = 0; i < dim; i++)
+      psi[i] /= nrm;
+    std::vector<std::vector<Real> > basis(krylovDim, std::vector<Real>(dim));
+    std::vector<Real> w(dim), alpha, beta;
+    bool converged = false;
+    while(!converged && matvecs < maxIter){
+      memcpy(&basis[0][0], psi, dim * sizeof(Real));
+      alpha.clear();
+      beta.clear();
+      Matrix ritz;
+      size_t k = 0;
+      for(; k < krylovDim && matvecs < maxIter; k++){
+        A(&basis[k][0], &w[0]);
+        matvecs++;
+        alpha.push_back(dot(&basis[k][0], &w[0], dim));
+        // twice, a single pass loses orthogonality once w is nearly in the Krylov space
+        orthogonalize(&w[0], basis, k + 1, dim);
+        orthogonalize(&w[0], basis, k + 1, dim);
+        Real b = std::sqrt(dot(&w[0], &w[0], dim));
+        // eigenpairs of the tridiagonal projection
+        Matrix T(k + 1, k + 1);
+        T.set_zero();
+        for(size_t j = 0; j <= k; j++){
+          T.at(j, j) = alpha[j];
+          if(j < k)
+            T.at(j, j + 1) = T.at(j + 1, j) = beta[j];
+        }
+        std::vector<Matrix> eig = T.eigh();
+        E0 = eig[0][0];
+        ritz = eig[1];
+        Real residual = std::fabs(b * ritz.at(0, k));
+        if(residual < tol || b < 1E-14 || k + 1 == dim){
+          converged = true;
+          k++;
+          break;
+        }
+        beta.push_back(b);
+        if(k + 1 < krylovDim)
+          for(size_t i = 0; i < dim; i++)
+            basis[k + 1][i] = w[i] / b;
+      }
+      // Ritz vector of the lowest eigenvalue, the start of the next restart
+      memset(psi, 0, dim * sizeof(Real));
+      for(size_t j = 0; j < k; j++){
+        Real c = ritz.at(0, j);
+        for(size_t i = 0; i < dim; i++)
+          psi[i] += c * basis[j][i];
+      }
+      nrm = std::sqrt(dot(psi, psi, dim));
+      for(size_t i = 0; i < dim; i++)
+        psi[i] /= nrm;
+    }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function lanczosGroundState(uni10::LinearMap&, size_t, ...):");
+  }
+  return matvecs;
+}
+
+size_t lanczosExpm(const LinearMap& A, size_t dim, Real* psi, Real t, Real tol, size_t krylovDim){
+  size_t matvecs = 0;
+  try{
+    matvecs = krylovExpm(A, dim, psi, t, tol, krylovDim);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function lanczosExpm(uni10::LinearMap&, size_t, uni10::Real*, ...):");
+  }
+  return matvecs;
+}
+
+size_t lanczosExpm(const ComplexLinearMap& A, size_t dim, Complex* psi, Real t, Real tol, size_t krylovDim){
+  size_t matvecs = 0;
+  try{
+    matvecs = krylovExpm(A, dim, psi, t, tol, krylovDim);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function lanczosExpm(uni10::ComplexLinearMap&, size_t, uni10::Complex*, ...):");
+  }
+  return matvecs;
+}
+
+size_t truncationRank(const Real* s, size_t num, int maxChi, Real cutoff, Real& discarded){
+  Real total = 0;
+  for(size_t j = 0; j < num; j++)
+    total += s[j] * s[j];
+  size_t keep = std::min(num, (size_t)std::max(1, maxChi));
+  Real tail = 0;
+  for(size_t j = keep; j < num; j++)
+    tail += s[j] * s[j];
+  while(keep > 1 && total > 0 && (tail + s[keep - 1] * s[keep - 1]) / total <= cutoff){
+    keep--;
+    tail += s[keep] * s[keep];
+  }
+  discarded = total > 0 ? tail / total : 0;
+  return keep;
+}
+
+std::vector<Matrix> truncatedSvd(const Block& M, int maxChi, Real cutoff, Real& discarded){
+  std::vector<Matrix> usv;
+  try{
+    usv = M.svd();
+    size_t num = usv[1].row();
+    size_t keep = truncationRank(usv[1].getElem(), num, maxChi, cutoff, discarded);
+    if(keep < num){
+      usv[0].resize(usv[0].row(), keep);
+      usv[1].resize(keep, keep);
+      usv[2].resize(keep, usv[2].col());
+    }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function truncatedSvd(uni10::Block&, int, uni10::Real, uni10::Real&):");
+  }
+  return usv;
+}
+
+std::vector<UniTensor> truncatedSvd(const UniTensor& T, int maxChi, Real cutoff, Real& discarded){
+  std::vector<UniTensor> usv;
+  try{
+    if(T.typeID() != 1){
+      std::ostringstream err;
+      err<<"Only real tensors are supported.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    const std::map<Qnum, Block>& blocks = T.const_getBlocks();
+    std::vector<Qnum> qnums;
+    std::vector<std::vector<Matrix> > svds;
+    std::vector<std::pair<Real, size_t> > values;
+    for(std::map<Qnum, Block>::const_iterator it = blocks.begin(); it != blocks.end(); ++it){
+      if(!it->second.row() || !it->second.col())
+        continue;
+      qnums.push_back(it->first);
+      svds.push_back(it->second.svd());
+      const Real* S = svds.back()[1].getElem();
+      for(size_t i = 0; i < svds.back()[1].row(); i++)
+        values.push_back(std::make_pair(S[i], qnums.size() - 1));
+    }
+    if(values.empty()){
+      std::ostringstream err;
+      err<<"The tensor has no element to decompose.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    std::sort(values.begin(), values.end(), std::greater<std::pair<Real, size_t> >());
+    std::vector<Real> s(values.size());
+    for(size_t i = 0; i < values.size(); i++)
+      s[i] = values[i].first;
+    size_t keep = truncationRank(&s[0], s.size(), maxChi, cutoff, discarded);
+    // the values of a block are in decreasing order, the first ones of each block are kept
+    std::vector<size_t> kept(qnums.size(), 0);
+    for(size_t i = 0; i < keep; i++)
+      kept[values[i].second]++;
+    std::vector<Qnum> kqnums;
+    for(size_t b = 0; b < qnums.size(); b++)
+      kqnums.insert(kqnums.end(), kept[b], qnums[b]);
+
+    std::vector<Bond> bondU, bondS, bondV;
+    for(size_t i = 0; i < T.bondNum(); i++)
+      (i < T.inBondNum() ? bondU : bondV).push_back(T.bond(i));
+    bondU.push_back(Bond(BD_OUT, kqnums));
+    bondS.push_back(Bond(BD_IN, kqnums));
+    bondS.push_back(Bond(BD_OUT, kqnums));
+    bondV.insert(bondV.begin(), Bond(BD_IN, kqnums));
+    usv.push_back(UniTensor(bondU));
+    usv.push_back(UniTensor(bondS));
+    usv.push_back(UniTensor(bondV));
+    for(size_t t = 0; t < 3; t++)
+      usv[t].set_zero();
+    for(size_t b = 0; b < qnums.size(); b++){
+      size_t k = kept[b];
+      if(k == 0)
+        continue;
+      std::vector<Matrix>& f = svds[b];
+      f[0].resize(f[0].row(), k);
+      f[1].resize(k, k);
+      f[2].resize(k, f[2].col());
+      usv[0].putBlock(qnums[b], f[0]);
+      usv[1].putBlock(qnums[b], f[1]);
+      usv[2].putBlock(qnums[b], f[2]);
+    }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function truncatedSvd(uni10::UniTensor&, int, uni10::Real, uni10::Real&):");
+  }
+  return usv;
+}
+
+};	/* namespace uni10 */
@@ -0,0 +1,293 @@
+/****************************************************************************
+*  @file TDVP.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file of the TDVP time evolution of an MPS
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/algorithm/TDVP.h>
+#include <uni10/algorithm/EffectiveHamiltonian.h>
+#include <uni10/algorithm/Solvers.h>
+#include <uni10/tools/uni10_tools.h>
+#include <uni10/tools/uni10_trace.h>
+#include <cmath>
+namespace uni10{
+
+namespace{
+  void elements(UniTensor T, std::vector<Real>& v){
+    v.assign(T.getElem(), T.getElem() + T.elemNum());
+  }
+  void elements(UniTensor T, std::vector<Complex>& v){
+    if(T.typeID() == 1)
+      RtoC(T);
+    v.assign(T.getElem(CTYPE), T.getElem(CTYPE) + T.elemNum());
+  }
+
+  // Dense k x k elements of the diagonal matrix S, of a real or a complex SVD
+  void diagElements(const Matrix& S, std::vector<Real>& v){
+    size_t k = S.row();
+    v.assign(k * k, 0);
+    for(size_t j = 0; j < k; j++)
+      v[j * k + j] = S.getElem()[j];
+  }
+  void diagElements(const Matrix& S, std::vector<Complex>& v){
+    size_t k = S.row();
+    v.assign(k * k, 0);
+    for(size_t j = 0; j < k; j++)
+      v[j * k + j] = S.typeID() == 2 ? S.getElem(CTYPE)[j] : Complex(S.getElem()[j]);
+  }
+};
+
+TDVPParams::TDVPParams(): maxChi(64), cutoff(1E-10), twoSite(true), krylovTol(1E-12), krylovDim(30){}
+
+TDVP::TDVP(MPS& _psi, const MPO& _H, const TDVPParams& _params): psi(_psi), H(_H), params(_params), env(_psi, _H),
+  m_energy(0), m_time(0), m_realTime(0), m_discarded(0), m_matvecs(0){
+  try{
+    if(psi.size() != H.size() || psi.size() < 2){
+      std::ostringstream err;
+      err<<"TDVP needs an MPS and an MPO of the same number of sites, at least two.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    if(psi.center() != 0)
+      psi.moveCenter(0);
+    psi.normalize();
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor TDVP::TDVP(uni10::MPS&, uni10::MPO&, uni10::TDVPParams&):");
+  }
+}
+
+// v <- e^{t H} v normalized
+void TDVP::evolve(EffectiveHamiltonian& Heff, std::vector<Real>& v, Real t){
+  size_t dim = v.size();
+  m_matvecs += lanczosExpm(Heff.map(), dim, &v[0], t, params.krylovTol, params.krylovDim);
+  Real nrm = 0;
+  for(size_t i = 0; i < dim; i++)
+    nrm += v[i] * v[i];
+  nrm = std::sqrt(nrm);
+  for(size_t i = 0; i < dim; i++)
+    v[i] /= nrm;
+}
+
+// v <- e^{i t H} v normalized, so that the sweeps evolve forward in real time with the same t < 0 as in
+// imaginary time
+void TDVP::evolve(EffectiveHamiltonian& Heff, std::vector<Complex>& v, Real t){
+  size_t dim = v.size();
+  m_matvecs += lanczosExpm(Heff.complexMap(), dim, &v[0], -t, params.krylovTol, params.krylovDim);
+  Real nrm = 0;
+  for(size_t i = 0; i < dim; i++)
+    nrm += std::norm(v[i]);
+  nrm = std::sqrt(nrm);
+  for(size_t i = 0; i < dim; i++)
+    v[i] /= nrm;
+}
+
+// Evolves each pair forward by tau and, but at the end of the chain, the site left as the center backward
+void TDVP::sweepTwoSite(Real tau, bool toRight){
+  size_t L = psi.size();
+  int labelA[] = {1, 2, 100}, labelB[] = {100, 3, 4}, labelTheta[] = {1, 2, 3, 4};
+  for(size_t n = 0; n + 1 < L; n++){
+    size_t i = toRight ? n : L - 2 - n;
+    UniTensor A = psi[i], B = psi[i + 1];
+    A.setLabel(labelA);
+    B.setLabel(labelB);
+    UniTensor theta = contract(A, B, true);
+    theta.permute(labelTheta, 2);
+    std::vector<Real> v;
+    elements(theta, v);
+    {
+      EffectiveHamiltonian Heff(env.left(i), H[i], H[i + 1], env.right(i + 2));
+      evolve(Heff, v, -tau);
+    }
+    int l = psi.bondDim(i), d1 = psi.physDim(i), d2 = psi.physDim(i + 1), r = psi.bondDim(i + 2);
+    Real discarded;
+    std::vector<Matrix> usv = truncatedSvd(Matrix(l * d1, d2 * r, &v[0]), params.maxChi, params.cutoff, discarded);
+    usv[1] *= 1.0 / usv[1].norm();
+    m_discarded = std::max(m_discarded, discarded);
+    int k = usv[1].row();
+    size_t center = toRight ? i + 1 : i;
+    if(toRight)
+      psi.setSites(i, MPS::siteTensor(l, d1, k, usv[0]), MPS::siteTensor(k, d2, r, usv[1] * usv[2], 1), center);
+    else
+      psi.setSites(i, MPS::siteTensor(l, d1, k, usv[0] * usv[1]), MPS::siteTensor(k, d2, r, usv[2], 1), center);
+    psi.setLambda(i + 1, usv[1]);
+    env.invalidate(i);
+    env.invalidate(i + 1);
+    if(toRight ? i + 2 == L : i == 0)
+      continue;
+    elements(psi[center], v);
+    {
+      EffectiveHamiltonian Heff(env.left(center), H[center], env.right(center + 1));
+      evolve(Heff, v, tau);
+    }
+    int lc = psi.bondDim(center), rc = psi.bondDim(center + 1), dc = psi.physDim(center);
+    psi.setSite(center, MPS::siteTensor(lc, dc, rc, Matrix(lc * dc, rc, &v[0])));
+    env.invalidate(center);
+  }
+}
+
+// Evolves each site forward by tau and, but at the end of the chain, the bond to the next site backward;
+// in imaginary time for real elements T and in real time for complex ones
+template<typename T>
+void TDVP::sweepOneSite(Real tau, bool toRight){
+  size_t L = psi.size();
+  for(size_t n = 0; n < L; n++){
+    size_t i = toRight ? n : L - 1 - n;
+    int l = psi.bondDim(i), d = psi.physDim(i), r = psi.bondDim(i + 1);
+    std::vector<T> v;
+    elements(psi[i], v);
+    {
+      EffectiveHamiltonian Heff(env.left(i), H[i], env.right(i + 1));
+      evolve(Heff, v, -tau);
+    }
+    if(toRight ? i + 1 == L : i == 0){
+      psi.setSite(i, MPS::siteTensor(l, d, r, Matrix(l * d, r, &v[0])));
+      env.invalidate(i);
+      continue;
+    }
+    // split off the bond matrix S, the neighbour takes the unitary factor so that both stay normalized
+    size_t next = toRight ? i + 1 : i - 1;
+    int dn = psi.physDim(next);
+    size_t bond = toRight ? i + 1 : i;
+    std::vector<Matrix> usv;
+    int k;
+    if(toRight){
+      usv = Matrix(l * d, r, &v[0]).svd();
+      k = usv[1].row();
+      UniTensor B = psi[next];
+      B.permute(1);
+      psi.setSites(i, MPS::siteTensor(l, d, k, usv[0]),
+          MPS::siteTensor(k, dn, psi.bondDim(next + 1), usv[2] * B.const_getBlock(), 1), next);
+    }
+    else{
+      usv = Matrix(l, d * r, &v[0]).svd();
+      k = usv[1].row();
+      psi.setSites(next, MPS::siteTensor(psi.bondDim(next), dn, k, psi[next].const_getBlock() * usv[0]),
+          MPS::siteTensor(k, d, r, usv[2], 1), next);
+    }
+    env.invalidate(i);
+    env.invalidate(next);
+    diagElements(usv[1], v);
+    {
+      EffectiveHamiltonian Heff(env.left(bond), env.right(bond));
+      evolve(Heff, v, tau);
+    }
+    Matrix C(k, k, &v[0]);
+    if(toRight){
+      UniTensor B = psi[next];
+      B.permute(1);
+      psi.setSite(next, MPS::siteTensor(k, dn, psi.bondDim(next + 1), C * B.const_getBlock(), 1));
+    }
+    else
+      psi.setSite(next, MPS::siteTensor(psi.bondDim(next), dn, k, psi[next].const_getBlock() * C));
+    env.invalidate(next);
+  }
+}
+
+Real TDVP::step(Real tau){
+  try{
+    UNI10_TRACE_SCOPE(trace, "tdvp step", "tdvp");
+    for(size_t i = 0; i < psi.size(); i++)
+      if(psi[i].typeID() == 2){
+        std::ostringstream err;
+        err<<"The imaginary time evolution needs a real MPS, site " << i << " is complex.";
+        throw std::runtime_error(exception_msg(err.str()));
+      }
+    m_discarded = 0;
+    if(psi.center() != 0)
+      psi.moveCenter(0);
+    if(params.twoSite){
+      sweepTwoSite(tau / 2, true);
+      sweepTwoSite(tau / 2, false);
+    }
+    else{
+      sweepOneSite<Real>(tau / 2, true);
+      sweepOneSite<Real>(tau / 2, false);
+    }
+    m_time += tau;
+    m_energy = env.expectation(0);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function TDVP::step(uni10::Real):");
+  }
+  return m_energy;
+}
+
+Real TDVP::realTimeStep(Real dt){
+  try{
+    UNI10_TRACE_SCOPE(trace, "tdvp real time step", "tdvp");
+    if(params.twoSite){
+      std::ostringstream err;
+      err<<"The real time evolution needs the one-site integrator, set TDVPParams::twoSite to false.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    m_discarded = 0;
+    if(psi.center() != 0)
+      psi.moveCenter(0);
+    bool real = false;
+    for(size_t i = 0; i < psi.size(); i++)
+      real = real || psi[i].typeID() == 1;
+    if(real){  // the sites become complex once, at the first step
+      std::vector<UniTensor> sites(psi.size());
+      for(size_t i = 0; i < psi.size(); i++){
+        sites[i] = psi[i];
+        if(sites[i].typeID() == 1)
+          RtoC(sites[i]);
+      }
+      psi = MPS(sites, 0);
+      env.invalidate();
+    }
+    sweepOneSite<Complex>(dt / 2, true);
+    sweepOneSite<Complex>(dt / 2, false);
+    m_realTime += dt;
+    m_energy = env.expectation(0);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function TDVP::realTimeStep(uni10::Real):");
+  }
+  return m_energy;
+}
+
+Real TDVP::energy()const{
+  return m_energy;
+}
+
+Real TDVP::time()const{
+  return m_time;
+}
+
+Real TDVP::realTime()const{
+  return m_realTime;
+}
+
+Real TDVP::discarded()const{
+  return m_discarded;
+}
+
+size_t TDVP::matvecs()const{
+  return m_matvecs;
+}
+
+};	/* namespace uni10 */
@@ -0,0 +1,567 @@
+/****************************************************************************
+*  @file TEBD.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file of the TEBD and iTEBD time evolution
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/algorithm/TEBD.h>
+#include <uni10/algorithm/Solvers.h>
+#include <uni10/numeric/lapack/uni10_lapack.h>
+#include <uni10/tools/uni10_tools.h>
+#include <uni10/tools/uni10_trace.h>
+#include <algorithm>
+#include <cmath>
+#include <exception>
+namespace uni10{
+
+namespace{
+  // Schmidt values below are treated as zero when they are divided out
+  const Real LAMBDA_EPS = 1E-14;
+  enum{BUF_X, BUF_THETA, BUF_GATED, BUF_U, BUF_VT, BUF_WORK, BUF_GATE, BUF_NUM};
+
+  inline Real inverse(Real x){
+    return x > LAMBDA_EPS ? 1 / x : 0;
+  }
+  inline Real absSq(Real x){
+    return x * x;
+  }
+  inline Real absSq(const Complex& x){
+    return std::norm(x);
+  }
+  inline Real conjugate(Real x){
+    return x;
+  }
+  inline Complex conjugate(const Complex& x){
+    return std::conj(x);
+  }
+  inline Real realPart(Real x){
+    return x;
+  }
+  inline Real realPart(const Complex& x){
+    return x.real();
+  }
+
+  // Divide and conquer SVD of the m x n matrix M, which is destroyed, with the workspaces grown on demand
+  void svd(Real* M, int m, int n, Real* U, Real* S, Real* vT, std::vector<Real>& work, std::vector<Real>& /* rwork */,
+      std::vector<int>& iwork){
+    if(iwork.size() < (size_t)(8 * std::min(m, n)))
+      iwork.resize(8 * std::min(m, n));
+    Real size;
+    matrixSVD(M, m, n, U, S, vT, &size, -1, &iwork[0], false);
+    if(work.size() < (size_t)size)
+      work.resize((size_t)size);
+    matrixSVD(M, m, n, U, S, vT, &work[0], (int)work.size(), &iwork[0], false);
+  }
+  void svd(Complex* M, int m, int n, Complex* U, Real* S, Complex* vT, std::vector<Complex>& work,
+      std::vector<Real>& rwork, std::vector<int>& iwork){
+    if(iwork.size() < (size_t)(8 * std::min(m, n)))
+      iwork.resize(8 * std::min(m, n));
+    if(rwork.size() < svdRworkSize(m, n))
+      rwork.resize(svdRworkSize(m, n));
+    Complex size;
+    matrixSVD(M, m, n, U, S, vT, &size, -1, &rwork[0], &iwork[0], false);
+    if(work.size() < (size_t)size.real())
+      work.resize((size_t)size.real());
+    matrixSVD(M, m, n, U, S, vT, &work[0], (int)work.size(), &rwork[0], &iwork[0], false);
+  }
+
+  // Elements of a dense square matrix in the scalar type of the state
+  void copyElem(const Matrix& mat, std::vector<Real>& elem){
+    size_t num = mat.row() * mat.col();
+    elem.assign(mat.getElem(), mat.getElem() + num);
+  }
+  void copyElem(const Matrix& mat, std::vector<Complex>& elem){
+    size_t num = mat.row() * mat.col();
+    if(mat.typeID() == 2)
+      elem.assign(mat.getElem(CTYPE), mat.getElem(CTYPE) + num);
+    else
+      elem.assign(mat.getElem(), mat.getElem() + num);
+  }
+
+  // theta[a, s, t, e] = lamL[a] gi[a, s, c] lamM[c] gj[c, t, e], lamL and lamM are multiplied in while gi is
+  // copied to X and the sum over c is one GEMM
+  template<typename T>
+  void joinSites(const std::vector<T>& gi, const std::vector<T>& gj, const std::vector<Real>& lamL,
+      const std::vector<Real>& lamM, int d1, int d2, size_t r, std::vector<T>& X, std::vector<T>& theta){
+    size_t l = lamL.size(), m = lamM.size();
+    X.resize(l * d1 * m);
+    for(size_t a = 0; a < l; a++)
+      for(int s = 0; s < d1; s++){
+        const T* src = &gi[(a * d1 + s) * m];
+        T* des = &X[(a * d1 + s) * m];
+        for(size_t c = 0; c < m; c++)
+          des[c] = lamL[a] * lamM[c] * src[c];
+      }
+    theta.resize(l * d1 * d2 * r);
+    matrixMul(&X[0], const_cast<T*>(&gj[0]), l * d1, d2 * r, m, &theta[0], false, false, false, false, false);
+  }
+
+  // out[a, p, e] = lamR[e] sum_q G[p, q] theta[a, q, e], where p and q are the pairs of physical indices
+  template<typename T>
+  void applyPhysical(const T* G, int D, const std::vector<T>& theta, const std::vector<Real>& lamR, size_t l,
+      std::vector<T>& out){
+    size_t r = lamR.size();
+    out.resize(l * D * r);
+    for(size_t a = 0; a < l; a++)
+      for(int p = 0; p < D; p++){
+        T* o = &out[(a * D + p) * r];
+        std::fill(o, o + r, T(0));
+        for(int q = 0; q < D; q++){
+          T g = G[p * D + q];
+          if(g == T(0))
+            continue;
+          const T* t = &theta[(a * D + q) * r];
+          for(size_t e = 0; e < r; e++)
+            o[e] += g * t[e];
+        }
+        for(size_t e = 0; e < r; e++)
+          o[e] *= lamR[e];
+      }
+  }
+
+  // Applies the gate G to lamL gi lamM gj lamR, truncates and splits the result back into gi, lamM and gj
+  template<typename T>
+  Real gateKernel(std::vector<T>& gi, std::vector<T>& gj, const std::vector<Real>& lamL, std::vector<Real>& lamM,
+      const std::vector<Real>& lamR, int d1, int d2, const T* G, std::vector<std::vector<T> >& buf,
+      std::vector<Real>& S, std::vector<Real>& rwork, std::vector<int>& iwork, int maxChi, Real cutoff){
+    size_t l = lamL.size(), r = lamR.size();
+    joinSites(gi, gj, lamL, lamM, d1, d2, r, buf[BUF_X], buf[BUF_THETA]);
+    applyPhysical(G, d1 * d2, buf[BUF_THETA], lamR, l, buf[BUF_GATED]);
+    int M = l * d1, N = d2 * r, K = std::min(M, N);
+    buf[BUF_U].resize((size_t)M * K);
+    buf[BUF_VT].resize((size_t)K * N);
+    S.resize(K);
+    svd(&buf[BUF_GATED][0], M, N, &buf[BUF_U][0], &S[0], &buf[BUF_VT][0], buf[BUF_WORK], rwork, iwork);
+    Real discarded;
+    size_t k = truncationRank(&S[0], K, maxChi, cutoff, discarded);
+    Real nrm = 0;
+    for(size_t c = 0; c < k; c++)
+      nrm += S[c] * S[c];
+    nrm = std::sqrt(nrm);
+    if(nrm == 0){
+      std::ostringstream err;
+      err<<"The gate annihilates the state.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    lamM.resize(k);
+    for(size_t c = 0; c < k; c++)
+      lamM[c] = S[c] / nrm;
+    // the Schmidt values of the outer bonds are divided out while U and VT are copied back
+    gi.resize(l * d1 * k);
+    for(size_t a = 0; a < l; a++){
+      Real inv = inverse(lamL[a]);
+      for(int s = 0; s < d1; s++){
+        const T* src = &buf[BUF_U][(a * d1 + s) * K];
+        T* des = &gi[(a * d1 + s) * k];
+        for(size_t c = 0; c < k; c++)
+          des[c] = inv * src[c];
+      }
+    }
+    gj.resize(k * d2 * r);
+    for(size_t c = 0; c < k; c++)
+      for(int t = 0; t < d2; t++){
+        const T* src = &buf[BUF_VT][c * N + t * r];
+        T* des = &gj[(c * d2 + t) * r];
+        for(size_t e = 0; e < r; e++)
+          des[e] = inverse(lamR[e]) * src[e];
+      }
+    return discarded;
+  }
+
+  // <op> of the site lamL g lamR
+  template<typename T>
+  Real siteExpectation(const std::vector<T>& g, const std::vector<Real>& lamL, const std::vector<Real>& lamR, int d,
+      const std::vector<T>& op){
+    size_t l = lamL.size(), r = lamR.size();
+    T num = 0;
+    Real den = 0;
+    for(size_t a = 0; a < l; a++)
+      for(size_t c = 0; c < r; c++){
+        Real w = lamL[a] * lamL[a] * lamR[c] * lamR[c];
+        for(int s = 0; s < d; s++){
+          T bra = conjugate(g[(a * d + s) * r + c]);
+          den += w * absSq(bra);
+          for(int t = 0; t < d; t++)
+            num += w * bra * op[s * d + t] * g[(a * d + t) * r + c];
+        }
+      }
+    return realPart(num) / den;
+  }
+
+  // <op> of the two sites lamL gi lamM gj lamR
+  template<typename T>
+  Real twoSiteExpectation(const std::vector<T>& gi, const std::vector<T>& gj, const std::vector<Real>& lamL,
+      const std::vector<Real>& lamM, const std::vector<Real>& lamR, int d1, int d2, const std::vector<T>& op){
+    std::vector<T> X, theta, out;
+    size_t l = lamL.size(), r = lamR.size();
+    joinSites(gi, gj, lamL, lamM, d1, d2, r, X, theta);
+    applyPhysical(&op[0], d1 * d2, theta, lamR, l, out);
+    T num = 0;
+    Real den = 0;
+    for(size_t i = 0; i < theta.size(); i++){
+      T ket = theta[i] * lamR[i % r];
+      num += conjugate(ket) * out[i];
+      den += absSq(ket);
+    }
+    return realPart(num) / den;
+  }
+};
+
+TEBDParams::TEBDParams(): maxChi(64), cutoff(1E-10), threads(0){}
+
+TEBD::TEBD(): m_infinite(false), m_complex(false), m_applications(0){}
+
+TEBD::TEBD(const MPS& psi, const TEBDParams& _params): params(_params), m_infinite(false), m_complex(false),
+  m_applications(0){
+  try{
+    size_t L = psi.size();
+    if(L < 2){
+      std::ostringstream err;
+      err<<"TEBD needs a chain of at least two sites.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    MPS phi(psi);
+    phi.canonicalize(0);
+    phi.normalize();
+    lambdas.assign(L + 1, std::vector<Real>(1, 1));
+    for(size_t b = 1; b < L; b++){
+      const Matrix& lam = phi.lambda(b);
+      lambdas[b].assign(lam.getElem(), lam.getElem() + lam.row());
+    }
+    // the sites right of the center are lambda-normalized, A = Gamma lambda
+    dims.resize(L);
+    gammaR.resize(L);
+    for(size_t i = 0; i < L; i++){
+      dims[i] = phi.physDim(i);
+      const Block& A = phi[i].const_getBlock();
+      const Real* elem = A.getElem();
+      const std::vector<Real>& lamR = lambdas[i + 1];
+      size_t r = lamR.size();
+      gammaR[i].resize(A.row() * A.col());
+      for(size_t n = 0; n < gammaR[i].size(); n++)
+        gammaR[i][n] = elem[n] * inverse(lamR[n % r]);
+    }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor TEBD::TEBD(uni10::MPS&, uni10::TEBDParams&):");
+  }
+}
+
+TEBD TEBD::infinite(size_t n, const std::vector<Real>& local, const TEBDParams& params){
+  TEBD tebd;
+  try{
+    if(n < 2 || n % 2){
+      std::ostringstream err;
+      err<<"The unit cell of an infinite chain must have an even number of sites, not " << n << ".";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    Real nrm = 0;
+    for(size_t s = 0; s < local.size(); s++)
+      nrm += local[s] * local[s];
+    if(nrm == 0){
+      std::ostringstream err;
+      err<<"The local state of the product state is zero.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    nrm = std::sqrt(nrm);
+    tebd.params = params;
+    tebd.m_infinite = true;
+    tebd.dims.assign(n, local.size());
+    tebd.lambdas.assign(n, std::vector<Real>(1, 1));
+    tebd.gammaR.assign(n, local);
+    for(size_t i = 0; i < n; i++)
+      for(size_t s = 0; s < local.size(); s++)
+        tebd.gammaR[i][s] /= nrm;
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function TEBD::infinite(size_t, std::vector<uni10::Real>&, uni10::TEBDParams&):");
+  }
+  return tebd;
+}
+
+size_t TEBD::size()const{
+  return dims.size();
+}
+
+bool TEBD::isInfinite()const{
+  return m_infinite;
+}
+
+bool TEBD::isComplex()const{
+  return m_complex;
+}
+
+int TEBD::physDim(size_t i)const{
+  if(i >= dims.size()){
+    std::ostringstream err;
+    err<<"Site " << i << " is out of the chain of " << dims.size() << " sites.";
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+  return dims[i];
+}
+
+const std::vector<Real>& TEBD::lambdaOf(size_t b)const{
+  return m_infinite ? lambdas[b % lambdas.size()] : lambdas[b];
+}
+
+int TEBD::bondDim(size_t b)const{
+  if(b >= lambdas.size()){
+    std::ostringstream err;
+    err<<"Bond " << b << " is out of the chain of " << dims.size() << " sites.";
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+  return lambdas[b].size();
+}
+
+Matrix TEBD::lambda(size_t b)const{
+  bondDim(b);
+  return Matrix(lambdas[b].size(), lambdas[b].size(), &lambdas[b][0], true);
+}
+
+size_t TEBD::gateNum()const{
+  return m_infinite ? dims.size() : dims.size() - 1;
+}
+
+size_t TEBD::applications()const{
+  return m_applications;
+}
+
+void TEBD::checkGate(size_t i, const Matrix& gate)const{
+  if(i >= gateNum()){
+    std::ostringstream err;
+    err<<"There is no gate on the sites " << i << " and " << i + 1 << " of the chain of " << dims.size() << " sites.";
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+  size_t D = dims[i] * dims[(i + 1) % dims.size()];
+  if(gate.row() != D || gate.col() != D || gate.isDiag()){
+    std::ostringstream err;
+    err<<"The gate on the sites " << i << " and " << i + 1 << " must be a dense " << D << " x " << D << " matrix.";
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+}
+
+void TEBD::toComplex(){
+  if(m_complex)
+    return;
+  gammaC.resize(gammaR.size());
+  for(size_t i = 0; i < gammaR.size(); i++){
+    gammaC[i].assign(gammaR[i].begin(), gammaR[i].end());
+    std::vector<Real>().swap(gammaR[i]);
+  }
+  m_complex = true;
+}
+
+Real TEBD::apply(size_t i, const Matrix& gate, Workspace& ws){
+  size_t j = (i + 1) % dims.size();
+  std::vector<Real>& lamM = lambdas[m_infinite ? j : i + 1];
+  if(m_complex){
+    ws.complex.resize(BUF_NUM);
+    copyElem(gate, ws.complex[BUF_GATE]);
+    return gateKernel(gammaC[i], gammaC[j], lambdaOf(i), lamM, lambdaOf(i + 2), dims[i], dims[j],
+        &ws.complex[BUF_GATE][0], ws.complex, ws.S, ws.rwork, ws.iwork, params.maxChi, params.cutoff);
+  }
+  ws.real.resize(BUF_NUM);
+  copyElem(gate, ws.real[BUF_GATE]);
+  return gateKernel(gammaR[i], gammaR[j], lambdaOf(i), lamM, lambdaOf(i + 2), dims[i], dims[j],
+      &ws.real[BUF_GATE][0], ws.real, ws.S, ws.rwork, ws.iwork, params.maxChi, params.cutoff);
+}
+
+Real TEBD::applyGate(size_t i, const Matrix& gate){
+  Real discarded = 0;
+  try{
+    checkGate(i, gate);
+    if(gate.typeID() == 2)
+      toComplex();
+    if(work.empty())
+      work.resize(1);
+    discarded = apply(i, gate, work[0]);
+    m_applications++;
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function TEBD::applyGate(size_t, uni10::Matrix&):");
+  }
+  return discarded;
+}
+
+Real TEBD::applyLayer(const std::vector<Matrix>& gates, int parity){
+  Real discarded = 0;
+  try{
+    UNI10_TRACE_SCOPE(trace, "tebd layer", "tebd");
+    if(parity != 0 && parity != 1){
+      std::ostringstream err;
+      err<<"The parity of a layer must be 0 or 1, not " << parity << ".";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    if(gates.size() != 1 && gates.size() != gateNum()){
+      std::ostringstream err;
+      err<<"A layer needs one gate, or one gate per pair of sites (" << gateNum() << "), not " << gates.size() << ".";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    std::vector<size_t> sites;
+    double cost = 0;
+    for(size_t i = parity; i < gateNum(); i += 2){
+      const Matrix& gate = gates[gates.size() == 1 ? 0 : i];
+      checkGate(i, gate);
+      if(gate.typeID() == 2)
+        toComplex();
+      sites.push_back(i);
+      size_t j = (i + 1) % dims.size();
+      cost += (double)bondDim(i) * dims[i] * lambdaOf(i + 1).size() * dims[j] * lambdaOf(i + 2).size();
+    }
+    size_t threadNum = taskThreads(params.threads, sites.size(), cost);
+    if(work.size() < threadNum)
+      work.resize(threadNum);
+    std::vector<Real> discards(sites.size(), 0);
+    // the gates of a layer touch disjoint sites and bonds, each thread has its own buffers
+    parallelTasks(sites.size(), threadNum, [&](size_t g, size_t t){
+      discards[g] = apply(sites[g], gates[gates.size() == 1 ? 0 : sites[g]], work[t]);
+    });
+    m_applications += sites.size();
+    for(size_t g = 0; g < discards.size(); g++)
+      discarded = std::max(discarded, discards[g]);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function TEBD::applyLayer(std::vector<uni10::Matrix>&, int):");
+  }
+  return discarded;
+}
+
+Real TEBD::step(const std::vector<Matrix>& gates){
+  Real discarded = applyLayer(gates, 0);
+  return std::max(discarded, applyLayer(gates, 1));
+}
+
+Real TEBD::expectation(size_t i, const Matrix& op)const{
+  try{
+    int d = physDim(i);
+    if(op.row() != (size_t)d || op.col() != (size_t)d || op.isDiag()){
+      std::ostringstream err;
+      err<<"The operator on site " << i << " must be a dense " << d << " x " << d << " matrix.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    if(m_complex || op.typeID() == 2){
+      std::vector<Complex> elem;
+      copyElem(op, elem);
+      if(m_complex)
+        return siteExpectation(gammaC[i], lambdaOf(i), lambdaOf(i + 1), d, elem);
+      std::vector<Complex> g(gammaR[i].begin(), gammaR[i].end());
+      return siteExpectation(g, lambdaOf(i), lambdaOf(i + 1), d, elem);
+    }
+    std::vector<Real> elem;
+    copyElem(op, elem);
+    return siteExpectation(gammaR[i], lambdaOf(i), lambdaOf(i + 1), d, elem);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function TEBD::expectation(size_t, uni10::Matrix&):");
+  }
+  return 0;
+}
+
+Real TEBD::bondExpectation(size_t i, const Matrix& op)const{
+  try{
+    checkGate(i, op);
+    size_t j = (i + 1) % dims.size();
+    if(m_complex || op.typeID() == 2){
+      std::vector<Complex> elem;
+      copyElem(op, elem);
+      if(m_complex)
+        return twoSiteExpectation(gammaC[i], gammaC[j], lambdaOf(i), lambdaOf(i + 1), lambdaOf(i + 2), dims[i],
+            dims[j], elem);
+      std::vector<Complex> gi(gammaR[i].begin(), gammaR[i].end()), gj(gammaR[j].begin(), gammaR[j].end());
+      return twoSiteExpectation(gi, gj, lambdaOf(i), lambdaOf(i + 1), lambdaOf(i + 2), dims[i], dims[j], elem);
+    }
+    std::vector<Real> elem;
+    copyElem(op, elem);
+    return twoSiteExpectation(gammaR[i], gammaR[j], lambdaOf(i), lambdaOf(i + 1), lambdaOf(i + 2), dims[i],
+        dims[j], elem);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function TEBD::bondExpectation(size_t, uni10::Matrix&):");
+  }
+  return 0;
+}
+
+MPS TEBD::toMPS()const{
+  try{
+    if(m_infinite || m_complex){
+      std::ostringstream err;
+      err<<"Only a real finite chain converts to an MPS.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    size_t L = dims.size();
+    std::vector<UniTensor> sites(L);
+    for(size_t i = 0; i < L; i++){
+      const std::vector<Real>& lamL = lambdas[i];
+      size_t l = lamL.size(), r = lambdas[i + 1].size();
+      std::vector<Real> elem(gammaR[i]);
+      for(size_t n = 0; n < elem.size(); n++)
+        elem[n] *= lamL[n / (dims[i] * r)];
+      sites[i] = MPS::siteTensor(l, dims[i], r, Matrix(l * dims[i], r, elem));
+    }
+    // lambda Gamma is only left-normalized up to the errors of non-unitary gates
+    MPS psi(sites);
+    psi.canonicalize(L - 1);
+    psi.normalize();
+    return psi;
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function TEBD::toMPS():");
+  }
+  return MPS();
+}
+
+Matrix TEBD::imaginaryTimeGate(const Matrix& h, Real tau){
+  return takeExp(-tau, h);
+}
+
+Matrix TEBD::realTimeGate(const Matrix& h, Real dt){
+  try{
+    if(h.typeID() != 1 || h.row() != h.col()){
+      std::ostringstream err;
+      err<<"The bond Hamiltonian of a real time gate must be a real square matrix.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    // h = U^T D U with the eigenvectors as the rows of U
+    std::vector<Matrix> rets = h.eigh();
+    size_t D = h.row();
+    const Real* eig = rets[0].getElem();
+    const Real* U = rets[1].getElem();
+    std::vector<Complex> elem(D * D, 0);
+    for(size_t k = 0; k < D; k++){
+      Complex phase = std::exp(Complex(0, -dt * eig[k]));
+      for(size_t p = 0; p < D; p++)
+        for(size_t q = 0; q < D; q++)
+          elem[p * D + q] += U[k * D + p] * phase * U[k * D + q];
+    }
+    return Matrix(D, D, elem);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function TEBD::realTimeGate(uni10::Matrix&, uni10::Real):");
+  }
+  return Matrix();
+}
+
+};	/* namespace uni10 */
@@ -326,6 +326,18 @@ namespace uni10{
 	    /*********************  REAL **********************/
 
 	    Block(rflag _tp, size_t _Rnum, size_t _Cnum, bool _diag = false);
+        ///
+        /// @brief Create a Block on top of an existing real buffer
+        ///
+        /// The Block refers to \c _elem directly and does not take ownership of it. The caller must keep
+        /// the buffer alive, and at least <tt> Rnum*Cnum </tt> (or <tt> min(Rnum, Cnum)</tt> if \c diag is
+        /// \c true) elements long, for as long as the Block is in use.
+        ///
+        /// @param _Rnum Number of rows
+        /// @param _Cnum Number of columns
+        /// @param _elem Pointer to the row-major elements
+        /// @param _diag Set \c true for a diagonal matrix, defaults to \c false
+	    Block(size_t _Rnum, size_t _Cnum, Real* _elem, bool _diag = false);
 	    void save(rflag _tp, const std::string& fname)const;
 	    std::vector<Matrix> qr(rflag tp)const;
 	    std::vector<Matrix> rq(rflag tp)const;
@@ -348,6 +360,10 @@ namespace uni10{
 	    /*********************  COMPLEX **********************/
 
         Block(cflag _tp, size_t _Rnum, size_t _Cnum, bool _diag = false);
+        /// @brief Create a Block on top of an existing complex buffer
+        ///
+        /// @see Block(size_t, size_t, Real*, bool)
+	    Block(size_t _Rnum, size_t _Cnum, Complex* _elem, bool _diag = false);
 	    void save(cflag _tp, const std::string& fname)const;
 	    std::vector<Matrix> qr(cflag _tp)const;
 	    std::vector<Matrix> rq(cflag _tp)const;
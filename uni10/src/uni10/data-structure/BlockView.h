@@ -0,0 +1,117 @@
+/****************************************************************************
+*  @file BlockView.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file for BlockView class
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef BLOCKVIEW_H
+#define BLOCKVIEW_H
+#include <uni10/data-structure/Block.h>
+
+namespace uni10{
+
+    ///@class BlockView
+    ///@brief Mutable, non-owning view of a block of elements
+    ///
+    /// A BlockView refers to elements owned by someone else, a symmetry sector of a UniTensor obtained from
+    /// UniTensor::getBlockView or UniTensor::getBlockViews. Since it is a Block, every Block algorithm (svd, qr, eigh, norm,
+    /// products, ...) runs on the view directly without copying the sector out into a Matrix first.
+    /// Writes through the view land in the owner's storage.
+    ///
+    /// A view does not keep its owner alive, and is invalidated by anything that reallocates the owner's
+    /// elements, e.g. assigning bonds or permuting the tensor. Taking a view pins the owner's elements:
+    /// copies of the tensor made while the view may still be written get their own elements, so writes
+    /// through the view never reach them.
+    class BlockView: public Block{
+
+    public:
+
+        ///
+        /// @brief Default constructor, an empty view
+        ///
+        BlockView();
+
+        ///
+        /// @brief Copy constructor, the copy views the same elements
+        ///
+        BlockView(const BlockView& view);
+
+        ///
+        /// @brief Views the elements of \c view instead, no element is copied
+        ///
+        BlockView& operator=(const BlockView& view);
+
+        ///
+        /// @brief Leading dimension
+        ///
+        /// Distance between the starts of two consecutive rows. The elements of a block are stored contiguously
+        /// in row-major order, so this is the number of columns, or 1 for a diagonal block.
+        /// @return Leading dimension
+        size_t ld()const;
+
+        ///
+        /// @brief Copy elements into the viewed block
+        ///
+        /// Copies the elements of \c src into the elements referred to by the view. A real \c src can be put
+        /// into a complex view, but not the other way around.
+        /// @param src Block of the same shape as the view
+        /// @return The view itself
+        BlockView& put(const Block& src);
+
+        ///
+        /// @brief Set the viewed elements to zero
+        ///
+        void set_zero();
+
+        ///
+        /// @brief Multiply the viewed elements by \c a in place
+        ///
+        /// @param a Scalar
+        BlockView& operator*=(Real a);
+
+        ///
+        /// @brief Multiply the viewed elements by \c a in place
+        ///
+        /// Only a complex view can be scaled by a complex number.
+        /// @param a Scalar
+        BlockView& operator*=(Complex a);
+
+        ///
+        /// @brief Add the elements of \c blk to the viewed elements in place
+        ///
+        /// @param blk Block of the same shape as the view
+        BlockView& operator+=(const Block& blk);
+
+    private:
+        friend class UniTensor;
+        /// View the elements of \c blk, no element is copied. Only UniTensor, which pins its elements first,
+        /// makes views, so that a const block never turns into a writable one.
+        explicit BlockView(const Block& blk);
+        void checkShape(const Block& blk, const char* op)const;
+    };
+
+};	/* namespace uni10 */
+#endif /* BLOCKVIEW_H */
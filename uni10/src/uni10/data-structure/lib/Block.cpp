@@ -30,6 +30,7 @@
 *****************************************************************************/
 #include <uni10/numeric/lapack/uni10_lapack.h>
 #include <uni10/tools/uni10_tools.h>
+#include <uni10/tools/uni10_trace.h>
 #include <uni10/tensor-network/Matrix.h>
 
 
@@ -244,6 +245,7 @@ namespace uni10{
 
   void Block::save(const std::string& fname)const{
     try{
+      UNI10_TRACE_SCOPE(trace, "save " + fname, "io");
       if(typeID() == 1)
         save(RTYPE, fname);
       else if(typeID() == 2)
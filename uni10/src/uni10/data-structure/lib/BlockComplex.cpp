@@ -38,6 +38,8 @@ namespace uni10{
 
   Block::Block(cflag tp, size_t _Rnum, size_t _Cnum, bool _diag): r_flag(RNULL), c_flag(tp), m_elem(NULL), cm_elem(NULL), Rnum(_Rnum), Cnum(_Cnum), diag(_diag), ongpu(false){}
 
+  Block::Block(size_t _Rnum, size_t _Cnum, Complex* _elem, bool _diag): r_flag(RNULL), c_flag(CTYPE), m_elem(NULL), cm_elem(_elem), Rnum(_Rnum), Cnum(_Cnum), diag(_diag), ongpu(false){}
+
   Complex Block::operator()(size_t idx)const{
     try{
       if(!(idx < elemNum())){
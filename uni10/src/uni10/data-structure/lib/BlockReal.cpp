@@ -38,6 +38,8 @@ namespace uni10{
 
   Block::Block(rflag _tp, size_t _Rnum, size_t _Cnum, bool _diag): r_flag(_tp), c_flag(CNULL), m_elem(NULL), cm_elem(NULL), Rnum(_Rnum), Cnum(_Cnum), diag(_diag), ongpu(false){}
 
+  Block::Block(size_t _Rnum, size_t _Cnum, Real* _elem, bool _diag): r_flag(RTYPE), c_flag(CNULL), m_elem(_elem), cm_elem(NULL), Rnum(_Rnum), Cnum(_Cnum), diag(_diag), ongpu(false){}
+
   Real Block::operator[](size_t idx)const{
     try{
       if(!(idx < elemNum())){
@@ -51,7 +53,7 @@ namespace uni10{
         throw std::runtime_error(exception_msg(err.str()));
       }
       if(typeID() == 1)
-        return getElemAt(idx, cm_elem, ongpu), 0;
+        return getElemAt(idx, m_elem, ongpu);
     }
     catch(const std::exception& e){
       propogate_exception(e, "In function Block::operator[](size_t):");
@@ -0,0 +1,148 @@
+/****************************************************************************
+*  @file BlockView.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file of BlockView class
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/data-structure/BlockView.h>
+#include <uni10/numeric/lapack/uni10_lapack.h>
+#include <uni10/tools/uni10_tools.h>
+
+namespace uni10{
+
+  BlockView::BlockView(): Block(){}
+
+  BlockView::BlockView(const Block& blk): Block(blk){}
+
+  BlockView::BlockView(const BlockView& view): Block(view){}
+
+  BlockView& BlockView::operator=(const BlockView& view){
+    r_flag = view.r_flag;
+    c_flag = view.c_flag;
+    m_elem = view.m_elem;
+    cm_elem = view.cm_elem;
+    Rnum = view.Rnum;
+    Cnum = view.Cnum;
+    diag = view.diag;
+    ongpu = view.ongpu;
+    return *this;
+  }
+
+  size_t BlockView::ld()const{
+    return diag ? 1 : Cnum;
+  }
+
+  void BlockView::checkShape(const Block& blk, const char* op)const{
+    if(!(blk.row() == Rnum && blk.col() == Cnum && blk.isDiag() == diag)){
+      std::ostringstream err;
+      err<<"Cannot "<<op<<" a block of shape "<<blk.row()<<" x "<<blk.col()<<(blk.isDiag() ? " (diagonal)" : "")
+        <<" and a view of shape "<<Rnum<<" x "<<Cnum<<(diag ? " (diagonal)" : "")<<".";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    if(typeID() == 1 && blk.typeID() == 2){
+      std::ostringstream err;
+      err<<"Cannot "<<op<<" a complex block and a real view.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+  }
+
+  BlockView& BlockView::put(const Block& src){
+    try{
+      checkShape(src, "put");
+      size_t n = elemNum();
+      if(typeID() == 1){
+        if(src.getElem(RTYPE) != m_elem)
+          elemCopy(m_elem, src.getElem(RTYPE), n * sizeof(Real), ongpu, src.isOngpu());
+      }
+      else if(src.typeID() == 1)
+        elemCast(cm_elem, src.getElem(RTYPE), n, ongpu, src.isOngpu());
+      else if(src.getElem(CTYPE) != cm_elem)
+        elemCopy(cm_elem, src.getElem(CTYPE), n * sizeof(Complex), ongpu, src.isOngpu());
+    }
+    catch(const std::exception& e){
+      propogate_exception(e, "In function BlockView::put(uni10::Block&):");
+    }
+    return *this;
+  }
+
+  void BlockView::set_zero(){
+    try{
+      if(typeID() == 1)
+        elemBzero(m_elem, elemNum() * sizeof(Real), ongpu);
+      else
+        elemBzero(cm_elem, elemNum() * sizeof(Complex), ongpu);
+    }
+    catch(const std::exception& e){
+      propogate_exception(e, "In function BlockView::set_zero():");
+    }
+  }
+
+  BlockView& BlockView::operator*=(Real a){
+    try{
+      if(typeID() == 1)
+        vectorScal(a, m_elem, elemNum(), ongpu);
+      else
+        vectorScal(a, cm_elem, elemNum(), ongpu);
+    }
+    catch(const std::exception& e){
+      propogate_exception(e, "In function BlockView::operator*=(double):");
+    }
+    return *this;
+  }
+
+  BlockView& BlockView::operator*=(Complex a){
+    try{
+      if(typeID() == 1){
+        std::ostringstream err;
+        err<<"Cannot scale a real view by a complex number.";
+        throw std::runtime_error(exception_msg(err.str()));
+      }
+      vectorScal(a, cm_elem, elemNum(), ongpu);
+    }
+    catch(const std::exception& e){
+      propogate_exception(e, "In function BlockView::operator*=(std::complex<double>):");
+    }
+    return *this;
+  }
+
+  BlockView& BlockView::operator+=(const Block& blk){
+    try{
+      checkShape(blk, "add");
+      size_t n = elemNum();
+      if(typeID() == 1)
+        vectorAdd(m_elem, blk.getElem(RTYPE), n, ongpu, blk.isOngpu());
+      else if(blk.typeID() == 1)
+        vectorAdd(cm_elem, blk.getElem(RTYPE), n, ongpu, blk.isOngpu());
+      else
+        vectorAdd(cm_elem, blk.getElem(CTYPE), n, ongpu, blk.isOngpu());
+    }
+    catch(const std::exception& e){
+      propogate_exception(e, "In function BlockView::operator+=(uni10::Block&):");
+    }
+    return *this;
+  }
+
+};	/* namespace uni10 */
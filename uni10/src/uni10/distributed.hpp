@@ -0,0 +1,38 @@
+/****************************************************************************
+*  @file distributed.hpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Generic header file for the MPI-distributed tensors
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef UNI10_DISTRIBUTED_HPP
+#define UNI10_DISTRIBUTED_HPP
+
+#include <uni10/distributed/ProcessGrid.h>
+#include <uni10/distributed/DistMatrix.h>
+#include <uni10/distributed/DistUniTensor.h>
+#include <uni10/distributed/MPISectorScheduler.h>
+
+#endif
@@ -0,0 +1,161 @@
+/****************************************************************************
+*  @file DistMatrix.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file of the dense matrix distributed block-cyclically over a process grid
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef DISTMATRIX_H
+#define DISTMATRIX_H
+#include <vector>
+#include <uni10/distributed/ProcessGrid.h>
+#include <uni10/tensor-network/Matrix.h>
+namespace uni10{
+
+///@class DistMatrix
+///@brief Real dense matrix distributed over a ProcessGrid
+///
+/// The matrix is cut into tiles of blockSize() x blockSize() elements. In the block-cyclic layout, the
+/// layout of ScaLAPACK, tile \f$(b_i, b_j)\f$ belongs to the process in grid row \f$b_i \bmod P_r\f$ and
+/// grid column \f$b_j \bmod P_c\f$. Alternatively the whole matrix belongs to a single process, owner(),
+/// and the other processes hold nothing. Each process keeps its part in local(), row-major, its tiles in
+/// the order of their global positions, so that local row \c i is global row globalRow(i).
+///
+/// A matrix moves between layouts tile by tile in a single all-to-all exchange, see redistribute().
+/// @see multiply(), DistUniTensor
+class DistMatrix{
+public:
+    /// @brief Empty matrix
+    DistMatrix();
+
+    /// @brief Zero \c m x \c n matrix over \c grid
+    /// @param nb Size of the tiles
+    /// @param owner Process holding the whole matrix, -1 for the block-cyclic layout
+    DistMatrix(const ProcessGrid& grid, size_t m, size_t n, int nb = 64, int owner = -1);
+
+    /// @brief Number of rows
+    size_t row()const;
+
+    /// @brief Number of columns
+    size_t col()const;
+
+    /// @brief Size of the tiles
+    int blockSize()const;
+
+    /// @brief Process holding the whole matrix, -1 in the block-cyclic layout
+    int owner()const;
+
+    /// @brief The grid
+    const ProcessGrid& grid()const;
+
+    /// @brief Number of rows held by this process
+    size_t localRows()const;
+
+    /// @brief Number of columns held by this process
+    size_t localCols()const;
+
+    /// @brief Elements held by this process, localRows() x localCols() row-major
+    Real* local();
+    /// @overload
+    const Real* local()const;
+
+    /// @brief Global row of local row \c i
+    size_t globalRow(size_t i)const;
+
+    /// @brief Global column of local column \c j
+    size_t globalCol(size_t j)const;
+
+    /// @brief Sets the local elements from the whole matrix \c elem, row-major, that every process has
+    ///
+    /// Not collective.
+    void assign(const Real* elem);
+
+    /// @brief Sets the matrix from the whole matrix \c elem, row-major, on the process \c root
+    ///
+    /// \c elem is only read on \c root.
+    void scatter(const Real* elem, int root);
+
+    /// @brief The whole matrix on the process \c root, an empty matrix on the others
+    Matrix gather(int root)const;
+
+    /// @brief The whole matrix on every process
+    Matrix allgather()const;
+
+    /// @brief The matrix in the layout of \c owner, -1 for block-cyclic
+    DistMatrix redistribute(int owner)const;
+
+    /// @brief The transpose, in the same layout
+    DistMatrix transpose()const;
+
+    /// @brief The leading \c m x \c n submatrix, in the same layout
+    ///
+    /// Not collective: the elements of a submatrix stay on their processes.
+    DistMatrix leading(size_t m, size_t n)const;
+
+    /// @brief Frobenius norm
+    Real norm()const;
+
+    /// @brief Bytes of the elements held by this process
+    size_t localBytes()const;
+
+    friend void summa(const DistMatrix& A, const DistMatrix& B, DistMatrix& C);
+    friend void remap(const DistMatrix& src, DistMatrix& dst, bool transpose);
+
+private:
+    const ProcessGrid* m_grid;
+    size_t m;
+    size_t n;
+    int nb;
+    int m_owner;
+    size_t lrows;
+    size_t lcols;
+    std::vector<Real> elem;
+    int prows()const;
+    int pcols()const;
+    int myRow()const;
+    int myCol()const;
+    int tileOwner(size_t bi, size_t bj)const;
+};
+
+/// @brief \c C = \c A \c B by SUMMA, the three matrices block-cyclic over the same grid with the same tiles
+///
+/// For each column of tiles of \c A, the tiles are broadcast along the grid rows and the matching row of
+/// tiles of \c B along the grid columns, and every process adds their product to its part of \c C. The
+/// memory of a process is its parts of the matrices and one panel of each.
+void summa(const DistMatrix& A, const DistMatrix& B, DistMatrix& C);
+
+/// @brief Moves the elements of \c src into \c dst, of the same tiles over the same grid, in a single
+/// all-to-all exchange; with \c transpose, \c dst receives the transpose of \c src
+void remap(const DistMatrix& src, DistMatrix& dst, bool transpose);
+
+/// @brief \f$AB\f$ in the layout of \c owner
+///
+/// Block-cyclic products are computed by summa(), the operands are moved to the block-cyclic layout first
+/// if needed. The product in the layout of a single process is computed by it, the operands are sent to it
+/// first if needed.
+DistMatrix multiply(const DistMatrix& A, const DistMatrix& B, int owner = -1);
+
+};	/* namespace uni10 */
+#endif /* DISTMATRIX_H */
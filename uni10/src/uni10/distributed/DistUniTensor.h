@@ -0,0 +1,155 @@
+/****************************************************************************
+*  @file DistUniTensor.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file of the block diagonal tensor distributed over a process grid
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef DISTUNITENSOR_H
+#define DISTUNITENSOR_H
+#include <map>
+#include <vector>
+#include <uni10/distributed/DistMatrix.h>
+#include <uni10/tensor-network/UniTensor.h>
+namespace uni10{
+
+///@class DistUniTensor
+///@brief Real symmetric tensor whose blocks are spread over a ProcessGrid
+///
+/// The tensor has the bonds, labels and blocks of a UniTensor, each block a DistMatrix. The blocks of
+/// at least threshold() elements are block-cyclic over the whole grid. The smaller ones each belong to a
+/// single process, given out from the largest to the least loaded process, so that the sectors of a
+/// tensor with many small blocks run side by side while the few large ones are shared.
+///
+/// Only the operations that keep the bonds in place are distributed: contract() needs the outgoing bonds
+/// of the first tensor to be the incoming bonds of the second, in the same order, and there is no
+/// distributed permute. A tensor is permuted as a UniTensor before it is scattered.
+/// @see ProcessGrid, DistMatrix
+class DistUniTensor{
+public:
+    /// @brief Default size of the blocks that are split over the grid, \f$2^{20}\f$ elements
+    static const size_t DEFAULT_THRESHOLD = 1 << 20;
+
+    /// @brief Empty tensor
+    DistUniTensor();
+
+    /// @brief Zero tensor of the bonds \c bonds over \c grid
+    /// @param threshold Number of elements from which a block is split over the grid
+    /// @param nb Size of the tiles of the blocks
+    DistUniTensor(const ProcessGrid& grid, const std::vector<Bond>& bonds, size_t threshold = DEFAULT_THRESHOLD, int nb = 64);
+
+    /// @brief Tensor of the elements of \c T on the process \c root
+    ///
+    /// \c T is only read on \c root, its bonds and labels are sent to the other processes.
+    static DistUniTensor scatter(const ProcessGrid& grid, const UniTensor& T, int root = 0, size_t threshold = DEFAULT_THRESHOLD, int nb = 64);
+
+    /// @brief The whole tensor on the process \c root, an empty tensor on the others
+    UniTensor gather(int root = 0)const;
+
+    /// @brief The grid
+    const ProcessGrid& grid()const;
+
+    /// @brief Number of bonds
+    size_t bondNum()const;
+
+    /// @brief Number of incoming bonds
+    int inBondNum()const;
+
+    /// @brief The bonds
+    std::vector<Bond> bond()const;
+    /// @brief The bond \c idx
+    Bond bond(size_t idx)const;
+
+    /// @brief The labels
+    std::vector<int> label()const;
+
+    /// @brief Sets the labels
+    void setLabel(const std::vector<int>& newLabels);
+    /// @overload
+    void setLabel(int* newLabels);
+
+    /// @brief Quantum numbers of the blocks
+    std::vector<Qnum> blockQnum()const;
+
+    /// @brief Number of blocks
+    size_t blockNum()const;
+
+    /// @brief The block of quantum number \c qnum
+    const DistMatrix& getBlock(const Qnum& qnum)const;
+
+    /// @brief Process holding the block of quantum number \c qnum, -1 if it is split over the grid
+    int blockOwner(const Qnum& qnum)const;
+
+    /// @brief Sets the block of quantum number \c qnum, moving \c M to the layout of the block
+    void putBlock(const Qnum& qnum, const DistMatrix& M);
+
+    /// @brief Number of elements
+    size_t elemNum()const;
+
+    /// @brief Bytes of the elements held by this process
+    size_t localBytes()const;
+
+    /// @brief Frobenius norm
+    Real norm()const;
+
+    /// @brief Number of elements from which a block is split over the grid
+    size_t threshold()const;
+
+    /// @brief Size of the tiles of the blocks
+    int blockSize()const;
+
+    friend DistUniTensor contract(const DistUniTensor& Ta, const DistUniTensor& Tb);
+
+private:
+    const ProcessGrid* m_grid;
+    std::vector<Bond> bonds;
+    std::vector<int> labels;
+    int RBondNum;
+    size_t m_threshold;
+    int nb;
+    std::map<Qnum, DistMatrix> blocks;
+};
+
+/// @brief Contraction of the outgoing bonds of \c Ta with the incoming bonds of \c Tb
+///
+/// The labels of the outgoing bonds of \c Ta must be those of the incoming bonds of \c Tb, in the same
+/// order. Each block of the result is multiply() of the blocks of the operands, in the layout the result
+/// gives it.
+/// @return Tensor of the incoming bonds of \c Ta and the outgoing bonds of \c Tb
+DistUniTensor contract(const DistUniTensor& Ta, const DistUniTensor& Tb);
+
+/// @brief Truncated singular value decomposition of a DistUniTensor
+///
+/// The distributed counterpart of truncatedSvd(const UniTensor&, int, Real, Real&), of the same factors.
+/// A block held by one process is decomposed by LAPACK there. A block split over the grid is decomposed
+/// by TSQR: each process factorizes a slice of its rows (of its columns for a wide block) by QR, and
+/// process 0 factorizes the stacked R factors by QR and SVD, which gives the singular values as accurately
+/// as a dense SVD. Only these small factors, of the size of the shorter side, are held by a single process.
+/// The singular values of all the blocks are then truncated together.
+/// @return Tensors \f$[U, S, V^T]\f$ with the threshold and tiles of \c T
+std::vector<DistUniTensor> truncatedSvd(const DistUniTensor& T, int maxChi, Real cutoff, Real& discarded);
+
+};	/* namespace uni10 */
+#endif /* DISTUNITENSOR_H */
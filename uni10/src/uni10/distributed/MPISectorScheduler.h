@@ -0,0 +1,66 @@
+/****************************************************************************
+*  @file MPISectorScheduler.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file of the scheduler of block products over MPI processes
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef MPISECTORSCHEDULER_H
+#define MPISECTORSCHEDULER_H
+#include <mpi.h>
+#include <uni10/tensor-network/SectorScheduler.h>
+namespace uni10{
+
+///@class MPISectorScheduler
+///@brief Runs the block products of each contraction on the processes of an MPI communicator
+///
+/// The program runs on every process with the same tensors, as an unchanged single-process program started
+/// by \c mpiexec: every process calls each contraction, and so each run(), in the same order. The products
+/// are split by splitSectors() and balanceSectors(), identically on all the processes; each process
+/// computes its share and broadcasts it, so that all the processes end with the whole result. The work of
+/// the contractions is spread, their memory is not; see DistUniTensor for tensors larger than a node.
+/// Contractions of fewer than minCost() multiply-adds are computed by every process alone.
+class MPISectorScheduler: public SectorScheduler{
+public:
+    /// @brief Scheduler over the processes of \c comm, duplicated
+    MPISectorScheduler(MPI_Comm comm = MPI_COMM_WORLD, double minCost = 1E7);
+
+    ~MPISectorScheduler();
+
+    /// @brief Multiply-adds below which a contraction is not spread
+    double minCost()const;
+
+    void run(std::vector<SectorGemm<double> >& gemms);
+    void run(std::vector<SectorGemm<std::complex<double> > >& gemms);
+
+private:
+    MPI_Comm m_comm;
+    double m_minCost;
+    MPISectorScheduler(const MPISectorScheduler&);
+    MPISectorScheduler& operator=(const MPISectorScheduler&);
+};
+
+};	/* namespace uni10 */
+#endif /* MPISECTORSCHEDULER_H */
@@ -0,0 +1,97 @@
+/****************************************************************************
+*  @file ProcessGrid.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file of the two dimensional grid of MPI processes
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef PROCESSGRID_H
+#define PROCESSGRID_H
+#include <mpi.h>
+namespace uni10{
+
+///@class ProcessGrid
+///@brief Two dimensional grid of the processes of an MPI communicator
+///
+/// The ranks of the communicator fill a grid of rows() x cols() processes row by row. The processes of a
+/// grid row share rowComm(), ranked by their column, the processes of a grid column share colComm(),
+/// ranked by their row. DistMatrix and DistUniTensor keep a pointer to their grid, which must outlive
+/// them.
+///
+/// All the functions that take a ProcessGrid are collective over its communicator unless stated
+/// otherwise, and every process must call them in the same order.
+class ProcessGrid{
+public:
+    /// @brief Grid of all the processes of \c comm
+    /// @param comm The communicator, duplicated
+    /// @param rows Number of grid rows, a divisor of the number of processes; 0 for the grid closest to a square
+    ProcessGrid(MPI_Comm comm = MPI_COMM_WORLD, int rows = 0);
+
+    ~ProcessGrid();
+
+    /// @brief Communicator of the grid
+    MPI_Comm comm()const;
+
+    /// @brief Communicator of the processes in the grid row of this process
+    MPI_Comm rowComm()const;
+
+    /// @brief Communicator of the processes in the grid column of this process
+    MPI_Comm colComm()const;
+
+    /// @brief Rank of this process
+    int rank()const;
+
+    /// @brief Number of processes
+    int size()const;
+
+    /// @brief Number of grid rows
+    int rows()const;
+
+    /// @brief Number of grid columns
+    int cols()const;
+
+    /// @brief Grid row of this process
+    int myRow()const;
+
+    /// @brief Grid column of this process
+    int myCol()const;
+
+    /// @brief Rank of the process in grid row \c r and grid column \c c, not collective
+    int rankOf(int r, int c)const;
+
+private:
+    MPI_Comm m_comm;
+    MPI_Comm m_rowComm;
+    MPI_Comm m_colComm;
+    int m_rank;
+    int m_size;
+    int m_rows;
+    int m_cols;
+    ProcessGrid(const ProcessGrid&);
+    ProcessGrid& operator=(const ProcessGrid&);
+};
+
+};	/* namespace uni10 */
+#endif /* PROCESSGRID_H */
@@ -0,0 +1,438 @@
+/****************************************************************************
+*  @file DistMatrix.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file of the DistMatrix class
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/distributed/DistMatrix.h>
+#include <uni10/numeric/lapack/uni10_lapack.h>
+#include <uni10/tools/uni10_tools.h>
+#include <climits>
+#include <cmath>
+#include <cstring>
+namespace uni10{
+
+namespace{
+
+// Number of the n rows, cut in tiles of nb, that the cyclic distribution over P processes gives to p
+size_t numroc(size_t n, int nb, int p, int P){
+  if(p < 0)
+    return 0;
+  size_t tiles = n / nb;
+  size_t num = (tiles / P) * nb;
+  size_t extra = tiles % P;
+  if((size_t)p < extra)
+    num += nb;
+  else if((size_t)p == extra)
+    num += n % nb;
+  return num;
+}
+
+int checkedCount(size_t count){
+  if(count > (size_t)INT_MAX){
+    std::ostringstream err;
+    err<<"A message of " << count << " elements exceeds the range of an MPI count.";
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+  return (int)count;
+}
+
+void broadcast(Real* buf, size_t count, int root, MPI_Comm comm){
+  const size_t chunk = 1 << 30;
+  for(size_t off = 0; off < count; off += chunk)
+    MPI_Bcast(buf + off, (int)std::min(chunk, count - off), MPI_DOUBLE, root, comm);
+}
+
+};
+
+DistMatrix::DistMatrix(): m_grid(NULL), m(0), n(0), nb(1), m_owner(-1), lrows(0), lcols(0){}
+
+DistMatrix::DistMatrix(const ProcessGrid& grid, size_t _m, size_t _n, int _nb, int owner): m_grid(&grid), m(_m), n(_n), nb(_nb), m_owner(owner){
+  try{
+    if(nb <= 0){
+      std::ostringstream err;
+      err<<"The tiles must have a positive size.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    if(owner < -1 || owner >= grid.size()){
+      std::ostringstream err;
+      err<<"Process " << owner << " is not in the grid of " << grid.size() << " processes.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    lrows = numroc(m, nb, myRow(), prows());
+    lcols = numroc(n, nb, myCol(), pcols());
+    elem.assign(lrows * lcols, 0);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor DistMatrix::DistMatrix(ProcessGrid&, size_t, size_t, int, int):");
+  }
+}
+
+size_t DistMatrix::row()const{
+  return m;
+}
+
+size_t DistMatrix::col()const{
+  return n;
+}
+
+int DistMatrix::blockSize()const{
+  return nb;
+}
+
+int DistMatrix::owner()const{
+  return m_owner;
+}
+
+const ProcessGrid& DistMatrix::grid()const{
+  return *m_grid;
+}
+
+size_t DistMatrix::localRows()const{
+  return lrows;
+}
+
+size_t DistMatrix::localCols()const{
+  return lcols;
+}
+
+Real* DistMatrix::local(){
+  return elem.empty() ? NULL : &elem[0];
+}
+
+const Real* DistMatrix::local()const{
+  return elem.empty() ? NULL : &elem[0];
+}
+
+int DistMatrix::prows()const{
+  return m_owner < 0 ? m_grid->rows() : 1;
+}
+
+int DistMatrix::pcols()const{
+  return m_owner < 0 ? m_grid->cols() : 1;
+}
+
+int DistMatrix::myRow()const{
+  if(m_owner < 0)
+    return m_grid->myRow();
+  return m_grid->rank() == m_owner ? 0 : -1;
+}
+
+int DistMatrix::myCol()const{
+  if(m_owner < 0)
+    return m_grid->myCol();
+  return m_grid->rank() == m_owner ? 0 : -1;
+}
+
+int DistMatrix::tileOwner(size_t bi, size_t bj)const{
+  if(m_owner >= 0)
+    return m_owner;
+  return m_grid->rankOf(bi % prows(), bj % pcols());
+}
+
+size_t DistMatrix::globalRow(size_t i)const{
+  return ((i / nb) * prows() + myRow()) * nb + i % nb;
+}
+
+size_t DistMatrix::globalCol(size_t j)const{
+  return ((j / nb) * pcols() + myCol()) * nb + j % nb;
+}
+
+void DistMatrix::assign(const Real* src){
+  for(size_t i = 0; i < lrows; i++){
+    const Real* srow = src + globalRow(i) * n;
+    Real* drow = &elem[i * lcols];
+    for(size_t j = 0; j < lcols; j++)
+      drow[j] = srow[globalCol(j)];
+  }
+}
+
+void DistMatrix::scatter(const Real* src, int root){
+  try{
+    DistMatrix whole(*m_grid, m, n, nb, root);
+    if(m_grid->rank() == root && m && n)
+      std::memcpy(whole.local(), src, m * n * sizeof(Real));
+    remap(whole, *this, false);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function DistMatrix::scatter(Real*, int):");
+  }
+}
+
+Matrix DistMatrix::gather(int root)const{
+  try{
+    DistMatrix whole(*m_grid, m, n, nb, root);
+    remap(*this, whole, false);
+    if(m_grid->rank() == root)
+      return Matrix(m, n, whole.local());
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function DistMatrix::gather(int):");
+  }
+  return Matrix();
+}
+
+Matrix DistMatrix::allgather()const{
+  Matrix M;
+  try{
+    M = gather(0);
+    if(m_grid->rank() != 0)
+      M = Matrix(m, n);
+    broadcast(M.getElem(), m * n, 0, m_grid->comm());
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function DistMatrix::allgather():");
+  }
+  return M;
+}
+
+DistMatrix DistMatrix::redistribute(int owner)const{
+  DistMatrix M;
+  try{
+    M = DistMatrix(*m_grid, m, n, nb, owner);
+    remap(*this, M, false);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function DistMatrix::redistribute(int):");
+  }
+  return M;
+}
+
+DistMatrix DistMatrix::transpose()const{
+  DistMatrix M;
+  try{
+    M = DistMatrix(*m_grid, n, m, nb, m_owner);
+    remap(*this, M, true);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function DistMatrix::transpose():");
+  }
+  return M;
+}
+
+DistMatrix DistMatrix::leading(size_t _m, size_t _n)const{
+  DistMatrix M;
+  try{
+    if(_m > m || _n > n){
+      std::ostringstream err;
+      err<<"The " << m << " x " << n << " matrix has no leading " << _m << " x " << _n << " submatrix.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    M = DistMatrix(*m_grid, _m, _n, nb, m_owner);
+    for(size_t i = 0; i < M.lrows; i++)
+      if(M.lcols)
+        std::memcpy(&M.elem[i * M.lcols], &elem[i * lcols], M.lcols * sizeof(Real));
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function DistMatrix::leading(size_t, size_t):");
+  }
+  return M;
+}
+
+Real DistMatrix::norm()const{
+  Real local = 0, total = 0;
+  for(size_t i = 0; i < elem.size(); i++)
+    local += elem[i] * elem[i];
+  MPI_Allreduce(&local, &total, 1, MPI_DOUBLE, MPI_SUM, m_grid->comm());
+  return std::sqrt(total);
+}
+
+size_t DistMatrix::localBytes()const{
+  return elem.size() * sizeof(Real);
+}
+
+void remap(const DistMatrix& src, DistMatrix& dst, bool transpose){
+  try{
+    if(src.m_grid != dst.m_grid || src.nb != dst.nb || dst.m != (transpose ? src.n : src.m) || dst.n != (transpose ? src.m : src.n)){
+      std::ostringstream err;
+      err<<"Cannot move a " << src.m << " x " << src.n << " matrix into a " << dst.m << " x " << dst.n << " matrix of other tiles or grid.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    const ProcessGrid& grid = *src.m_grid;
+    int P = grid.size(), me = grid.rank(), nb = src.nb;
+    size_t tileRows = (src.m + nb - 1) / nb, tileCols = (src.n + nb - 1) / nb;
+    if(src.m_owner >= 0 && src.m_owner == dst.m_owner){  // nothing moves
+      if(me == src.m_owner){
+        if(transpose){
+          for(size_t i = 0; i < src.m; i++)
+            for(size_t j = 0; j < src.n; j++)
+              dst.elem[j * src.m + i] = src.elem[i * src.n + j];
+        }
+        else
+          dst.elem = src.elem;
+      }
+      return;
+    }
+    // Both sides walk the source tiles in the same order, so the messages need no headers.
+    std::vector<size_t> scount(P, 0), rcount(P, 0);
+    for(size_t bi = 0; bi < tileRows; bi++)
+      for(size_t bj = 0; bj < tileCols; bj++){
+        int s = src.tileOwner(bi, bj);
+        int d = transpose ? dst.tileOwner(bj, bi) : dst.tileOwner(bi, bj);
+        if(s != me && d != me)
+          continue;
+        size_t size = std::min((size_t)nb, src.m - bi * nb) * std::min((size_t)nb, src.n - bj * nb);
+        if(s == me)
+          scount[d] += size;
+        if(d == me)
+          rcount[s] += size;
+      }
+    std::vector<int> sc(P), sd(P), rc(P), rd(P);
+    size_t stotal = 0, rtotal = 0;
+    for(int p = 0; p < P; p++){
+      sd[p] = checkedCount(stotal);
+      rd[p] = checkedCount(rtotal);
+      sc[p] = checkedCount(scount[p]);
+      rc[p] = checkedCount(rcount[p]);
+      stotal += scount[p];
+      rtotal += rcount[p];
+    }
+    checkedCount(stotal);
+    checkedCount(rtotal);
+    std::vector<Real> sbuf(stotal + 1), rbuf(rtotal + 1);
+    std::vector<size_t> pos(sd.begin(), sd.end());
+    for(size_t bi = 0; bi < tileRows; bi++)
+      for(size_t bj = 0; bj < tileCols; bj++){
+        if(src.tileOwner(bi, bj) != me)
+          continue;
+        int d = transpose ? dst.tileOwner(bj, bi) : dst.tileOwner(bi, bj);
+        size_t h = std::min((size_t)nb, src.m - bi * nb), w = std::min((size_t)nb, src.n - bj * nb);
+        const Real* tile = &src.elem[(bi / src.prows()) * nb * src.lcols + (bj / src.pcols()) * nb];
+        Real* out = &sbuf[pos[d]];
+        if(transpose){
+          for(size_t r = 0; r < h; r++)
+            for(size_t c = 0; c < w; c++)
+              out[c * h + r] = tile[r * src.lcols + c];
+        }
+        else{
+          for(size_t r = 0; r < h; r++)
+            std::memcpy(out + r * w, tile + r * src.lcols, w * sizeof(Real));
+        }
+        pos[d] += h * w;
+      }
+    MPI_Alltoallv(&sbuf[0], &sc[0], &sd[0], MPI_DOUBLE, &rbuf[0], &rc[0], &rd[0], MPI_DOUBLE, grid.comm());
+    pos.assign(rd.begin(), rd.end());
+    for(size_t bi = 0; bi < tileRows; bi++)
+      for(size_t bj = 0; bj < tileCols; bj++){
+        size_t di = transpose ? bj : bi, dj = transpose ? bi : bj;
+        if(dst.tileOwner(di, dj) != me)
+          continue;
+        int s = src.tileOwner(bi, bj);
+        size_t h = std::min((size_t)nb, dst.m - di * nb), w = std::min((size_t)nb, dst.n - dj * nb);
+        Real* tile = &dst.elem[(di / dst.prows()) * nb * dst.lcols + (dj / dst.pcols()) * nb];
+        for(size_t r = 0; r < h; r++)
+          std::memcpy(tile + r * dst.lcols, &rbuf[pos[s] + r * w], w * sizeof(Real));
+        pos[s] += h * w;
+      }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function remap(DistMatrix&, DistMatrix&, bool):");
+  }
+}
+
+void summa(const DistMatrix& A, const DistMatrix& B, DistMatrix& C){
+  try{
+    if(A.m_owner >= 0 || B.m_owner >= 0 || C.m_owner >= 0 || A.m_grid != B.m_grid || A.m_grid != C.m_grid || A.nb != B.nb || A.nb != C.nb){
+      std::ostringstream err;
+      err<<"SUMMA needs three block-cyclic matrices of the same tiles over the same grid.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    if(A.n != B.m || C.m != A.m || C.n != B.n){
+      std::ostringstream err;
+      err<<"Cannot multiply a " << A.m << " x " << A.n << " matrix by a " << B.m << " x " << B.n << " matrix into a " << C.m << " x " << C.n << " matrix.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    const ProcessGrid& grid = *A.m_grid;
+    int nb = A.nb, Pr = grid.rows(), Pc = grid.cols();
+    std::fill(C.elem.begin(), C.elem.end(), 0);
+    size_t tiles = (A.n + nb - 1) / nb;
+    std::vector<Real> apanel(C.lrows * nb + 1), bpanel(nb * C.lcols + 1), prod(C.lrows * C.lcols + 1);
+    for(size_t kb = 0; kb < tiles; kb++){
+      size_t w = std::min((size_t)nb, A.n - kb * nb);
+      int acol = kb % Pc, brow = kb % Pr;
+      // The tile column kb of A, A.lrows x w, from the grid column acol
+      if(grid.myCol() == acol){
+        size_t off = (kb / Pc) * nb;
+        for(size_t i = 0; i < A.lrows; i++)
+          std::memcpy(&apanel[i * w], &A.elem[i * A.lcols + off], w * sizeof(Real));
+      }
+      if(A.lrows)
+        MPI_Bcast(&apanel[0], checkedCount(A.lrows * w), MPI_DOUBLE, acol, grid.rowComm());
+      // The tile row kb of B, w x B.lcols, from the grid row brow
+      if(grid.myRow() == brow && B.lcols){
+        size_t off = (kb / Pr) * nb;
+        std::memcpy(&bpanel[0], &B.elem[off * B.lcols], w * B.lcols * sizeof(Real));
+      }
+      if(B.lcols)
+        MPI_Bcast(&bpanel[0], checkedCount(w * B.lcols), MPI_DOUBLE, brow, grid.colComm());
+      if(C.lrows && C.lcols){
+        matrixMul(&apanel[0], &bpanel[0], C.lrows, C.lcols, w, &prod[0], false, false, false);
+        vectorAdd(&C.elem[0], &prod[0], C.elem.size(), false, false);
+      }
+    }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function summa(DistMatrix&, DistMatrix&, DistMatrix&):");
+  }
+}
+
+DistMatrix multiply(const DistMatrix& A, const DistMatrix& B, int owner){
+  DistMatrix C;
+  try{
+    if(&A.grid() != &B.grid() || A.blockSize() != B.blockSize()){
+      std::ostringstream err;
+      err<<"Cannot multiply matrices of different tiles or grids.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    if(A.col() != B.row()){
+      std::ostringstream err;
+      err<<"Cannot multiply a " << A.row() << " x " << A.col() << " matrix by a " << B.row() << " x " << B.col() << " matrix.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    C = DistMatrix(A.grid(), A.row(), B.col(), A.blockSize(), owner);
+    DistMatrix ta, tb;
+    const DistMatrix* pa = &A;
+    const DistMatrix* pb = &B;
+    if(A.owner() != owner){
+      ta = A.redistribute(owner);
+      pa = &ta;
+    }
+    if(B.owner() != owner){
+      tb = B.redistribute(owner);
+      pb = &tb;
+    }
+    if(owner < 0)
+      summa(*pa, *pb, C);
+    else if(A.grid().rank() == owner && A.row() && B.col() && A.col())
+      matrixMul(const_cast<Real*>(pa->local()), const_cast<Real*>(pb->local()), A.row(), B.col(), A.col(), C.local(), false, false, false);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function multiply(DistMatrix&, DistMatrix&, int):");
+  }
+  return C;
+}
+
+};	/* namespace uni10 */
@@ -0,0 +1,579 @@
+/****************************************************************************
+*  @file DistUniTensor.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file of the DistUniTensor class
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/distributed/DistUniTensor.h>
+#include <uni10/algorithm/Solvers.h>
+#include <uni10/numeric/lapack/uni10_lapack.h>
+#include <uni10/tools/uni10_tools.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+namespace uni10{
+
+namespace{
+
+// Dimensions of the quantum numbers of the products of the states of the bonds [from, to), as UniTensor groups them
+std::map<Qnum, size_t> sectorDims(const std::vector<Bond>& bonds, size_t from, size_t to){
+  std::map<Qnum, size_t> dims;
+  dims[Qnum()] = 1;
+  for(size_t b = from; b < to; b++){
+    std::map<Qnum, int> degs = bonds[b].degeneracy();
+    std::map<Qnum, size_t> next;
+    for(std::map<Qnum, size_t>::iterator it = dims.begin(); it != dims.end(); ++it)
+      for(std::map<Qnum, int>::iterator jt = degs.begin(); jt != degs.end(); ++jt)
+        next[it->first * jt->first] += it->second * jt->second;
+    dims.swap(next);
+  }
+  return dims;
+}
+
+// Counts and displacements of the exchange between the block-cyclic layout of A and slices of full rows:
+// the local rows of a grid row are cut into one slice per grid column, [from, to) for this process
+struct RowSlices{
+  std::vector<int> cols, scount, sdispl, rcount, rdispl;
+  size_t from, to;
+  RowSlices(const DistMatrix& A){
+    const ProcessGrid& grid = A.grid();
+    int pc = grid.cols(), me = grid.myCol();
+    size_t lrows = A.localRows();
+    int lcols = A.localCols();
+    cols.resize(pc);
+    MPI_Allgather(&lcols, 1, MPI_INT, &cols[0], 1, MPI_INT, grid.rowComm());
+    from = lrows * me / pc;
+    to = lrows * (me + 1) / pc;
+    scount.assign(pc, 0);
+    sdispl.assign(pc, 0);
+    rcount.assign(pc, 0);
+    rdispl.assign(pc, 0);
+    for(int c = 0; c < pc; c++){
+      sdispl[c] = lrows * c / pc * lcols;
+      scount[c] = lrows * (c + 1) / pc * lcols - sdispl[c];
+      rcount[c] = (to - from) * cols[c];
+      if(c > 0)
+        rdispl[c] = rdispl[c - 1] + rcount[c - 1];
+    }
+  }
+  // Global column of the local column j of the grid column c
+  size_t globalCol(const DistMatrix& A, size_t j, int c)const{
+    int nb = A.blockSize();
+    return ((j / nb) * cols.size() + c) * nb + j % nb;
+  }
+};
+
+// The slice of the rows of A that this process takes, every column, row-major
+std::vector<Real> toRowSlice(const DistMatrix& A){
+  RowSlices ex(A);
+  size_t n = A.col(), k = ex.to - ex.from;
+  std::vector<Real> buf(ex.rdispl.back() + ex.rcount.back() + 1), rows(k * n + 1);
+  MPI_Alltoallv(A.local(), &ex.scount[0], &ex.sdispl[0], MPI_DOUBLE,
+      &buf[0], &ex.rcount[0], &ex.rdispl[0], MPI_DOUBLE, A.grid().rowComm());
+  for(size_t c = 0; c < ex.cols.size(); c++)
+    for(size_t i = 0; i < k; i++)
+      for(int j = 0; j < ex.cols[c]; j++)
+        rows[i * n + ex.globalCol(A, j, c)] = buf[ex.rdispl[c] + i * ex.cols[c] + j];
+  rows.pop_back();
+  return rows;
+}
+
+// Sets A from the slices of rows of toRowSlice()
+void fromRowSlice(const std::vector<Real>& rows, DistMatrix& A){
+  RowSlices ex(A);
+  size_t n = A.col(), k = ex.to - ex.from;
+  std::vector<Real> buf(ex.rdispl.back() + ex.rcount.back() + 1);
+  for(size_t c = 0; c < ex.cols.size(); c++)
+    for(size_t i = 0; i < k; i++)
+      for(int j = 0; j < ex.cols[c]; j++)
+        buf[ex.rdispl[c] + i * ex.cols[c] + j] = rows[i * n + ex.globalCol(A, j, c)];
+  MPI_Alltoallv(&buf[0], &ex.rcount[0], &ex.rdispl[0], MPI_DOUBLE,
+      A.local(), &ex.scount[0], &ex.sdispl[0], MPI_DOUBLE, A.grid().rowComm());
+}
+
+// Singular value decomposition of a block-cyclic matrix by TSQR. Every process factorizes a slice of the
+// rows, X_p = Q_p R_p; the R_p are stacked and factorized again on process 0, [R_p] = Q' R, followed by
+// the small SVD R = U' S V^T. Then U = Q_p (Q' U')_p on every slice. Only the n x n factors are on a single
+// process, and the singular values are as accurate as those of a dense SVD. A wide matrix is decomposed
+// as its transpose.
+void tsqrSvd(const DistMatrix& A, std::vector<Real>& s, DistMatrix& U, DistMatrix& VT){
+  if(A.row() < A.col()){
+    DistMatrix Ut, V;
+    tsqrSvd(A.transpose(), s, V, Ut);
+    U = Ut.transpose();
+    VT = V.transpose();
+    return;
+  }
+  const ProcessGrid& grid = A.grid();
+  size_t m = A.row(), n = A.col();
+  int nb = A.blockSize(), me = grid.rank();
+  std::vector<Real> X = toRowSlice(A);
+  size_t k = X.size() / n;
+  // a slice of fewer rows than columns is its own R factor
+  std::vector<Real> Q, R;
+  if(k > n){
+    Q.resize(k * n);
+    R.resize(n * n);
+    matrixQR(&X[0], k, n, &Q[0], &R[0], false);
+  }
+  else
+    R.swap(X);
+  int count = R.size();
+  std::vector<int> counts(grid.size()), displs(grid.size(), 0);
+  MPI_Allgather(&count, 1, MPI_INT, &counts[0], 1, MPI_INT, grid.comm());
+  for(int p = 1; p < grid.size(); p++)
+    displs[p] = displs[p - 1] + counts[p - 1];
+  size_t stacked = (displs.back() + counts.back()) / n;  // at least n rows, as m >= n
+  std::vector<Real> stack(1), Y(1), vT(n * n);
+  s.assign(n, 0);
+  if(me == 0)
+    stack.resize(stacked * n + 1);
+  R.push_back(0);
+  MPI_Gatherv(&R[0], count, MPI_DOUBLE, &stack[0], &counts[0], &displs[0], MPI_DOUBLE, 0, grid.comm());
+  if(me == 0){
+    std::vector<Real> Q2(stacked * n), R2(n * n), U2(n * n);
+    matrixQR(&stack[0], stacked, n, &Q2[0], &R2[0], false);
+    matrixSVD(&R2[0], n, n, &U2[0], &s[0], &vT[0], false);
+    Y.resize(stacked * n + 1);
+    matrixMul(&Q2[0], &U2[0], stacked, n, n, &Y[0], false, false, false);
+  }
+  MPI_Bcast(&s[0], n, MPI_DOUBLE, 0, grid.comm());
+  std::vector<Real> Yp(count + 1);
+  MPI_Scatterv(&Y[0], &counts[0], &displs[0], MPI_DOUBLE, &Yp[0], count, MPI_DOUBLE, 0, grid.comm());
+  Yp.pop_back();
+  std::vector<Real> Uslice(k * n);
+  if(k > n)
+    matrixMul(&Q[0], &Yp[0], k, n, n, &Uslice[0], false, false, false);
+  else
+    Uslice.swap(Yp);
+  U = DistMatrix(grid, m, n, nb, -1);
+  fromRowSlice(Uslice, U);
+  VT = DistMatrix(grid, n, n, nb, -1);
+  VT.scatter(&vT[0], 0);
+}
+
+};
+
+DistUniTensor::DistUniTensor(): m_grid(NULL), RBondNum(0), m_threshold(DEFAULT_THRESHOLD), nb(64){}
+
+DistUniTensor::DistUniTensor(const ProcessGrid& grid, const std::vector<Bond>& _bonds, size_t threshold, int _nb): m_grid(&grid), bonds(_bonds), RBondNum(0), m_threshold(threshold), nb(_nb){
+  try{
+    for(size_t b = 0; b < bonds.size(); b++){
+      if(bonds[b].type() == BD_IN){
+        if((int)b != RBondNum){
+          std::ostringstream err;
+          err<<"Error in the input bond array: BD_OUT bonds must be placed after all BD_IN bonds.";
+          throw std::runtime_error(exception_msg(err.str()));
+        }
+        RBondNum++;
+      }
+    }
+    if(RBondNum == 0 || RBondNum == (int)bonds.size()){
+      std::ostringstream err;
+      err<<"A DistUniTensor needs incoming and outgoing bonds.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    labels.resize(bonds.size());
+    for(size_t b = 0; b < bonds.size(); b++)
+      labels[b] = b;
+    std::map<Qnum, size_t> rows = sectorDims(bonds, 0, RBondNum);
+    std::map<Qnum, size_t> cols = sectorDims(bonds, RBondNum, bonds.size());
+    std::vector<std::pair<size_t, Qnum> > sizes;
+    for(std::map<Qnum, size_t>::iterator it = rows.begin(); it != rows.end(); ++it)
+      if(cols.count(it->first))
+        sizes.push_back(std::make_pair(it->second * cols[it->first], it->first));
+    if(sizes.empty()){
+      std::ostringstream err;
+      err<<"There is no symmetry block with the given bonds:\n";
+      for(size_t b = 0; b < bonds.size(); b++)
+        err<<"    "<<bonds[b];
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    // the largest blocks first, each to the least loaded process unless it is split over the grid
+    std::stable_sort(sizes.begin(), sizes.end(), std::greater<std::pair<size_t, Qnum> >());
+    std::vector<size_t> load(grid.size(), 0);
+    for(size_t s = 0; s < sizes.size(); s++){
+      const Qnum& q = sizes[s].second;
+      int owner = -1;
+      if(sizes[s].first < m_threshold || grid.size() == 1){
+        owner = std::min_element(load.begin(), load.end()) - load.begin();
+        load[owner] += sizes[s].first;
+      }
+      blocks[q] = DistMatrix(grid, rows[q], cols[q], nb, owner);
+    }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor DistUniTensor::DistUniTensor(ProcessGrid&, std::vector<Bond>&, size_t, int):");
+  }
+}
+
+DistUniTensor DistUniTensor::scatter(const ProcessGrid& grid, const UniTensor& T, int root, size_t threshold, int nb){
+  DistUniTensor D;
+  try{
+    // bond number, incoming bond number, labels, then the type, dimension and quantum numbers of each bond
+    std::vector<int> desc;
+    if(grid.rank() == root){
+      if(T.typeID() != 1){
+        std::ostringstream err;
+        err<<"Only real tensors are supported.";
+        throw std::runtime_error(exception_msg(err.str()));
+      }
+      std::vector<Bond> bds = T.bond();
+      std::vector<int> lbs = T.label();
+      desc.push_back(bds.size());
+      desc.push_back(T.inBondNum());
+      desc.insert(desc.end(), lbs.begin(), lbs.end());
+      for(size_t b = 0; b < bds.size(); b++){
+        std::vector<Qnum> qnums = bds[b].Qlist();
+        desc.push_back(bds[b].type());
+        desc.push_back(qnums.size());
+        for(size_t i = 0; i < qnums.size(); i++){
+          desc.push_back(qnums[i].U1());
+          desc.push_back(qnums[i].prt());
+          desc.push_back(qnums[i].prtF());
+        }
+      }
+    }
+    int len = desc.size();
+    MPI_Bcast(&len, 1, MPI_INT, root, grid.comm());
+    desc.resize(len);
+    MPI_Bcast(&desc[0], len, MPI_INT, root, grid.comm());
+    size_t bondNum = desc[0], pos = 2 + bondNum;
+    std::vector<int> lbs(desc.begin() + 2, desc.begin() + pos);
+    std::vector<Bond> bds;
+    for(size_t b = 0; b < bondNum; b++){
+      bondType tp = (bondType)desc[pos++];
+      std::vector<Qnum> qnums(desc[pos++]);
+      for(size_t i = 0; i < qnums.size(); i++, pos += 3)
+        qnums[i] = Qnum((parityFType)desc[pos + 2], desc[pos], (parityType)desc[pos + 1]);
+      bds.push_back(Bond(tp, qnums));
+    }
+    D = DistUniTensor(grid, bds, threshold, nb);
+    D.setLabel(lbs);
+    std::map<Qnum, Matrix> Tblocks;
+    if(grid.rank() == root)
+      Tblocks = T.getBlocks();
+    for(std::map<Qnum, DistMatrix>::iterator it = D.blocks.begin(); it != D.blocks.end(); ++it)
+      it->second.scatter(grid.rank() == root ? Tblocks[it->first].getElem() : NULL, root);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function DistUniTensor::scatter(ProcessGrid&, uni10::UniTensor&, int, size_t, int):");
+  }
+  return D;
+}
+
+UniTensor DistUniTensor::gather(int root)const{
+  UniTensor T;
+  try{
+    bool here = m_grid->rank() == root;
+    if(here){
+      T = UniTensor(bonds);
+      T.setLabel(labels);
+    }
+    for(std::map<Qnum, DistMatrix>::const_iterator it = blocks.begin(); it != blocks.end(); ++it){
+      Matrix M = it->second.gather(root);
+      if(here)
+        T.putBlock(it->first, M);
+    }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function DistUniTensor::gather(int):");
+  }
+  return T;
+}
+
+const ProcessGrid& DistUniTensor::grid()const{
+  return *m_grid;
+}
+
+size_t DistUniTensor::bondNum()const{
+  return bonds.size();
+}
+
+int DistUniTensor::inBondNum()const{
+  return RBondNum;
+}
+
+std::vector<Bond> DistUniTensor::bond()const{
+  return bonds;
+}
+
+Bond DistUniTensor::bond(size_t idx)const{
+  try{
+    if(idx >= bonds.size()){
+      std::ostringstream err;
+      err<<"Index exceeds the number of the bonds( " << bonds.size() << " ).";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function DistUniTensor::bond(size_t):");
+  }
+  return bonds[idx];
+}
+
+std::vector<int> DistUniTensor::label()const{
+  return labels;
+}
+
+void DistUniTensor::setLabel(const std::vector<int>& newLabels){
+  try{
+    if(newLabels.size() != bonds.size()){
+      std::ostringstream err;
+      err<<"The size of input vector(labels) does not match for the number of bonds.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    labels = newLabels;
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function DistUniTensor::setLabel(std::vector<int>&):");
+  }
+}
+
+void DistUniTensor::setLabel(int* newLabels){
+  setLabel(std::vector<int>(newLabels, newLabels + bonds.size()));
+}
+
+std::vector<Qnum> DistUniTensor::blockQnum()const{
+  std::vector<Qnum> qnums;
+  for(std::map<Qnum, DistMatrix>::const_iterator it = blocks.begin(); it != blocks.end(); ++it)
+    qnums.push_back(it->first);
+  return qnums;
+}
+
+size_t DistUniTensor::blockNum()const{
+  return blocks.size();
+}
+
+const DistMatrix& DistUniTensor::getBlock(const Qnum& qnum)const{
+  std::map<Qnum, DistMatrix>::const_iterator it = blocks.find(qnum);
+  try{
+    if(it == blocks.end()){
+      std::ostringstream err;
+      err<<"There is no block with the given quantum number "<<qnum;
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function DistUniTensor::getBlock(uni10::Qnum&):");
+  }
+  return it->second;
+}
+
+int DistUniTensor::blockOwner(const Qnum& qnum)const{
+  return getBlock(qnum).owner();
+}
+
+void DistUniTensor::putBlock(const Qnum& qnum, const DistMatrix& M){
+  try{
+    std::map<Qnum, DistMatrix>::iterator it = blocks.find(qnum);
+    if(it == blocks.end()){
+      std::ostringstream err;
+      err<<"There is no block with the given quantum number "<<qnum;
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    if(M.row() != it->second.row() || M.col() != it->second.col()){
+      std::ostringstream err;
+      err<<"The dimension of input matrix does not match for the dimension of the block with quantum number "<<qnum<<std::endl;
+      err<<"  Hint: Use Matrix::resize(int, int)";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    remap(M, it->second, false);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function DistUniTensor::putBlock(uni10::Qnum&, uni10::DistMatrix&):");
+  }
+}
+
+size_t DistUniTensor::elemNum()const{
+  size_t num = 0;
+  for(std::map<Qnum, DistMatrix>::const_iterator it = blocks.begin(); it != blocks.end(); ++it)
+    num += it->second.row() * it->second.col();
+  return num;
+}
+
+size_t DistUniTensor::localBytes()const{
+  size_t bytes = 0;
+  for(std::map<Qnum, DistMatrix>::const_iterator it = blocks.begin(); it != blocks.end(); ++it)
+    bytes += it->second.localBytes();
+  return bytes;
+}
+
+Real DistUniTensor::norm()const{
+  Real norm2 = 0;
+  for(std::map<Qnum, DistMatrix>::const_iterator it = blocks.begin(); it != blocks.end(); ++it){
+    Real n = it->second.norm();
+    norm2 += n * n;
+  }
+  return std::sqrt(norm2);
+}
+
+size_t DistUniTensor::threshold()const{
+  return m_threshold;
+}
+
+int DistUniTensor::blockSize()const{
+  return nb;
+}
+
+DistUniTensor contract(const DistUniTensor& Ta, const DistUniTensor& Tb){
+  DistUniTensor Tc;
+  try{
+    if(Ta.m_grid != Tb.m_grid || Ta.nb != Tb.nb){
+      std::ostringstream err;
+      err<<"Cannot contract tensors of different tiles or grids.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    size_t contracted = Ta.bonds.size() - Ta.RBondNum;
+    bool match = contracted == (size_t)Tb.RBondNum;
+    for(size_t b = 0; match && b < contracted; b++)
+      match = Ta.labels[Ta.RBondNum + b] == Tb.labels[b] && Ta.bonds[Ta.RBondNum + b].Qlist() == Tb.bonds[b].Qlist();
+    if(!match){
+      std::ostringstream err;
+      err<<"The outgoing bonds of the first tensor must be the incoming bonds of the second, in the same order.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    std::vector<Bond> bonds(Ta.bonds.begin(), Ta.bonds.begin() + Ta.RBondNum);
+    bonds.insert(bonds.end(), Tb.bonds.begin() + Tb.RBondNum, Tb.bonds.end());
+    std::vector<int> labels(Ta.labels.begin(), Ta.labels.begin() + Ta.RBondNum);
+    labels.insert(labels.end(), Tb.labels.begin() + Tb.RBondNum, Tb.labels.end());
+    Tc = DistUniTensor(*Ta.m_grid, bonds, Ta.m_threshold, Ta.nb);
+    Tc.setLabel(labels);
+    for(std::map<Qnum, DistMatrix>::iterator it = Tc.blocks.begin(); it != Tc.blocks.end(); ++it){
+      std::map<Qnum, DistMatrix>::const_iterator a = Ta.blocks.find(it->first);
+      std::map<Qnum, DistMatrix>::const_iterator b = Tb.blocks.find(it->first);
+      if(a != Ta.blocks.end() && b != Tb.blocks.end())
+        it->second = multiply(a->second, b->second, it->second.owner());
+    }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function contract(uni10::DistUniTensor&, uni10::DistUniTensor&):");
+  }
+  return Tc;
+}
+
+std::vector<DistUniTensor> truncatedSvd(const DistUniTensor& T, int maxChi, Real cutoff, Real& discarded){
+  std::vector<DistUniTensor> usv;
+  try{
+    const ProcessGrid& grid = T.grid();
+    int me = grid.rank(), nb = T.blockSize();
+    std::vector<Qnum> qnums = T.blockQnum();
+    size_t blockNum = qnums.size();
+    // the factors of the blocks held by this process, or of the blocks split over the grid
+    std::vector<std::vector<Matrix> > svds(blockNum);
+    std::vector<DistMatrix> Us(blockNum), VTs(blockNum);
+    std::vector<Real> mine;  // pairs of a singular value and its block
+    for(size_t b = 0; b < blockNum; b++){
+      const DistMatrix& A = T.getBlock(qnums[b]);
+      std::vector<Real> s;
+      if(A.owner() < 0)
+        tsqrSvd(A, s, Us[b], VTs[b]);
+      else if(A.owner() == me){
+        svds[b] = Matrix(A.row(), A.col(), A.local()).svd();
+        s.assign(svds[b][1].getElem(), svds[b][1].getElem() + svds[b][1].row());
+      }
+      if(A.owner() == me || (A.owner() < 0 && me == 0))
+        for(size_t i = 0; i < s.size(); i++){
+          mine.push_back(s[i]);
+          mine.push_back(b);
+        }
+    }
+    int count = mine.size();
+    std::vector<int> counts(grid.size()), displs(grid.size(), 0);
+    MPI_Allgather(&count, 1, MPI_INT, &counts[0], 1, MPI_INT, grid.comm());
+    for(int p = 1; p < grid.size(); p++)
+      displs[p] = displs[p - 1] + counts[p - 1];
+    std::vector<Real> all(displs.back() + counts.back() + 1);
+    mine.push_back(0);
+    MPI_Allgatherv(&mine[0], count, MPI_DOUBLE, &all[0], &counts[0], &displs[0], MPI_DOUBLE, grid.comm());
+    std::vector<std::pair<Real, size_t> > values;
+    for(size_t i = 0; i + 1 < all.size(); i += 2)
+      values.push_back(std::make_pair(all[i], (size_t)all[i + 1]));
+    if(values.empty()){
+      std::ostringstream err;
+      err<<"The tensor has no element to decompose.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    std::sort(values.begin(), values.end(), std::greater<std::pair<Real, size_t> >());
+    std::vector<Real> s(values.size());
+    for(size_t i = 0; i < values.size(); i++)
+      s[i] = values[i].first;
+    size_t keep = truncationRank(&s[0], s.size(), maxChi, cutoff, discarded);
+    // the values of a block are in decreasing order, the first ones of each block are kept
+    std::vector<std::vector<Real> > kept(blockNum);
+    for(size_t i = 0; i < keep; i++)
+      kept[values[i].second].push_back(values[i].first);
+    std::vector<Qnum> kqnums;
+    for(size_t b = 0; b < blockNum; b++)
+      kqnums.insert(kqnums.end(), kept[b].size(), qnums[b]);
+
+    std::vector<Bond> bondU, bondS, bondV;
+    for(size_t i = 0; i < T.bondNum(); i++)
+      ((int)i < T.inBondNum() ? bondU : bondV).push_back(T.bond(i));
+    bondU.push_back(Bond(BD_OUT, kqnums));
+    bondS.push_back(Bond(BD_IN, kqnums));
+    bondS.push_back(Bond(BD_OUT, kqnums));
+    bondV.insert(bondV.begin(), Bond(BD_IN, kqnums));
+    usv.push_back(DistUniTensor(grid, bondU, T.threshold(), nb));
+    usv.push_back(DistUniTensor(grid, bondS, T.threshold(), nb));
+    usv.push_back(DistUniTensor(grid, bondV, T.threshold(), nb));
+    for(size_t b = 0; b < blockNum; b++){
+      size_t k = kept[b].size();
+      if(k == 0)
+        continue;
+      const DistMatrix& A = T.getBlock(qnums[b]);
+      size_t m = A.row(), n = A.col();
+      if(A.owner() < 0){
+        usv[0].putBlock(qnums[b], Us[b].leading(m, k));
+        usv[2].putBlock(qnums[b], VTs[b].leading(k, n));
+      }
+      else{
+        DistMatrix U(grid, m, k, nb, A.owner()), VT(grid, k, n, nb, A.owner());
+        if(A.owner() == me){
+          svds[b][0].resize(m, k);
+          svds[b][2].resize(k, n);
+          std::memcpy(U.local(), svds[b][0].getElem(), m * k * sizeof(Real));
+          std::memcpy(VT.local(), svds[b][2].getElem(), k * n * sizeof(Real));
+        }
+        usv[0].putBlock(qnums[b], U);
+        usv[2].putBlock(qnums[b], VT);
+      }
+      std::vector<Real> S(k * k, 0);
+      for(size_t i = 0; i < k; i++)
+        S[i * k + i] = kept[b][i];
+      DistMatrix Sb(grid, k, k, nb, usv[1].blockOwner(qnums[b]));
+      Sb.assign(&S[0]);
+      usv[1].putBlock(qnums[b], Sb);
+    }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function truncatedSvd(uni10::DistUniTensor&, int, uni10::Real, uni10::Real&):");
+  }
+  return usv;
+}
+
+};	/* namespace uni10 */
@@ -0,0 +1,84 @@
+/****************************************************************************
+*  @file MPISectorScheduler.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file of the MPISectorScheduler class
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/distributed/MPISectorScheduler.h>
+#include <uni10/numeric/lapack/uni10_lapack.h>
+#include <algorithm>
+namespace uni10{
+
+namespace{
+
+template<typename T>
+void spread(std::vector<SectorGemm<T> >& gemms, MPI_Comm comm, double minCost){
+  int size, rank;
+  MPI_Comm_size(comm, &size);
+  MPI_Comm_rank(comm, &rank);
+  double total = 0;
+  for(size_t i = 0; i < gemms.size(); i++)
+    total += gemms[i].cost();
+  std::vector<SectorGemm<T> > tasks = size > 1 && total >= minCost ? splitSectors(gemms, size) : gemms;
+  std::vector<int> owner = size > 1 && total >= minCost ? balanceSectors(tasks, size) : std::vector<int>(tasks.size(), rank);
+  for(size_t t = 0; t < tasks.size(); t++)
+    if(owner[t] == rank && tasks[t].M && tasks[t].N)
+      matrixMul(const_cast<T*>(tasks[t].A), const_cast<T*>(tasks[t].B), tasks[t].M, tasks[t].N, tasks[t].K, tasks[t].C, false, false, false);
+  if(size == 1 || total < minCost)
+    return;
+  // doubles of the rows of each band, in chunks within the range of an MPI count
+  const size_t chunk = 1 << 30, scale = sizeof(T) / sizeof(double);
+  for(size_t t = 0; t < tasks.size(); t++){
+    double* C = (double*)tasks[t].C;
+    size_t count = tasks[t].M * tasks[t].N * scale;
+    for(size_t off = 0; off < count; off += chunk)
+      MPI_Bcast(C + off, (int)std::min(chunk, count - off), MPI_DOUBLE, owner[t], comm);
+  }
+}
+
+};
+
+MPISectorScheduler::MPISectorScheduler(MPI_Comm comm, double minCost): m_minCost(minCost){
+  MPI_Comm_dup(comm, &m_comm);
+}
+
+MPISectorScheduler::~MPISectorScheduler(){
+  MPI_Comm_free(&m_comm);
+}
+
+double MPISectorScheduler::minCost()const{
+  return m_minCost;
+}
+
+void MPISectorScheduler::run(std::vector<SectorGemm<double> >& gemms){
+  spread(gemms, m_comm, m_minCost);
+}
+
+void MPISectorScheduler::run(std::vector<SectorGemm<std::complex<double> > >& gemms){
+  spread(gemms, m_comm, m_minCost);
+}
+
+};	/* namespace uni10 */
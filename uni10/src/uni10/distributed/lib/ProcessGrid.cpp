@@ -0,0 +1,107 @@
+/****************************************************************************
+*  @file ProcessGrid.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file of the two dimensional grid of MPI processes
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/distributed/ProcessGrid.h>
+#include <uni10/tools/uni10_tools.h>
+#include <cmath>
+namespace uni10{
+
+ProcessGrid::ProcessGrid(MPI_Comm comm, int rows){
+  try{
+    MPI_Comm_dup(comm, &m_comm);
+    MPI_Comm_rank(m_comm, &m_rank);
+    MPI_Comm_size(m_comm, &m_size);
+    if(rows <= 0){
+      rows = (int)std::sqrt((double)m_size);
+      while(m_size % rows)
+        rows--;
+    }
+    if(m_size % rows){
+      MPI_Comm_free(&m_comm);
+      std::ostringstream err;
+      err<<"The " << m_size << " processes cannot fill a grid of " << rows << " rows.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    m_rows = rows;
+    m_cols = m_size / rows;
+    MPI_Comm_split(m_comm, myRow(), myCol(), &m_rowComm);
+    MPI_Comm_split(m_comm, myCol(), myRow(), &m_colComm);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor ProcessGrid::ProcessGrid(MPI_Comm, int):");
+  }
+}
+
+ProcessGrid::~ProcessGrid(){
+  MPI_Comm_free(&m_rowComm);
+  MPI_Comm_free(&m_colComm);
+  MPI_Comm_free(&m_comm);
+}
+
+MPI_Comm ProcessGrid::comm()const{
+  return m_comm;
+}
+
+MPI_Comm ProcessGrid::rowComm()const{
+  return m_rowComm;
+}
+
+MPI_Comm ProcessGrid::colComm()const{
+  return m_colComm;
+}
+
+int ProcessGrid::rank()const{
+  return m_rank;
+}
+
+int ProcessGrid::size()const{
+  return m_size;
+}
+
+int ProcessGrid::rows()const{
+  return m_rows;
+}
+
+int ProcessGrid::cols()const{
+  return m_cols;
+}
+
+int ProcessGrid::myRow()const{
+  return m_rank / m_cols;
+}
+
+int ProcessGrid::myCol()const{
+  return m_rank % m_cols;
+}
+
+int ProcessGrid::rankOf(int r, int c)const{
+  return r * m_cols + c;
+}
+
+};	/* namespace uni10 */
@@ -38,13 +38,93 @@
 #include <string.h>
 #include <uni10/numeric/lapack/uni10_lapack.h>
 #include <uni10/tools/uni10_tools.h>
+#include <uni10/tools/uni10_profile.h>
+#include <uni10/tools/uni10_tuning.h>
 #include <iostream>
+#include <algorithm>
 namespace uni10{
+
+namespace{
+  // C = op(A) * op(B) in row-major order for products too small to amortize the BLAS call,
+  // see TuningParams::gemmSmallCutoff.
+  template<typename T>
+  bool smallMatrixMul(const T* A, const T* B, int M, int N, int K, T* C, bool transA, bool transB){
+    if((size_t)M * N * K >= tuning().gemmSmallCutoff)
+      return false;
+    for(int i = 0; i < M; i++){
+      T* c = C + (size_t)i * N;
+      for(int j = 0; j < N; j++)
+        c[j] = 0;
+      for(int k = 0; k < K; k++){
+        T a = transA ? A[(size_t)k * M + i] : A[(size_t)i * K + k];
+        if(transB)
+          for(int j = 0; j < N; j++)
+            c[j] += a * B[(size_t)j * K + k];
+        else{
+          const T* b = B + (size_t)k * N;
+          for(int j = 0; j < N; j++)
+            c[j] += a * b[j];
+        }
+      }
+    }
+    return true;
+  }
+
+  // Y = a * X + b * Y in one pass, written so that the compiler vectorizes each branch
+  template<typename TY, typename TX, typename S>
+  void axpbyKernel(S a, const TX* X, S b, TY* Y, size_t N){
+    parallelRange(N, tuning().vectorParallelMin, [=](size_t begin, size_t end){
+      TY* y = Y + begin;
+      const TX* x = X + begin;
+      size_t n = end - begin;
+      if(a == S(0)){
+        if(b == S(0))
+          std::fill(y, y + n, TY(0));
+        else if(b != S(1))
+          for(size_t i = 0; i < n; i++)
+            y[i] *= b;
+      }
+      else if(b == S(1))
+        for(size_t i = 0; i < n; i++)
+          y[i] += a * x[i];
+      else if(b == S(0))
+        for(size_t i = 0; i < n; i++)
+          y[i] = a * x[i];
+      else
+        for(size_t i = 0; i < n; i++)
+          y[i] = a * x[i] + b * y[i];
+    });
+  }
+
+  template<typename TY, typename TX>
+  void mulKernel(TY* Y, const TX* X, size_t N){
+    parallelRange(N, tuning().vectorParallelMin, [=](size_t begin, size_t end){
+      for(size_t i = begin; i < end; i++)
+        Y[i] *= X[i];
+    });
+  }
+};
 void matrixMul(double* A, double* B, int M, int N, int K, double* C, bool ongpuA, bool ongpuB, bool ongpuC){
+	UNI10_PROFILE_SCOPE(prof, PROF_GEMM, ((size_t)M * K + (size_t)K * N + (size_t)M * N) * sizeof(double));
+	UNI10_PROFILE_FLOPS(prof, (uint64_t)2 * M * N * K);
+	if(smallMatrixMul(A, B, M, N, K, C, false, false))
+		return;
 	double alpha = 1, beta = 0;
 	dgemm((char*)"N", (char*)"N", &N, &M, &K, &alpha, B, &N, A, &K, &beta, C, &N);
 }
 
+void matrixMul(double* A, double* B, int M, int N, int K, double* C, bool transA, bool transB, bool ongpuA, bool ongpuB, bool ongpuC){
+	UNI10_PROFILE_SCOPE(prof, PROF_GEMM, ((size_t)M * K + (size_t)K * N + (size_t)M * N) * sizeof(double));
+	UNI10_PROFILE_FLOPS(prof, (uint64_t)2 * M * N * K);
+	if(smallMatrixMul(A, B, M, N, K, C, transA, transB))
+		return;
+	double alpha = 1, beta = 0;
+	int lda = std::max(1, transA ? M : K);
+	int ldb = std::max(1, transB ? K : N);
+	int ldc = std::max(1, N);
+	dgemm((char*)(transB ? "T" : "N"), (char*)(transA ? "T" : "N"), &N, &M, &K, &alpha, B, &ldb, A, &lda, &beta, C, &ldc);
+}
+
 void diagRowMul(double* mat, double* diag, size_t M, size_t N, bool mat_ongpu, bool diag_ongpu){
 	for(size_t i = 0; i < M; i++)
 		vectorScal(diag[i], &(mat[i * N]), N, false);
@@ -91,8 +171,11 @@ void vectorScal(double a, double* X, size_t N, bool ongpu){
 }
 
 void vectorMul(double* Y, double* X, size_t N, bool y_ongpu, bool x_ongpu){ // Y = Y * X, element-wise multiplication;
-  for(size_t i = 0; i < N; i++)
-    Y[i] *= X[i];
+  mulKernel(Y, X, N);
+}
+
+void vectorAxpby(double a, double* X, double b, double* Y, size_t N, bool y_ongpu, bool x_ongpu){
+  axpbyKernel(a, X, b, Y, N);
 }
 
 void vectorExp(double a, double* X, size_t N, bool ongpu){
@@ -123,14 +206,49 @@ void orthoRandomize(double* elem, int M, int N, bool ongpu){
 	free(S);
 }
 
+namespace{
+  // zgeev without the profiling, shared by the real and the complex eigDecompose
+  void geevDecompose(std::complex<double>* Kij, int N, std::complex<double>* Eig, std::complex<double>* EigVec){
+    size_t memsize = N * N * sizeof(std::complex<double>);
+    std::complex<double> *A = (std::complex<double>*) malloc(memsize);
+    memcpy(A, Kij, memsize);
+    int ldA = N;
+    int ldvl = 1;
+    int ldvr = N;
+    int lwork = -1;
+    double *rwork = (double*) malloc(2 * N * sizeof(double));
+    std::complex<double> worktest;
+    int info;
+    zgeev((char*)"N", (char*)"V", &N, A, &ldA, Eig, NULL, &ldvl, EigVec, &ldvr, &worktest, &lwork, rwork, &info);
+    if(info != 0){
+      std::ostringstream err;
+      err<<"Error in Lapack function 'zgeev': Lapack INFO = "<<info;
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    lwork = (int)worktest.real();
+    std::complex<double>* work = (std::complex<double>*)malloc(sizeof(std::complex<double>)*lwork);
+    zgeev((char*)"N", (char*)"V", &N, A, &ldA, Eig, NULL, &ldvl, EigVec, &ldvr, work, &lwork, rwork, &info);
+    if(info != 0){
+      std::ostringstream err;
+      err<<"Error in Lapack function 'zgeev': Lapack INFO = "<<info;
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    free(work);
+    free(rwork);
+    free(A);
+  }
+};
+
 void eigDecompose(double* Kij_ori, int N, std::complex<double>* Eig, std::complex<double>* EigVec, bool ongpu){
+  UNI10_PROFILE_SCOPE(prof, PROF_EIG, N * N * sizeof(double));
   std::complex<double> *Kij = (std::complex<double>*) malloc(N * N * sizeof(std::complex<double>));
   elemCast(Kij, Kij_ori, N * N, ongpu, ongpu);
-  eigDecompose(Kij, N, Eig, EigVec, ongpu);
+  geevDecompose(Kij, N, Eig, EigVec);
   free(Kij);
 }
 
 void eigSyDecompose(double* Kij, int N, double* Eig, double* EigVec, bool ongpu){
+	UNI10_PROFILE_SCOPE(prof, PROF_EIGH, N * N * sizeof(double));
 	memcpy(EigVec, Kij, N * N * sizeof(double));
 	int ldA = N;
 	int lwork = -1;
@@ -158,6 +276,7 @@ void eigSyDecompose(double* Kij, int N, double* Eig, double* EigVec, bool ongpu)
 // dorgrq -> ql 
 // dorgql -> rq
 void matrixQR(double* Mij_ori, int M, int N, double* Q, double* R, bool ongpu){
+  UNI10_PROFILE_SCOPE(prof, PROF_QR, M * N * sizeof(double));
   assert(M >= N);
   double* Mij = (double*)malloc(N*M*sizeof(double));
   memcpy(Mij, Mij_ori, N*M*sizeof(double));
@@ -189,6 +308,7 @@ void matrixQR(double* Mij_ori, int M, int N, double* Q, double* R, bool ongpu){
 }
 
 void matrixRQ(double* Mij_ori, int M, int N, double* Q, double* R, bool ongpu){
+  UNI10_PROFILE_SCOPE(prof, PROF_QR, M * N * sizeof(double));
 
   assert(N >= M);
   double* Mij = (double*)malloc(M*N*sizeof(double));
@@ -223,6 +343,7 @@ void matrixRQ(double* Mij_ori, int M, int N, double* Q, double* R, bool ongpu){
 }
 
 void matrixLQ(double* Mij_ori, int M, int N, double* Q, double* L, bool ongpu){
+  UNI10_PROFILE_SCOPE(prof, PROF_QR, M * N * sizeof(double));
 
   assert(N >= M);
   double* Mij = (double*)malloc(M*N*sizeof(double));
@@ -255,6 +376,7 @@ void matrixLQ(double* Mij_ori, int M, int N, double* Q, double* L, bool ongpu){
 }
 
 void matrixQL(double* Mij_ori, int M, int N, double* Q, double* R, bool ongpu){
+  UNI10_PROFILE_SCOPE(prof, PROF_QR, M * N * sizeof(double));
   assert(M >= N);
   double* Mij = (double*)malloc(N*M*sizeof(double));
   memcpy(Mij, Mij_ori, N*M*sizeof(double));
@@ -286,6 +408,7 @@ void matrixQL(double* Mij_ori, int M, int N, double* Q, double* R, bool ongpu){
 }
 
 void matrixSVD(double* Mij_ori, int M, int N, double* U, double* S, double* vT, bool ongpu){
+	UNI10_PROFILE_SCOPE(prof, PROF_SVD, M * N * sizeof(double));
 	double* Mij = (double*)malloc(M * N * sizeof(double));
 	memcpy(Mij, Mij_ori, M * N * sizeof(double));
 	int min = std::min(M, N);
@@ -311,6 +434,19 @@ void matrixSVD(double* Mij_ori, int M, int N, double* U, double* S, double* vT,
 	free(Mij);
 }
 
+void matrixSVD(double* Mij, int M, int N, double* U, double* S, double* vT, double* work, int lwork, int* iwork, bool ongpu){
+	UNI10_PROFILE_SCOPE(prof, PROF_SVD, lwork < 0 ? 0 : M * N * sizeof(double));
+	int min = std::min(M, N);
+	int ldA = N, ldu = N, ldvT = min;
+	int info;
+	dgesdd((char*)"S", &N, &M, Mij, &ldA, S, vT, &ldu, U, &ldvT, work, &lwork, iwork, &info);
+  if(info != 0){
+    std::ostringstream err;
+    err<<"Error in Lapack function 'dgesdd': Lapack INFO = "<<info;
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+}
+
 void matrixInv(double* A, int N, bool diag, bool ongpu){
   if(diag){
     for(int i = 0; i < N; i++)
@@ -597,6 +733,7 @@ bool lanczosEVL(double* A, double* psi, size_t dim, size_t& max_iter, double err
 
 /***** Complex version *****/
 void matrixSVD(std::complex<double>* Mij_ori, int M, int N, std::complex<double>* U, double *S, std::complex<double>* vT, bool ongpu){
+	UNI10_PROFILE_SCOPE(prof, PROF_SVD, M * N * sizeof(std::complex<double>));
 	std::complex<double>* Mij = (std::complex<double>*)malloc(M * N * sizeof(std::complex<double>));
 	memcpy(Mij, Mij_ori, M * N * sizeof(std::complex<double>));
 	int min = std::min(M, N);
@@ -623,6 +760,22 @@ void matrixSVD(std::complex<double>* Mij_ori, int M, int N, std::complex<double>
 	free(work);
 	free(Mij);
 }
+void matrixSVD(std::complex<double>* Mij, int M, int N, std::complex<double>* U, double *S, std::complex<double>* vT, std::complex<double>* work, int lwork, double* rwork, int* iwork, bool ongpu){
+	UNI10_PROFILE_SCOPE(prof, PROF_SVD, lwork < 0 ? 0 : M * N * sizeof(std::complex<double>));
+	int min = std::min(M, N);
+	int ldA = N, ldu = N, ldvT = min;
+	int info;
+	zgesdd((char*)"S", &N, &M, Mij, &ldA, S, vT, &ldu, U, &ldvT, work, &lwork, rwork, iwork, &info);
+  if(info != 0){
+    std::ostringstream err;
+    err<<"Error in Lapack function 'zgesdd': Lapack INFO = "<<info;
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+}
+size_t svdRworkSize(int M, int N){
+	size_t mn = std::min(M, N), mx = std::max(M, N);
+	return std::max(5 * mn * mn + 5 * mn, 2 * mx * mn + 2 * mn * mn + mn);
+}
 void matrixSVD(std::complex<double>* Mij_ori, int M, int N, std::complex<double>* U, std::complex<double>* S_ori, std::complex<double>* vT, bool ongpu){
 	int min = std::min(M, N);
   double* S = (double*)malloc(min * sizeof(double));
@@ -694,10 +847,26 @@ std::complex<double> vectorSum(std::complex<double>* X, size_t N, int inc, bool
 	return sum;
 }
 void matrixMul(std::complex<double>* A, std::complex<double>* B, int M, int N, int K, std::complex<double>* C, bool ongpuA, bool ongpuB, bool ongpuC){
+	UNI10_PROFILE_SCOPE(prof, PROF_GEMM, ((size_t)M * K + (size_t)K * N + (size_t)M * N) * sizeof(std::complex<double>));
+	UNI10_PROFILE_FLOPS(prof, (uint64_t)8 * M * N * K);
+	if(smallMatrixMul(A, B, M, N, K, C, false, false))
+		return;
   std::complex<double> alpha = 1.0, beta = 0.0;
 	zgemm((char*)"N", (char*)"N", &N, &M, &K, &alpha, B, &N, A, &K, &beta, C, &N);
 }
 
+void matrixMul(std::complex<double>* A, std::complex<double>* B, int M, int N, int K, std::complex<double>* C, bool transA, bool transB, bool ongpuA, bool ongpuB, bool ongpuC){
+	UNI10_PROFILE_SCOPE(prof, PROF_GEMM, ((size_t)M * K + (size_t)K * N + (size_t)M * N) * sizeof(std::complex<double>));
+	UNI10_PROFILE_FLOPS(prof, (uint64_t)8 * M * N * K);
+	if(smallMatrixMul(A, B, M, N, K, C, transA, transB))
+		return;
+  std::complex<double> alpha = 1.0, beta = 0.0;
+	int lda = std::max(1, transA ? M : K);
+	int ldb = std::max(1, transB ? K : N);
+	int ldc = std::max(1, N);
+	zgemm((char*)(transB ? "T" : "N"), (char*)(transA ? "T" : "N"), &N, &M, &K, &alpha, B, &ldb, A, &lda, &beta, C, &ldc);
+}
+
 void vectorAdd(std::complex<double>* Y, double* X, size_t N, bool y_ongpu, bool x_ongpu){	// Y = Y + X
   for(size_t i = 0; i < N; i++)
     Y[i] += X[i];
@@ -751,8 +920,19 @@ void vectorScal(const std::complex<double>& a, std::complex<double>* X, size_t N
 	}
 }
 void vectorMul(std::complex<double>* Y, std::complex<double>* X, size_t N, bool y_ongpu, bool x_ongpu){ // Y = Y * X, element-wise multiplication;
-  for(size_t i = 0; i < N; i++)
-    Y[i] *= X[i];
+  mulKernel(Y, X, N);
+}
+
+void vectorMul(std::complex<double>* Y, double* X, size_t N, bool y_ongpu, bool x_ongpu){
+  mulKernel(Y, X, N);
+}
+
+void vectorAxpby(const std::complex<double>& a, std::complex<double>* X, const std::complex<double>& b, std::complex<double>* Y, size_t N, bool y_ongpu, bool x_ongpu){
+  axpbyKernel(a, X, b, Y, N);
+}
+
+void vectorAxpby(const std::complex<double>& a, double* X, const std::complex<double>& b, std::complex<double>* Y, size_t N, bool y_ongpu, bool x_ongpu){
+  axpbyKernel(a, X, b, Y, N);
 }
 
 void diagRowMul(std::complex<double>* mat, std::complex<double>* diag, size_t M, size_t N, bool mat_ongpu, bool diag_ongpu){
@@ -824,36 +1004,12 @@ void setCTranspose(std::complex<double>* A, size_t M, size_t N, bool ongpu){
 }
 
 void eigDecompose(std::complex<double>* Kij, int N, std::complex<double>* Eig, std::complex<double>* EigVec, bool ongpu){
-  size_t memsize = N * N * sizeof(std::complex<double>);
-  std::complex<double> *A = (std::complex<double>*) malloc(memsize);
-  memcpy(A, Kij, memsize);
-  int ldA = N;
-  int ldvl = 1;
-  int ldvr = N;
-  int lwork = -1;
-  double *rwork = (double*) malloc(2 * N * sizeof(double));
-  std::complex<double> worktest;
-  int info;
-  zgeev((char*)"N", (char*)"V", &N, A, &ldA, Eig, NULL, &ldvl, EigVec, &ldvr, &worktest, &lwork, rwork, &info);
-  if(info != 0){
-    std::ostringstream err;
-    err<<"Error in Lapack function 'zgeev': Lapack INFO = "<<info;
-    throw std::runtime_error(exception_msg(err.str()));
-  }
-  lwork = (int)worktest.real();
-  std::complex<double>* work = (std::complex<double>*)malloc(sizeof(std::complex<double>)*lwork);
-  zgeev((char*)"N", (char*)"V", &N, A, &ldA, Eig, NULL, &ldvl, EigVec, &ldvr, work, &lwork, rwork, &info);
-  if(info != 0){
-    std::ostringstream err;
-    err<<"Error in Lapack function 'zgeev': Lapack INFO = "<<info;
-    throw std::runtime_error(exception_msg(err.str()));
-  }
-  free(work);
-  free(rwork);
-  free(A);
+  UNI10_PROFILE_SCOPE(prof, PROF_EIG, N * N * sizeof(std::complex<double>));
+  geevDecompose(Kij, N, Eig, EigVec);
 }
 
 void eigSyDecompose(std::complex<double>* Kij, int N, double* Eig, std::complex<double>* EigVec, bool ongpu){
+  UNI10_PROFILE_SCOPE(prof, PROF_EIGH, N * N * sizeof(std::complex<double>));
   //eigDecompose(Kij, N, Eig, EigVec, ongpu);
   memcpy(EigVec, Kij, N * N * sizeof(std::complex<double>));
   int ldA = N;
@@ -991,6 +1147,7 @@ bool lanczosEV(std::complex<double>* A, std::complex<double>* psi, size_t dim, s
 }
 
 void matrixQR(std::complex<double>* Mij_ori, int M, int N, std::complex<double>* Q, std::complex<double>* R, bool ongpu){
+  UNI10_PROFILE_SCOPE(prof, PROF_QR, M * N * sizeof(std::complex<double>));
   std::complex<double>* Mij = (std::complex<double>*)malloc(N*M*sizeof(std::complex<double>));
   memcpy(Mij, Mij_ori, N*M*sizeof(std::complex<double>));
   std::complex<double>* tau = (std::complex<double>*)malloc(M*sizeof(std::complex<double>));
@@ -1021,6 +1178,7 @@ void matrixQR(std::complex<double>* Mij_ori, int M, int N, std::complex<double>*
 }
 
 void matrixRQ(std::complex<double>* Mij_ori, int M, int N, std::complex<double>* Q, std::complex<double>* R, bool ongpu){
+  UNI10_PROFILE_SCOPE(prof, PROF_QR, M * N * sizeof(std::complex<double>));
 
   std::complex<double>* Mij = (std::complex<double>*)malloc(M*N*sizeof(std::complex<double>));
   memcpy(Mij, Mij_ori, M*N*sizeof(std::complex<double>));
@@ -1053,6 +1211,7 @@ void matrixRQ(std::complex<double>* Mij_ori, int M, int N, std::complex<double>*
 }
 
 void matrixLQ(std::complex<double>* Mij_ori, int M, int N, std::complex<double>* Q, std::complex<double>* L, bool ongpu){
+  UNI10_PROFILE_SCOPE(prof, PROF_QR, M * N * sizeof(std::complex<double>));
 
   std::complex<double>* Mij = (std::complex<double>*)malloc(M*N*sizeof(std::complex<double>));
   memcpy(Mij, Mij_ori, M*N*sizeof(std::complex<double>));
@@ -1084,6 +1243,7 @@ void matrixLQ(std::complex<double>* Mij_ori, int M, int N, std::complex<double>*
 }
 
 void matrixQL(std::complex<double>* Mij_ori, int M, int N, std::complex<double>* Q, std::complex<double>* L, bool ongpu){
+  UNI10_PROFILE_SCOPE(prof, PROF_QR, M * N * sizeof(std::complex<double>));
   assert(M >= N);
   std::complex<double>* Mij = (std::complex<double>*)malloc(N*M*sizeof(std::complex<double>));
   memcpy(Mij, Mij_ori, N*M*sizeof(std::complex<double>));
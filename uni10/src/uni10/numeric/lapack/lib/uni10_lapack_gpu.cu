@@ -189,6 +189,13 @@ void vectorMul(double* Y, double* X, size_t N, bool y_ongpu, bool x_ongpu){
   throw std::runtime_error(exception_msg(err.str()));
 
 }// Y = Y * X, element-wise multiplication;
+void vectorAxpby(double a, double* X, double b, double* Y, size_t N, bool y_ongpu, bool x_ongpu){
+
+  std::ostringstream err;
+  err<<"GPU version is not ready !!!!";
+  throw std::runtime_error(exception_msg(err.str()));
+
+}// Y = a * X + b * Y
 double vectorSum(double* X, size_t N, int inc, bool ongpu){
 
   std::ostringstream err;
@@ -623,6 +630,38 @@ double vectorNorm(std::complex<double>* X, size_t N, int inc, bool ongpu){
   err<<"GPU version is not ready !!!!";
   throw std::runtime_error(exception_msg(err.str()));
 
+}
+void matrixSVD(double* Mij, int M, int N, double* U, double* S, double* vT, double* work, int lwork, int* iwork, bool ongpu){
+
+  std::ostringstream err;
+  err<<"GPU version is not ready !!!!";
+  throw std::runtime_error(exception_msg(err.str()));
+
+}
+size_t svdRworkSize(int M, int N){
+	size_t mn = std::min(M, N), mx = std::max(M, N);
+	return std::max(5 * mn * mn + 5 * mn, 2 * mx * mn + 2 * mn * mn + mn);
+}
+void matrixSVD(std::complex<double>* Mij, int M, int N, std::complex<double>* U, double *S, std::complex<double>* vT, std::complex<double>* work, int lwork, double* rwork, int* iwork, bool ongpu){
+
+  std::ostringstream err;
+  err<<"GPU version is not ready !!!!";
+  throw std::runtime_error(exception_msg(err.str()));
+
+}
+void matrixMul(double* A, double* B, int M, int N, int K, double* C, bool transA, bool transB, bool ongpuA, bool ongpuB, bool ongpuC){
+
+  std::ostringstream err;
+  err<<"GPU version is not ready !!!!";
+  throw std::runtime_error(exception_msg(err.str()));
+
+}
+void matrixMul(std::complex<double>* A, std::complex<double>* B, int M, int N, int K, std::complex<double>* C, bool transA, bool transB, bool ongpuA, bool ongpuB, bool ongpuC){
+
+  std::ostringstream err;
+  err<<"GPU version is not ready !!!!";
+  throw std::runtime_error(exception_msg(err.str()));
+
 }
 void matrixMul(std::complex<double>* A, std::complex<double>* B, int M, int N, int K, std::complex<double>* C, bool ongpuA, bool ongpuB, bool ongpuC){
 
@@ -667,6 +706,27 @@ void vectorMul(std::complex<double>* Y, std::complex<double>* X, size_t N, bool
   throw std::runtime_error(exception_msg(err.str()));
 
 } // Y = Y * X, element-wise multiplication;
+void vectorMul(std::complex<double>* Y, double* X, size_t N, bool y_ongpu, bool x_ongpu){
+
+  std::ostringstream err;
+  err<<"GPU version is not ready !!!!";
+  throw std::runtime_error(exception_msg(err.str()));
+
+} // Y = Y * X, element-wise multiplication;
+void vectorAxpby(const std::complex<double>& a, std::complex<double>* X, const std::complex<double>& b, std::complex<double>* Y, size_t N, bool y_ongpu, bool x_ongpu){
+
+  std::ostringstream err;
+  err<<"GPU version is not ready !!!!";
+  throw std::runtime_error(exception_msg(err.str()));
+
+} // Y = a * X + b * Y
+void vectorAxpby(const std::complex<double>& a, double* X, const std::complex<double>& b, std::complex<double>* Y, size_t N, bool y_ongpu, bool x_ongpu){
+
+  std::ostringstream err;
+  err<<"GPU version is not ready !!!!";
+  throw std::runtime_error(exception_msg(err.str()));
+
+} // Y = a * X + b * Y
 void diagRowMul(std::complex<double>* mat, std::complex<double>* diag, size_t M, size_t N, bool mat_ongpu, bool diag_ongpu){
 
   std::ostringstream err;
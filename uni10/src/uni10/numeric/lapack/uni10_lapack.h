@@ -51,9 +51,11 @@ enum mmtype{
 };
 void uni10Dgemm(int p, int q, int M, int N, int K, double* A, double* B, double* C, mmtype how);
 void matrixMul(double* A, double* B, int M, int N, int K, double* C, bool ongpuA, bool ongpuB, bool ongpuC);
+void matrixMul(double* A, double* B, int M, int N, int K, double* C, bool transA, bool transB, bool ongpuA, bool ongpuB, bool ongpuC); // C = op(A) * op(B), op(A) is M x K
 void vectorAdd(double* Y, double* X, size_t N, bool y_ongpu, bool x_ongpu);// Y = Y + X
 void vectorScal(double a, double* X, size_t N, bool ongpu);	// X = a * X
 void vectorMul(double* Y, double* X, size_t N, bool y_ongpu, bool x_ongpu); // Y = Y * X, element-wise multiplication;
+void vectorAxpby(double a, double* X, double b, double* Y, size_t N, bool y_ongpu, bool x_ongpu); // Y = a * X + b * Y, X is not read if a is zero
 double vectorSum(double* X, size_t N, int inc, bool ongpu);
 double vectorNorm(double* X, size_t N, int inc, bool ongpu);
 void vectorExp(double a, double* X, size_t N, bool ongpu);
@@ -66,6 +68,7 @@ void orthoRandomize(double* elem, int M, int N, bool ongpu);
 void eigDecompose(double* Kij, int N, std::complex<double>* Eig, std::complex<double> *EigVec, bool ongpu);
 void eigSyDecompose(double* Kij, int N, double* Eig, double* EigVec, bool ongpu);
 void matrixSVD(double* Mij_ori, int M, int N, double* U, double* S, double* vT, bool ongpu);
+void matrixSVD(double* Mij, int M, int N, double* U, double* S, double* vT, double* work, int lwork, int* iwork, bool ongpu); // divide and conquer on caller buffers: overwrites Mij, iwork holds 8 min(M, N), lwork = -1 puts the workspace size in work[0]
 void matrixInv(double* A, int N, bool diag, bool ongpu);
 void setTranspose(double* A, size_t M, size_t N, double* AT, bool ongpu, bool ongpuT);
 void setTranspose(double* A, size_t M, size_t N, bool ongpu);
@@ -82,16 +85,22 @@ void matrixLQ(double* Mij_ori, int M, int N, double* Q, double* L, bool ongpu);
 //==============================//
 /***** Complex version *****/
 void matrixSVD(std::complex<double>* Mij_ori, int M, int N, std::complex<double>* U, double *S, std::complex<double>* vT, bool ongpu);
+void matrixSVD(std::complex<double>* Mij, int M, int N, std::complex<double>* U, double *S, std::complex<double>* vT, std::complex<double>* work, int lwork, double* rwork, int* iwork, bool ongpu); // rwork holds svdRworkSize(M, N)
+size_t svdRworkSize(int M, int N);
 void matrixSVD(std::complex<double>* Mij_ori, int M, int N, std::complex<double>* U, std::complex<double>* S, std::complex<double>* vT, bool ongpu);
 void matrixInv(std::complex<double>* A, int N, bool diag, bool ongpu);
 std::complex<double> vectorSum(std::complex<double>* X, size_t N, int inc, bool ongpu);
 double vectorNorm(std::complex<double>* X, size_t N, int inc, bool ongpu);
 void matrixMul(std::complex<double>* A, std::complex<double>* B, int M, int N, int K, std::complex<double>* C, bool ongpuA, bool ongpuB, bool ongpuC);
+void matrixMul(std::complex<double>* A, std::complex<double>* B, int M, int N, int K, std::complex<double>* C, bool transA, bool transB, bool ongpuA, bool ongpuB, bool ongpuC);
 void vectorAdd(std::complex<double>* Y, double* X, size_t N, bool y_ongpu, bool x_ongpu);// Y = Y + X
 void vectorAdd(std::complex<double>* Y, std::complex<double>* X, size_t N, bool y_ongpu, bool x_ongpu);// Y = Y + X
 void vectorScal(double a, std::complex<double>* X, size_t N, bool ongpu);	// X = a * X
 void vectorScal(const std::complex<double>& a, std::complex<double>* X, size_t N, bool ongpu);	// X = a * X
 void vectorMul(std::complex<double>* Y, std::complex<double>* X, size_t N, bool y_ongpu, bool x_ongpu); // Y = Y * X, element-wise multiplication;
+void vectorMul(std::complex<double>* Y, double* X, size_t N, bool y_ongpu, bool x_ongpu); // Y = Y * X, element-wise multiplication;
+void vectorAxpby(const std::complex<double>& a, std::complex<double>* X, const std::complex<double>& b, std::complex<double>* Y, size_t N, bool y_ongpu, bool x_ongpu); // Y = a * X + b * Y
+void vectorAxpby(const std::complex<double>& a, double* X, const std::complex<double>& b, std::complex<double>* Y, size_t N, bool y_ongpu, bool x_ongpu); // Y = a * X + b * Y
 void diagRowMul(std::complex<double>* mat, std::complex<double>* diag, size_t M, size_t N, bool mat_ongpu, bool diag_ongpu);
 void diagColMul(std::complex<double>* mat, std::complex<double>* diag, size_t M, size_t N, bool mat_ongpu, bool diag_ongpu);
 void vectorExp(double a, std::complex<double>* X, size_t N, bool ongpu);
@@ -70,6 +70,13 @@ void zgesvd_( const char* jobu, const char* jobvt, const int32_t* m,
               const int32_t* n, std::complex<double>* a, const int32_t* lda, double* s,
               std::complex<double>* u, const int32_t* ldu, std::complex<double>* vt, const int32_t* ldvt,
               std::complex<double>* work, const int32_t* lwork, double* rwork, int32_t* info );
+void dgesdd_( const char* jobz, const int32_t* m, const int32_t* n, double* a,
+              const int32_t* lda, double* s, double* u, const int32_t* ldu, double* vt,
+              const int32_t* ldvt, double* work, const int32_t* lwork, int32_t* iwork, int32_t* info );
+void zgesdd_( const char* jobz, const int32_t* m, const int32_t* n, std::complex<double>* a,
+              const int32_t* lda, double* s, std::complex<double>* u, const int32_t* ldu,
+              std::complex<double>* vt, const int32_t* ldvt, std::complex<double>* work,
+              const int32_t* lwork, double* rwork, int32_t* iwork, int32_t* info );
 void dsyev_( const char* jobz, const char* uplo, const int32_t* n, double* a,
              const int32_t* lda, double* w, double* work, const int32_t* lwork,
              int32_t* info );
@@ -202,6 +209,21 @@ inline void zgesvd( const char* jobu, const char* jobvt, const int32_t* m,
   zgesvd_( jobu, jobvt, m, n, a, lda, s, u, ldu, vt, ldvt, work, lwork, rwork, info );
 }
 
+inline void dgesdd( const char* jobz, const int32_t* m, const int32_t* n, double* a,
+              const int32_t* lda, double* s, double* u, const int32_t* ldu, double* vt,
+              const int32_t* ldvt, double* work, const int32_t* lwork, int32_t* iwork, int32_t* info )
+{
+  dgesdd_( jobz, m, n, a, lda, s, u, ldu, vt, ldvt, work, lwork, iwork, info );
+}
+
+inline void zgesdd( const char* jobz, const int32_t* m, const int32_t* n, std::complex<double>* a,
+              const int32_t* lda, double* s, std::complex<double>* u, const int32_t* ldu,
+              std::complex<double>* vt, const int32_t* ldvt, std::complex<double>* work,
+              const int32_t* lwork, double* rwork, int32_t* iwork, int32_t* info )
+{
+  zgesdd_( jobz, m, n, a, lda, s, u, ldu, vt, ldvt, work, lwork, rwork, iwork, info );
+}
+
 inline void dgemv(const char *trans, const int32_t *m, const int32_t *n, const double *alpha, const double *a, const int32_t *lda, const double *x,
            const int32_t *incx, const double *beta, const double *y, const int32_t *incy)
 {
@@ -31,6 +31,8 @@
 
 #include <uni10/tensor-network/Matrix.h>
 #include <uni10/tensor-network/UniTensor.h>
+#include <uni10/tensor-network/TensorExpr.h>
 #include <uni10/tensor-network/Network.h>
+#include <uni10/tensor-network/SectorScheduler.h>
 
 #endif
@@ -43,6 +43,8 @@
 #include <uni10/data-structure/uni10_struct.h>
 namespace uni10 {
 
+class SectorScheduler;
+
     ///@class Network
     ///@brief The Network class defines the tensor networks
     ///
@@ -133,6 +135,17 @@ public:
     /// @param name Name of the result tensor
     /// @return A UniTensor
     UniTensor launch(const std::string& name="");
+
+    /// @brief Spreads the block products of launch() over the workers of \c scheduler
+    ///
+    /// launch() installs \c scheduler (see SchedulerScope) while it contracts symmetric tensors, so that
+    /// the blocks of each pairwise contraction are computed side by side. The scheduler must outlive its
+    /// use; NULL, the default, contracts in the calling thread.
+    /// @see ForkSectorScheduler, MPISectorScheduler
+    void setScheduler(SectorScheduler* scheduler);
+
+    /// @brief The scheduler of launch(), NULL if none
+    SectorScheduler* getScheduler()const;
     /// @brief Print out the memory usage
     /// Prints out the memory usage and requirement to contract  Network as:
     /** @code
@@ -227,10 +240,14 @@ private:
     int times;  //construction times
     int tot_elem;   //total memory ussage
     int max_elem;   //maximum
+    SectorScheduler* scheduler;  //block products of launch, NULL in the calling thread
     void destruct();
     void matching(Node* sbj, Node* tar);
     void branch(Node* sbj, Node* tar);
     UniTensor merge(Node* nd);
+    static std::string nodeName(Node* nd);
+    bool isDense();
+    UniTensor launchDense(const std::string& name);
     void clean(Node* nd);
     void fromfile(const std::string& fname);
     void findConOrd(Node* nd);
@@ -0,0 +1,148 @@
+/****************************************************************************
+*  @file SectorScheduler.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file of the schedulers of the block products of a contraction
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef SECTORSCHEDULER_H
+#define SECTORSCHEDULER_H
+#include <atomic>
+#include <complex>
+#include <vector>
+namespace uni10{
+
+///@brief One block product of a contraction, \f$C = AB\f$ of row-major matrices
+template<typename T>
+struct SectorGemm{
+  const T* A;   ///< \c M x \c K
+  const T* B;   ///< \c K x \c N
+  T* C;         ///< \c M x \c N, overwritten
+  size_t M;
+  size_t N;
+  size_t K;
+  /// @brief Multiply-adds of the product
+  double cost()const{ return (double)M * N * K; }
+};
+
+///@class SectorScheduler
+///@brief Runs the block products of the contractions, possibly in other processes
+///
+/// A symmetric contraction multiplies its blocks independently. While a scheduler is installed on the
+/// calling thread by a SchedulerScope, contract() hands the products of each contraction to run() instead
+/// of computing them one after another, so that Network::launch (see Network::setScheduler()) spreads the
+/// blocks of every pairwise contraction over workers without a change to the network. Dense contractions
+/// have a single block and gain nothing.
+/// @see ForkSectorScheduler, MPISectorScheduler
+class SectorScheduler{
+public:
+    virtual ~SectorScheduler(){}
+
+    /// @brief Computes all the products; on return every \c C is set in the calling process
+    virtual void run(std::vector<SectorGemm<double> >& gemms) = 0;
+    /// @overload
+    virtual void run(std::vector<SectorGemm<std::complex<double> > >& gemms) = 0;
+};
+
+/// @brief Splits the products into at least \c parts tasks of similar cost
+///
+/// A product costing more than a share of the total is cut into bands of rows of \c A and \c C, so that a
+/// single large block is shared too.
+template<typename T>
+std::vector<SectorGemm<T> > splitSectors(const std::vector<SectorGemm<T> >& gemms, int parts);
+
+/// @brief Worker of each task, the most costly tasks first to the least loaded of \c workers
+template<typename T>
+std::vector<int> balanceSectors(const std::vector<SectorGemm<T> >& gemms, int workers);
+
+///@class ForkSectorScheduler
+///@brief Runs the block products in forked worker processes of the local machine
+///
+/// The products of a contraction are split over the calling process and workers-1 children forked for the
+/// contraction, which see the operands through the copy-on-write memory of the fork and return the
+/// products through an anonymous shared mapping. A worker that fails, or is not done timeout() seconds
+/// after the fork, is killed and has its products computed by the caller. Contractions of fewer than
+/// minCost() multiply-adds run in the caller alone, as forking costs about a millisecond.
+///
+/// Only a single-threaded process is forked, see forkable(): the child of a multithreaded process may
+/// inherit locks held by the other threads and deadlock. Otherwise the products run in the caller, which
+/// notForked() counts. A threaded BLAS keeps its own threads, use a sequential BLAS (e.g.
+/// \c OPENBLAS_NUM_THREADS=1) with this scheduler.
+class ForkSectorScheduler: public SectorScheduler{
+public:
+    /// @brief Scheduler of \c workers processes, the caller included
+    ForkSectorScheduler(int workers, double minCost = 1E8, double timeout = 60);
+
+    /// @brief Number of processes, the caller included
+    int workers()const;
+
+    /// @brief Multiply-adds below which a contraction is not forked
+    double minCost()const;
+
+    /// @brief Seconds after which a worker is killed
+    double timeout()const;
+
+    /// @brief \c true if the calling process has no other thread and can be forked
+    static bool forkable();
+
+    /// @brief Number of runs whose products were split over forked workers
+    size_t forked()const;
+
+    /// @brief Number of runs of at least minCost() multiply-adds that ran in the caller alone, because the
+    /// process could not be forked
+    size_t notForked()const;
+
+    void run(std::vector<SectorGemm<double> >& gemms);
+    void run(std::vector<SectorGemm<std::complex<double> > >& gemms);
+
+private:
+    int m_workers;
+    double m_minCost;
+    double m_timeout;
+    std::atomic<size_t> m_forked;
+    std::atomic<size_t> m_notForked;
+    void count(int result);
+};
+
+/// @brief The scheduler installed on the calling thread, NULL if none
+SectorScheduler* sectorScheduler();
+
+///@class SchedulerScope
+///@brief Installs a scheduler on the calling thread for the lifetime of the object
+///
+/// Threads started inside the scope compute their products themselves. Scopes nest; a NULL scheduler
+/// leaves the installed one in place.
+class SchedulerScope{
+public:
+    explicit SchedulerScope(SectorScheduler* scheduler);
+    ~SchedulerScope();
+private:
+    SectorScheduler* previous;
+    SchedulerScope(const SchedulerScope&);
+    SchedulerScope& operator=(const SchedulerScope&);
+};
+
+};	/* namespace uni10 */
+#endif /* SECTORSCHEDULER_H */
@@ -0,0 +1,116 @@
+/****************************************************************************
+*  @file TensorExpr.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file for the lazily evaluated element-wise expressions of UniTensors
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef TENSOREXPR_H
+#define TENSOREXPR_H
+#include <complex>
+#include <vector>
+#include <uni10/datatype.hpp>
+namespace uni10{
+
+class UniTensor;
+
+///@class TensorExpr
+///@brief Element-wise expression of UniTensors, evaluated in a single pass when assigned
+///
+/// The operators of UniTensor evaluate at once, so that <tt>a*T1 + b*T2 + c*T3</tt> allocates and
+/// passes over four temporaries. Expressions built from lazy() instead only record the operands:
+/// \code
+/// UniTensor R = a * lazy(T1) + b * lazy(T2) - c * conj(lazy(T3));
+/// W = lazy(W) - alpha * lazy(V) - beta * lazy(Vprev);   // in place, no allocation
+/// \endcode
+/// An expression is a sum of terms, each a scalar times an element-wise product of tensors or their
+/// conjugates; sums, differences, scalings, conj() and hadamard() of expressions are expanded into
+/// this form. Assigning the expression to a UniTensor evaluates all its terms together, in chunks that
+/// stay in cache, reading every operand once and writing the result once. The elements are combined in
+/// place if the target already has the bonds of the first operand, which may itself appear in the
+/// expression, and the work is split over threads like UniTensor::axpby().
+///
+/// The operands must have the same block structure in the sense of UniTensor::axpby(): equal bonds, or
+/// blocks of equal shape sector by sector, the blocks missing from an operand counting as zero. The
+/// result has the bonds and labels of the first operand of the first term, and is complex if any operand
+/// or scalar is.
+///
+/// An expression refers to its operands without copying them, so it must be assigned before they change
+/// or go out of scope.
+class TensorExpr{
+public:
+    /// @brief The element-wise product of \c factors, with their conjugation flags, times \c coef
+    struct Term{
+      Complex coef;
+      std::vector<const UniTensor*> factors;
+      std::vector<bool> conjs;
+    };
+
+    /// @brief Zero expression, which has no operands and cannot be assigned
+    TensorExpr();
+    /// @brief The expression of the tensor \c T itself
+    explicit TensorExpr(const UniTensor& T);
+
+    /// @brief The terms of the expression
+    const std::vector<Term>& terms()const;
+
+    /// @brief Evaluates the expression into \c T
+    void evaluate(UniTensor& T)const;
+
+    friend TensorExpr operator+(const TensorExpr& a, const TensorExpr& b);
+    friend TensorExpr operator-(const TensorExpr& a, const TensorExpr& b);
+    friend TensorExpr operator-(const TensorExpr& a);
+    friend TensorExpr operator*(Complex c, const TensorExpr& a);
+    friend TensorExpr operator*(Real c, const TensorExpr& a);
+    /// @brief Complex conjugate
+    friend TensorExpr conj(const TensorExpr& a);
+    /// @brief Element-wise product
+    friend TensorExpr hadamard(const TensorExpr& a, const TensorExpr& b);
+
+private:
+    std::vector<Term> m_terms;
+};
+
+/// @brief Starts an expression, see TensorExpr
+TensorExpr lazy(const UniTensor& T);
+
+TensorExpr operator+(const TensorExpr& a, const TensorExpr& b);
+TensorExpr operator+(const TensorExpr& a, const UniTensor& T);
+TensorExpr operator+(const UniTensor& T, const TensorExpr& a);
+TensorExpr operator-(const TensorExpr& a, const TensorExpr& b);
+TensorExpr operator-(const TensorExpr& a, const UniTensor& T);
+TensorExpr operator-(const UniTensor& T, const TensorExpr& a);
+TensorExpr operator-(const TensorExpr& a);
+TensorExpr operator*(Complex c, const TensorExpr& a);
+TensorExpr operator*(const TensorExpr& a, Complex c);
+TensorExpr operator*(Real c, const TensorExpr& a);
+TensorExpr operator*(const TensorExpr& a, Real c);
+TensorExpr conj(const TensorExpr& a);
+TensorExpr hadamard(const TensorExpr& a, const TensorExpr& b);
+TensorExpr hadamard(const TensorExpr& a, const UniTensor& T);
+TensorExpr hadamard(const UniTensor& T, const TensorExpr& a);
+
+};	/* namespace uni10 */
+#endif /* TENSOREXPR_H */
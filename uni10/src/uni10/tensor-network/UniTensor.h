@@ -36,6 +36,8 @@
 #include <vector>
 #include <deque>
 #include <map>
+#include <memory>
+#include <atomic>
 #include <set>
 #include <string>
 #include <assert.h>
@@ -45,7 +47,10 @@
 #include <uni10/data-structure/uni10_struct.h>
 #include <uni10/data-structure/Bond.h>
 #include <uni10/data-structure/Block.h>
+#include <uni10/data-structure/BlockView.h>
 #include <uni10/tensor-network/Matrix.h>
+#include <uni10/tools/uni10_profile.h>
+#include <uni10/tools/uni10_tuning.h>
 
 /// @brief Uni10 - the Universal Tensor %Network Library
 namespace uni10 {
@@ -67,6 +72,7 @@ namespace uni10 {
     /// @example egU3.cpp
     class Block;
     class Matrix;
+    class TensorExpr;
     class UniTensor {
 
     public:
@@ -299,11 +305,18 @@ namespace uni10 {
 
         /// @brief Copy content
         ///
-        /// Assigns new content to the UniTensor from \c UniT, replacing the original contents
+        /// Assigns new content to the UniTensor from \c UniT, replacing the original contents. The elements
+        /// are shared until either tensor writes them.
         /// @param UniT Tensor to be copied
         ///
         UniTensor& operator=(const UniTensor& UniT);
 
+        /// @brief Evaluates an expression in a single pass, see TensorExpr
+        ///
+        /// The elements are overwritten in place when the tensor has the bonds of the first operand of
+        /// \c expr, which may be the tensor itself.
+        UniTensor& operator=(const TensorExpr& expr);
+
         /// @brief   Perform  element-wise addition and assign
         ///
         /// Performs element-wise addition. The tensor \c Tb to be added must be \ref{similar} to  UniTensor.
@@ -316,6 +329,43 @@ namespace uni10 {
         /// @param Ta,Tb Tensors to be added
         friend UniTensor operator+ (const UniTensor& Ta, const UniTensor& Tb);
 
+        /// @brief Scales the elements in place
+        ///
+        /// Unlike <tt>T * a</tt>, no tensor is allocated. A real tensor becomes complex if \c a is not real.
+        /// @param a A scalar
+        UniTensor& scale(Real a);
+        /// @overload
+        UniTensor& scale(Complex a);
+
+        /// @brief In-place <tt>*this = a * X + b * (*this)</tt>
+        ///
+        /// The element-wise kernels of scale(), axpy(), axpby(), add() and hadamard() update the elements of
+        /// the tensor in place in a single pass, and run on several threads for long arrays (see
+        /// TuningParams::vectorParallelMin). \c X is neither copied nor converted: a real \c X is added
+        /// to a complex tensor as it is, and a real tensor becomes complex if \c X or a scalar is complex.
+        ///
+        /// If \c X has the bonds of the tensor, the whole element arrays are combined at once. Otherwise the
+        /// bonds must match one to one and differ only by the quantum numbers one of them lacks, and the
+        /// blocks are combined sector by sector, which requires that the blocks of the same quantum number
+        /// have the same shape and that the blocks of \c X missing in the tensor are zero; the blocks
+        /// missing in \c X count as zero.
+        /// @param a,b Scalars
+        /// @param X A tensor of the same block structure
+        UniTensor& axpby(Real a, const UniTensor& X, Real b);
+        /// @overload
+        UniTensor& axpby(Complex a, const UniTensor& X, Complex b);
+
+        /// @brief In-place <tt>*this += a * X</tt>, see axpby()
+        UniTensor& axpy(Real a, const UniTensor& X);
+        /// @overload
+        UniTensor& axpy(Complex a, const UniTensor& X);
+
+        /// @brief In-place <tt>*this += X</tt>, see axpby()
+        UniTensor& add(const UniTensor& X);
+
+        /// @brief In-place element-wise product with \c X, see axpby()
+        UniTensor& hadamard(const UniTensor& X);
+
         /*********************  NO TYPE **************************/
 
         ///
@@ -341,8 +391,13 @@ namespace uni10 {
         UniTensor(const std::vector<Bond>& _bonds, int* labels, const std::string& _name = "");
 
         /// @brief Copy constructor
+        ///
+        /// The copy shares the elements of \c UniT. They are duplicated on the first write to either tensor.
         UniTensor(const UniTensor& UniT);
 
+        /// @brief Creates a UniTensor from the value of an expression, see TensorExpr
+        UniTensor(const TensorExpr& expr);
+
         /// @brief Create a UniTensor from a file
         ///
         /// @param fname Filename to be read in
@@ -524,6 +579,30 @@ namespace uni10 {
         /// @return A Matrix of \c qnum block
         Matrix getBlock(const Qnum& qnum, bool diag = false)const;
 
+        /// @brief Mutable view of a block
+        ///
+        /// Returns a BlockView referring to the Qnum(0) block elements in place, without copying them.
+        /// Shared elements are detached first, so writes through the view only affect this tensor.
+        /// The view is invalidated by anything that reallocates the elements of the tensor.
+        /// Use const_getBlock() for read-only access.
+        /// @return A view of Qnum(0) block
+        BlockView getBlockView();
+
+        /// @brief Mutable view of a block
+        ///
+        /// Returns a BlockView referring to the elements of the \c qnum block in place.
+        /// @param qnum Quantum number of the block
+        /// @return A view of \c qnum block
+        /// @see getBlockView()
+        BlockView getBlockView(const Qnum& qnum);
+
+        /// @brief Mutable views of all blocks
+        ///
+        /// Returns a map from a composite Qnum to a view of the corresponding block.
+        /// @return Map from Qnum to BlockView
+        /// @see getBlockView()
+        std::map<Qnum, BlockView> getBlockViews();
+
         /// @brief Assign elements
         ///
         /// Set all  elements to zero.
@@ -589,6 +668,8 @@ namespace uni10 {
         /// @brief Permute the order of bonds
         ///
         /// Permutes the order of bonds to the order according to \c newLabels with \c inBondNum incoming bonds.
+        /// Only the bonds and labels change at once; the elements are moved the first time they are accessed,
+        /// and consecutive permutations are composed so that the elements are moved at most once.
         /// @param newLabels list of new labels
         /// @param inBondNum Number of incoming bonds after permutation
         UniTensor& permute(const std::vector<int>& newLabels, int inBondNum);
@@ -684,7 +765,25 @@ namespace uni10 {
         ///
         /// In the above example, currently there are 30 tensors and total number of existing elements is 2240.
         /// The maximum element number for now is 4295 and the maximum element number of a tensor is 924.
+        ///
+        /// When built with \c BUILD_PROFILING, the counters of the hot operations (permute, contract,
+        /// allocations, decompositions, copies and RtoC promotions) are printed below, see profileData().
+        /// The allocations alive at the high-water mark are listed too if memory tracking was used, see
+        /// memoryTrackBegin().
         static std::string profile(bool print = true);
+
+        /// @brief Operation counters
+        ///
+        /// Returns the calls, bytes, FLOPs and time accumulated by the hot operations since the start of
+        /// the program or the last resetProfile(). The counters stay zero unless uni10 is built with
+        /// \c BUILD_PROFILING.
+        /// @return Snapshot of the counters
+        static ProfileData profileData();
+
+        /// @brief Resets the operation counters
+        ///
+        /// Sets the counters returned by profileData() to zero, e.g. before a region to be profiled.
+        static void resetProfile();
         std::vector<_Swap> exSwap(const UniTensor& Tb)const;
         void addGate(const std::vector<_Swap>& swaps);
 
@@ -742,6 +841,18 @@ namespace uni10 {
         UniTensor(rflag tp, const std::vector<Bond>& _bonds, const std::string& _name = "");
         UniTensor(rflag tp, const std::vector<Bond>& _bonds, std::vector<int>& labels, const std::string& _name = "");
         UniTensor(rflag tp, const std::vector<Bond>& _bonds, int* labels, const std::string& _name = "");
+        ///
+        /// @brief Create a real UniTensor on top of an existing buffer
+        ///
+        /// The tensor uses \c _elem as its element storage, in the order of getRawElem(), without copying it
+        /// and without taking ownership of it. The caller must keep the buffer alive, and at least elemNum()
+        /// elements long, as long as the tensor refers to it. Writes to the tensor land in the buffer until
+        /// its elements are reallocated (permute, assign, ...); copies of the tensor get their own elements.
+        ///
+        /// @param _bonds List of bonds
+        /// @param _elem Pointer to the elements
+        /// @param _name Name of the tensor, defaults to ""
+        UniTensor(const std::vector<Bond>& _bonds, Real* _elem, const std::string& _name = "");
 
         /// @brief Assign raw elements
         ///
@@ -813,6 +924,10 @@ namespace uni10 {
         UniTensor(cflag tp, const std::vector<Bond>& _bonds, const std::string& _name = "");
         UniTensor(cflag tp, const std::vector<Bond>& _bonds, std::vector<int>& labels, const std::string& _name = "");
         UniTensor(cflag tp, const std::vector<Bond>& _bonds, int* labels, const std::string& _name = "");
+        /// @brief Create a complex UniTensor on top of an existing buffer
+        ///
+        /// @see UniTensor(const std::vector<Bond>&, Real*, const std::string&)
+        UniTensor(const std::vector<Bond>& _bonds, Complex* _elem, const std::string& _name = "");
 
         /// @overload
         void setRawElem(const std::vector< Complex >& rawElem);
@@ -887,6 +1002,8 @@ namespace uni10 {
 
         /// @brief Access element array
         ///
+        /// The array may be written. Copies of the tensor made afterwards get their own elements instead of
+        /// sharing them, so writes through the array never reach a copy.
         Real* getElem();
         Real* getElem(rflag tp);
         void exportElemR(double *out_array, int elem_num = -1);
@@ -916,6 +1033,7 @@ namespace uni10 {
 
         friend class Node;
         friend class Network;
+        friend class TensorExpr;
 
     private:
 
@@ -940,31 +1058,61 @@ namespace uni10 {
         std::map<int, size_t> RQidx2Dim;
         std::map<int, size_t> CQidx2Dim;
         bool ongpu;
+        struct ElemStorage{   //Owner of elem/c_elem, shared by copies until one of them writes
+            void* elem;
+            size_t memsize;
+            bool ongpu;
+            bool pinned;      //A writable address was handed out, copies no longer share the elements
+            bool owned;       //False for a buffer of the caller, which is not freed
+            ElemStorage(void* _elem, size_t _memsize, bool _ongpu, bool _owned = true): elem(_elem), memsize(_memsize), ongpu(_ongpu), pinned(!_owned), owned(_owned){}
+            ~ElemStorage();
+        };
+        std::shared_ptr<ElemStorage> storage;
+        struct PendingPermute;
+        std::shared_ptr<PendingPermute> pending;   //Last lazy permutation, kept until a non-const method replaces it
+        mutable std::atomic<bool> hasPending{false};   //True until the elements of pending are in place, read without a lock
         static int COUNTER;
         static int64_t ELEMNUM;
         static size_t MAXELEMNUM;
         static size_t MAXELEMTEN;   //Max number of element of a tensor
+        /// Updates the counters above; safe to call from several threads.
+        static void updateCounter(int tenDiff, int64_t elemDiff, size_t tenElemNum = 0);
 
         //Private Functions
         /*********************  NO TYPE **************************/
         void initUniT(int typeID);
         std::vector<UniTensor> _hosvd(size_t modeNum, size_t fixedNum, std::vector<std::map<Qnum, Matrix> >& Ls, bool returnL)const;
         void TelemFree();
+        void swapContent(UniTensor& T);
+        void initBonds(int typeID, const std::vector<Bond>& outBonds);
+        void permuteLazily(const std::vector<int>& rsp_outin, const std::vector<Bond>& outBonds, const std::vector<int>& newLabels);
+        /// Moves the elements of a pending permutation into place under the lock of that permutation, so
+        /// that tensors are materialized concurrently; a no-op otherwise.
+        void materialize()const;
+        /// Materializes and gives the tensor its own copy of elements shared with other tensors, before they are written.
+        void detachElem();
+        /// Detaches the elements before a writable address leaves the tensor, and keeps later copies from sharing them.
+        void pinElem();
+        /// Gives a tensor that just started sharing the elements of a pinned storage its own copy.
+        void unshareIfPinned();
         /*********************  REAL **********************/
-        void initUniT(rflag tp = RTYPE);
+        void initUniT(rflag tp = RTYPE, Real* _elem = NULL);   //Adopts _elem as the storage if given
         size_t grouping(rflag tp = RTYPE);
         void initBlocks(rflag tp = RTYPE);
         void TelemAlloc(rflag tp = RTYPE);
         void TelemBzero(rflag tp = RTYPE);
         void exportElem(rflag tp, double *out_array, int elem_num);
+        void permuteElemFrom(rflag tp, const UniTensor& src, const std::vector<int>& rsp_outin);
         /*********************  COMPLEX **********************/
-        void initUniT(cflag tp);
+        void initUniT(cflag tp, Complex* _elem = NULL);
         size_t grouping(cflag tp);
         void initBlocks(cflag tp);
         void TelemAlloc(cflag tp);
         void TelemBzero(cflag tp);
         void exportElem(cflag tp, Complex *out_array, int elem_num);
+        void permuteElemFrom(cflag tp, const UniTensor& src, const std::vector<int>& rsp_outin);
         /*****************************************************/
+        bool sameElemLayout(const UniTensor& X)const;
 
         static const int HAVEBOND = 1;        /**< A flag for initialization */
         static const int HAVEELEM = 2;        /**< A flag for having element assigned */
@@ -29,6 +29,7 @@
 *
 *****************************************************************************/
 #include <uni10/tools/uni10_tools.h>
+#include <uni10/tools/uni10_profile.h>
 #include <uni10/numeric/lapack/uni10_lapack.h>
 #include <uni10/tensor-network/Matrix.h>
 
@@ -38,6 +39,7 @@ namespace uni10{
 
 Matrix& Matrix::operator=(const Matrix& _m){
   try{
+    UNI10_PROFILE_SCOPE(prof, PROF_COPY, _m.elemNum() * (_m.typeID() == 2 ? sizeof(Complex) : sizeof(Real)));
     r_flag = _m.r_flag;
     c_flag = _m.c_flag;
     Rnum = _m.Rnum;
@@ -56,6 +58,7 @@ Matrix& Matrix::operator=(const Matrix& _m){
 
 Matrix& Matrix::operator=(const Block& _b){
   try{
+    UNI10_PROFILE_SCOPE(prof, PROF_COPY, _b.elemNum() * (_b.typeID() == 2 ? sizeof(Complex) : sizeof(Real)));
     r_flag = _b.r_flag;
     c_flag = _b.c_flag;
     Rnum = _b.Rnum;
@@ -240,6 +243,7 @@ Matrix::Matrix(std::string stp, size_t _Rnum, size_t _Cnum, bool _diag, bool _on
 
 Matrix::Matrix(const Matrix& _m): Block(_m.Rnum, _m.Cnum, _m.diag){
   try{
+    UNI10_PROFILE_SCOPE(prof, PROF_COPY, _m.elemNum() * (_m.typeID() == 2 ? sizeof(Complex) : sizeof(Real)));
     r_flag = _m.r_flag;
     c_flag = _m.c_flag;
     ongpu = _m.ongpu;
@@ -252,6 +256,7 @@ Matrix::Matrix(const Matrix& _m): Block(_m.Rnum, _m.Cnum, _m.diag){
 
 Matrix::Matrix(const Block& _b): Block(_b){
   try{
+    UNI10_PROFILE_SCOPE(prof, PROF_COPY, _b.elemNum() * (_b.typeID() == 2 ? sizeof(Complex) : sizeof(Real)));
     init(_b.m_elem, _b.cm_elem, _b.ongpu);
   }
   catch(const std::exception& e){
@@ -385,6 +390,7 @@ Matrix& Matrix::resize(size_t row, size_t col){
 
 void Matrix::load(const std::string& fname){
   try{
+    UNI10_TRACE_SCOPE(trace, "load " + fname, "io");
     setMelemBNULL();
     FILE *fp = fopen(fname.c_str(), "r");
     if(!(fp != NULL)){
@@ -29,6 +29,7 @@
 *
 *****************************************************************************/
 #include <uni10/tools/uni10_tools.h>
+#include <uni10/tools/uni10_profile.h>
 #include <uni10/numeric/lapack/uni10_lapack.h>
 #include <uni10/tensor-network/Matrix.h>
 
@@ -38,6 +39,7 @@ namespace uni10{
   void RtoC(Matrix& mat){
     try{
       if(mat.typeID() == 1){
+        UNI10_PROFILE_SCOPE(prof, PROF_RTOC, mat.elemNum() * sizeof(Real));
         mat.r_flag = RNULL;
         mat.c_flag = CTYPE;
         mat.cm_elem = (Complex*)elemAlloc(mat.elemNum() * sizeof(Complex), mat.ongpu);
@@ -30,11 +30,218 @@
 *****************************************************************************/
 #include <algorithm>
 #include <uni10/tools/uni10_tools.h>
+#include <uni10/numeric/lapack/uni10_lapack.h>
 #include <uni10/tensor-network/UniTensor.h>
 #include <uni10/tensor-network/Network.h>
+#include <uni10/tensor-network/SectorScheduler.h>
 
 
 namespace uni10{
+
+namespace{
+
+// Element buffer of the dense path. It allocates through elemAlloc() like the blocks of a UniTensor,
+// so that MEM_USAGE and the memory tracker account for the intermediates of launchDense().
+template<typename T>
+class DenseBuffer{
+  public:
+    DenseBuffer(): ptr(NULL), num(0){}
+    ~DenseBuffer(){ release(); }
+    // drops the old elements and allocates n uninitialized ones
+    void resize(size_t n){
+      release();
+      if(n){
+        bool ongpu;
+        ptr = (T*)elemAlloc(n * sizeof(T), ongpu);
+        num = n;
+      }
+    }
+    size_t size()const{ return num; }
+    T* data(){ return ptr; }
+    const T* data()const{ return ptr; }
+  private:
+    DenseBuffer(const DenseBuffer&);
+    DenseBuffer& operator=(const DenseBuffer&);
+    void release(){
+      if(ptr != NULL)
+        elemFree(ptr, num * sizeof(T), false);
+      ptr = NULL;
+      num = 0;
+    }
+    T* ptr;
+    size_t num;
+};
+
+// Plain row-major tensor used by Network::launchDense(). Leaves point to the elements of the
+// tensors in the network, intermediate results own their elements in buf.
+template<typename T>
+struct DenseTensor{
+  std::vector<int> labels;
+  std::vector<size_t> dims;
+  DenseBuffer<T> buf;
+  const T* elem;
+  DenseTensor(): elem(NULL){}
+  const T* data()const{ return buf.size() ? buf.data() : elem; }
+};
+
+// out[i_0, ..., i_n] = in[j_0, ..., j_n] with i_b = j_{perm[b]}
+template<typename T>
+void densePermute(const T* in, const std::vector<size_t>& dims, const std::vector<size_t>& perm, T* out){
+  size_t bn = dims.size();
+  if(bn == 0){
+    out[0] = in[0];
+    return;
+  }
+  std::vector<size_t> inStride(bn, 1);
+  for(int b = (int)bn - 2; b >= 0; b--)
+    inStride[b] = inStride[b + 1] * dims[b + 1];
+  std::vector<size_t> outDims(bn), stride(bn), idx(bn, 0);
+  size_t total = 1;
+  for(size_t b = 0; b < bn; b++){
+    outDims[b] = dims[perm[b]];
+    stride[b] = inStride[perm[b]];
+    total *= outDims[b];
+  }
+  size_t last = outDims[bn - 1];
+  size_t lastStride = stride[bn - 1];
+  size_t off = 0;
+  for(size_t o = 0; o < total; o += last){
+    const T* src = in + off;
+    for(size_t j = 0; j < last; j++)
+      out[o + j] = src[j * lastStride];
+    for(int b = (int)bn - 2; b >= 0; b--){
+      idx[b]++;
+      off += stride[b];
+      if(idx[b] < outDims[b])
+        break;
+      off -= stride[b] * outDims[b];
+      idx[b] = 0;
+    }
+  }
+}
+
+template<typename T>
+void densePermute(const DenseTensor<T>& Ta, const std::vector<int>& newLabels, DenseBuffer<T>& out){
+  std::vector<size_t> perm(newLabels.size());
+  size_t num = 1;
+  for(size_t i = 0; i < newLabels.size(); i++){
+    perm[i] = std::find(Ta.labels.begin(), Ta.labels.end(), newLabels[i]) - Ta.labels.begin();
+    num *= Ta.dims[i];
+  }
+  out.resize(num);
+  densePermute(Ta.data(), Ta.dims, perm, out.data());
+}
+
+// Whether the labels in 'sub' occupy the leading (or trailing) bonds of 'all', in the same order.
+bool denseLeading(const std::vector<int>& all, const std::vector<int>& sub){
+  return std::equal(sub.begin(), sub.end(), all.begin());
+}
+bool denseTrailing(const std::vector<int>& all, const std::vector<int>& sub){
+  return std::equal(sub.begin(), sub.end(), all.end() - sub.size());
+}
+
+// Contracts the common labels of Ta and Tb with a single GEMM. The contracted bonds are fed to the
+// GEMM as a strided (transposed) operand whenever they are contiguous, so that only an operand whose
+// contracted bonds are scattered is permuted into a scratch buffer.
+template<typename T>
+void denseContract(const DenseTensor<T>& Ta, const DenseTensor<T>& Tb, DenseTensor<T>& Tc){
+  std::vector<int> conA, conB, freeA, freeB;
+  std::vector<size_t> dimA, dimB;
+  size_t M = 1, N = 1, K = 1;
+  for(size_t a = 0; a < Ta.labels.size(); a++){
+    if(std::find(Tb.labels.begin(), Tb.labels.end(), Ta.labels[a]) != Tb.labels.end()){
+      conA.push_back(Ta.labels[a]);
+      K *= Ta.dims[a];
+    }
+    else{
+      freeA.push_back(Ta.labels[a]);
+      dimA.push_back(Ta.dims[a]);
+      M *= Ta.dims[a];
+    }
+  }
+  for(size_t b = 0; b < Tb.labels.size(); b++){
+    if(std::find(Ta.labels.begin(), Ta.labels.end(), Tb.labels[b]) != Ta.labels.end())
+      conB.push_back(Tb.labels[b]);
+    else{
+      freeB.push_back(Tb.labels[b]);
+      dimB.push_back(Tb.dims[b]);
+      N *= Tb.dims[b];
+    }
+  }
+  UNI10_PROFILE_SCOPE(prof, PROF_CONTRACT, (M + N) * K * sizeof(T));
+  UNI10_PROFILE_FLOPS(prof, (uint64_t)(sizeof(T) == sizeof(Complex) ? 8 : 2) * M * N * K);
+  bool aLead = denseLeading(Ta.labels, conA), aTrail = denseTrailing(Ta.labels, conA);
+  bool bLead = denseLeading(Tb.labels, conB), bTrail = denseTrailing(Tb.labels, conB);
+  const std::vector<int>& con = (aLead || aTrail || !(bLead || bTrail)) ? conA : conB;
+
+  DenseBuffer<T> bufA, bufB;
+  const T* elemA = Ta.data();
+  const T* elemB = Tb.data();
+  bool transA = false, transB = false;
+  if(con == conA && aTrail);
+  else if(con == conA && aLead)
+    transA = true;
+  else{
+    std::vector<int> newLabels(freeA);
+    newLabels.insert(newLabels.end(), con.begin(), con.end());
+    densePermute(Ta, newLabels, bufA);
+    elemA = bufA.data();
+  }
+  if(con == conB && bLead);
+  else if(con == conB && bTrail)
+    transB = true;
+  else{
+    std::vector<int> newLabels(con);
+    newLabels.insert(newLabels.end(), freeB.begin(), freeB.end());
+    densePermute(Tb, newLabels, bufB);
+    elemB = bufB.data();
+  }
+
+  Tc.labels = freeA;
+  Tc.labels.insert(Tc.labels.end(), freeB.begin(), freeB.end());
+  Tc.dims = dimA;
+  Tc.dims.insert(Tc.dims.end(), dimB.begin(), dimB.end());
+  Tc.buf.resize(M * N);
+  Tc.elem = NULL;
+  if(M * N > 0){
+    elemBzero(Tc.buf.data(), M * N * sizeof(T), false);
+    matrixMul(const_cast<T*>(elemA), const_cast<T*>(elemB), M, N, K, Tc.buf.data(), transA, transB, false, false, false);
+  }
+}
+
+// the single block of a tensor without symmetry, read without detaching the elements it may share
+void denseLeaf(const UniTensor* UniT, DenseTensor<Real>& dt){
+  dt.elem = UniT->const_getBlock().getElem(RTYPE);
+}
+
+void denseLeaf(const UniTensor* UniT, DenseTensor<Complex>& dt){
+  if(UniT->typeID() == 2)
+    dt.elem = UniT->const_getBlock().getElem(CTYPE);
+  else{
+    dt.buf.resize(UniT->elemNum());
+    elemCast(dt.buf.data(), UniT->const_getBlock().getElem(RTYPE), UniT->elemNum(), false, false);
+  }
+}
+
+// nodeName names the memory tracking site of every contraction, see Network::nodeName()
+template<typename T>
+void denseMerge(Node* nd, DenseTensor<T>& dt, std::string (*nodeName)(Node*)){
+  if(nd->T != NULL){
+    dt.labels = nd->T->label();
+    std::vector<Bond> bonds = nd->T->bond();
+    for(size_t b = 0; b < bonds.size(); b++)
+      dt.dims.push_back(bonds[b].dim());
+    denseLeaf(nd->T, dt);
+    return;
+  }
+  DenseTensor<T> lft, rht;
+  denseMerge(nd->left, lft, nodeName);
+  denseMerge(nd->right, rht, nodeName);
+  UNI10_MEMORY_SCOPE(mem, nodeName(nd));
+  denseContract(lft, rht, dt);
+}
+
+}; /* namespace */
 Node::Node(): T(NULL), elemNum(0), parent(NULL), left(NULL), right(NULL), point(0){
 }
 
@@ -220,7 +427,7 @@ int64_t Node::cal_elemNum(std::vector<Bond>& _bonds){
 }
 
 
-Network::Network(const std::string& fname): root(NULL), load(false), times(0), tot_elem(0), max_elem(0){
+Network::Network(const std::string& fname): root(NULL), load(false), times(0), tot_elem(0), max_elem(0), scheduler(NULL){
   try{
     fromfile(fname);
     int Tnum = label_arr.size() - 1;
@@ -235,7 +442,7 @@ Network::Network(const std::string& fname): root(NULL), load(false), times(0), t
   }
 }
 
-Network::Network(const std::string& fname, const std::vector<UniTensor*>& tens): root(NULL), load(false), times(0), tot_elem(0), max_elem(0){
+Network::Network(const std::string& fname, const std::vector<UniTensor*>& tens): root(NULL), load(false), times(0), tot_elem(0), max_elem(0), scheduler(NULL){
   try{
     fromfile(fname);
     if(!((label_arr.size() - 1) == tens.size())){
@@ -729,8 +936,13 @@ void Network::destruct(){
 
 UniTensor Network::launch(const std::string& _name){
   try{
+    UNI10_TRACE_SCOPE(trace, _name.size() ? "launch " + _name : std::string("launch"), "network");
+    UNI10_MEMORY_SCOPE(mem, _name.size() ? "launch " + _name : std::string("launch"));
     if(!load)
       construct();
+    if(isDense())
+      return launchDense(_name);
+    SchedulerScope scope(scheduler);
     // for(int t = 0; t < tensors.size(); t++)
     //   if(Qnum::isFermionic() && !swapflags[t]){
 	  //     tensors[t]->addGate(swaps_arr[t]);
@@ -759,6 +971,69 @@ UniTensor Network::launch(const std::string& _name){
   }
 }
 
+void Network::setScheduler(SectorScheduler* _scheduler){
+  scheduler = _scheduler;
+}
+
+SectorScheduler* Network::getScheduler()const{
+  return scheduler;
+}
+
+bool Network::isDense(){
+  if(Qnum::isFermionic() || swap_gates.size())
+    return false;
+  Qnum q0;
+  for(size_t t = 0; t < tensors.size(); t++){
+    if(tensors[t] == NULL || !(tensors[t]->status & tensors[t]->HAVEELEM) || tensors[t]->ongpu)
+      return false;
+    for(size_t b = 0; b < tensors[t]->bonds.size(); b++){
+      std::map<Qnum, int> degs = tensors[t]->bonds[b].degeneracy();
+      if(degs.size() != 1 || !(degs.begin()->first == q0))
+        return false;
+    }
+  }
+  return true;
+}
+
+UniTensor Network::launchDense(const std::string& _name){
+  bool complex = false;
+  for(size_t t = 0; t < tensors.size(); t++)
+    if(tensors[t]->typeID() == 2)
+      complex = true;
+  int idx = label_arr.size() - 1;
+  DenseTensor<Real> rres;
+  DenseTensor<Complex> cres;
+  if(complex)
+    denseMerge(root, cres, &Network::nodeName);
+  else
+    denseMerge(root, rres, &Network::nodeName);
+  const std::vector<int>& resLabels = complex ? cres.labels : rres.labels;
+  const std::vector<size_t>& resDims = complex ? cres.dims : rres.dims;
+
+  std::vector<Bond> bonds;
+  std::vector<size_t> perm(label_arr[idx].size());
+  for(size_t l = 0; l < label_arr[idx].size(); l++){
+    perm[l] = std::find(resLabels.begin(), resLabels.end(), label_arr[idx][l]) - resLabels.begin();
+    bonds.push_back(Bond((int)l < Rnums[idx] ? BD_IN : BD_OUT, resDims[perm[l]]));
+  }
+  if(complex){
+    UniTensor UniT(CTYPE, bonds, _name);
+    if(UniT.elemNum())
+      densePermute(cres.data(), resDims, perm, UniT.getElem(CTYPE));
+    UniT.status |= UniT.HAVEELEM;
+    if(bonds.size())
+      UniT.setLabel(label_arr[idx]);
+    return UniT;
+  }
+  UniTensor UniT(RTYPE, bonds, _name);
+  if(UniT.elemNum())
+    densePermute(rres.data(), resDims, perm, UniT.getElem());
+  UniT.status |= UniT.HAVEELEM;
+  if(bonds.size())
+    UniT.setLabel(label_arr[idx]);
+  return UniT;
+}
+
 void Network::applySwapGate(UniTensor& UniT){
   // apply swap gate if label contains _Swap
   for (std::vector<_Swap>::iterator it=swap_gates.begin(); it!=swap_gates.end();) {
@@ -771,16 +1046,26 @@ void Network::applySwapGate(UniTensor& UniT){
   }
 }
 
+// Name of the node in the syntax of the ORDER line, e.g. "((W1 U) Ob)", used for tracing
+std::string Network::nodeName(Node* nd){
+  if(nd->T != NULL)
+    return nd->name;
+  return "(" + nodeName(nd->left) + " " + nodeName(nd->right) + ")";
+}
+
 UniTensor Network::merge(Node* nd){
+  UNI10_TRACE_SCOPE(trace, isTracing() ? nodeName(nd) : std::string(), "network");
   if(nd->left->T == NULL){
     UniTensor lftT = merge(nd->left);
     if(nd->right->T == NULL){
       UniTensor rhtT = merge(nd->right);
+      UNI10_MEMORY_SCOPE(mem, nodeName(nd));
       this->applySwapGate(lftT);
       this->applySwapGate(rhtT);
       return contract(lftT, rhtT, true);
     }
     else{
+      UNI10_MEMORY_SCOPE(mem, nodeName(nd));
       this->applySwapGate(lftT);
       this->applySwapGate(*(nd->right->T));
       return contract(lftT, *(nd->right->T), true);
@@ -789,11 +1074,13 @@ UniTensor Network::merge(Node* nd){
   else{
     if(nd->right->T == NULL){
       UniTensor rhtT = merge(nd->right);
+      UNI10_MEMORY_SCOPE(mem, nodeName(nd));
       this->applySwapGate(*(nd->left->T));
       this->applySwapGate(rhtT);
       return contract(*(nd->left->T), rhtT, true);
     }
     else{
+      UNI10_MEMORY_SCOPE(mem, nodeName(nd));
       this->applySwapGate(*(nd->left->T));
       this->applySwapGate(*(nd->right->T));
       return contract(*(nd->left->T), *(nd->right->T), true);
@@ -0,0 +1,276 @@
+/****************************************************************************
+*  @file SectorScheduler.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file of the schedulers of the block products
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/tensor-network/SectorScheduler.h>
+#include <uni10/numeric/lapack/uni10_lapack.h>
+#include <uni10/tools/uni10_tools.h>
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <functional>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#else
+#include <dirent.h>
+#endif
+namespace uni10{
+
+namespace{
+
+thread_local SectorScheduler* installed = NULL;
+
+template<typename T>
+void compute(const SectorGemm<T>& g, T* C){
+  if(g.M && g.N)
+    matrixMul(const_cast<T*>(g.A), const_cast<T*>(g.B), g.M, g.N, g.K, C, false, false, false);
+}
+
+// Threads of the process, 0 if they cannot be counted
+size_t threadCount(){
+#if defined(__APPLE__)
+  thread_act_array_t threads;
+  mach_msg_type_number_t num = 0;
+  if(task_threads(mach_task_self(), &threads, &num) != KERN_SUCCESS)
+    return 0;
+  for(mach_msg_type_number_t i = 0; i < num; i++)
+    mach_port_deallocate(mach_task_self(), threads[i]);
+  vm_deallocate(mach_task_self(), (vm_address_t)threads, num * sizeof(thread_act_t));
+  return num;
+#else
+  DIR* dir = opendir("/proc/self/task");
+  if(dir == NULL)
+    return 0;
+  size_t num = 0;
+  while(struct dirent* entry = readdir(dir))
+    if(entry->d_name[0] != '.')
+      num++;
+  closedir(dir);
+  return num;
+#endif
+}
+
+// Waits for the child until the deadline and kills it then, true if it finished its products
+bool reap(pid_t pid, std::chrono::steady_clock::time_point deadline){
+  int status = 0;
+  while(true){
+    pid_t done = waitpid(pid, &status, WNOHANG);
+    if(done == pid)
+      return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    if(done < 0)
+      return false;
+    if(std::chrono::steady_clock::now() >= deadline){
+      kill(pid, SIGKILL);
+      waitpid(pid, &status, 0);
+      return false;
+    }
+    usleep(100);
+  }
+}
+
+enum ForkResult{ RAN_ALONE, FORKED, NOT_FORKED };
+
+// Runs the products, in forked workers if they are worth it; NOT_FORKED if they were but could not be
+template<typename T>
+ForkResult forkRun(std::vector<SectorGemm<T> >& gemms, int workers, double minCost, double timeout){
+  double total = 0;
+  for(size_t i = 0; i < gemms.size(); i++)
+    total += gemms[i].cost();
+  if(workers <= 1 || total < minCost){
+    for(size_t i = 0; i < gemms.size(); i++)
+      compute(gemms[i], gemms[i].C);
+    return RAN_ALONE;
+  }
+  // a child of a multithreaded process inherits the locks held by the other threads, e.g. of malloc
+  if(!ForkSectorScheduler::forkable()){
+    for(size_t i = 0; i < gemms.size(); i++)
+      compute(gemms[i], gemms[i].C);
+    return NOT_FORKED;
+  }
+  std::vector<SectorGemm<T> > tasks = splitSectors(gemms, workers);
+  std::vector<int> owner = balanceSectors(tasks, workers);
+  // the products of the children land in a shared mapping, task by task
+  std::vector<size_t> offset(tasks.size(), 0);
+  size_t shared = 0;
+  for(size_t t = 0; t < tasks.size(); t++)
+    if(owner[t] != 0){
+      offset[t] = shared;
+      shared += tasks[t].M * tasks[t].N;
+    }
+  T* buf = (T*)mmap(NULL, (shared + 1) * sizeof(T), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if(buf == (T*)MAP_FAILED){
+    for(size_t i = 0; i < gemms.size(); i++)
+      compute(gemms[i], gemms[i].C);
+    return NOT_FORKED;
+  }
+  std::vector<pid_t> pids(workers, -1);
+  std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() +
+    std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(timeout));
+  for(int w = 1; w < workers; w++){
+    pid_t pid = fork();
+    if(pid == 0){
+      // the child never returns into the code of the caller, the parent recomputes what it could not
+      try{
+        for(size_t t = 0; t < tasks.size(); t++)
+          if(owner[t] == w)
+            compute(tasks[t], buf + offset[t]);
+      }
+      catch(...){
+        _exit(1);
+      }
+      _exit(0);
+    }
+    pids[w] = pid;
+  }
+  for(size_t t = 0; t < tasks.size(); t++)
+    if(owner[t] == 0)
+      compute(tasks[t], tasks[t].C);
+  for(int w = 1; w < workers; w++){
+    bool done = pids[w] > 0 && reap(pids[w], deadline);
+    for(size_t t = 0; t < tasks.size(); t++)
+      if(owner[t] == w){
+        if(done)
+          std::memcpy(tasks[t].C, buf + offset[t], tasks[t].M * tasks[t].N * sizeof(T));
+        else
+          compute(tasks[t], tasks[t].C);
+      }
+  }
+  munmap(buf, (shared + 1) * sizeof(T));
+  return FORKED;
+}
+
+};
+
+template<typename T>
+std::vector<SectorGemm<T> > splitSectors(const std::vector<SectorGemm<T> >& gemms, int parts){
+  double total = 0;
+  for(size_t i = 0; i < gemms.size(); i++)
+    total += gemms[i].cost();
+  double share = parts > 1 ? total / parts : total;
+  std::vector<SectorGemm<T> > tasks;
+  for(size_t i = 0; i < gemms.size(); i++){
+    const SectorGemm<T>& g = gemms[i];
+    if(g.M == 0){
+      tasks.push_back(g);
+      continue;
+    }
+    size_t bands = share > 0 ? (size_t)(g.cost() / share + 0.5) : 1;
+    bands = std::max((size_t)1, std::min(bands, g.M));
+    size_t rows = (g.M + bands - 1) / bands;
+    for(size_t r = 0; r < g.M; r += rows){
+      SectorGemm<T> band = g;
+      band.A = g.A + r * g.K;
+      band.C = g.C + r * g.N;
+      band.M = std::min(rows, g.M - r);
+      tasks.push_back(band);
+    }
+  }
+  return tasks;
+}
+
+template<typename T>
+std::vector<int> balanceSectors(const std::vector<SectorGemm<T> >& gemms, int workers){
+  std::vector<std::pair<double, size_t> > order;
+  for(size_t i = 0; i < gemms.size(); i++)
+    order.push_back(std::make_pair(gemms[i].cost(), i));
+  std::stable_sort(order.begin(), order.end(), std::greater<std::pair<double, size_t> >());
+  std::vector<double> load(std::max(workers, 1), 0);
+  std::vector<int> owner(gemms.size(), 0);
+  for(size_t i = 0; i < order.size(); i++){
+    int w = std::min_element(load.begin(), load.end()) - load.begin();
+    owner[order[i].second] = w;
+    load[w] += order[i].first + 1;  // so that the empty products are spread as well
+  }
+  return owner;
+}
+
+template std::vector<SectorGemm<double> > splitSectors(const std::vector<SectorGemm<double> >&, int);
+template std::vector<SectorGemm<std::complex<double> > > splitSectors(const std::vector<SectorGemm<std::complex<double> > >&, int);
+template std::vector<int> balanceSectors(const std::vector<SectorGemm<double> >&, int);
+template std::vector<int> balanceSectors(const std::vector<SectorGemm<std::complex<double> > >&, int);
+
+ForkSectorScheduler::ForkSectorScheduler(int workers, double minCost, double timeout):
+  m_workers(std::max(workers, 1)), m_minCost(minCost), m_timeout(timeout), m_forked(0), m_notForked(0){}
+
+int ForkSectorScheduler::workers()const{
+  return m_workers;
+}
+
+double ForkSectorScheduler::minCost()const{
+  return m_minCost;
+}
+
+double ForkSectorScheduler::timeout()const{
+  return m_timeout;
+}
+
+bool ForkSectorScheduler::forkable(){
+  return threadCount() == 1;
+}
+
+size_t ForkSectorScheduler::forked()const{
+  return m_forked;
+}
+
+size_t ForkSectorScheduler::notForked()const{
+  return m_notForked;
+}
+
+void ForkSectorScheduler::count(int result){
+  if(result == FORKED)
+    m_forked++;
+  else if(result == NOT_FORKED)
+    m_notForked++;
+}
+
+void ForkSectorScheduler::run(std::vector<SectorGemm<double> >& gemms){
+  count(forkRun(gemms, m_workers, m_minCost, m_timeout));
+}
+
+void ForkSectorScheduler::run(std::vector<SectorGemm<std::complex<double> > >& gemms){
+  count(forkRun(gemms, m_workers, m_minCost, m_timeout));
+}
+
+SectorScheduler* sectorScheduler(){
+  return installed;
+}
+
+SchedulerScope::SchedulerScope(SectorScheduler* scheduler): previous(installed){
+  if(scheduler)
+    installed = scheduler;
+}
+
+SchedulerScope::~SchedulerScope(){
+  installed = previous;
+}
+
+};	/* namespace uni10 */
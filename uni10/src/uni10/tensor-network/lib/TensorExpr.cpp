@@ -0,0 +1,284 @@
+/****************************************************************************
+*  @file TensorExpr.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file of the TensorExpr class
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/tensor-network/TensorExpr.h>
+#include <uni10/tensor-network/UniTensor.h>
+#include <uni10/tools/uni10_tools.h>
+#include <uni10/tools/uni10_tuning.h>
+namespace uni10{
+
+namespace{
+  // Elements evaluated together, small enough for the partial products to stay in L1
+  const size_t EXPR_CHUNK = 256;
+
+  // One factor of a term over a segment of the elements, real or complex
+  struct Source{
+    const Real* r;
+    const Complex* c;
+    bool conj;
+  };
+
+  struct TermSources{
+    Complex coef;
+    std::vector<Source> sources;
+  };
+
+  template<typename T>
+  void loadFactor(T* tmp, const Source& src, T coef, size_t n);
+
+  template<>
+  void loadFactor(Real* tmp, const Source& src, Real coef, size_t n){
+    for(size_t i = 0; i < n; i++)
+      tmp[i] = coef * src.r[i];
+  }
+
+  template<>
+  void loadFactor(Complex* tmp, const Source& src, Complex coef, size_t n){
+    if(src.r)
+      for(size_t i = 0; i < n; i++)
+        tmp[i] = coef * src.r[i];
+    else if(src.conj)
+      for(size_t i = 0; i < n; i++)
+        tmp[i] = coef * std::conj(src.c[i]);
+    else
+      for(size_t i = 0; i < n; i++)
+        tmp[i] = coef * src.c[i];
+  }
+
+  void mulFactor(Real* tmp, const Source& src, size_t n){
+    for(size_t i = 0; i < n; i++)
+      tmp[i] *= src.r[i];
+  }
+
+  void mulFactor(Complex* tmp, const Source& src, size_t n){
+    if(src.r)
+      for(size_t i = 0; i < n; i++)
+        tmp[i] *= src.r[i];
+    else if(src.conj)
+      for(size_t i = 0; i < n; i++)
+        tmp[i] *= std::conj(src.c[i]);
+    else
+      for(size_t i = 0; i < n; i++)
+        tmp[i] *= src.c[i];
+  }
+
+  Real scalar(Complex c, Real*){ return c.real(); }
+  Complex scalar(Complex c, Complex*){ return c; }
+
+  // Y[0, N) = sum of the terms, chunk by chunk; the sources may alias Y
+  template<typename T>
+  void evaluateSegment(T* Y, const std::vector<TermSources>& terms, size_t N){
+    parallelRange(N, tuning().vectorParallelMin, [&](size_t begin, size_t end){
+      T acc[EXPR_CHUNK], tmp[EXPR_CHUNK];
+      std::vector<Source> shifted;
+      for(size_t off = begin; off < end; off += EXPR_CHUNK){
+        size_t n = std::min(EXPR_CHUNK, end - off);
+        std::fill(acc, acc + n, T(0));
+        for(size_t t = 0; t < terms.size(); t++){
+          shifted = terms[t].sources;
+          for(size_t f = 0; f < shifted.size(); f++){
+            if(shifted[f].r)
+              shifted[f].r += off;
+            else
+              shifted[f].c += off;
+          }
+          loadFactor(tmp, shifted[0], scalar(terms[t].coef, (T*)0), n);
+          for(size_t f = 1; f < shifted.size(); f++)
+            mulFactor(tmp, shifted[f], n);
+          for(size_t i = 0; i < n; i++)
+            acc[i] += tmp[i];
+        }
+        std::copy(acc, acc + n, Y + off);
+      }
+    });
+  }
+};
+
+TensorExpr::TensorExpr(){}
+
+TensorExpr::TensorExpr(const UniTensor& T): m_terms(1){
+  m_terms[0].coef = 1;
+  m_terms[0].factors.push_back(&T);
+  m_terms[0].conjs.push_back(false);
+}
+
+const std::vector<TensorExpr::Term>& TensorExpr::terms()const{
+  return m_terms;
+}
+
+void TensorExpr::evaluate(UniTensor& T)const{
+  try{
+    if(m_terms.empty()){
+      std::ostringstream err;
+      err<<"Cannot evaluate an expression without operands.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    T.materialize();
+    const UniTensor& ref = *m_terms[0].factors[0];
+    bool complex = false, aliased = false;
+    for(size_t t = 0; t < m_terms.size(); t++){
+      complex = complex || m_terms[t].coef.imag() != 0;
+      for(size_t f = 0; f < m_terms[t].factors.size(); f++){
+        const UniTensor& X = *m_terms[t].factors[f];
+        X.materialize();
+        if(!(X.status & X.HAVEELEM)){
+          std::ostringstream err;
+          err<<"Cannot evaluate an expression of tensors before setting their elements.";
+          throw std::runtime_error(exception_msg(err.str()));
+        }
+        complex = complex || X.typeID() == 2;
+        aliased = aliased || &X == &T;
+      }
+    }
+    if(!((T.status & T.HAVEELEM) && T.bonds == ref.bonds)){
+      // a new target, which is then copied if it is also an operand
+      UniTensor R = complex ? UniTensor(CTYPE, ref.bonds) : UniTensor(RTYPE, ref.bonds);
+      R.status |= R.HAVEELEM;
+      R.setLabel(ref.label());
+      evaluate(R);
+      T = R;
+      return;
+    }
+    bool flat = true;
+    for(size_t t = 0; t < m_terms.size(); t++)
+      for(size_t f = 0; f < m_terms[t].factors.size(); f++)
+        flat = T.sameElemLayout(*m_terms[t].factors[f]) && flat;
+    if(complex && T.typeID() == 1)
+      RtoC(T);
+    else
+      T.detachElem();
+    if(!aliased)
+      T.setLabel(ref.label());
+
+    // the sources of every term in a segment of the elements of T, terms with a missing block dropped
+    std::vector<TermSources> terms;
+    auto sources = [&](const Qnum* q){
+      terms.clear();
+      for(size_t t = 0; t < m_terms.size(); t++){
+        TermSources ts;
+        ts.coef = m_terms[t].coef;
+        for(size_t f = 0; f < m_terms[t].factors.size(); f++){
+          const UniTensor& X = *m_terms[t].factors[f];
+          Source src = {NULL, NULL, m_terms[t].conjs[f]};
+          if(q == NULL){
+            src.r = X.typeID() == 1 ? X.elem : NULL;
+            src.c = X.typeID() == 2 ? X.c_elem : NULL;
+          }
+          else{
+            std::map<Qnum, Block>::const_iterator it = X.blocks.find(*q);
+            if(it == X.blocks.end())
+              break;
+            src.r = X.typeID() == 1 ? it->second.getElem(RTYPE) : NULL;
+            src.c = X.typeID() == 2 ? it->second.getElem(CTYPE) : NULL;
+          }
+          ts.sources.push_back(src);
+        }
+        if(ts.sources.size() == m_terms[t].factors.size())
+          terms.push_back(ts);
+      }
+    };
+    if(flat){
+      sources(NULL);
+      T.typeID() == 1 ? evaluateSegment(T.elem, terms, T.m_elemNum) : evaluateSegment(T.c_elem, terms, T.m_elemNum);
+    }
+    else
+      for(std::map<Qnum, Block>::iterator it = T.blocks.begin(); it != T.blocks.end(); it++){
+        sources(&it->first);
+        size_t n = it->second.row() * it->second.col();
+        T.typeID() == 1 ? evaluateSegment(it->second.getElem(RTYPE), terms, n) : evaluateSegment(it->second.getElem(CTYPE), terms, n);
+      }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function TensorExpr::evaluate(uni10::UniTensor&):");
+  }
+}
+
+TensorExpr lazy(const UniTensor& T){
+  return TensorExpr(T);
+}
+
+TensorExpr operator+(const TensorExpr& a, const TensorExpr& b){
+  TensorExpr c(a);
+  c.m_terms.insert(c.m_terms.end(), b.m_terms.begin(), b.m_terms.end());
+  return c;
+}
+
+TensorExpr operator+(const TensorExpr& a, const UniTensor& T){return a + TensorExpr(T);}
+
+TensorExpr operator+(const UniTensor& T, const TensorExpr& a){return TensorExpr(T) + a;}
+
+TensorExpr operator-(const TensorExpr& a, const TensorExpr& b){return a + (-b);}
+
+TensorExpr operator-(const TensorExpr& a, const UniTensor& T){return a - TensorExpr(T);}
+
+TensorExpr operator-(const UniTensor& T, const TensorExpr& a){return TensorExpr(T) - a;}
+
+TensorExpr operator-(const TensorExpr& a){return -1.0 * a;}
+
+TensorExpr operator*(Complex c, const TensorExpr& a){
+  TensorExpr b(a);
+  for(size_t t = 0; t < b.m_terms.size(); t++)
+    b.m_terms[t].coef *= c;
+  return b;
+}
+
+TensorExpr operator*(const TensorExpr& a, Complex c){return c * a;}
+
+TensorExpr operator*(Real c, const TensorExpr& a){return Complex(c) * a;}
+
+TensorExpr operator*(const TensorExpr& a, Real c){return Complex(c) * a;}
+
+TensorExpr conj(const TensorExpr& a){
+  TensorExpr b(a);
+  for(size_t t = 0; t < b.m_terms.size(); t++){
+    b.m_terms[t].coef = std::conj(b.m_terms[t].coef);
+    for(size_t f = 0; f < b.m_terms[t].conjs.size(); f++)
+      b.m_terms[t].conjs[f] = !b.m_terms[t].conjs[f];
+  }
+  return b;
+}
+
+TensorExpr hadamard(const TensorExpr& a, const TensorExpr& b){
+  TensorExpr c;
+  for(size_t s = 0; s < a.m_terms.size(); s++)
+    for(size_t t = 0; t < b.m_terms.size(); t++){
+      TensorExpr::Term term = a.m_terms[s];
+      term.coef *= b.m_terms[t].coef;
+      term.factors.insert(term.factors.end(), b.m_terms[t].factors.begin(), b.m_terms[t].factors.end());
+      term.conjs.insert(term.conjs.end(), b.m_terms[t].conjs.begin(), b.m_terms[t].conjs.end());
+      c.m_terms.push_back(term);
+    }
+  return c;
+}
+
+TensorExpr hadamard(const TensorExpr& a, const UniTensor& T){return hadamard(a, TensorExpr(T));}
+
+TensorExpr hadamard(const UniTensor& T, const TensorExpr& a){return hadamard(TensorExpr(T), a);}
+
+};	/* namespace uni10 */
@@ -33,7 +33,9 @@
 #include <uni10/data-structure/Bond.h>
 #include <uni10/tensor-network/Matrix.h>
 #include <uni10/tensor-network/UniTensor.h>
+#include <uni10/tensor-network/TensorExpr.h>
 #include <deque>
+#include <mutex>
 #ifdef HDF5
 #include <uni10/hdf5io/uni10_hdf5io.h>
 #endif
@@ -47,6 +49,28 @@ int64_t UniTensor::ELEMNUM = 0;
 int UniTensor::COUNTER = 0;
 size_t UniTensor::MAXELEMNUM = 0;
 size_t UniTensor::MAXELEMTEN = 0;
+static std::mutex counterMutex;  // guards the static counters of UniTensor
+
+UniTensor::ElemStorage::~ElemStorage(){
+  if(owned)
+    elemFree(elem, memsize, ongpu);
+}
+
+struct UniTensor::PendingPermute{
+  std::mutex lock;                    // serializes the threads materializing the same tensor
+  std::shared_ptr<UniTensor> source;  // the elements as they were before the first pending permutation
+  std::vector<int> order;             // bond b of the tensor is bond order[b] of the source
+};
+
+void UniTensor::updateCounter(int tenDiff, int64_t elemDiff, size_t tenElemNum){
+  std::lock_guard<std::mutex> lock(counterMutex);
+  COUNTER += tenDiff;
+  ELEMNUM += elemDiff;
+  if(ELEMNUM > (int64_t)MAXELEMNUM)
+    MAXELEMNUM = ELEMNUM;
+  if(tenElemNum > MAXELEMTEN)
+    MAXELEMTEN = tenElemNum;
+}
 
 /*********************  DEVELOP **************************/
 
@@ -54,6 +78,7 @@ size_t UniTensor::MAXELEMTEN = 0;
 
 std::ostream& operator<< (std::ostream& os, const UniTensor& UniT){
   try{
+    UniT.materialize();
     if(!(UniT.status & UniT.HAVEBOND)){
       if(UniT.ongpu){
         if(UniT.typeID() == 1)
@@ -146,6 +171,7 @@ std::ostream& operator<< (std::ostream& os, const UniTensor& UniT){
 
 UniTensor& UniTensor::operator*=(const UniTensor& uT){
   try{
+    materialize();
     *this = *this * uT;
   }
   catch(const std::exception& e){
@@ -161,8 +187,7 @@ UniTensor& UniTensor::operator*= (Real a){
       err<<"Cannot perform scalar multiplication on a tensor before setting its elements.";
       throw std::runtime_error(exception_msg(err.str()));
     }
-    *this = *this * a;
-    //vectorScal(a, elem, m_elemNum, ongpu);
+    scale(a);
   }
   catch(const std::exception& e){
     propogate_exception(e, "In function UniTensor::operator*=(Real):");
@@ -177,8 +202,7 @@ UniTensor& UniTensor::operator*= (Complex a){
       err<<"Cannot perform scalar multiplication on a tensor before setting its elements.";
       throw std::runtime_error(exception_msg(err.str()));
     }
-    *this = *this * a;
-    //vectorScal(a, c_elem, m_elemNum, ongpu);
+    scale(a);
   }
   catch(const std::exception& e){
     propogate_exception(e, "In function UniTensor::operator*=(Complex):");
@@ -198,6 +222,8 @@ UniTensor operator*(const Complex& a, const UniTensor& Ta){
     UniTensor Tb(Ta);
     if(Tb.typeID() == 1)
       RtoC(Tb);
+    else
+      Tb.detachElem();
     vectorScal(a, Tb.c_elem, Tb.m_elemNum, Tb.ongpu);
     return Tb;
   }
@@ -217,6 +243,7 @@ UniTensor operator*(const UniTensor& Ta, Real a){
       throw std::runtime_error(exception_msg(err.str()));
     }
     UniTensor Tb(Ta);
+    Tb.detachElem();
     if(Tb.typeID() == 1)
       vectorScal(a, Tb.elem, Tb.m_elemNum, Tb.ongpu);
     else if(Tb.typeID() == 2)
@@ -245,6 +272,11 @@ UniTensor operator*(const UniTensor& Ta, const UniTensor& Tb){
 
 UniTensor& UniTensor::operator=(const UniTensor& UniT){ //GPU
   try{
+    if(this == &UniT)
+      return *this;
+    UniT.materialize();
+    pending.reset();
+    hasPending = false;
 
     r_flag = UniT.r_flag;
     c_flag = UniT.c_flag;
@@ -262,113 +294,259 @@ UniTensor& UniTensor::operator=(const UniTensor& UniT){ //GPU
     CQidx2Dim = UniT.CQidx2Dim;
     RQidx2Blk = UniT.RQidx2Blk;
 
-    ELEMNUM -= m_elemNum;	//free original memory
-
-
+    updateCounter(0, -(int64_t)m_elemNum);	//free original memory
     TelemFree();
 
-    elem = NULL;
-    c_elem = NULL;
+    // share the elements, the blocks copied above already point into them
+    storage = UniT.storage;
+    elem = UniT.elem;
+    c_elem = UniT.c_elem;
+    ongpu = UniT.ongpu;
     status = UniT.status;
     m_elemNum = UniT.m_elemNum;
+    std::map<const Block*, Block*> blkmap;
+    for(std::map<Qnum, Block>::iterator it = blocks.begin(); it != blocks.end(); it++)
+      blkmap[&(UniT.blocks.find(it->first)->second)] = &(it->second);
+    for(std::map<int, Block*>::iterator it = RQidx2Blk.begin(); it != RQidx2Blk.end(); it++)
+      it->second = blkmap[it->second];
+    unshareIfPinned();
 
+    updateCounter(0, m_elemNum, m_elemNum);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function UniTensor::operator=(uni10::UniTensor&):");
+  }
+  return *this;
+}
 
-    std::map<Qnum, Block>::const_iterator it2;
-    std::map< const Block* , Block*> blkmap;
-
-    if(typeID() == 1){
-      TelemAlloc(RTYPE);
-      for (std::map<Qnum, Block>::iterator it = blocks.begin(); it != blocks.end(); it++ ){ // blocks here is UniT.blocks
-        it->second.m_elem = &(elem[it->second.m_elem - UniT.elem]);
-        it2 = UniT.blocks.find(it->first);
-        blkmap[&(it2->second)] = &(it->second);
-      }
-    }else if(typeID() == 2){
-      TelemAlloc(CTYPE);
-      for (std::map<Qnum, Block>::iterator it = blocks.begin(); it != blocks.end(); it++ ){ // blocks here is UniT.blocks
-        it->second.cm_elem = &(c_elem[it->second.cm_elem - UniT.c_elem]);
-        it2 = UniT.blocks.find(it->first);
-        blkmap[&(it2->second)] = &(it->second);
-      }
-    }
+UniTensor& UniTensor::operator=(const TensorExpr& expr){
+  try{
+    expr.evaluate(*this);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function UniTensor::operator=(uni10::TensorExpr&):");
+  }
+  return *this;
+}
 
-    if(UniT.status & HAVEBOND){
-      for(std::map<int, Block*>::iterator it = RQidx2Blk.begin(); it != RQidx2Blk.end(); it++)
-        it->second = blkmap[it->second];
-    }
+UniTensor operator+(const UniTensor& Ta, const UniTensor& Tb){
+  try{
+    UniTensor Tc(Ta);
+    Tc.add(Tb);
+    return Tc;
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function operator+(uni10::UniTensor&, uni10::UniTensor&):");
+    return UniTensor();
+  }
+}
 
-    ELEMNUM += m_elemNum;
-    if(ELEMNUM > MAXELEMNUM)
-      MAXELEMNUM = ELEMNUM;
-    if(m_elemNum > MAXELEMTEN)
-      MAXELEMTEN = m_elemNum;
+UniTensor& UniTensor::operator+= (const UniTensor& Tb){
+  try{
+    add(Tb);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function UniTensor::operator+=(uni10::UniTensor&):");
+  }
+  return *this;
+}
 
+UniTensor& UniTensor::scale(Real a){
+  try{
+    detachElem();
+    if(!(status & HAVEELEM)){
+      std::ostringstream err;
+      err<<"Cannot perform scalar multiplication on a tensor before setting its elements.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
     if(typeID() == 1)
-      elemCopy(elem, UniT.elem, sizeof(Real) * UniT.m_elemNum, ongpu, UniT.ongpu);
+      vectorAxpby(0., elem, a, elem, m_elemNum, ongpu, ongpu);
     else if(typeID() == 2)
-      elemCopy(c_elem, UniT.c_elem, sizeof(Complex) * UniT.m_elemNum, ongpu, UniT.ongpu);
-
+      vectorAxpby(Complex(0), c_elem, Complex(a), c_elem, m_elemNum, ongpu, ongpu);
   }
   catch(const std::exception& e){
-    propogate_exception(e, "In function UniTensor::operator=(uni10::UniTensor&):");
+    propogate_exception(e, "In function UniTensor::scale(Real):");
   }
   return *this;
 }
 
-UniTensor operator+(const UniTensor& _Ta, const UniTensor& _Tb){
+UniTensor& UniTensor::scale(Complex a){
   try{
-
-    UniTensor Ta(_Ta);
-    UniTensor Tb(_Tb);
-    if(Ta.typeID() == 1 && Tb.typeID() == 2)
-      RtoC(Ta);
-    if(Ta.typeID() == 2 && Tb.typeID() == 1)
-      RtoC(Tb);
-    if(!(Ta.status & Tb.status & Ta.HAVEELEM)){
+    detachElem();
+    if(a.imag() == 0)
+      return scale(a.real());
+    if(!(status & HAVEELEM)){
       std::ostringstream err;
-      err<<"Cannot perform addition of tensors before setting their elements.";
+      err<<"Cannot perform scalar multiplication on a tensor before setting its elements.";
       throw std::runtime_error(exception_msg(err.str()));
     }
-    if(!(Ta.bonds == Tb.bonds)){
+    if(typeID() == 1)
+      RtoC(*this);
+    vectorAxpby(Complex(0), c_elem, a, c_elem, m_elemNum, ongpu, ongpu);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function UniTensor::scale(Complex):");
+  }
+  return *this;
+}
+
+// The states of bd, without those whose quantum number the bond other does not have
+static std::vector<Qnum> sharedStates(const Bond& bd, const Bond& other){
+  std::map<Qnum, int> degs = other.degeneracy();
+  std::vector<Qnum> qnums = bd.Qlist();
+  std::vector<Qnum> shared;
+  for(size_t s = 0; s < qnums.size(); s++)
+    if(degs.find(qnums[s]) != degs.end())
+      shared.push_back(qnums[s]);
+  return shared;
+}
+
+// True if X has the bonds, and so the element layout, of the tensor; false if the blocks can only be
+// matched sector by sector, that is, if the bonds match one to one up to the sectors one of them lacks
+bool UniTensor::sameElemLayout(const UniTensor& X)const{
+  if(bonds == X.bonds)
+    return true;
+  bool match = bonds.size() == X.bonds.size();
+  for(size_t b = 0; b < bonds.size() && match; b++)
+    match = bonds[b].type() == X.bonds[b].type() &&
+      sharedStates(bonds[b], X.bonds[b]) == sharedStates(X.bonds[b], bonds[b]);
+  if(!match){
+    std::ostringstream err;
+    err<<"Cannot combine two tensors having different bonds.";
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+  for(std::map<Qnum, Block>::const_iterator it = X.blocks.begin(); it != X.blocks.end(); it++){
+    std::map<Qnum, Block>::const_iterator mine = blocks.find(it->first);
+    bool zero = true;
+    if(mine == blocks.end()){
+      size_t n = it->second.row() * it->second.col();
+      for(size_t k = 0; k < n && zero; k++)
+        zero = X.typeID() == 1 ? it->second.m_elem[k] == 0 : it->second.cm_elem[k] == Complex(0);
+    }
+    if(mine == blocks.end() ? !zero : mine->second.row() != it->second.row() || mine->second.col() != it->second.col()){
       std::ostringstream err;
-      err<<"Cannot perform addition of two tensors having diffirent bonds.";
+      err<<"Cannot combine two tensors having different bonds and different blocks of the quantum number " << it->first << ".";
       throw std::runtime_error(exception_msg(err.str()));
     }
+  }
+  return false;
+}
 
-    UniTensor Tc(Ta);
-    Tc.typeID() == 1 ? vectorAdd(Tc.elem, Tb.elem, Tc.m_elemNum, Tc.ongpu, Tb.ongpu) :vectorAdd(Tc.c_elem, Tb.c_elem, Tc.m_elemNum, Tc.ongpu, Tb.ongpu);
-    return Tc;
+UniTensor& UniTensor::axpby(Real a, const UniTensor& X, Real b){
+  try{
+    axpby(Complex(a), X, Complex(b));
   }
   catch(const std::exception& e){
-    propogate_exception(e, "In function operator+(uni10::UniTensor&, uni10::UniTensor&):");
-    return UniTensor();
+    propogate_exception(e, "In function UniTensor::axpby(Real, uni10::UniTensor&, Real):");
   }
+  return *this;
 }
 
-UniTensor& UniTensor::operator+= (const UniTensor& _Tb){
+UniTensor& UniTensor::axpby(Complex a, const UniTensor& X, Complex b){
   try{
-
-    UniTensor Tb(_Tb);
-    if(typeID() == 1 && Tb.typeID() == 2)
-      RtoC(*this);
-    if(typeID() == 2 && Tb.typeID() == 1)
-      RtoC(Tb);
-
-    if(!(status & Tb.status & HAVEELEM)){
+    detachElem();
+    X.materialize();
+    if(!(status & X.status & HAVEELEM)){
       std::ostringstream err;
       err<<"Cannot perform addition of tensors before setting their elements.";
       throw std::runtime_error(exception_msg(err.str()));
     }
-    if(!(bonds == Tb.bonds)){
+    bool flat = sameElemLayout(X);
+    if(typeID() == 1 && (X.typeID() == 2 || a.imag() != 0 || b.imag() != 0))
+      RtoC(*this);
+    bool real = typeID() == 1, realX = X.typeID() == 1;
+    // Y = a * X + b * Y of n elements, X is not read if a is zero
+    auto combine = [&](Complex a, Real* x, Complex* cx, Real* y, Complex* cy, size_t n){
+      if(real)
+        vectorAxpby(a.real(), x, b.real(), y, n, ongpu, X.ongpu);
+      else if(realX)
+        vectorAxpby(a, x, b, cy, n, ongpu, X.ongpu);
+      else
+        vectorAxpby(a, cx, b, cy, n, ongpu, X.ongpu);
+    };
+    if(flat)
+      combine(a, X.elem, X.c_elem, elem, c_elem, m_elemNum);
+    else
+      for(std::map<Qnum, Block>::iterator it = blocks.begin(); it != blocks.end(); it++){
+        std::map<Qnum, Block>::const_iterator xit = X.blocks.find(it->first);
+        size_t n = it->second.row() * it->second.col();
+        if(xit == X.blocks.end())
+          combine(0, it->second.m_elem, it->second.cm_elem, it->second.m_elem, it->second.cm_elem, n);
+        else
+          combine(a, xit->second.m_elem, xit->second.cm_elem, it->second.m_elem, it->second.cm_elem, n);
+      }
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function UniTensor::axpby(Complex, uni10::UniTensor&, Complex):");
+  }
+  return *this;
+}
+
+UniTensor& UniTensor::axpy(Real a, const UniTensor& X){
+  try{
+    axpby(Complex(a), X, Complex(1));
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function UniTensor::axpy(Real, uni10::UniTensor&):");
+  }
+  return *this;
+}
+
+UniTensor& UniTensor::axpy(Complex a, const UniTensor& X){
+  try{
+    axpby(a, X, Complex(1));
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function UniTensor::axpy(Complex, uni10::UniTensor&):");
+  }
+  return *this;
+}
+
+UniTensor& UniTensor::add(const UniTensor& X){
+  try{
+    axpby(Complex(1), X, Complex(1));
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function UniTensor::add(uni10::UniTensor&):");
+  }
+  return *this;
+}
+
+UniTensor& UniTensor::hadamard(const UniTensor& X){
+  try{
+    detachElem();
+    X.materialize();
+    if(!(status & X.status & HAVEELEM)){
       std::ostringstream err;
-      err<<"Cannot perform addition of two tensors having different bonds.";
+      err<<"Cannot perform element-wise multiplication of tensors before setting their elements.";
       throw std::runtime_error(exception_msg(err.str()));
     }
-
-    typeID() == 1 ? vectorAdd(elem, Tb.elem, m_elemNum, ongpu, Tb.ongpu) : vectorAdd(c_elem, Tb.c_elem, m_elemNum, ongpu, Tb.ongpu);
+    bool flat = sameElemLayout(X);
+    if(typeID() == 1 && X.typeID() == 2)
+      RtoC(*this);
+    bool real = typeID() == 1, realX = X.typeID() == 1;
+    auto multiply = [&](Real* x, Complex* cx, Real* y, Complex* cy, size_t n){
+      if(real)
+        vectorMul(y, x, n, ongpu, X.ongpu);
+      else if(realX)
+        vectorMul(cy, x, n, ongpu, X.ongpu);
+      else
+        vectorMul(cy, cx, n, ongpu, X.ongpu);
+    };
+    if(flat)
+      multiply(X.elem, X.c_elem, elem, c_elem, m_elemNum);
+    else
+      for(std::map<Qnum, Block>::iterator it = blocks.begin(); it != blocks.end(); it++){
+        std::map<Qnum, Block>::const_iterator xit = X.blocks.find(it->first);
+        size_t n = it->second.row() * it->second.col();
+        if(xit == X.blocks.end())
+          real ? elemBzero(it->second.m_elem, n * sizeof(Real), ongpu) : elemBzero(it->second.cm_elem, n * sizeof(Complex), ongpu);
+        else
+          multiply(xit->second.m_elem, xit->second.cm_elem, it->second.m_elem, it->second.cm_elem, n);
+      }
   }
   catch(const std::exception& e){
-    propogate_exception(e, "In function UniTensor::operator+=(uni10::UniTensor&):");
+    propogate_exception(e, "In function UniTensor::hadamard(uni10::UniTensor&):");
   }
   return *this;
 }
@@ -394,6 +572,16 @@ UniTensor::UniTensor(): status(0){
   }
 }
 
+UniTensor::UniTensor(const TensorExpr& expr): status(0){
+  try{
+    initUniT(RTYPE);
+    expr.evaluate(*this);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor UniTensor::UniTensor(uni10::TensorExpr&):");
+  }
+}
+
 
 UniTensor::UniTensor(const std::vector<Bond>& _bonds, const std::string& _name): name(_name), status(0), bonds(_bonds){
   try{
@@ -438,48 +626,26 @@ UniTensor::UniTensor(const std::vector<Bond>& _bonds, int* _labels, const std::s
 
 UniTensor::UniTensor(const UniTensor& UniT): //GPU
   r_flag(UniT.r_flag), c_flag(UniT.c_flag),name(UniT.name), elem(NULL), c_elem(NULL), status(UniT.status), 
-bonds(UniT.bonds), blocks(UniT.blocks), labels(UniT.labels), \
-    RBondNum(UniT.RBondNum), RQdim(UniT.RQdim), CQdim(UniT.CQdim), m_elemNum(UniT.m_elemNum), RQidx2Blk(UniT.RQidx2Blk), QidxEnc(UniT.QidxEnc),  RQidx2Off(UniT.RQidx2Off), CQidx2Off(UniT.CQidx2Off), RQidx2Dim(UniT.RQidx2Dim), CQidx2Dim(UniT.CQidx2Dim){
+bonds(UniT.bonds), labels(UniT.labels), \
+    RBondNum(UniT.RBondNum), RQdim(UniT.RQdim), CQdim(UniT.CQdim), m_elemNum(UniT.m_elemNum), QidxEnc(UniT.QidxEnc),  RQidx2Off(UniT.RQidx2Off), CQidx2Off(UniT.CQidx2Off), RQidx2Dim(UniT.RQidx2Dim), CQidx2Dim(UniT.CQidx2Dim){
     try{
-
-      std::map<Qnum, Block>::const_iterator it2;
-      std::map<const Block* , Block*> blkmap;
-
-      if(typeID() == 1){
-        TelemAlloc(RTYPE);
-        for (std::map<Qnum, Block>::iterator it = blocks.begin() ; it != blocks.end(); it++ ){
-          it->second.m_elem = &(elem[(it->second.m_elem - UniT.elem)]);
-          it2 = UniT.blocks.find(it->first);
-          blkmap[(&(it2->second))] = &(it->second);
-        }
-      }
-
-      if(typeID() == 2){
-        TelemAlloc(CTYPE);
-        for (std::map<Qnum, Block>::iterator it = blocks.begin() ; it != blocks.end(); it++ ){
-          it->second.cm_elem = &(c_elem[(it->second.cm_elem - UniT.c_elem)]);
-
-          it2 = UniT.blocks.find(it->first);
-          blkmap[(&(it2->second))] = &(it->second);
-        }
-      }
-
-      if(UniT.status & HAVEBOND){
-        for(std::map<int, Block*>::iterator it = RQidx2Blk.begin(); it != RQidx2Blk.end(); it++)
-          it->second = blkmap[it->second];
-      }
-
-      ELEMNUM += m_elemNum;
-      COUNTER++;
-      if(ELEMNUM > MAXELEMNUM)
-        MAXELEMNUM = ELEMNUM;
-      if(m_elemNum > MAXELEMTEN)
-        MAXELEMTEN = m_elemNum;
-
-      if(typeID() == 1)
-        elemCopy(elem, UniT.elem, sizeof(Real) * UniT.m_elemNum, ongpu, UniT.ongpu);
-      if(typeID() == 2)
-        elemCopy(c_elem, UniT.c_elem, sizeof(Complex) * UniT.m_elemNum, ongpu, UniT.ongpu);
+      // the blocks of a pending permutation do not point to elements yet, and another thread copying
+      // UniT may be moving them into place
+      UniT.materialize();
+      blocks = UniT.blocks;
+      RQidx2Blk = UniT.RQidx2Blk;
+      // share the elements, the blocks copied above already point into them
+      storage = UniT.storage;
+      elem = UniT.elem;
+      c_elem = UniT.c_elem;
+      ongpu = UniT.ongpu;
+      std::map<const Block*, Block*> blkmap;
+      for(std::map<Qnum, Block>::iterator it = blocks.begin(); it != blocks.end(); it++)
+        blkmap[&(UniT.blocks.find(it->first)->second)] = &(it->second);
+      for(std::map<int, Block*>::iterator it = RQidx2Blk.begin(); it != RQidx2Blk.end(); it++)
+        it->second = blkmap[it->second];
+      unshareIfPinned();
+      updateCounter(1, m_elemNum, m_elemNum);
     }
     catch(const std::exception& e){
       propogate_exception(e, "In copy constructor UniTensor::UniTensor(uni10::UniTensor&):");
@@ -502,12 +668,12 @@ UniTensor::UniTensor(const Block& blk): status(0){
 
 UniTensor::~UniTensor(){
   TelemFree();
-  ELEMNUM -= m_elemNum;
-  COUNTER--;
+  updateCounter(-1, -(int64_t)m_elemNum);
 }
 
 UniTensor::UniTensor(const std::string& fname): status(0){ //GPU
   try{
+    UNI10_TRACE_SCOPE(trace, "load " + fname, "io");
     /*
     int namemax = 32;
     if(fname.size() > (size_t)namemax)
@@ -802,11 +968,13 @@ Qnum UniTensor::blockQnum(size_t idx)const{
   return Qnum(0);
 }
 const std::map<Qnum, Block>& UniTensor::const_getBlocks()const{
+  materialize();
   return blocks;
 }
 
 const Block& UniTensor::const_getBlock()const{
   try{
+    materialize();
     Qnum q0(0);
     return const_getBlock(q0);
   }
@@ -818,6 +986,7 @@ const Block& UniTensor::const_getBlock()const{
 
 const Block& UniTensor::const_getBlock(const Qnum& qnum)const{
   try{
+    materialize();
     std::map<Qnum, Block>::const_iterator it = blocks.find(qnum);
     if(it == blocks.end()){
       std::ostringstream err;
@@ -835,6 +1004,7 @@ const Block& UniTensor::const_getBlock(const Qnum& qnum)const{
 
 std::map<Qnum, Matrix> UniTensor::getBlocks()const{
   try{
+    materialize();
     if(typeID() == 1)
       return getBlocks(RTYPE);
     else if(typeID() == 2)
@@ -848,6 +1018,7 @@ std::map<Qnum, Matrix> UniTensor::getBlocks()const{
 
 Matrix UniTensor::getBlock(bool diag)const{
   try{
+    materialize();
     if(typeID() == 1)
       return getBlock(RTYPE, diag);
     else if(typeID() == 2)
@@ -862,6 +1033,7 @@ Matrix UniTensor::getBlock(bool diag)const{
 
 Matrix UniTensor::getBlock(const Qnum& qnum, bool diag)const{
   try{
+    materialize();
     if(typeID() == 1)
       return getBlock(RTYPE, qnum, diag);
     else if(typeID() == 2)
@@ -874,8 +1046,53 @@ Matrix UniTensor::getBlock(const Qnum& qnum, bool diag)const{
   return Matrix();
 }
 
+BlockView UniTensor::getBlockView(){
+  try{
+    Qnum q0(0);
+    return getBlockView(q0);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function UniTensor::getBlockView():");
+  }
+  return BlockView();
+}
+
+BlockView UniTensor::getBlockView(const Qnum& qnum){
+  try{
+    pinElem();
+    std::map<Qnum, Block>::iterator it = blocks.find(qnum);
+    if(it == blocks.end()){
+      std::ostringstream err;
+      err<<"There is no block with the given quantum number "<<qnum;
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    status |= HAVEELEM;
+    return BlockView(it->second);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function UniTensor::getBlockView(uni10::Qnum&):");
+  }
+  return BlockView();
+}
+
+std::map<Qnum, BlockView> UniTensor::getBlockViews(){
+  std::map<Qnum, BlockView> views;
+  try{
+    pinElem();
+    for(std::map<Qnum, Block>::iterator it = blocks.begin(); it != blocks.end(); it++)
+      views[it->first] = BlockView(it->second);
+    if(blocks.size())
+      status |= HAVEELEM;
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function UniTensor::getBlockViews():");
+  }
+  return views;
+}
+
 void UniTensor::set_zero(){
   try{
+    detachElem();
     if(typeID() == 1)
       set_zero(RTYPE);
     else if(typeID() == 2)
@@ -888,6 +1105,7 @@ void UniTensor::set_zero(){
 
 void UniTensor::set_zero(const Qnum& qnum){
   try{
+    detachElem();
     if(typeID() == 1)
       set_zero(RTYPE, qnum);
     else if(typeID() == 2)
@@ -900,6 +1118,7 @@ void UniTensor::set_zero(const Qnum& qnum){
 
 void UniTensor::identity(){
   try{
+    detachElem();
     if(typeID() == 1)
       identity(RTYPE);
     else if(typeID() == 2)
@@ -912,6 +1131,7 @@ void UniTensor::identity(){
 
 void UniTensor::identity(const Qnum& qnum){
   try{
+    detachElem();
     if(typeID() == 1)
       identity(RTYPE, qnum);
     else if(typeID() == 2)
@@ -924,6 +1144,7 @@ void UniTensor::identity(const Qnum& qnum){
 
 void UniTensor::randomize(){
   try{
+    detachElem();
     if(typeID() == 1)
       randomize(RTYPE);
     else if(typeID() == 2)
@@ -936,6 +1157,7 @@ void UniTensor::randomize(){
 
 void UniTensor::orthoRand(){
   try{
+    detachElem();
     if(typeID() == 1)
       orthoRand(RTYPE);
     else if(typeID() == 2)
@@ -948,6 +1170,7 @@ void UniTensor::orthoRand(){
 
 void UniTensor::orthoRand(const Qnum& qnum){
   try{
+    detachElem();
     if(typeID() == 1)
       orthoRand(RTYPE, qnum);
     else if(typeID() == 2)
@@ -960,6 +1183,8 @@ void UniTensor::orthoRand(const Qnum& qnum){
 
 void UniTensor::save(const std::string& fname) const{
   try{
+    materialize();
+    UNI10_TRACE_SCOPE(trace, "save " + fname, "io");
     if((status & HAVEBOND) == 0){   //If not INIT, NO NEED to write out to file
       throw std::runtime_error(exception_msg("Saving a tensor without bonds(scalar) is not supported."));
     }
@@ -1026,6 +1251,7 @@ void UniTensor::save(const std::string& fname) const{
 #ifdef HDF5
 void UniTensor::h5save(const std::string& fname){
   try{
+    materialize();
     if((status & HAVEBOND) == 0){   //If not INIT, NO NEED to write out to file
       throw std::runtime_error(exception_msg("Saving a tensor without bonds(scalar) is not supported."));
     }
@@ -1068,6 +1294,7 @@ void UniTensor::h5save(const std::string& fname){
 
 UniTensor& UniTensor::transpose(){
   try{
+    materialize();
     if(typeID() == 1)
       return transpose(RTYPE);
     else if(typeID() == 2)
@@ -1120,6 +1347,7 @@ UniTensor& UniTensor::permute(const std::vector<int>& newLabels, int rowBondNum)
 
 UniTensor& UniTensor::permuteFm(int rowBondNum){
   try{
+    materialize();
     if(typeID() == 1)
       return permuteFm(RTYPE, rowBondNum);
     else if(typeID() == 2)
@@ -1133,6 +1361,7 @@ UniTensor& UniTensor::permuteFm(int rowBondNum){
 
 UniTensor& UniTensor::permuteFm(int* newLabels, int rowBondNum){
   try{
+    materialize();
     if(typeID() == 1)
       return permuteFm(RTYPE, newLabels, rowBondNum);
     else if(typeID() == 2)
@@ -1146,6 +1375,7 @@ UniTensor& UniTensor::permuteFm(int* newLabels, int rowBondNum){
 
 UniTensor& UniTensor::permuteFm(const std::vector<int>& newLabels, int rowBondNum){
   try{
+    materialize();
     if(typeID() == 1)
       return permuteFm(RTYPE, newLabels, rowBondNum);
     else if(typeID() == 2)
@@ -1158,6 +1388,7 @@ UniTensor& UniTensor::permuteFm(const std::vector<int>& newLabels, int rowBondNu
 }
 
 void UniTensor::applySwapGate(int to_permute, const std::vector<int>& to_cross, bool permute_back){
+  materialize();
   std::vector<int> lab_ori = this->label();
   int tbn = lab_ori.size();
   int ibn = this->inBondNum();
@@ -1219,16 +1450,19 @@ void UniTensor::applySwapGate(int to_permute, const std::vector<int>& to_cross,
 }
 
 void UniTensor::applySwapGate(int to_permute, int to_cross, bool permute_back){
+  materialize();
   std::vector<int> to_cross_vec = {to_cross};
   this->applySwapGate(to_permute, to_cross_vec, permute_back);
 }
 
 void UniTensor::applySwapGate(_Swap to_swap, bool permute_back){
+  materialize();
   this->applySwapGate(to_swap.b1, to_swap.b2, permute_back);
 }
 
 UniTensor& UniTensor::combineBond(const std::vector<int>&cmbLabels){
   try{
+    materialize();
     if(typeID() == 1)
       return combineBond(RTYPE, cmbLabels);
     else if(typeID() == 2)
@@ -1242,6 +1476,7 @@ UniTensor& UniTensor::combineBond(const std::vector<int>&cmbLabels){
 
 std::string UniTensor::printRawElem(bool print)const{
   try{
+    materialize();
     std::ostringstream os;
     if(status & HAVEBOND && status & HAVEELEM){
       int bondNum = bonds.size();
@@ -1319,10 +1554,17 @@ std::string UniTensor::printRawElem(bool print)const{
 std::string UniTensor::profile(bool print){
   std::ostringstream os;
   os<<"\n===== Tensor profile =====\n";
+  std::lock_guard<std::mutex> lock(counterMutex);
 	os<<"Existing Tensors: " << COUNTER << std::endl;
 	os<<"Allocated Elements: " << ELEMNUM << std::endl;
 	os<<"Max Allocated Elements: " << MAXELEMNUM << std::endl;
 	os<<"Max Allocated Elements for a Tensor: " << MAXELEMTEN << std::endl;
+  if(ProfileData::enabled()){
+    os<<"----------------------------\n"<<profileSnapshot().str();
+    MemorySnapshot mem = memorySnapshot();
+    if(mem.peakBytes)
+      os<<"----------------------------\n"<<mem.str();
+  }
   os<<"============================\n\n";
   if(print){
     std::cout<<os.str();
@@ -1331,9 +1573,17 @@ std::string UniTensor::profile(bool print){
   return os.str();
 }
 
+ProfileData UniTensor::profileData(){
+  return profileSnapshot();
+}
+
+void UniTensor::resetProfile(){
+  profileReset();
+}
 
 void UniTensor::setRawElem(const Block& blk){
   try{
+    detachElem();
     if(blk.typeID() == 1)
       setRawElem(RTYPE, blk);
     else if(blk.typeID() == 2)
@@ -1345,6 +1595,7 @@ void UniTensor::setRawElem(const Block& blk){
 }
 
 void UniTensor::putBlock(const Block& mat, bool force){
+  detachElem();
 
   try{
 
@@ -1362,6 +1613,7 @@ void UniTensor::putBlock(const Block& mat, bool force){
 
 void UniTensor::putBlock(const Qnum& qnum, const Block& mat, bool force){
   try{
+    detachElem();
 
     if(typeID() == 1)
       this->putBlock(RTYPE, qnum, mat, force);
@@ -1410,6 +1662,7 @@ std::vector<_Swap> UniTensor::exSwap(const UniTensor& Tb) const{
 }
 void UniTensor::addGate(const std::vector<_Swap>& swaps){
   try{
+    detachElem();
     if(typeID() == 1)
       addGate(RTYPE, swaps);
     else if(typeID() == 2)
@@ -1422,6 +1675,7 @@ void UniTensor::addGate(const std::vector<_Swap>& swaps){
 
 Complex UniTensor::trace()const{
   try{
+    materialize();
     if(typeID() == 1)
       return Complex(trace(RTYPE), 0);
     else if(typeID() == 2)
@@ -1436,6 +1690,7 @@ Complex UniTensor::trace()const{
 
 UniTensor& UniTensor::partialTrace(int la, int lb){
   try{
+    materialize();
     if(typeID() == 1)
       return partialTrace(RTYPE, la, lb);
     else if(typeID() == 2)
@@ -1449,6 +1704,7 @@ UniTensor& UniTensor::partialTrace(int la, int lb){
 
 Real UniTensor::operator[](size_t idx)const{
   try{
+    materialize();
     if(!(idx < m_elemNum)){
       std::ostringstream err;
       err<<"Index exceeds the number of elements("<<m_elemNum<<").";
@@ -1470,6 +1726,7 @@ Real UniTensor::operator[](size_t idx)const{
 
 Complex UniTensor::operator()(size_t idx)const{
   try{
+    materialize();
     if(!(idx < m_elemNum)){
       std::ostringstream err;
       err<<"Index exceeds the number of elements("<<m_elemNum<<").";
@@ -1491,6 +1748,7 @@ Complex UniTensor::operator()(size_t idx)const{
 
 Matrix UniTensor::getRawElem()const{
   try{
+    materialize();
     if(typeID() == 1)
       return getRawElem(RTYPE);
     else if(typeID() == 2)
@@ -1505,6 +1763,7 @@ Matrix UniTensor::getRawElem()const{
 
 UniTensor& UniTensor::assign(const std::vector<Bond>& _bond){
   try{
+    materialize();
     if(typeID() == 1)
       this->assign(RTYPE, _bond);
     else if(typeID() == 2)
@@ -1517,9 +1776,11 @@ UniTensor& UniTensor::assign(const std::vector<Bond>& _bond){
 }
 
 bool UniTensor::CelemIsNULL(){
+  materialize();
   return c_elem == NULL;
 }
 bool UniTensor::RelemIsNULL(){
+  materialize();
   return elem == NULL;
 }
 
@@ -1540,6 +1801,7 @@ bool UniTensor::similar(const UniTensor& Tb)const{
 
 bool UniTensor::elemCmp(const UniTensor& _UniT)const{
   try{
+    materialize();
     UniTensor Ta(*this);
     UniTensor UniT(_UniT);
     if(Ta.typeID() != UniT.typeID())
@@ -1571,11 +1833,13 @@ bool UniTensor::elemCmp(const UniTensor& _UniT)const{
 }
 
 void UniTensor::clear(){
+  materialize();
   status &= ~HAVEELEM;
 }
 
 Real UniTensor::at(size_t idx)const{
   try{
+    materialize();
     return at(RTYPE, idx);
   }
   catch(const std::exception& e){
@@ -1586,6 +1850,7 @@ Real UniTensor::at(size_t idx)const{
 
 Real UniTensor::at(const std::vector<int>& idxs)const{
   try{
+    materialize();
     std::vector<size_t> _idxs(idxs.size());
     for(size_t i = 0; i < idxs.size(); i++)
       _idxs[i] = idxs[i];
@@ -1599,6 +1864,7 @@ Real UniTensor::at(const std::vector<int>& idxs)const{
 
 Real UniTensor::at(const std::vector<size_t>& idxs)const{
   try{
+    materialize();
     return at(RTYPE, idxs);
   }
   catch(const std::exception& e){
@@ -1609,6 +1875,7 @@ Real UniTensor::at(const std::vector<size_t>& idxs)const{
 
 Real* UniTensor::getElem(){
   try{
+    pinElem();
     if(typeID() == 2){
       std::ostringstream err;
       err<<"This Tensor is COMPLEX. Please use UniTensor::getElem(uni10::cflag ) instead";
@@ -1631,15 +1898,165 @@ void UniTensor::initUniT(int typeID){
 }
 
 void UniTensor::TelemFree(){
-  if(elem != NULL)
-    elemFree(elem, sizeof(Real) * m_elemNum, ongpu);
-  else if(c_elem != NULL)
-    elemFree(c_elem, sizeof(Complex) * m_elemNum, ongpu);
+  storage.reset();  // frees the elements unless another tensor still shares them
+  elem = NULL;
+  c_elem = NULL;
+}
+
+void UniTensor::detachElem(){
+  materialize();
+  if(!storage || storage.use_count() == 1)
+    return;
+  UNI10_PROFILE_SCOPE(prof, PROF_COPY, storage->memsize);
+  std::shared_ptr<ElemStorage> shared = storage;
+  Real* oldElem = elem;
+  Complex* oldCElem = c_elem;
+  if(typeID() == 1){
+    TelemAlloc(RTYPE);
+    elemCopy(elem, oldElem, shared->memsize, ongpu, shared->ongpu);
+    for(std::map<Qnum, Block>::iterator it = blocks.begin(); it != blocks.end(); it++)
+      it->second.m_elem = elem + (it->second.m_elem - oldElem);
+  }
+  else{
+    TelemAlloc(CTYPE);
+    elemCopy(c_elem, oldCElem, shared->memsize, ongpu, shared->ongpu);
+    for(std::map<Qnum, Block>::iterator it = blocks.begin(); it != blocks.end(); it++)
+      it->second.cm_elem = c_elem + (it->second.cm_elem - oldCElem);
+  }
+}
+
+void UniTensor::pinElem(){
+  detachElem();
+  if(storage)
+    storage->pinned = true;
+}
+
+void UniTensor::unshareIfPinned(){
+  if(storage && storage->pinned)
+    detachElem();
+}
+
+void UniTensor::swapContent(UniTensor& T){
+  std::swap(r_flag, T.r_flag);
+  std::swap(c_flag, T.c_flag);
+  name.swap(T.name);
+  std::swap(elem, T.elem);
+  std::swap(c_elem, T.c_elem);
+  std::swap(status, T.status);
+  bonds.swap(T.bonds);
+  blocks.swap(T.blocks);  // the nodes keep their addresses, so RQidx2Blk stays valid
+  labels.swap(T.labels);
+  std::swap(RBondNum, T.RBondNum);
+  std::swap(RQdim, T.RQdim);
+  std::swap(CQdim, T.CQdim);
+  std::swap(m_elemNum, T.m_elemNum);
+  RQidx2Blk.swap(T.RQidx2Blk);
+  QidxEnc.swap(T.QidxEnc);
+  RQidx2Off.swap(T.RQidx2Off);
+  CQidx2Off.swap(T.CQidx2Off);
+  RQidx2Dim.swap(T.RQidx2Dim);
+  CQidx2Dim.swap(T.CQidx2Dim);
+  std::swap(ongpu, T.ongpu);
+  storage.swap(T.storage);
+  pending.swap(T.pending);
+  hasPending = T.hasPending.exchange(hasPending);
+}
+
+void UniTensor::initBonds(int typeID, const std::vector<Bond>& outBonds){
+  TelemFree();
+  updateCounter(0, -(int64_t)m_elemNum);
+  bonds = outBonds;
+  RQidx2Blk.clear();
+  QidxEnc.clear();
+  RQidx2Off.clear();
+  CQidx2Off.clear();
+  RQidx2Dim.clear();
+  CQidx2Dim.clear();
+  r_flag = typeID == 1 ? RTYPE : RNULL;
+  c_flag = typeID == 2 ? CTYPE : CNULL;
+  m_elemNum = typeID == 2 ? grouping(CTYPE) : grouping(RTYPE);
+  status = HAVEBOND | HAVEELEM;
+  updateCounter(0, m_elemNum, m_elemNum);
+}
+
+void UniTensor::permuteLazily(const std::vector<int>& rsp_outin, const std::vector<Bond>& outBonds, const std::vector<int>& newLabels){
+  std::string tname = name;
+  std::shared_ptr<PendingPermute> next(new PendingPermute);
+  if(hasPending){  // compose with the permutation not yet applied
+    next->source = pending->source;
+    next->order.resize(rsp_outin.size());
+    for(size_t b = 0; b < rsp_outin.size(); b++)
+      next->order[b] = pending->order[rsp_outin[b]];
+    pending.reset();
+    hasPending = false;
+  }
+  else{
+    pending.reset();
+    next->source.reset(new UniTensor());
+    next->source->swapContent(*this);
+    next->order = rsp_outin;
+  }
+  bool inorder = true;
+  for(size_t b = 0; b < next->order.size(); b++)
+    if(next->order[b] != (int)b){
+      inorder = false;
+      break;
+    }
+  if(inorder && next->source->bonds == outBonds)  // permuted back, nothing to move
+    swapContent(*next->source);
+  else{
+    initBonds(next->source->typeID(), outBonds);
+    pending = next;
+    hasPending = true;
+  }
+  name = tname;
+  setLabel(newLabels);
+}
+
+void UniTensor::materialize()const{
+  if(!hasPending.load(std::memory_order_acquire))  // cleared only under the lock, after the elements are in place
+    return;
+  // pending itself is left in place, only the non-const methods reset it
+  PendingPermute& perm = *pending;
+  std::lock_guard<std::mutex> lock(perm.lock);
+  if(!hasPending.load(std::memory_order_relaxed))
+    return;
+  UniTensor* T = const_cast<UniTensor*>(this);
+  UniTensor& src = *perm.source;
+  bool inorder = true, withoutSymmetry = true;
+  for(size_t b = 0; b < bonds.size(); b++){
+    if(perm.order[b] != (int)b)
+      inorder = false;
+    if(bonds[b].Qnums.size() != 1)
+      withoutSymmetry = false;
+  }
+  if(inorder && withoutSymmetry){  // only the row bond number changed: the layout is the same
+    std::swap(T->elem, src.elem);
+    std::swap(T->c_elem, src.c_elem);
+    T->storage.swap(src.storage);
+  }
+  else if(typeID() == 1)
+    T->TelemAlloc(RTYPE);
+  else
+    T->TelemAlloc(CTYPE);
+  if(typeID() == 1){
+    T->initBlocks(RTYPE);
+    if(src.elem != NULL)
+      T->permuteElemFrom(RTYPE, src, perm.order);
+  }
+  else{
+    T->initBlocks(CTYPE);
+    if(src.c_elem != NULL)
+      T->permuteElemFrom(CTYPE, src, perm.order);
+  }
+  perm.source.reset();
+  hasPending.store(false, std::memory_order_release);
 }
 
 /************* developping *************/
 Real UniTensor::max() const{
   try{
+    materialize();
     if(blocks.size() == 0){
       std::ostringstream err;
       err<<"There is no block in this tensor ";
@@ -1660,6 +2077,7 @@ Real UniTensor::max() const{
 
 Real UniTensor::absMax() const{
   try{
+    materialize();
     if(blocks.size() == 0){
       std::ostringstream err;
       err<<"There is no block in this tensor ";
@@ -1680,6 +2098,7 @@ Real UniTensor::absMax() const{
 
 Real UniTensor::norm() const{
   try{
+    materialize();
     if(blocks.size() == 0){
       std::ostringstream err;
       err<<"There is no block in this tensor ";
@@ -1698,6 +2117,7 @@ Real UniTensor::norm() const{
 
 UniTensor& UniTensor::normalize(){
   try{
+    detachElem();
     if(typeID() == 1)
       return this->normalize(RTYPE);
     else if(typeID() == 2)
@@ -1711,6 +2131,7 @@ UniTensor& UniTensor::normalize(){
 
 UniTensor& UniTensor::absMaxNorm(){
   try{
+    detachElem();
     if(typeID() == 2){
       std::ostringstream err;
       err<< "Can't perform UniTensor::absMaxNorm() on this matrix. The type of matirx is COMPLEX.";
@@ -1726,6 +2147,7 @@ UniTensor& UniTensor::absMaxNorm(){
 
 UniTensor& UniTensor::maxNorm(){
   try{
+    detachElem();
     if(typeID() == 2){
       std::ostringstream err;
       err<< "Can't perform UniTensor::maxNorm() on this matrix. The type of matirx is COMPLEX.";
@@ -1741,6 +2163,7 @@ UniTensor& UniTensor::maxNorm(){
 
 void UniTensor::printDiagram()const{
   try{
+    materialize();
     if(!(status & HAVEBOND)){
       if(ongpu){
         if(typeID() == 1)
@@ -1822,6 +2245,7 @@ void UniTensor::printDiagram()const{
 
 UniTensor& UniTensor::cTranspose(){
   try{
+    materialize();
     if(typeID() == 1)
       return this->transpose(RTYPE); 
     else if(typeID() == 2)
@@ -1836,6 +2260,7 @@ UniTensor& UniTensor::cTranspose(){
 
 std::vector<UniTensor> UniTensor::hosvd(int* group_labels, int* groups, size_t groupsSize, std::vector<Matrix>& Ls)const{
   try{
+    materialize();
     if(typeID() == 1)
       return hosvd(RTYPE, group_labels, groups, groupsSize, Ls);
     else if(typeID() == 2)
@@ -1849,6 +2274,7 @@ std::vector<UniTensor> UniTensor::hosvd(int* group_labels, int* groups, size_t g
 
 std::vector<UniTensor> UniTensor::hosvd(std::vector<int>& group_labels, std::vector<int>& groups, std::vector<Matrix>& Ls)const{
   try{
+    materialize();
     if(typeID() == 1)
       return hosvd(RTYPE, group_labels, groups, Ls);
     else if(typeID() == 2)
@@ -1862,6 +2288,7 @@ std::vector<UniTensor> UniTensor::hosvd(std::vector<int>& group_labels, std::vec
 
 std::vector<UniTensor> UniTensor::hosvd(int* group_labels, int* groups, size_t groupsSize, std::vector<std::map<Qnum, Matrix> >& Ls, bool returnL)const{
   try{
+    materialize();
     if(typeID() == 1)
       return hosvd(RTYPE, group_labels, groups, groupsSize, Ls, returnL);
     else if(typeID() == 2)
@@ -1875,6 +2302,7 @@ std::vector<UniTensor> UniTensor::hosvd(int* group_labels, int* groups, size_t g
 
 std::vector<UniTensor> UniTensor::hosvd(std::vector<int>& group_labels, std::vector<int>& groups, std::vector<std::map<Qnum, Matrix> >& Ls, bool returnL)const{
   try{
+    materialize();
     if(typeID() == 1)
       return hosvd(RTYPE, group_labels, groups, Ls, returnL);
     else if(typeID() == 2)
@@ -1888,6 +2316,7 @@ std::vector<UniTensor> UniTensor::hosvd(std::vector<int>& group_labels, std::vec
 
 std::vector<UniTensor> UniTensor::hosvd(size_t modeNum, size_t fixedNum)const{
   try{
+    materialize();
     if(typeID() == 1)
       return hosvd(RTYPE, modeNum, fixedNum);
     else if(typeID() == 2)
@@ -1901,6 +2330,7 @@ std::vector<UniTensor> UniTensor::hosvd(size_t modeNum, size_t fixedNum)const{
 
 std::vector<UniTensor> UniTensor::hosvd(size_t modeNum, size_t fixedNum, std::vector<Matrix>& Ls)const{
   try{
+    materialize();
     if(typeID() == 1)
       return hosvd(RTYPE, modeNum, fixedNum, Ls);
     else if(typeID() == 2)
@@ -1915,6 +2345,7 @@ std::vector<UniTensor> UniTensor::hosvd(size_t modeNum, size_t fixedNum, std::ve
 
 std::vector<UniTensor> UniTensor::hosvd(size_t modeNum, size_t fixedNum, std::vector<std::map<Qnum, Matrix> >& Ls)const{
   try{
+    materialize();
     if(typeID() == 1)
       return hosvd(RTYPE, modeNum, fixedNum, Ls);
     else if(typeID() == 2)
@@ -1964,6 +2395,7 @@ std::vector<UniTensor> UniTensor::_hosvd(size_t modeNum, size_t fixedNum, std::v
         rsp_labels[l] = ori_labels[fixedNum + (((m) * combNum + l - fixedNum) % (bondNum - fixedNum))];
     }
     T.permute(rsp_labels, combNum);
+    T.materialize();
     std::vector<Bond> bonds(T.bonds.begin(), T.bonds.begin() + combNum);
     bonds.push_back(combine(bonds).dummy_change(BD_OUT));
     Us.push_back(UniTensor(bonds));
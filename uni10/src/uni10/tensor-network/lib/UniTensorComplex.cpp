@@ -79,8 +79,23 @@ UniTensor::UniTensor(cflag _tp, const std::vector<Bond>& _bonds, int* _labels, c
   }
 }
 
+UniTensor::UniTensor(const std::vector<Bond>& _bonds, Complex* _elem, const std::string& _name): name(_name), status(0), bonds(_bonds){
+  try{
+    if(_elem == NULL){
+      std::ostringstream err;
+      err<<"Cannot create a tensor on top of a null buffer.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    initUniT(CTYPE, _elem);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor UniTensor::UniTensor(std::vector<Bond>&, std::complex<double>*, std::string& = \"\"):");
+  }
+}
+
 void UniTensor::setRawElem(const std::vector<Complex>& rawElem){
   try{
+    detachElem();
     setRawElem(&rawElem[0]);
   }
   catch(const std::exception& e){
@@ -90,6 +105,7 @@ void UniTensor::setRawElem(const std::vector<Complex>& rawElem){
 
 void UniTensor::setRawElem(cflag tp, const Block& blk){
   try{
+    detachElem();
     throwTypeError(tp);
     setRawElem(blk.getElem(CTYPE));
   }
@@ -100,6 +116,7 @@ void UniTensor::setRawElem(cflag tp, const Block& blk){
 
 void UniTensor::setRawElem(const Complex* rawElem){
   try{
+    detachElem();
     if((status & HAVEBOND) == 0){
       std::ostringstream err;
       err<<"Setting elements to a tensor without bonds is not supported.";
@@ -178,6 +195,7 @@ void UniTensor::setRawElem(const Complex* rawElem){
 
 void UniTensor::setElem(const Complex* _elem, bool _ongpu){
   try{
+    detachElem();
     if(typeID() == 1)
       this->assign(CTYPE, this->bond());
     elemCopy(c_elem, _elem, m_elemNum * sizeof(Complex), ongpu, _ongpu);
@@ -190,6 +208,7 @@ void UniTensor::setElem(const Complex* _elem, bool _ongpu){
 
 void UniTensor::setElem(const std::vector<Complex>& _elem, bool _ongpu){
   try{
+    detachElem();
     setElem(&_elem[0], _ongpu);
   }
   catch(const std::exception& e){
@@ -199,6 +218,7 @@ void UniTensor::setElem(const std::vector<Complex>& _elem, bool _ongpu){
 
 void UniTensor::setElemC(Complex* in_array, int elem_num){
   try{
+    detachElem();
     this->setElem(in_array, false);
   }
   catch(const std::exception& e){
@@ -207,6 +227,7 @@ void UniTensor::setElemC(Complex* in_array, int elem_num){
 }
 
 void UniTensor::putBlock(cflag uni10_tp, const Block& mat, bool force){
+  detachElem();
 
   try{
 
@@ -225,6 +246,7 @@ void UniTensor::putBlock(cflag uni10_tp, const Block& mat, bool force){
 }
 
 void UniTensor::putBlock(cflag uni10_tp, const Qnum& qnum, const Block& mat, bool force){
+  detachElem();
 
   try{
 
@@ -281,6 +303,7 @@ void UniTensor::putBlock(cflag uni10_tp, const Qnum& qnum, const Block& mat, boo
 
 Matrix UniTensor::getRawElem(cflag tp)const{
   try{
+    materialize();
     throwTypeError(tp);
     if(status & HAVEBOND && status & HAVEELEM){
       int bondNum = bonds.size();
@@ -322,6 +345,7 @@ Matrix UniTensor::getRawElem(cflag tp)const{
 
 Complex* UniTensor::getElem(cflag tp){
   try{
+    pinElem();
     throwTypeError(tp);
     if(typeID() == 1){
       std::ostringstream err;
@@ -336,6 +360,7 @@ Complex* UniTensor::getElem(cflag tp){
 }
 
 void UniTensor::exportElem(cflag tp, Complex *out_array, int elem_num){
+  materialize();
   /// PYTHON ONLY!!!
   try{
     throwTypeError(tp);
@@ -358,6 +383,7 @@ void UniTensor::exportElem(cflag tp, Complex *out_array, int elem_num){
 }
 
 void UniTensor::exportElemC(Complex *out_array, int elem_num){
+  materialize();
   /// PYTHON ONLY!!!
   if (elem_num < 0)
     elem_num = m_elemNum;
@@ -365,6 +391,7 @@ void UniTensor::exportElemC(Complex *out_array, int elem_num){
 }
 
 std::map<Qnum, Matrix> UniTensor::getBlocks(cflag tp)const{
+  materialize();
   std::map<Qnum, Matrix> mats;
   try{
     throwTypeError(tp);
@@ -381,6 +408,7 @@ std::map<Qnum, Matrix> UniTensor::getBlocks(cflag tp)const{
 
 Matrix UniTensor::getBlock(cflag tp, bool diag)const{
   try{
+    materialize();
     throwTypeError(tp);
     Qnum q0(0);
     return getBlock(CTYPE, q0, diag);
@@ -393,6 +421,7 @@ Matrix UniTensor::getBlock(cflag tp, bool diag)const{
 
 Matrix UniTensor::getBlock(cflag tp, const Qnum& qnum, bool diag)const{
   try{
+    materialize();
     throwTypeError(tp);
     std::map<Qnum, Block>::const_iterator it = blocks.find(qnum);
     if(it == blocks.end()){
@@ -415,6 +444,7 @@ Matrix UniTensor::getBlock(cflag tp, const Qnum& qnum, bool diag)const{
 
 void UniTensor::set_zero(cflag tp){
   try{
+    detachElem();
     throwTypeError(tp);
     elemBzero(c_elem, m_elemNum * sizeof(Complex), ongpu);
     status |= HAVEELEM;
@@ -426,6 +456,7 @@ void UniTensor::set_zero(cflag tp){
 
 void UniTensor::set_zero(cflag tp, const Qnum& qnum){
   try{
+    detachElem();
     throwTypeError(tp);
     std::map<Qnum, Block>::iterator it = blocks.find(qnum);
     if(it == blocks.end()){
@@ -444,6 +475,7 @@ void UniTensor::set_zero(cflag tp, const Qnum& qnum){
 
 void UniTensor::identity(cflag tp){
   try{
+    detachElem();
     throwTypeError(tp);
     std::map<Qnum, Block>::iterator it;
     for ( it = blocks.begin() ; it != blocks.end(); it++ )
@@ -457,6 +489,7 @@ void UniTensor::identity(cflag tp){
 
 void UniTensor::identity(cflag tp, const Qnum& qnum){
   try{
+    detachElem();
     throwTypeError(tp);
     std::map<Qnum, Block>::iterator it = blocks.find(qnum);
     if(it == blocks.end()){
@@ -475,6 +508,7 @@ void UniTensor::identity(cflag tp, const Qnum& qnum){
 
 void UniTensor::randomize(cflag tp){
   try{
+    detachElem();
     throwTypeError(tp);
     elemRand(c_elem, m_elemNum, ongpu);
     status |= HAVEELEM;
@@ -486,6 +520,7 @@ void UniTensor::randomize(cflag tp){
 
 void UniTensor::orthoRand(cflag tp){
   try{
+    detachElem();
     throwTypeError(tp);
     std::map<Qnum, Block>::iterator it;
     for ( it = blocks.begin() ; it != blocks.end(); it++ )
@@ -499,6 +534,7 @@ void UniTensor::orthoRand(cflag tp){
 
 void UniTensor::orthoRand(cflag tp, const Qnum& qnum){
   try{
+    detachElem();
     throwTypeError(tp);
     std::map<Qnum, Block>::iterator it = blocks.find(qnum);
     if(it == blocks.end()){
@@ -517,6 +553,7 @@ void UniTensor::orthoRand(cflag tp, const Qnum& qnum){
 
 UniTensor& UniTensor::transpose(cflag tp){
   try{
+    materialize();
     throwTypeError(tp);
     if(!(status & HAVEBOND)){
       std::ostringstream err;
@@ -577,6 +614,7 @@ UniTensor& UniTensor::transpose(cflag tp){
 
 UniTensor& UniTensor::cTranspose(cflag tp){
   try{
+    materialize();
     throwTypeError(tp);
     if(!(status & HAVEBOND)){
       std::ostringstream err;
@@ -663,6 +701,7 @@ UniTensor& UniTensor::permute(cflag tp, int* newLabels, int rowBondNum){
 UniTensor& UniTensor::permute(cflag tp, const std::vector<int>& newLabels, int rowBondNum){
   try{
     throwTypeError(tp);
+    UNI10_PROFILE_SCOPE(prof, PROF_PERMUTE, m_elemNum * sizeof(Complex));
     if((status & HAVEBOND) == 0){
       std::ostringstream err;
       err<<"There is no bond in the tensor(scalar) to permute.";
@@ -697,167 +736,24 @@ UniTensor& UniTensor::permute(cflag tp, const std::vector<int>& newLabels, int r
       return *this;
     else{
       std::vector<Bond> outBonds;
-      bool withoutSymmetry = true;
-      for(size_t b = 0; b < bonds.size(); b++){
+      for(size_t b = 0; b < bonds.size(); b++)
         outBonds.push_back(bonds[rsp_outin[b]]);
-        if(bonds[b].Qnums.size() != 1)
-          withoutSymmetry = false;
-      }
       for(size_t b = 0; b < bonds.size(); b++){
         if(b < rowBondNum)
           outBonds[b].change(BD_IN);
         else
           outBonds[b].change(BD_OUT);
       }
+      if((status & HAVEELEM) && !ongpu){
+        permuteLazily(rsp_outin, outBonds, newLabels);
+        return *this;
+      }
       UniTensor UniTout(CTYPE, outBonds, name);
       if(status & HAVEELEM){
-        if(withoutSymmetry){
-          if(!inorder){
-            if(ongpu && UniTout.ongpu){
-              size_t* perInfo = (size_t*)malloc(bondNum * 2 * sizeof(size_t));
-              std::vector<size_t> newAcc(bondNum);
-              newAcc[bondNum - 1] = 1;
-              perInfo[bondNum - 1] = 1;
-              for(int b = bondNum - 1; b > 0; b--){
-                newAcc[b - 1] = newAcc[b] * UniTout.bonds[b].Qdegs[0];
-                perInfo[b - 1] = perInfo[b] * bonds[b].Qdegs[0];
-              }
-              for(int b = 0; b < bondNum; b++)
-                perInfo[bondNum + rsp_outin[b]] = newAcc[b];
-              Complex* des_elem = UniTout.c_elem;
-              Complex* src_elem = c_elem;
-              reshapeElem(src_elem, bondNum, m_elemNum, perInfo, des_elem);
-              free(perInfo);
-            }
-            else{
-              Complex* des_elem = UniTout.c_elem;
-              Complex* src_elem = c_elem;
-              size_t memsize = m_elemNum * sizeof(Complex);
-              if(ongpu){
-                src_elem = (Complex*)elemAllocForce(memsize, false);
-                elemCopy(src_elem, c_elem, memsize, false, ongpu);
-              }
-              if(UniTout.ongpu)
-                des_elem = (Complex*)elemAllocForce(memsize, false);
-
-              std::vector<size_t> transAcc(bondNum);
-              std::vector<size_t> newAcc(bondNum);
-              transAcc[bondNum - 1] = 1;
-              newAcc[bondNum - 1] = 1;
-              for(int b = bondNum - 1; b > 0; b--)
-                newAcc[b - 1] = newAcc[b] * UniTout.bonds[b].Qdegs[0];
-              std::vector<int> bondDims(bondNum);
-              std::vector<int> idxs(bondNum);
-              for(int b = 0; b < bondNum; b++){
-                transAcc[rsp_outin[b]] = newAcc[b];
-                bondDims[b] = bonds[b].Qdegs[0];
-                idxs[b] = 0;
-              }
-              size_t cnt_ot = 0;
-              for(size_t i = 0; i < m_elemNum; i++){
-                des_elem[cnt_ot] = src_elem[i];
-                for(int bend = bondNum - 1; bend >= 0; bend--){
-                  idxs[bend]++;
-                  if(idxs[bend] < bondDims[bend]){
-                    cnt_ot += transAcc[bend];
-                    break;
-                  }
-                  else{
-                    cnt_ot -= transAcc[bend] * (idxs[bend] - 1);
-                    idxs[bend] = 0;
-                  }
-                }
-              }
-              if(ongpu)
-                elemFree(src_elem, memsize, false);
-              if(UniTout.ongpu){
-                elemCopy(UniTout.c_elem, des_elem, memsize, UniTout.ongpu, false);
-                elemFree(des_elem, memsize, false);
-              }
-            }
-          }
-          else{  //non-symmetry inorder
-            size_t memsize = m_elemNum * sizeof(Complex);
-            elemCopy(UniTout.c_elem, c_elem, memsize, UniTout.ongpu, ongpu);
-          }
-        }
-        else{
-          Real sign = 1.0;
-          //For Fermionic system
-          //End Fermionic system
-          std::vector<int> Qin_idxs(bondNum, 0);
-          std::vector<int> Qot_idxs(bondNum, 0);
-          int Qin_off, Qot_off;
-          int tmp;
-          int Qin_RQoff, Qin_CQoff;
-          int Qot_CQoff, Qot_RQoff;
-          size_t sBin_r, sBin_c;	//sub-block of a Qidx
-          size_t sBin_rDim, sBin_cDim;	//sub-block of a Qidx
-          size_t sBot_cDim;	//sub-block of a Qidx
-          size_t sBot_r, sBot_c;
-          size_t Bin_cDim, Bot_cDim;
-          Complex* Ein_ptr;
-          Complex* Eot_ptr;
-          std::vector<int> sBin_idxs(bondNum, 0);
-          std::vector<int> sBin_sBdims(bondNum, 0);
-          std::vector<int> Qot_acc(bondNum, 1);
-          std::vector<int> sBot_acc(bondNum, 1);
-          for(int b = bondNum	- 1; b > 0; b--)
-            Qot_acc[b - 1] = Qot_acc[b] * UniTout.bonds[b].Qnums.size();
-
-          for(std::map<int, size_t>::iterator it = QidxEnc.begin(); it != QidxEnc.end(); it++){
-            Qin_off = it->first;
-            tmp = Qin_off;
-            int qdim;
-            for(int b = bondNum - 1; b >= 0; b--){
-              qdim = bonds[b].Qnums.size();
-              Qin_idxs[b] = tmp % qdim;
-              sBin_sBdims[b] = bonds[b].Qdegs[Qin_idxs[b]];
-              tmp /= qdim;
-            }
-            Qot_off = 0;
-            for(int b = 0; b < bondNum; b++){
-              Qot_idxs[b] = Qin_idxs[rsp_outin[b]];
-              Qot_off += Qot_idxs[b] * Qot_acc[b];
-            }
-            for(int b = bondNum - 1; b > 0; b--)
-              sBot_acc[rsp_outin[b-1]] = sBot_acc[rsp_outin[b]] * bonds[rsp_outin[b]].Qdegs[Qot_idxs[b]];
-            Qin_RQoff = Qin_off / CQdim;
-            Qin_CQoff = Qin_off % CQdim;
-            Qot_RQoff = Qot_off / UniTout.CQdim;
-            Qot_CQoff = Qot_off % UniTout.CQdim;
-            Bin_cDim = RQidx2Blk[Qin_RQoff]->Cnum;
-            Bot_cDim = UniTout.RQidx2Blk[Qot_RQoff]->Cnum;
-            Ein_ptr = RQidx2Blk[Qin_RQoff]->cm_elem + (RQidx2Off[Qin_RQoff] * Bin_cDim) + CQidx2Off[Qin_CQoff];
-            Eot_ptr = UniTout.RQidx2Blk[Qot_RQoff]->cm_elem + (UniTout.RQidx2Off[Qot_RQoff] * Bot_cDim) + UniTout.CQidx2Off[Qot_CQoff];
-            sBin_rDim = RQidx2Dim[Qin_RQoff];
-            sBin_cDim = CQidx2Dim[Qin_CQoff];
-            sBot_cDim = UniTout.CQidx2Dim[Qot_CQoff];
-            int cnt_ot = 0;
-            sBin_idxs.assign(bondNum, 0);
-            //if(Qnum::isFermionic()){}
-            for(sBin_r = 0; sBin_r < sBin_rDim; sBin_r++)
-              for(sBin_c = 0; sBin_c < sBin_cDim; sBin_c++){
-                sBot_r = cnt_ot / sBot_cDim;
-                sBot_c = cnt_ot % sBot_cDim;
-                Eot_ptr[(sBot_r * Bot_cDim) + sBot_c] = sign * Ein_ptr[(sBin_r * Bin_cDim) + sBin_c];
-                for(int bend = bondNum - 1; bend >= 0; bend--){
-                  sBin_idxs[bend]++;
-                  if(sBin_idxs[bend] < sBin_sBdims[bend]){
-                    cnt_ot += sBot_acc[bend];
-                    break;
-                  }
-                  else{
-                    cnt_ot -= sBot_acc[bend] * (sBin_idxs[bend] - 1);
-                    sBin_idxs[bend] = 0;
-                  }
-                }
-              }
-          }
-        }
+        UniTout.permuteElemFrom(CTYPE, *this, rsp_outin);
         UniTout.status |= HAVEELEM;
       }
-      *this = UniTout;
+      swapContent(UniTout);
       this->setLabel(newLabels);
     }
   }
@@ -867,8 +763,141 @@ UniTensor& UniTensor::permute(cflag tp, const std::vector<int>& newLabels, int r
   return *this;
 }
 
+void UniTensor::permuteElemFrom(cflag tp, const UniTensor& src, const std::vector<int>& rsp_outin){
+  int bondNum = src.bonds.size();
+  bool inorder = true;
+  bool withoutSymmetry = true;
+  for(int b = 0; b < bondNum; b++){
+    if(rsp_outin[b] != b)
+      inorder = false;
+    if(src.bonds[b].Qnums.size() != 1)
+      withoutSymmetry = false;
+  }
+  if(withoutSymmetry){
+    if(!inorder){
+      if(src.ongpu && ongpu){
+        size_t* perInfo = (size_t*)malloc(bondNum * 2 * sizeof(size_t));
+        std::vector<size_t> newAcc(bondNum);
+        newAcc[bondNum - 1] = 1;
+        perInfo[bondNum - 1] = 1;
+        for(int b = bondNum - 1; b > 0; b--){
+          newAcc[b - 1] = newAcc[b] * bonds[b].Qdegs[0];
+          perInfo[b - 1] = perInfo[b] * src.bonds[b].Qdegs[0];
+        }
+        for(int b = 0; b < bondNum; b++)
+          perInfo[bondNum + rsp_outin[b]] = newAcc[b];
+        Complex* des_elem = c_elem;
+        Complex* src_elem = src.c_elem;
+        reshapeElem(src_elem, bondNum, src.m_elemNum, perInfo, des_elem);
+        free(perInfo);
+      }
+      else{
+        Complex* des_elem = c_elem;
+        Complex* src_elem = src.c_elem;
+        size_t memsize = src.m_elemNum * sizeof(Complex);
+        if(src.ongpu){
+          src_elem = (Complex*)elemAllocForce(memsize, false);
+          elemCopy(src_elem, src.c_elem, memsize, false, src.ongpu);
+        }
+        if(ongpu)
+          des_elem = (Complex*)elemAllocForce(memsize, false);
+
+        std::vector<int> bondDims(bondNum);
+        for(int b = 0; b < bondNum; b++)
+          bondDims[b] = src.bonds[b].Qdegs[0];
+        permuteElem(src_elem, bondNum, &bondDims[0], &rsp_outin[0], des_elem);
+        if(src.ongpu)
+          elemFree(src_elem, memsize, false);
+        if(ongpu){
+          elemCopy(c_elem, des_elem, memsize, ongpu, false);
+          elemFree(des_elem, memsize, false);
+        }
+      }
+    }
+    else{  //non-symmetry inorder
+      size_t memsize = src.m_elemNum * sizeof(Complex);
+      elemCopy(c_elem, src.c_elem, memsize, ongpu, src.ongpu);
+    }
+  }
+  else{
+    Real sign = 1.0;
+    //For Fermionic system
+    //End Fermionic system
+    std::vector<int> Qin_idxs(bondNum, 0);
+    std::vector<int> Qot_idxs(bondNum, 0);
+    int Qin_off, Qot_off;
+    int tmp;
+    int Qin_RQoff, Qin_CQoff;
+    int Qot_CQoff, Qot_RQoff;
+    size_t sBin_r, sBin_c;	//sub-block of a Qidx
+    size_t sBin_rDim, sBin_cDim;	//sub-block of a Qidx
+    size_t sBot_cDim;	//sub-block of a Qidx
+    size_t sBot_r, sBot_c;
+    size_t Bin_cDim, Bot_cDim;
+    Complex* Ein_ptr;
+    Complex* Eot_ptr;
+    std::vector<int> sBin_idxs(bondNum, 0);
+    std::vector<int> sBin_sBdims(bondNum, 0);
+    std::vector<int> Qot_acc(bondNum, 1);
+    std::vector<int> sBot_acc(bondNum, 1);
+    for(int b = bondNum	- 1; b > 0; b--)
+      Qot_acc[b - 1] = Qot_acc[b] * bonds[b].Qnums.size();
+
+    for(std::map<int, size_t>::const_iterator it = src.QidxEnc.begin(); it != src.QidxEnc.end(); it++){
+      Qin_off = it->first;
+      tmp = Qin_off;
+      int qdim;
+      for(int b = bondNum - 1; b >= 0; b--){
+        qdim = src.bonds[b].Qnums.size();
+        Qin_idxs[b] = tmp % qdim;
+        sBin_sBdims[b] = src.bonds[b].Qdegs[Qin_idxs[b]];
+        tmp /= qdim;
+      }
+      Qot_off = 0;
+      for(int b = 0; b < bondNum; b++){
+        Qot_idxs[b] = Qin_idxs[rsp_outin[b]];
+        Qot_off += Qot_idxs[b] * Qot_acc[b];
+      }
+      for(int b = bondNum - 1; b > 0; b--)
+        sBot_acc[rsp_outin[b-1]] = sBot_acc[rsp_outin[b]] * src.bonds[rsp_outin[b]].Qdegs[Qot_idxs[b]];
+      Qin_RQoff = Qin_off / src.CQdim;
+      Qin_CQoff = Qin_off % src.CQdim;
+      Qot_RQoff = Qot_off / CQdim;
+      Qot_CQoff = Qot_off % CQdim;
+      Bin_cDim = src.RQidx2Blk.find(Qin_RQoff)->second->Cnum;
+      Bot_cDim = RQidx2Blk[Qot_RQoff]->Cnum;
+      Ein_ptr = src.RQidx2Blk.find(Qin_RQoff)->second->cm_elem + (src.RQidx2Off.find(Qin_RQoff)->second * Bin_cDim) + src.CQidx2Off.find(Qin_CQoff)->second;
+      Eot_ptr = RQidx2Blk[Qot_RQoff]->cm_elem + (RQidx2Off[Qot_RQoff] * Bot_cDim) + CQidx2Off[Qot_CQoff];
+      sBin_rDim = src.RQidx2Dim.find(Qin_RQoff)->second;
+      sBin_cDim = src.CQidx2Dim.find(Qin_CQoff)->second;
+      sBot_cDim = CQidx2Dim[Qot_CQoff];
+      int cnt_ot = 0;
+      sBin_idxs.assign(bondNum, 0);
+      //if(Qnum::isFermionic()){}
+      for(sBin_r = 0; sBin_r < sBin_rDim; sBin_r++)
+        for(sBin_c = 0; sBin_c < sBin_cDim; sBin_c++){
+          sBot_r = cnt_ot / sBot_cDim;
+          sBot_c = cnt_ot % sBot_cDim;
+          Eot_ptr[(sBot_r * Bot_cDim) + sBot_c] = sign * Ein_ptr[(sBin_r * Bin_cDim) + sBin_c];
+          for(int bend = bondNum - 1; bend >= 0; bend--){
+            sBin_idxs[bend]++;
+            if(sBin_idxs[bend] < sBin_sBdims[bend]){
+              cnt_ot += sBot_acc[bend];
+              break;
+            }
+            else{
+              cnt_ot -= sBot_acc[bend] * (sBin_idxs[bend] - 1);
+              sBin_idxs[bend] = 0;
+            }
+          }
+        }
+    }
+  }
+}
+
 UniTensor& UniTensor::permuteFm(cflag tp, int rowBondNum){
   try{
+    materialize();
     throwTypeError(tp);
     std::vector<int> ori_labels = labels;
     this->permuteFm(CTYPE, ori_labels, rowBondNum);
@@ -881,6 +910,7 @@ UniTensor& UniTensor::permuteFm(cflag tp, int rowBondNum){
 
 UniTensor& UniTensor::permuteFm(cflag tp, int* newLabels, int rowBondNum){
   try{
+    materialize();
     throwTypeError(tp);
     std::vector<int> _labels(newLabels, newLabels + bonds.size());
     this->permuteFm(CTYPE, _labels, rowBondNum);
@@ -893,6 +923,7 @@ UniTensor& UniTensor::permuteFm(cflag tp, int* newLabels, int rowBondNum){
 
 UniTensor& UniTensor::permuteFm(cflag tp, const std::vector<int>& newLabels, int rowBondNum){
   try{
+    materialize();
     throwTypeError(tp);
     if((status & HAVEBOND) == 0){
       std::ostringstream err;
@@ -971,34 +1002,10 @@ UniTensor& UniTensor::permuteFm(cflag tp, const std::vector<int>& newLabels, int
               if(UniTout.ongpu)
                 des_elem = (Complex*)elemAllocForce(memsize, false);
 
-              std::vector<size_t> transAcc(bondNum);
-              std::vector<size_t> newAcc(bondNum);
-              transAcc[bondNum - 1] = 1;
-              newAcc[bondNum - 1] = 1;
-              for(int b = bondNum - 1; b > 0; b--)
-                newAcc[b - 1] = newAcc[b] * UniTout.bonds[b].Qdegs[0];
               std::vector<int> bondDims(bondNum);
-              std::vector<int> idxs(bondNum);
-              for(int b = 0; b < bondNum; b++){
-                transAcc[rsp_outin[b]] = newAcc[b];
+              for(int b = 0; b < bondNum; b++)
                 bondDims[b] = bonds[b].Qdegs[0];
-                idxs[b] = 0;
-              }
-              size_t cnt_ot = 0;
-              for(size_t i = 0; i < m_elemNum; i++){
-                des_elem[cnt_ot] = src_elem[i];
-                for(int bend = bondNum - 1; bend >= 0; bend--){
-                  idxs[bend]++;
-                  if(idxs[bend] < bondDims[bend]){
-                    cnt_ot += transAcc[bend];
-                    break;
-                  }
-                  else{
-                    cnt_ot -= transAcc[bend] * (idxs[bend] - 1);
-                    idxs[bend] = 0;
-                  }
-                }
-              }
+              permuteElem(src_elem, bondNum, &bondDims[0], &rsp_outin[0], des_elem);
               if(ongpu)
                 elemFree(src_elem, memsize, false);
               if(UniTout.ongpu){
@@ -1131,6 +1138,7 @@ UniTensor& UniTensor::permuteFm(cflag tp, const std::vector<int>& newLabels, int
 
 Complex UniTensor::at(cflag tp, size_t idx)const{
   try{
+    materialize();
     throwTypeError(tp);
     if(!(idx < m_elemNum)){
       std::ostringstream err;
@@ -1151,6 +1159,7 @@ Complex UniTensor::at(cflag tp, size_t idx)const{
 
 UniTensor& UniTensor::combineBond(cflag tp, const std::vector<int>&cmbLabels){
   try{
+    materialize();
     throwTypeError(tp);
     if((status & HAVEBOND) == 0){
       std::ostringstream err;
@@ -1230,6 +1239,7 @@ UniTensor& UniTensor::combineBond(cflag tp, const std::vector<int>&cmbLabels){
 
 void UniTensor::addGate(cflag tp, const std::vector<_Swap>& swaps){
   try{
+    detachElem();
     throwTypeError(tp);
     if((status & HAVEBOND) == 0){
       std::ostringstream err;
@@ -1285,6 +1295,7 @@ void UniTensor::addGate(cflag tp, const std::vector<_Swap>& swaps){
 
 Complex UniTensor::trace(cflag tp)const{
   try{
+    materialize();
     throwTypeError(tp);
     if(!(status & HAVEELEM)){
       std::ostringstream err;
@@ -1315,6 +1326,7 @@ Complex UniTensor::trace(cflag tp)const{
 
 UniTensor& UniTensor::partialTrace(cflag tp, int la, int lb){
   try{
+    materialize();
     throwTypeError(tp);
     if(!(status & HAVEELEM)){
       std::ostringstream err;
@@ -1356,6 +1368,7 @@ UniTensor& UniTensor::partialTrace(cflag tp, int la, int lb){
     ia = bondNum - 2;
     ib = bondNum - 1;
     this->permute(CTYPE, rsp_labels, Tt.RBondNum);
+    materialize();
     std::vector<int> Q_acc(bondNum, 1);
     for(int b = bondNum - 1; b > 0; b--)
       Q_acc[b - 1] = Q_acc[b] * bonds[b].Qnums.size();
@@ -1434,6 +1447,7 @@ UniTensor& UniTensor::partialTrace(cflag tp, int la, int lb){
 
 UniTensor& UniTensor::assign(cflag tp, const std::vector<Bond>& _bond){
   try{
+    materialize();
     throwTypeError(tp);
     UniTensor T(CTYPE, _bond);
     *this = T;
@@ -1446,6 +1460,7 @@ UniTensor& UniTensor::assign(cflag tp, const std::vector<Bond>& _bond){
 
 Complex UniTensor::at(cflag tp, const std::vector<int>& idxs)const{
   try{
+    materialize();
     throwTypeError(tp);
     if(typeID() == 1){
       std::ostringstream err;
@@ -1465,6 +1480,7 @@ Complex UniTensor::at(cflag tp, const std::vector<int>& idxs)const{
 
 Complex UniTensor::at(cflag tp, const std::vector<size_t>& idxs)const{
   try{
+    materialize();
     throwTypeError(tp);
     if((status & HAVEBOND) == 0){
       std::ostringstream err;
@@ -1533,7 +1549,7 @@ Complex UniTensor::at(cflag tp, const std::vector<size_t>& idxs)const{
 
 /*********************  Private **********************/
 
-void UniTensor::initUniT(cflag tp){ //GPU
+void UniTensor::initUniT(cflag tp, Complex* _elem){ //GPU
   r_flag= RNULL;
   c_flag= CTYPE;
   if(bonds.size()){
@@ -1562,13 +1578,16 @@ void UniTensor::initUniT(cflag tp){ //GPU
   elem = NULL;
   c_elem = NULL;
 
-  ELEMNUM += m_elemNum;
-  COUNTER++;
-  if(ELEMNUM > MAXELEMNUM)
-    MAXELEMNUM = ELEMNUM;
-  if(m_elemNum > MAXELEMTEN)
-    MAXELEMTEN = m_elemNum;
+  updateCounter(1, m_elemNum, m_elemNum);
 
+  if(_elem){
+    c_elem = _elem;
+    ongpu = false;  // a buffer of the caller is in host memory
+    storage.reset(new ElemStorage(_elem, sizeof(Complex) * m_elemNum, ongpu, false));
+    initBlocks(CTYPE);
+    status |= HAVEELEM;
+    return;
+  }
   TelemAlloc(CTYPE);
   initBlocks(CTYPE);
   TelemBzero(CTYPE);
@@ -1740,7 +1759,9 @@ void UniTensor::initBlocks(cflag tp){
 }
 
 void UniTensor::TelemAlloc(cflag tp){
+  UNI10_MEMORY_SCOPE(mem, name.size() ? "tensor " + name : std::string());
   c_elem = (Complex*)elemAlloc(sizeof(Complex) * m_elemNum, ongpu);
+  storage.reset(new ElemStorage(c_elem, sizeof(Complex) * m_elemNum, ongpu));
 }
 
 void UniTensor::TelemBzero(cflag tp){
@@ -1751,6 +1772,7 @@ void UniTensor::TelemBzero(cflag tp){
 
 Real UniTensor::norm(cflag tp) const{
   try{
+    materialize();
     throwTypeError(tp);
     return vectorNorm(c_elem, elemNum(), 1, ongpu);
   }
@@ -1762,6 +1784,7 @@ Real UniTensor::norm(cflag tp) const{
 
 UniTensor& UniTensor::normalize(cflag tp){
   try{
+    detachElem();
     throwTypeError(tp);
     Real norm = vectorNorm(c_elem, elemNum(), 1, ongpu);
     vectorScal((1./norm), c_elem, elemNum(), ongpu);
@@ -1775,6 +1798,7 @@ UniTensor& UniTensor::normalize(cflag tp){
 
 std::vector<UniTensor> UniTensor::hosvd(cflag tp, int* _group_labels, int* _groups, size_t _groupsSize, std::vector<Matrix>& Ls)const{
   try{
+    materialize();
     std::vector<int> group_labels(_group_labels, _group_labels+this->bondNum());
     std::vector<int> groups(_groups, _groups+_groupsSize);
     return hosvd(tp, group_labels, groups, Ls);
@@ -1787,6 +1811,7 @@ std::vector<UniTensor> UniTensor::hosvd(cflag tp, int* _group_labels, int* _grou
 
 std::vector<UniTensor> UniTensor::hosvd(cflag tp, std::vector<int>& group_labels, std::vector<int>& groups, std::vector<Matrix>& Ls)const{
   try{
+    materialize();
     bool withoutSymmetry = true;
     for(size_t b = 0; b < bonds.size(); b++){
       if(bonds[b].Qnums.size() != 1)
@@ -1814,6 +1839,7 @@ std::vector<UniTensor> UniTensor::hosvd(cflag tp, std::vector<int>& group_labels
 
 std::vector<UniTensor> UniTensor::hosvd(cflag tp, int* _group_labels, int* _groups, size_t _groupsSize, std::vector<std::map<Qnum, Matrix> >& Ls, bool returnL)const{
   try{
+    materialize();
     std::vector<int> group_labels(_group_labels, _group_labels+this->bondNum());
     std::vector<int> groups(_groups, _groups+_groupsSize);
     return hosvd(tp, group_labels, groups, Ls, returnL);
@@ -1825,6 +1851,7 @@ std::vector<UniTensor> UniTensor::hosvd(cflag tp, int* _group_labels, int* _grou
 }
 
 std::vector<UniTensor> UniTensor::hosvd(cflag tp, std::vector<int>& group_labels, std::vector<int>& groups, std::vector<std::map<Qnum, Matrix> >& Ls, bool returnL)const{
+  materialize();
   throwTypeError(tp);
   try{
     if((status & HAVEBOND) == 0){
@@ -1868,6 +1895,7 @@ std::vector<UniTensor> UniTensor::hosvd(cflag tp, std::vector<int>& group_labels
         pos++;
       }
       T.permute(CTYPE, lrsp_labels, groups[m]);
+      T.materialize();
       std::vector<Bond> bonds(T.bonds.begin(), T.bonds.begin() + groups[m]);
       bonds.push_back(combine(bonds).dummy_change(BD_OUT));
       Us.push_back(UniTensor(CTYPE, bonds));
@@ -1895,6 +1923,7 @@ std::vector<UniTensor> UniTensor::hosvd(cflag tp, std::vector<int>& group_labels
 
 std::vector<UniTensor> UniTensor::hosvd(cflag tp, size_t modeNum, size_t fixedNum)const{
   try{
+    materialize();
     std::vector<std::map<Qnum, Matrix> > symLs;
     std::vector<int> group_labels=this->labels;
     std::vector<int> groups(modeNum, (this->bondNum()-fixedNum)/modeNum);
@@ -1908,6 +1937,7 @@ std::vector<UniTensor> UniTensor::hosvd(cflag tp, size_t modeNum, size_t fixedNu
 
 std::vector<UniTensor> UniTensor::hosvd(cflag tp, size_t modeNum, size_t fixedNum, std::vector<std::map<Qnum, Matrix> >& Ls)const{
   try{
+    materialize();
     std::vector<std::map<Qnum, Matrix> > symLs;
     std::vector<int> group_labels=this->labels;
     std::vector<int> groups(modeNum, (this->bondNum()-fixedNum)/modeNum );
@@ -1921,6 +1951,7 @@ std::vector<UniTensor> UniTensor::hosvd(cflag tp, size_t modeNum, size_t fixedNu
 
 std::vector<UniTensor> UniTensor::hosvd(cflag tp, size_t modeNum, size_t fixedNum, std::vector<Matrix>& Ls)const{
   try{
+    materialize();
     bool withoutSymmetry = true;
     for(size_t b = 0; b < bonds.size(); b++){
       if(bonds[b].Qnums.size() != 1)
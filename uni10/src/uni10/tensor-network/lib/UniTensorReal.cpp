@@ -79,8 +79,23 @@ UniTensor::UniTensor(rflag _tp, const std::vector<Bond>& _bonds, int* _labels, c
   }
 }
 
+UniTensor::UniTensor(const std::vector<Bond>& _bonds, Real* _elem, const std::string& _name): name(_name), status(0), bonds(_bonds){
+  try{
+    if(_elem == NULL){
+      std::ostringstream err;
+      err<<"Cannot create a tensor on top of a null buffer.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    initUniT(RTYPE, _elem);
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In constructor UniTensor::UniTensor(std::vector<Bond>&, double*, std::string& = \"\"):");
+  }
+}
+
 void UniTensor::setRawElem(const std::vector<Real>& rawElem){
   try{
+    detachElem();
     setRawElem(&rawElem[0]);
   }
   catch(const std::exception& e){
@@ -90,6 +105,7 @@ void UniTensor::setRawElem(const std::vector<Real>& rawElem){
 
 void UniTensor::setRawElem(rflag tp, const Block& blk){
   try{
+    detachElem();
     throwTypeError(tp);
     setRawElem(blk.getElem(RTYPE));
   }
@@ -100,6 +116,7 @@ void UniTensor::setRawElem(rflag tp, const Block& blk){
 
 void UniTensor::setRawElem(const Real* rawElem){
   try{
+    detachElem();
     if((status & HAVEBOND) == 0){
       std::ostringstream err;
       err<<"Setting elements to a tensor without bonds is not supported.";
@@ -180,6 +197,7 @@ void UniTensor::setRawElem(const Real* rawElem){
 
 void UniTensor::setElem(const Real* _elem, bool _ongpu){
   try{
+    detachElem();
     if(typeID() == 2)
       this->assign(RTYPE, this->bond());
     elemCopy(elem, _elem, m_elemNum * sizeof(Real), ongpu, _ongpu);
@@ -192,6 +210,7 @@ void UniTensor::setElem(const Real* _elem, bool _ongpu){
 
 void UniTensor::setElem(const std::vector<Real>& _elem, bool _ongpu){
   try{
+    detachElem();
     setElem(&_elem[0], _ongpu);
   }
   catch(const std::exception& e){
@@ -200,6 +219,7 @@ void UniTensor::setElem(const std::vector<Real>& _elem, bool _ongpu){
 }
 
 void UniTensor::setElemR(double *in_array, int elem_num){
+  detachElem();
   /// PYTHON ONLY!!!
   try{
     this->setElem(in_array, false);
@@ -210,6 +230,7 @@ void UniTensor::setElemR(double *in_array, int elem_num){
 }
 
 void UniTensor::putBlock(rflag tp, const Block& mat, bool force){
+  detachElem();
 
   try{
 
@@ -228,6 +249,7 @@ void UniTensor::putBlock(rflag tp, const Block& mat, bool force){
 }
 
 void UniTensor::putBlock(rflag tp, const Qnum& qnum, const Block& mat, bool force){
+  detachElem();
 
   try{
 
@@ -286,6 +308,7 @@ void UniTensor::putBlock(rflag tp, const Qnum& qnum, const Block& mat, bool forc
 
 Matrix UniTensor::getRawElem(rflag tp)const{
   try{
+    materialize();
     throwTypeError(tp);
     if(status & HAVEBOND && status & HAVEELEM){
       int bondNum = bonds.size();
@@ -327,6 +350,7 @@ Matrix UniTensor::getRawElem(rflag tp)const{
 
 Real* UniTensor::getElem(rflag tp){
   try{
+    pinElem();
     throwTypeError(tp);
     if(typeID() == 2){
       std::ostringstream err;
@@ -341,6 +365,7 @@ Real* UniTensor::getElem(rflag tp){
 }
 
 void UniTensor::exportElem(rflag tp, double *out_array, int elem_num){
+  materialize();
   /// PYTHON ONLY!!!
   try{
     throwTypeError(tp);
@@ -363,6 +388,7 @@ void UniTensor::exportElem(rflag tp, double *out_array, int elem_num){
 }
 
 void UniTensor::exportElemR(double *out_array, int elem_num){
+  materialize();
   /// PYTHON ONLY!!!
   if (elem_num < 0)
     elem_num = m_elemNum;
@@ -370,6 +396,7 @@ void UniTensor::exportElemR(double *out_array, int elem_num){
 }
 
 std::map<Qnum, Matrix> UniTensor::getBlocks(rflag tp)const{
+  materialize();
   std::map<Qnum, Matrix> mats;
   try{
     throwTypeError(tp);
@@ -386,6 +413,7 @@ std::map<Qnum, Matrix> UniTensor::getBlocks(rflag tp)const{
 
 Matrix UniTensor::getBlock(rflag tp, bool diag)const{
   try{
+    materialize();
     throwTypeError(tp);
     Qnum q0(0);
     return getBlock(RTYPE, q0, diag);
@@ -398,6 +426,7 @@ Matrix UniTensor::getBlock(rflag tp, bool diag)const{
 
 Matrix UniTensor::getBlock(rflag tp, const Qnum& qnum, bool diag)const{
   try{
+    materialize();
     throwTypeError(tp);
     std::map<Qnum, Block>::const_iterator it = blocks.find(qnum);
     if(it == blocks.end()){
@@ -420,6 +449,7 @@ Matrix UniTensor::getBlock(rflag tp, const Qnum& qnum, bool diag)const{
 
 void UniTensor::set_zero(rflag tp){
   try{
+    detachElem();
     throwTypeError(tp);
     elemBzero(elem, m_elemNum * sizeof(Real), ongpu);
     status |= HAVEELEM;
@@ -431,6 +461,7 @@ void UniTensor::set_zero(rflag tp){
 
 void UniTensor::set_zero(rflag tp, const Qnum& qnum){
   try{
+    detachElem();
     throwTypeError(tp);
     std::map<Qnum, Block>::iterator it = blocks.find(qnum);
     if(it == blocks.end()){
@@ -449,6 +480,7 @@ void UniTensor::set_zero(rflag tp, const Qnum& qnum){
 
 void UniTensor::identity(rflag tp){
   try{
+    detachElem();
     throwTypeError(tp);
     std::map<Qnum, Block>::iterator it;
     for ( it = blocks.begin() ; it != blocks.end(); it++ )
@@ -462,6 +494,7 @@ void UniTensor::identity(rflag tp){
 
 void UniTensor::identity(rflag tp, const Qnum& qnum){
   try{
+    detachElem();
     throwTypeError(tp);
     std::map<Qnum, Block>::iterator it = blocks.find(qnum);
     if(it == blocks.end()){
@@ -480,6 +513,7 @@ void UniTensor::identity(rflag tp, const Qnum& qnum){
 
 void UniTensor::randomize(rflag tp){
   try{
+    detachElem();
     throwTypeError(tp);
     elemRand(elem, m_elemNum, ongpu);
     status |= HAVEELEM;
@@ -491,6 +525,7 @@ void UniTensor::randomize(rflag tp){
 
 void UniTensor::orthoRand(rflag tp){
   try{
+    detachElem();
     throwTypeError(tp);
     std::map<Qnum, Block>::iterator it;
     for ( it = blocks.begin() ; it != blocks.end(); it++ )
@@ -504,6 +539,7 @@ void UniTensor::orthoRand(rflag tp){
 
 void UniTensor::orthoRand(rflag tp, const Qnum& qnum){
   try{
+    detachElem();
     throwTypeError(tp);
     std::map<Qnum, Block>::iterator it = blocks.find(qnum);
     if(it == blocks.end()){
@@ -522,6 +558,7 @@ void UniTensor::orthoRand(rflag tp, const Qnum& qnum){
 
 UniTensor& UniTensor::transpose(rflag tp){
   try{
+    materialize();
     throwTypeError(tp);
     if(!(status & HAVEBOND)){
       std::ostringstream err;
@@ -607,6 +644,7 @@ UniTensor& UniTensor::permute(rflag tp, int* newLabels, int rowBondNum){
 UniTensor& UniTensor::permute(rflag tp, const std::vector<int>& newLabels, int rowBondNum){
   try{
     throwTypeError(tp);
+    UNI10_PROFILE_SCOPE(prof, PROF_PERMUTE, m_elemNum * sizeof(Real));
     if((status & HAVEBOND) == 0){
       std::ostringstream err;
       err<<"There is no bond in the tensor(scalar) to permute.";
@@ -641,167 +679,24 @@ UniTensor& UniTensor::permute(rflag tp, const std::vector<int>& newLabels, int r
       return *this;
     else{
       std::vector<Bond> outBonds;
-      bool withoutSymmetry = true;
-      for(size_t b = 0; b < bonds.size(); b++){
+      for(size_t b = 0; b < bonds.size(); b++)
         outBonds.push_back(bonds[rsp_outin[b]]);
-        if(bonds[b].Qnums.size() != 1)
-          withoutSymmetry = false;
-      }
       for(size_t b = 0; b < bonds.size(); b++){
         if(b < rowBondNum)
           outBonds[b].change(BD_IN);
         else
           outBonds[b].change(BD_OUT);
       }
+      if((status & HAVEELEM) && !ongpu){
+        permuteLazily(rsp_outin, outBonds, newLabels);
+        return *this;
+      }
       UniTensor UniTout(RTYPE, outBonds, name);
       if(status & HAVEELEM){
-        if(withoutSymmetry){
-          if(!inorder){
-            if(ongpu && UniTout.ongpu){
-              size_t* perInfo = (size_t*)malloc(bondNum * 2 * sizeof(size_t));
-              std::vector<size_t> newAcc(bondNum);
-              newAcc[bondNum - 1] = 1;
-              perInfo[bondNum - 1] = 1;
-              for(int b = bondNum - 1; b > 0; b--){
-                newAcc[b - 1] = newAcc[b] * UniTout.bonds[b].Qdegs[0];
-                perInfo[b - 1] = perInfo[b] * bonds[b].Qdegs[0];
-              }
-              for(int b = 0; b < bondNum; b++)
-                perInfo[bondNum + rsp_outin[b]] = newAcc[b];
-              Real* des_elem = UniTout.elem;
-              Real* src_elem = elem;
-              reshapeElem(src_elem, bondNum, m_elemNum, perInfo, des_elem);
-              free(perInfo);
-            }
-            else{
-              Real* des_elem = UniTout.elem;
-              Real* src_elem = elem;
-              size_t memsize = m_elemNum * sizeof(Real);
-              if(ongpu){
-                src_elem = (Real*)elemAllocForce(memsize, false);
-                elemCopy(src_elem, elem, memsize, false, ongpu);
-              }
-              if(UniTout.ongpu)
-                des_elem = (Real*)elemAllocForce(memsize, false);
-
-              std::vector<size_t> transAcc(bondNum);
-              std::vector<size_t> newAcc(bondNum);
-              transAcc[bondNum - 1] = 1;
-              newAcc[bondNum - 1] = 1;
-              for(int b = bondNum - 1; b > 0; b--)
-                newAcc[b - 1] = newAcc[b] * UniTout.bonds[b].Qdegs[0];
-              std::vector<int> bondDims(bondNum);
-              std::vector<int> idxs(bondNum);
-              for(int b = 0; b < bondNum; b++){
-                transAcc[rsp_outin[b]] = newAcc[b];
-                bondDims[b] = bonds[b].Qdegs[0];
-                idxs[b] = 0;
-              }
-              size_t cnt_ot = 0;
-              for(size_t i = 0; i < m_elemNum; i++){
-                des_elem[cnt_ot] = src_elem[i];
-                for(int bend = bondNum - 1; bend >= 0; bend--){
-                  idxs[bend]++;
-                  if(idxs[bend] < bondDims[bend]){
-                    cnt_ot += transAcc[bend];
-                    break;
-                  }
-                  else{
-                    cnt_ot -= transAcc[bend] * (idxs[bend] - 1);
-                    idxs[bend] = 0;
-                  }
-                }
-              }
-              if(ongpu)
-                elemFree(src_elem, memsize, false);
-              if(UniTout.ongpu){
-                elemCopy(UniTout.elem, des_elem, memsize, UniTout.ongpu, false);
-                elemFree(des_elem, memsize, false);
-              }
-            }
-          }
-          else{  //non-symmetry inorder
-            size_t memsize = m_elemNum * sizeof(Real);
-            elemCopy(UniTout.elem, elem, memsize, UniTout.ongpu, ongpu);
-          }
-        }
-        else{
-          double sign = 1.0;
-          //For Fermionic system
-          //End Fermionic system
-          std::vector<int> Qin_idxs(bondNum, 0);
-          std::vector<int> Qot_idxs(bondNum, 0);
-          int Qin_off, Qot_off;
-          int tmp;
-          int Qin_RQoff, Qin_CQoff;
-          int Qot_CQoff, Qot_RQoff;
-          size_t sBin_r, sBin_c;	//sub-block of a Qidx
-          size_t sBin_rDim, sBin_cDim;	//sub-block of a Qidx
-          size_t sBot_cDim;	//sub-block of a Qidx
-          size_t sBot_r, sBot_c;
-          size_t Bin_cDim, Bot_cDim;
-          Real* Ein_ptr;
-          Real* Eot_ptr;
-          std::vector<int> sBin_idxs(bondNum, 0);
-          std::vector<int> sBin_sBdims(bondNum, 0);
-          std::vector<int> Qot_acc(bondNum, 1);
-          std::vector<int> sBot_acc(bondNum, 1);
-          for(int b = bondNum	- 1; b > 0; b--)
-            Qot_acc[b - 1] = Qot_acc[b] * UniTout.bonds[b].Qnums.size();
-
-          for(std::map<int, size_t>::iterator it = QidxEnc.begin(); it != QidxEnc.end(); it++){
-            Qin_off = it->first;
-            tmp = Qin_off;
-            int qdim;
-            for(int b = bondNum - 1; b >= 0; b--){
-              qdim = bonds[b].Qnums.size();
-              Qin_idxs[b] = tmp % qdim;
-              sBin_sBdims[b] = bonds[b].Qdegs[Qin_idxs[b]];
-              tmp /= qdim;
-            }
-            Qot_off = 0;
-            for(int b = 0; b < bondNum; b++){
-              Qot_idxs[b] = Qin_idxs[rsp_outin[b]];
-              Qot_off += Qot_idxs[b] * Qot_acc[b];
-            }
-            for(int b = bondNum	- 1; b > 0; b--)
-              sBot_acc[rsp_outin[b-1]] = sBot_acc[rsp_outin[b]] * bonds[rsp_outin[b]].Qdegs[Qot_idxs[b]];
-            Qin_RQoff = Qin_off / CQdim;
-            Qin_CQoff = Qin_off % CQdim;
-            Qot_RQoff = Qot_off / UniTout.CQdim;
-            Qot_CQoff = Qot_off % UniTout.CQdim;
-            Bin_cDim = RQidx2Blk[Qin_RQoff]->Cnum;
-            Bot_cDim = UniTout.RQidx2Blk[Qot_RQoff]->Cnum;
-            Ein_ptr = RQidx2Blk[Qin_RQoff]->m_elem + (RQidx2Off[Qin_RQoff] * Bin_cDim) + CQidx2Off[Qin_CQoff];
-            Eot_ptr = UniTout.RQidx2Blk[Qot_RQoff]->m_elem + (UniTout.RQidx2Off[Qot_RQoff] * Bot_cDim) + UniTout.CQidx2Off[Qot_CQoff];
-            sBin_rDim = RQidx2Dim[Qin_RQoff];
-            sBin_cDim = CQidx2Dim[Qin_CQoff];
-            sBot_cDim = UniTout.CQidx2Dim[Qot_CQoff];
-            int cnt_ot = 0;
-            sBin_idxs.assign(bondNum, 0);
-            //if(Qnum::isFermionic()){}
-            for(sBin_r = 0; sBin_r < sBin_rDim; sBin_r++)
-              for(sBin_c = 0; sBin_c < sBin_cDim; sBin_c++){
-                sBot_r = cnt_ot / sBot_cDim;
-                sBot_c = cnt_ot % sBot_cDim;
-                Eot_ptr[(sBot_r * Bot_cDim) + sBot_c] = sign * Ein_ptr[(sBin_r * Bin_cDim) + sBin_c];
-                for(int bend = bondNum - 1; bend >= 0; bend--){
-                  sBin_idxs[bend]++;
-                  if(sBin_idxs[bend] < sBin_sBdims[bend]){
-                    cnt_ot += sBot_acc[bend];
-                    break;
-                  }
-                  else{
-                    cnt_ot -= sBot_acc[bend] * (sBin_idxs[bend] - 1);
-                    sBin_idxs[bend] = 0;
-                  }
-                }
-              }
-          }
-        }
+        UniTout.permuteElemFrom(RTYPE, *this, rsp_outin);
         UniTout.status |= HAVEELEM;
       }
-      *this = UniTout;
+      swapContent(UniTout);
       this->setLabel(newLabels);
     }
   }
@@ -811,8 +706,141 @@ UniTensor& UniTensor::permute(rflag tp, const std::vector<int>& newLabels, int r
   return *this;
 }
 
+void UniTensor::permuteElemFrom(rflag tp, const UniTensor& src, const std::vector<int>& rsp_outin){
+  int bondNum = src.bonds.size();
+  bool inorder = true;
+  bool withoutSymmetry = true;
+  for(int b = 0; b < bondNum; b++){
+    if(rsp_outin[b] != b)
+      inorder = false;
+    if(src.bonds[b].Qnums.size() != 1)
+      withoutSymmetry = false;
+  }
+  if(withoutSymmetry){
+    if(!inorder){
+      if(src.ongpu && ongpu){
+        size_t* perInfo = (size_t*)malloc(bondNum * 2 * sizeof(size_t));
+        std::vector<size_t> newAcc(bondNum);
+        newAcc[bondNum - 1] = 1;
+        perInfo[bondNum - 1] = 1;
+        for(int b = bondNum - 1; b > 0; b--){
+          newAcc[b - 1] = newAcc[b] * bonds[b].Qdegs[0];
+          perInfo[b - 1] = perInfo[b] * src.bonds[b].Qdegs[0];
+        }
+        for(int b = 0; b < bondNum; b++)
+          perInfo[bondNum + rsp_outin[b]] = newAcc[b];
+        Real* des_elem = elem;
+        Real* src_elem = src.elem;
+        reshapeElem(src_elem, bondNum, src.m_elemNum, perInfo, des_elem);
+        free(perInfo);
+      }
+      else{
+        Real* des_elem = elem;
+        Real* src_elem = src.elem;
+        size_t memsize = src.m_elemNum * sizeof(Real);
+        if(src.ongpu){
+          src_elem = (Real*)elemAllocForce(memsize, false);
+          elemCopy(src_elem, src.elem, memsize, false, src.ongpu);
+        }
+        if(ongpu)
+          des_elem = (Real*)elemAllocForce(memsize, false);
+
+        std::vector<int> bondDims(bondNum);
+        for(int b = 0; b < bondNum; b++)
+          bondDims[b] = src.bonds[b].Qdegs[0];
+        permuteElem(src_elem, bondNum, &bondDims[0], &rsp_outin[0], des_elem);
+        if(src.ongpu)
+          elemFree(src_elem, memsize, false);
+        if(ongpu){
+          elemCopy(elem, des_elem, memsize, ongpu, false);
+          elemFree(des_elem, memsize, false);
+        }
+      }
+    }
+    else{  //non-symmetry inorder
+      size_t memsize = src.m_elemNum * sizeof(Real);
+      elemCopy(elem, src.elem, memsize, ongpu, src.ongpu);
+    }
+  }
+  else{
+    double sign = 1.0;
+    //For Fermionic system
+    //End Fermionic system
+    std::vector<int> Qin_idxs(bondNum, 0);
+    std::vector<int> Qot_idxs(bondNum, 0);
+    int Qin_off, Qot_off;
+    int tmp;
+    int Qin_RQoff, Qin_CQoff;
+    int Qot_CQoff, Qot_RQoff;
+    size_t sBin_r, sBin_c;	//sub-block of a Qidx
+    size_t sBin_rDim, sBin_cDim;	//sub-block of a Qidx
+    size_t sBot_cDim;	//sub-block of a Qidx
+    size_t sBot_r, sBot_c;
+    size_t Bin_cDim, Bot_cDim;
+    Real* Ein_ptr;
+    Real* Eot_ptr;
+    std::vector<int> sBin_idxs(bondNum, 0);
+    std::vector<int> sBin_sBdims(bondNum, 0);
+    std::vector<int> Qot_acc(bondNum, 1);
+    std::vector<int> sBot_acc(bondNum, 1);
+    for(int b = bondNum	- 1; b > 0; b--)
+      Qot_acc[b - 1] = Qot_acc[b] * bonds[b].Qnums.size();
+
+    for(std::map<int, size_t>::const_iterator it = src.QidxEnc.begin(); it != src.QidxEnc.end(); it++){
+      Qin_off = it->first;
+      tmp = Qin_off;
+      int qdim;
+      for(int b = bondNum - 1; b >= 0; b--){
+        qdim = src.bonds[b].Qnums.size();
+        Qin_idxs[b] = tmp % qdim;
+        sBin_sBdims[b] = src.bonds[b].Qdegs[Qin_idxs[b]];
+        tmp /= qdim;
+      }
+      Qot_off = 0;
+      for(int b = 0; b < bondNum; b++){
+        Qot_idxs[b] = Qin_idxs[rsp_outin[b]];
+        Qot_off += Qot_idxs[b] * Qot_acc[b];
+      }
+      for(int b = bondNum	- 1; b > 0; b--)
+        sBot_acc[rsp_outin[b-1]] = sBot_acc[rsp_outin[b]] * src.bonds[rsp_outin[b]].Qdegs[Qot_idxs[b]];
+      Qin_RQoff = Qin_off / src.CQdim;
+      Qin_CQoff = Qin_off % src.CQdim;
+      Qot_RQoff = Qot_off / CQdim;
+      Qot_CQoff = Qot_off % CQdim;
+      Bin_cDim = src.RQidx2Blk.find(Qin_RQoff)->second->Cnum;
+      Bot_cDim = RQidx2Blk[Qot_RQoff]->Cnum;
+      Ein_ptr = src.RQidx2Blk.find(Qin_RQoff)->second->m_elem + (src.RQidx2Off.find(Qin_RQoff)->second * Bin_cDim) + src.CQidx2Off.find(Qin_CQoff)->second;
+      Eot_ptr = RQidx2Blk[Qot_RQoff]->m_elem + (RQidx2Off[Qot_RQoff] * Bot_cDim) + CQidx2Off[Qot_CQoff];
+      sBin_rDim = src.RQidx2Dim.find(Qin_RQoff)->second;
+      sBin_cDim = src.CQidx2Dim.find(Qin_CQoff)->second;
+      sBot_cDim = CQidx2Dim[Qot_CQoff];
+      int cnt_ot = 0;
+      sBin_idxs.assign(bondNum, 0);
+      //if(Qnum::isFermionic()){}
+      for(sBin_r = 0; sBin_r < sBin_rDim; sBin_r++)
+        for(sBin_c = 0; sBin_c < sBin_cDim; sBin_c++){
+          sBot_r = cnt_ot / sBot_cDim;
+          sBot_c = cnt_ot % sBot_cDim;
+          Eot_ptr[(sBot_r * Bot_cDim) + sBot_c] = sign * Ein_ptr[(sBin_r * Bin_cDim) + sBin_c];
+          for(int bend = bondNum - 1; bend >= 0; bend--){
+            sBin_idxs[bend]++;
+            if(sBin_idxs[bend] < sBin_sBdims[bend]){
+              cnt_ot += sBot_acc[bend];
+              break;
+            }
+            else{
+              cnt_ot -= sBot_acc[bend] * (sBin_idxs[bend] - 1);
+              sBin_idxs[bend] = 0;
+            }
+          }
+        }
+    }
+  }
+}
+
 UniTensor& UniTensor::permuteFm(rflag tp, int rowBondNum){
   try{
+    materialize();
     throwTypeError(tp);
     std::vector<int> ori_labels = labels;
     this->permuteFm(RTYPE, ori_labels, rowBondNum);
@@ -825,6 +853,7 @@ UniTensor& UniTensor::permuteFm(rflag tp, int rowBondNum){
 
 UniTensor& UniTensor::permuteFm(rflag tp, int* newLabels, int rowBondNum){
   try{
+    materialize();
     throwTypeError(tp);
     std::vector<int> _labels(newLabels, newLabels + bonds.size());
     this->permuteFm(RTYPE, _labels, rowBondNum);
@@ -837,6 +866,7 @@ UniTensor& UniTensor::permuteFm(rflag tp, int* newLabels, int rowBondNum){
 
 UniTensor& UniTensor::permuteFm(rflag tp, const std::vector<int>& newLabels, int rowBondNum){
   try{
+    materialize();
     throwTypeError(tp);
     if((status & HAVEBOND) == 0){
       std::ostringstream err;
@@ -915,34 +945,10 @@ UniTensor& UniTensor::permuteFm(rflag tp, const std::vector<int>& newLabels, int
               if(UniTout.ongpu)
                 des_elem = (Real*)elemAllocForce(memsize, false);
 
-              std::vector<size_t> transAcc(bondNum);
-              std::vector<size_t> newAcc(bondNum);
-              transAcc[bondNum - 1] = 1;
-              newAcc[bondNum - 1] = 1;
-              for(int b = bondNum - 1; b > 0; b--)
-                newAcc[b - 1] = newAcc[b] * UniTout.bonds[b].Qdegs[0];
               std::vector<int> bondDims(bondNum);
-              std::vector<int> idxs(bondNum);
-              for(int b = 0; b < bondNum; b++){
-                transAcc[rsp_outin[b]] = newAcc[b];
+              for(int b = 0; b < bondNum; b++)
                 bondDims[b] = bonds[b].Qdegs[0];
-                idxs[b] = 0;
-              }
-              size_t cnt_ot = 0;
-              for(size_t i = 0; i < m_elemNum; i++){
-                des_elem[cnt_ot] = src_elem[i];
-                for(int bend = bondNum - 1; bend >= 0; bend--){
-                  idxs[bend]++;
-                  if(idxs[bend] < bondDims[bend]){
-                    cnt_ot += transAcc[bend];
-                    break;
-                  }
-                  else{
-                    cnt_ot -= transAcc[bend] * (idxs[bend] - 1);
-                    idxs[bend] = 0;
-                  }
-                }
-              }
+              permuteElem(src_elem, bondNum, &bondDims[0], &rsp_outin[0], des_elem);
               if(ongpu)
                 elemFree(src_elem, memsize, false);
               if(UniTout.ongpu){
@@ -1075,6 +1081,7 @@ UniTensor& UniTensor::permuteFm(rflag tp, const std::vector<int>& newLabels, int
 
 Real UniTensor::at(rflag tp, size_t idx)const{
   try{
+    materialize();
     throwTypeError(tp);
     if(!(idx < m_elemNum)){
       std::ostringstream err;
@@ -1096,6 +1103,7 @@ Real UniTensor::at(rflag tp, size_t idx)const{
 
 UniTensor& UniTensor::combineBond(rflag tp, const std::vector<int>&cmbLabels){
   try{
+    materialize();
     throwTypeError(tp);
     if((status & HAVEBOND) == 0){
       std::ostringstream err;
@@ -1175,6 +1183,7 @@ UniTensor& UniTensor::combineBond(rflag tp, const std::vector<int>&cmbLabels){
 
 void UniTensor::addGate(rflag tp, const std::vector<_Swap>& swaps){
   try{
+    detachElem();
     throwTypeError(tp);
     if((status & HAVEBOND) == 0){
       std::ostringstream err;
@@ -1230,6 +1239,7 @@ void UniTensor::addGate(rflag tp, const std::vector<_Swap>& swaps){
 
 Real UniTensor::trace(rflag tp)const{
   try{
+    materialize();
     throwTypeError(tp);
     if(!(status & HAVEELEM)){
       std::ostringstream err;
@@ -1260,6 +1270,7 @@ Real UniTensor::trace(rflag tp)const{
 
 UniTensor& UniTensor::partialTrace(rflag tp, int la, int lb){
   try{
+    materialize();
     throwTypeError(tp);
     if(!(status & HAVEELEM)){
       std::ostringstream err;
@@ -1301,6 +1312,7 @@ UniTensor& UniTensor::partialTrace(rflag tp, int la, int lb){
     ia = bondNum - 2;
     ib = bondNum - 1;
     this->permute(RTYPE, rsp_labels, Tt.RBondNum);
+    materialize();
     std::vector<int> Q_acc(bondNum, 1);
     for(int b = bondNum - 1; b > 0; b--)
       Q_acc[b - 1] = Q_acc[b] * bonds[b].Qnums.size();
@@ -1379,6 +1391,7 @@ UniTensor& UniTensor::partialTrace(rflag tp, int la, int lb){
 
 UniTensor& UniTensor::assign(rflag tp, const std::vector<Bond>& _bond){
   try{
+    materialize();
     throwTypeError(tp);
     UniTensor T(RTYPE, _bond);
     *this = T;
@@ -1391,6 +1404,7 @@ UniTensor& UniTensor::assign(rflag tp, const std::vector<Bond>& _bond){
 
 Real UniTensor::at(rflag tp, const std::vector<int>& idxs)const{
   try{
+    materialize();
     throwTypeError(tp);
     std::vector<size_t> _idxs(idxs.size());
     for(size_t i = 0; i < idxs.size(); i++)
@@ -1405,6 +1419,7 @@ Real UniTensor::at(rflag tp, const std::vector<int>& idxs)const{
 
 Real UniTensor::at(rflag tp, const std::vector<size_t>& idxs)const{
   try{
+    materialize();
     throwTypeError(tp);
     if((status & HAVEBOND) == 0){
       std::ostringstream err;
@@ -1628,7 +1643,7 @@ size_t UniTensor::grouping(rflag tp){
   return off;
 }
 
-void UniTensor::initUniT(rflag tp){ //GPU
+void UniTensor::initUniT(rflag tp, Real* _elem){ //GPU
   r_flag = RTYPE;
   c_flag = CNULL;
   if(bonds.size()){
@@ -1658,12 +1673,15 @@ void UniTensor::initUniT(rflag tp){ //GPU
   elem = NULL;
   c_elem = NULL;
 
-  ELEMNUM += m_elemNum;
-  COUNTER++;
-  if((size_t)ELEMNUM > MAXELEMNUM)
-    MAXELEMNUM = ELEMNUM;
-  if(m_elemNum > MAXELEMTEN)
-    MAXELEMTEN = m_elemNum;
+  updateCounter(1, m_elemNum, m_elemNum);
+  if(_elem){
+    elem = _elem;
+    ongpu = false;  // a buffer of the caller is in host memory
+    storage.reset(new ElemStorage(_elem, sizeof(Real) * m_elemNum, ongpu, false));
+    initBlocks(RTYPE);
+    status |= HAVEELEM;
+    return;
+  }
   TelemAlloc(RTYPE);
   initBlocks(RTYPE);
   TelemBzero(RTYPE);
@@ -1681,7 +1699,9 @@ void UniTensor::initBlocks(rflag tp){
 }
 
 void UniTensor::TelemAlloc(rflag tp){
+  UNI10_MEMORY_SCOPE(mem, name.size() ? "tensor " + name : std::string());
   elem = (Real*)elemAlloc(sizeof(Real) * m_elemNum, ongpu);
+  storage.reset(new ElemStorage(elem, sizeof(Real) * m_elemNum, ongpu));
 }
 
 void UniTensor::TelemBzero(rflag tp){
@@ -1692,6 +1712,7 @@ void UniTensor::TelemBzero(rflag tp){
 
 Real UniTensor::norm(rflag tp) const{
   try{
+    materialize();
     throwTypeError(tp);
     return vectorNorm(elem, elemNum(), 1, ongpu);
   }
@@ -1703,6 +1724,7 @@ Real UniTensor::norm(rflag tp) const{
 
 Real UniTensor::max(rflag tp) const{
   try{
+    materialize();
     throwTypeError(tp);
     return elemMax(elem, elemNum(), ongpu);
   }
@@ -1714,6 +1736,7 @@ Real UniTensor::max(rflag tp) const{
 
 Real UniTensor::absMax(rflag tp) const{
   try{
+    materialize();
     throwTypeError(tp);
     return elemAbsMax(elem, elemNum(), ongpu);
   }
@@ -1725,6 +1748,7 @@ Real UniTensor::absMax(rflag tp) const{
 
 UniTensor& UniTensor::normalize(rflag tp){
   try{
+    detachElem();
     throwTypeError(tp);
     Real norm = vectorNorm(elem, elemNum(), 1, ongpu);
     vectorScal((1./norm), elem, elemNum(), ongpu);
@@ -1737,6 +1761,7 @@ UniTensor& UniTensor::normalize(rflag tp){
 
 UniTensor& UniTensor::maxNorm(rflag tp){
   try{
+    detachElem();
     throwTypeError(tp);
     Real max = elemMax(elem, elemNum(), ongpu);
     vectorScal((1./max), elem, elemNum(), ongpu);
@@ -1749,6 +1774,7 @@ UniTensor& UniTensor::maxNorm(rflag tp){
 
 UniTensor& UniTensor::absMaxNorm(rflag tp){
   try{
+    detachElem();
     throwTypeError(tp);
     Real absMax = elemAbsMax(elem, elemNum(), ongpu);
     vectorScal((1./absMax), elem, elemNum(), ongpu);
@@ -1761,6 +1787,7 @@ UniTensor& UniTensor::absMaxNorm(rflag tp){
 
 std::vector<UniTensor> UniTensor::hosvd(rflag tp, int* _group_labels, int* _groups, size_t _groupsSize, std::vector<Matrix>& Ls)const{
   try{
+    materialize();
     std::vector<int> group_labels(_group_labels, _group_labels+this->bondNum());
     std::vector<int> groups(_groups, _groups+_groupsSize);
     return hosvd(tp, group_labels, groups, Ls);
@@ -1773,6 +1800,7 @@ std::vector<UniTensor> UniTensor::hosvd(rflag tp, int* _group_labels, int* _grou
 
 std::vector<UniTensor> UniTensor::hosvd(rflag tp, std::vector<int>& group_labels, std::vector<int>& groups, std::vector<Matrix>& Ls)const{
   try{
+    materialize();
     bool withoutSymmetry = true;
     for(size_t b = 0; b < bonds.size(); b++){
       if(bonds[b].Qnums.size() != 1)
@@ -1800,6 +1828,7 @@ std::vector<UniTensor> UniTensor::hosvd(rflag tp, std::vector<int>& group_labels
 
 std::vector<UniTensor> UniTensor::hosvd(rflag tp, int* _group_labels, int* _groups, size_t _groupsSize, std::vector<std::map<Qnum, Matrix> >& Ls, bool returnL)const{
   try{
+    materialize();
     std::vector<int> group_labels(_group_labels, _group_labels+this->bondNum());
     std::vector<int> groups(_groups, _groups+_groupsSize);
     return hosvd(tp, group_labels, groups, Ls, returnL);
@@ -1811,6 +1840,7 @@ std::vector<UniTensor> UniTensor::hosvd(rflag tp, int* _group_labels, int* _grou
 }
 
 std::vector<UniTensor> UniTensor::hosvd(rflag tp, std::vector<int>& group_labels, std::vector<int>& groups, std::vector<std::map<Qnum, Matrix> >& Ls, bool returnL)const{
+  materialize();
   throwTypeError(tp);
   try{
     if((status & HAVEBOND) == 0){
@@ -1854,6 +1884,7 @@ std::vector<UniTensor> UniTensor::hosvd(rflag tp, std::vector<int>& group_labels
         pos++;
       }
       T.permute(RTYPE, lrsp_labels, groups[m]);
+      T.materialize();
       std::vector<Bond> bonds(T.bonds.begin(), T.bonds.begin() + groups[m]);
       bonds.push_back(combine(bonds).dummy_change(BD_OUT));
       Us.push_back(UniTensor(RTYPE, bonds));
@@ -1881,6 +1912,7 @@ std::vector<UniTensor> UniTensor::hosvd(rflag tp, std::vector<int>& group_labels
 
 std::vector<UniTensor> UniTensor::hosvd(rflag tp, size_t modeNum, size_t fixedNum)const{
   try{
+    materialize();
     std::vector<std::map<Qnum, Matrix> > symLs;
     std::vector<int> group_labels=this->labels;
     std::vector<int> groups(modeNum, (this->bondNum()-fixedNum)/modeNum);
@@ -1894,6 +1926,7 @@ std::vector<UniTensor> UniTensor::hosvd(rflag tp, size_t modeNum, size_t fixedNu
 
 std::vector<UniTensor> UniTensor::hosvd(rflag tp, size_t modeNum, size_t fixedNum, std::vector<std::map<Qnum, Matrix> >& Ls)const{
   try{
+    materialize();
     std::vector<std::map<Qnum, Matrix> > symLs;
     std::vector<int> group_labels=this->labels;
     std::vector<int> groups(modeNum, (this->bondNum()-fixedNum)/modeNum );
@@ -1907,6 +1940,7 @@ std::vector<UniTensor> UniTensor::hosvd(rflag tp, size_t modeNum, size_t fixedNu
 
 std::vector<UniTensor> UniTensor::hosvd(rflag tp, size_t modeNum, size_t fixedNum, std::vector<Matrix>& Ls)const{
   try{
+    materialize();
     bool withoutSymmetry = true;
     for(size_t b = 0; b < bonds.size(); b++){
       if(bonds[b].Qnums.size() != 1)
@@ -33,6 +33,7 @@
 #include <uni10/data-structure/Bond.h>
 #include <uni10/tensor-network/Matrix.h>
 #include <uni10/tensor-network/UniTensor.h>
+#include <uni10/tensor-network/SectorScheduler.h>
 #ifdef HDF5
   #include <uni10/hdf5io/uni10_hdf5io.h>
 #endif
@@ -42,10 +43,13 @@ namespace uni10{
 
   void RtoC(UniTensor& UniT){
     try{
+      UniT.materialize();
       if(UniT.typeID() == 1){
+        UNI10_PROFILE_SCOPE(prof, PROF_RTOC, UniT.m_elemNum * sizeof(Real));
+        std::shared_ptr<UniTensor::ElemStorage> real = UniT.storage;  // kept until the cast is done
         UniT.r_flag = RNULL;
         UniT.c_flag = CTYPE;
-        UniT.c_elem = (Complex*)elemAlloc( UniT.m_elemNum * sizeof(Complex), UniT.ongpu);
+        UniT.TelemAlloc(CTYPE);
         elemCast(UniT.c_elem, UniT.elem, UniT.m_elemNum, UniT.ongpu, UniT.ongpu);
         UniT.initBlocks(CTYPE);
         UniT.elem = NULL;
@@ -122,6 +126,7 @@ namespace uni10{
         UniTensor Ttmp = Tb;
         return contract(Ta, Ttmp, fast);
       }
+      UNI10_PROFILE_SCOPE(prof, PROF_CONTRACT, (Ta.m_elemNum + Tb.m_elemNum) * sizeof(Real));
 
       if(Ta.status & Ta.HAVEBOND && Tb.status & Ta.HAVEBOND){
         int AbondNum = Ta.bonds.size();
@@ -166,6 +171,8 @@ namespace uni10{
         int conBond = interLabel.size();
         Ta.permute(RTYPE, newLabelA, AbondNum - conBond);
         Tb.permute(RTYPE, newLabelB, conBond);
+        Ta.materialize();
+        Tb.materialize();
         std::vector<Bond> cBonds;
         for(int i = 0; i < AbondNum - conBond; i++)
           cBonds.push_back(Ta.bonds[i]);
@@ -177,6 +184,8 @@ namespace uni10{
         Block blockA, blockB, blockC;
         std::map<Qnum, Block>::iterator it;
         std::map<Qnum, Block>::iterator it2;
+        SectorScheduler* scheduler = Ta.ongpu || Tb.ongpu || Tc.ongpu ? NULL : sectorScheduler();
+        std::vector<SectorGemm<Real> > gemms;
         for(it = Ta.blocks.begin() ; it != Ta.blocks.end(); it++){
           if((it2 = Tb.blocks.find(it->first)) != Tb.blocks.end()){
             blockA = it->second;
@@ -187,9 +196,17 @@ namespace uni10{
               err<<"The dimensions the bonds to be contracted out are different.";
               throw std::runtime_error(exception_msg(err.str()));
             }
-            matrixMul(blockA.getElem(RTYPE), blockB.getElem(RTYPE), blockA.row(), blockB.col(), blockA.col(), blockC.getElem(RTYPE), Ta.ongpu, Tb.ongpu, Tc.ongpu);
+            if(scheduler){
+              SectorGemm<Real> gemm = {blockA.getElem(RTYPE), blockB.getElem(RTYPE), blockC.getElem(RTYPE), blockA.row(), blockB.col(), blockA.col()};
+              gemms.push_back(gemm);
+            }
+            else
+              matrixMul(blockA.getElem(RTYPE), blockB.getElem(RTYPE), blockA.row(), blockB.col(), blockA.col(), blockC.getElem(RTYPE), Ta.ongpu, Tb.ongpu, Tc.ongpu);
+            UNI10_PROFILE_FLOPS(prof, (uint64_t)2 * blockA.row() * blockB.col() * blockA.col());
           }
         }
+        if(gemms.size())
+          scheduler->run(gemms);
         Tc.status |= Tc.HAVEELEM;
 
         if(conBond == 0){	//Outer product
@@ -273,6 +290,7 @@ namespace uni10{
         UniTensor Ttmp = Tb;
         return contract(Ta, Ttmp, fast);
       }
+      UNI10_PROFILE_SCOPE(prof, PROF_CONTRACT, (Ta.m_elemNum + Tb.m_elemNum) * sizeof(Complex));
 
       if(Ta.status & Ta.HAVEBOND && Tb.status & Ta.HAVEBOND){
         int AbondNum = Ta.bonds.size();
@@ -317,6 +335,8 @@ namespace uni10{
         int conBond = interLabel.size();
         Ta.permute(CTYPE, newLabelA, AbondNum - conBond);
         Tb.permute(CTYPE, newLabelB, conBond);
+        Ta.materialize();
+        Tb.materialize();
         std::vector<Bond> cBonds;
         for(int i = 0; i < AbondNum - conBond; i++)
           cBonds.push_back(Ta.bonds[i]);
@@ -328,6 +348,8 @@ namespace uni10{
         Block blockA, blockB, blockC;
         std::map<Qnum, Block>::iterator it;
         std::map<Qnum, Block>::iterator it2;
+        SectorScheduler* scheduler = Ta.ongpu || Tb.ongpu || Tc.ongpu ? NULL : sectorScheduler();
+        std::vector<SectorGemm<Complex> > gemms;
         for(it = Ta.blocks.begin() ; it != Ta.blocks.end(); it++){
           if((it2 = Tb.blocks.find(it->first)) != Tb.blocks.end()){
             blockA = it->second;
@@ -338,9 +360,17 @@ namespace uni10{
               err<<"The dimensions the bonds to be contracted out are different.";
               throw std::runtime_error(exception_msg(err.str()));
             }
-            matrixMul(blockA.getElem(CTYPE), blockB.getElem(CTYPE), blockA.row(), blockB.col(), blockA.col(), blockC.getElem(CTYPE), Ta.ongpu, Tb.ongpu, Tc.ongpu);
+            if(scheduler){
+              SectorGemm<Complex> gemm = {blockA.getElem(CTYPE), blockB.getElem(CTYPE), blockC.getElem(CTYPE), blockA.row(), blockB.col(), blockA.col()};
+              gemms.push_back(gemm);
+            }
+            else
+              matrixMul(blockA.getElem(CTYPE), blockB.getElem(CTYPE), blockA.row(), blockB.col(), blockA.col(), blockC.getElem(CTYPE), Ta.ongpu, Tb.ongpu, Tc.ongpu);
+            UNI10_PROFILE_FLOPS(prof, (uint64_t)8 * blockA.row() * blockB.col() * blockA.col());
           }
         }
+        if(gemms.size())
+          scheduler->run(gemms);
         Tc.status |= Tc.HAVEELEM;
 
         if(conBond == 0){	//Outer product
@@ -0,0 +1,167 @@
+/****************************************************************************
+*  @file uni10_memory.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file for the allocation tracking memory profiler
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/tools/uni10_memory.h>
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+namespace uni10{
+
+std::atomic<bool> MEMTRACK_ON(false);
+
+namespace{
+  struct SiteUsage{
+    size_t bytes;
+    size_t count;
+    SiteUsage(): bytes(0), count(0){}
+  };
+  struct Allocation{
+    size_t bytes;
+    std::string site;
+  };
+
+  std::mutex memoryMutex;
+  std::unordered_map<const void*, Allocation> liveAllocs;
+  // Usage per site is kept up to date, so that the high-water mark is recorded by copying it
+  std::map<std::string, SiteUsage> liveSites;
+  std::map<std::string, SiteUsage> peakSites;
+  size_t liveBytes = 0;
+  size_t peakBytes = 0;
+  thread_local std::vector<std::string> siteStack;
+
+  std::string currentSite(){
+    if(siteStack.empty())
+      return "(untracked site)";
+    std::string site = siteStack[0];
+    for(size_t i = 1; i < siteStack.size(); i++)
+      site += " > " + siteStack[i];
+    return site;
+  }
+
+  bool largerSite(const MemorySite& a, const MemorySite& b){
+    return a.bytes > b.bytes || (a.bytes == b.bytes && a.site < b.site);
+  }
+
+  std::vector<MemorySite> sortedSites(const std::map<std::string, SiteUsage>& sites){
+    std::vector<MemorySite> sorted;
+    for(std::map<std::string, SiteUsage>::const_iterator it = sites.begin(); it != sites.end(); it++){
+      MemorySite ms;
+      ms.site = it->first;
+      ms.bytes = it->second.bytes;
+      ms.count = it->second.count;
+      sorted.push_back(ms);
+    }
+    std::sort(sorted.begin(), sorted.end(), largerSite);
+    return sorted;
+  }
+}
+
+void memoryTrackBegin(){
+  MEMTRACK_ON = true;
+}
+
+void memoryTrackEnd(){
+  MEMTRACK_ON = false;
+  std::lock_guard<std::mutex> lock(memoryMutex);
+  liveAllocs.clear();
+  liveSites.clear();
+  liveBytes = 0;
+}
+
+void memoryTrackAlloc(const void* ptr, size_t bytes){
+  Allocation alloc;
+  alloc.bytes = bytes;
+  alloc.site = currentSite();
+  std::lock_guard<std::mutex> lock(memoryMutex);
+  SiteUsage& usage = liveSites[alloc.site];
+  usage.bytes += bytes;
+  usage.count++;
+  liveAllocs[ptr] = alloc;
+  liveBytes += bytes;
+  if(liveBytes > peakBytes){
+    peakBytes = liveBytes;
+    peakSites = liveSites;
+  }
+}
+
+void memoryTrackFree(const void* ptr){
+  std::lock_guard<std::mutex> lock(memoryMutex);
+  std::unordered_map<const void*, Allocation>::iterator it = liveAllocs.find(ptr);
+  if(it == liveAllocs.end())
+    return;
+  std::map<std::string, SiteUsage>::iterator sit = liveSites.find(it->second.site);
+  sit->second.bytes -= it->second.bytes;
+  if(--sit->second.count == 0)
+    liveSites.erase(sit);
+  liveBytes -= it->second.bytes;
+  liveAllocs.erase(it);
+}
+
+MemorySnapshot memorySnapshot(){
+  std::lock_guard<std::mutex> lock(memoryMutex);
+  MemorySnapshot snap;
+  snap.liveBytes = liveBytes;
+  snap.peakBytes = peakBytes;
+  snap.live = sortedSites(liveSites);
+  snap.peak = sortedSites(peakSites);
+  return snap;
+}
+
+void memoryResetPeak(){
+  std::lock_guard<std::mutex> lock(memoryMutex);
+  peakBytes = liveBytes;
+  peakSites = liveSites;
+}
+
+MemoryScope::MemoryScope(const std::string& site): active(site.size() > 0){
+  if(active)
+    siteStack.push_back(site);
+}
+
+MemoryScope::~MemoryScope(){
+  if(active)
+    siteStack.pop_back();
+}
+
+std::string MemorySnapshot::str(size_t maxSites)const{
+  std::ostringstream os;
+  os<<"Tracked memory: "<<liveBytes<<" bytes alive, peak "<<peakBytes<<" bytes"<<std::endl;
+  if(peak.size())
+    os<<"Alive at the peak:"<<std::endl;
+  for(size_t i = 0; i < peak.size() && i < maxSites; i++)
+    os<<std::setw(14)<<peak[i].bytes<<" bytes in "<<std::setw(4)<<peak[i].count<<" allocs  "<<peak[i].site<<std::endl;
+  if(peak.size() > maxSites)
+    os<<"  ... "<<peak.size() - maxSites<<" more sites"<<std::endl;
+  return os.str();
+}
+
+};	/* namespace uni10 */
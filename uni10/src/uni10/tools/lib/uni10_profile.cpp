@@ -0,0 +1,127 @@
+/****************************************************************************
+*  @file uni10_profile.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file for the hot-path profiling counters
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/tools/uni10_profile.h>
+#include <atomic>
+#include <iomanip>
+#include <sstream>
+namespace uni10{
+
+namespace{
+  // Counters kept as integers so that they can be updated without a lock
+  struct AtomicOpProfile{
+    std::atomic<size_t> calls;
+    std::atomic<size_t> bytes;
+    std::atomic<uint64_t> flops;
+    std::atomic<uint64_t> nanoseconds;
+  };
+  AtomicOpProfile PROFILE[PROF_OP_NUM];
+}
+
+void profileAdd(profOp op, size_t bytes, uint64_t flops, double seconds){
+  AtomicOpProfile& prof = PROFILE[op];
+  prof.calls.fetch_add(1, std::memory_order_relaxed);
+  prof.bytes.fetch_add(bytes, std::memory_order_relaxed);
+  prof.flops.fetch_add(flops, std::memory_order_relaxed);
+  prof.nanoseconds.fetch_add((uint64_t)(seconds * 1E9), std::memory_order_relaxed);
+}
+
+ProfileData profileSnapshot(){
+  ProfileData data;
+  for(int i = 0; i < PROF_OP_NUM; i++){
+    data.ops[i].calls = PROFILE[i].calls.load(std::memory_order_relaxed);
+    data.ops[i].bytes = PROFILE[i].bytes.load(std::memory_order_relaxed);
+    data.ops[i].flops = PROFILE[i].flops.load(std::memory_order_relaxed);
+    data.ops[i].seconds = PROFILE[i].nanoseconds.load(std::memory_order_relaxed) * 1E-9;
+  }
+  return data;
+}
+
+void profileReset(){
+  for(int i = 0; i < PROF_OP_NUM; i++){
+    PROFILE[i].calls = 0;
+    PROFILE[i].bytes = 0;
+    PROFILE[i].flops = 0;
+    PROFILE[i].nanoseconds = 0;
+  }
+}
+
+ProfileData::ProfileData(){
+  for(int i = 0; i < PROF_OP_NUM; i++){
+    ops[i].calls = 0;
+    ops[i].bytes = 0;
+    ops[i].flops = 0;
+    ops[i].seconds = 0;
+  }
+}
+
+const OpProfile& ProfileData::operator[](profOp op)const{
+  return ops[op];
+}
+
+ProfileData ProfileData::operator-(const ProfileData& prev)const{
+  ProfileData diff;
+  for(int i = 0; i < PROF_OP_NUM; i++){
+    diff.ops[i].calls = ops[i].calls - prev.ops[i].calls;
+    diff.ops[i].bytes = ops[i].bytes - prev.ops[i].bytes;
+    diff.ops[i].flops = ops[i].flops - prev.ops[i].flops;
+    diff.ops[i].seconds = ops[i].seconds - prev.ops[i].seconds;
+  }
+  return diff;
+}
+
+const char* ProfileData::opName(profOp op){
+  static const char* names[PROF_OP_NUM] = {"permute", "contract", "alloc", "svd", "eig", "eigh", "qr", "copy", "RtoC", "gemm"};
+  return names[op];
+}
+
+bool ProfileData::enabled(){
+#ifdef UNI10_PROFILE
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::string ProfileData::str()const{
+  std::ostringstream os;
+  if(!enabled()){
+    os<<"Operation counters are disabled, rebuild with -DBUILD_PROFILING=ON\n";
+    return os.str();
+  }
+  os<<std::setw(10)<<std::left<<"Operation"<<std::right<<std::setw(12)<<"Calls"<<std::setw(16)<<"Bytes"
+    <<std::setw(16)<<"FLOPs"<<std::setw(14)<<"Time(s)"<<std::endl;
+  for(int i = 0; i < PROF_OP_NUM; i++)
+    if(ops[i].calls)
+      os<<std::setw(10)<<std::left<<opName((profOp)i)<<std::right<<std::setw(12)<<ops[i].calls<<std::setw(16)<<ops[i].bytes
+        <<std::setw(16)<<ops[i].flops<<std::setw(14)<<std::fixed<<std::setprecision(6)<<ops[i].seconds<<std::endl;
+  return os.str();
+}
+
+};	/* namespace uni10 */
@@ -29,11 +29,80 @@
 *
 *****************************************************************************/
 #include <uni10/tools/uni10_tools.h>
+#include <uni10/tools/uni10_tuning.h>
 #include <string.h>
 namespace uni10 {
 
-size_t MEM_USAGE = 0;
-size_t GPU_MEM_USAGE = 0;
+std::atomic<size_t> MEM_USAGE(0);
+std::atomic<size_t> GPU_MEM_USAGE(0);
+
+namespace{
+  // Permutes the elements of a dense tensor on the CPU. The pair of the last input bond and the
+  // input bond that becomes the last output bond is transposed in tiles of tuning().permuteTile,
+  // the other bonds are walked one by one.
+  template<typename T>
+  void permuteDense(const T* src, int bondNum, const int* dims, const int* rsp_outin, T* des){
+    std::vector<size_t> srcAcc(bondNum), desAcc(bondNum), newAcc(bondNum);
+    srcAcc[bondNum - 1] = 1;
+    newAcc[bondNum - 1] = 1;
+    for(int b = bondNum - 1; b > 0; b--){
+      srcAcc[b - 1] = srcAcc[b] * dims[b];
+      newAcc[b - 1] = newAcc[b] * dims[rsp_outin[b]];
+    }
+    size_t elemNum = srcAcc[0] * dims[0];
+    if(elemNum == 0)
+      return;
+    for(int b = 0; b < bondNum; b++)
+      desAcc[rsp_outin[b]] = newAcc[b];
+    int bin = bondNum - 1;              // contiguous in src
+    int bot = rsp_outin[bondNum - 1];   // contiguous in des
+    std::vector<int> outer;
+    for(int b = 0; b < bondNum; b++)
+      if(b != bin && b != bot)
+        outer.push_back(b);
+    size_t inner = (bin == bot) ? dims[bin] : (size_t)dims[bin] * dims[bot];
+    size_t tile = tuning().permuteTile;
+    std::vector<int> idxs(outer.size(), 0);
+    size_t srcOff = 0, desOff = 0;
+    for(size_t o = 0; o < elemNum / inner; o++){
+      if(bin == bot)
+        memcpy(des + desOff, src + srcOff, dims[bin] * sizeof(T));
+      else{
+        size_t rows = dims[bot], cols = dims[bin];
+        size_t srcLd = srcAcc[bot], desLd = desAcc[bin];
+        for(size_t r0 = 0; r0 < rows; r0 += tile)
+          for(size_t c0 = 0; c0 < cols; c0 += tile){
+            size_t rEnd = std::min(rows, r0 + tile), cEnd = std::min(cols, c0 + tile);
+            for(size_t c = c0; c < cEnd; c++){
+              T* d = des + desOff + c * desLd;
+              const T* s = src + srcOff + c;
+              for(size_t r = r0; r < rEnd; r++)
+                d[r] = s[r * srcLd];
+            }
+          }
+      }
+      for(int k = (int)outer.size() - 1; k >= 0; k--){
+        int b = outer[k];
+        srcOff += srcAcc[b];
+        desOff += desAcc[b];
+        if(++idxs[k] < dims[b])
+          break;
+        srcOff -= srcAcc[b] * dims[b];
+        desOff -= desAcc[b] * dims[b];
+        idxs[k] = 0;
+      }
+    }
+  }
+};
+
+// dims are the dimensions of the input bonds and rsp_outin[b] the input bond at output position b.
+void permuteElem(const double* src, int bondNum, const int* dims, const int* rsp_outin, double* des){
+  permuteDense(src, bondNum, dims, rsp_outin, des);
+}
+
+void permuteElem(const std::complex<double>* src, int bondNum, const int* dims, const int* rsp_outin, std::complex<double>* des){
+  permuteDense(src, bondNum, dims, rsp_outin, des);
+}
 
 std::vector<_Swap> recSwap(std::vector<int>& _ord) { //Given the reshape order out to in.
     //int ordF[n];
@@ -1,4 +1,6 @@
 #include <uni10/tools/uni10_tools.h>
+#include <uni10/tools/uni10_profile.h>
+#include <uni10/tools/uni10_memory.h>
 #include <string.h>
 
 namespace uni10{
@@ -12,6 +14,8 @@ namespace uni10{
       throw std::runtime_error(exception_msg(err.str()));
     }
     MEM_USAGE += memsize;
+    UNI10_PROFILE_COUNT(PROF_ALLOC, memsize);
+    UNI10_MEMORY_ALLOC(ptr, memsize);
     ongpu = false;
     return ptr;
   }
@@ -25,6 +29,8 @@ namespace uni10{
       throw std::runtime_error(exception_msg(err.str()));
     }
     MEM_USAGE += memsize;
+    UNI10_PROFILE_COUNT(PROF_ALLOC, memsize);
+    UNI10_MEMORY_ALLOC(ptr, memsize);
     return ptr;
   }
 
@@ -33,6 +39,7 @@ namespace uni10{
   }
 
   void elemFree(void* ptr, size_t memsize, bool ongpu){
+    UNI10_MEMORY_FREE(ptr);
     free(ptr);
     MEM_USAGE -= memsize;
     ptr = NULL;
@@ -1,4 +1,6 @@
 #include <uni10/tools/uni10_tools.h>
+#include <uni10/tools/uni10_profile.h>
+#include <uni10/tools/uni10_memory.h>
 #include <string.h>
 
 namespace uni10{
@@ -19,6 +21,8 @@ void* elemAlloc(size_t memsize, bool& ongpu){
     ongpu = false;
   }
   //printf("ongpu = %d, GPU_MEM_USAGE = %u, allocate %u\n", ongpu, GPU_MEM_USAGE, memsize);
+  UNI10_PROFILE_COUNT(PROF_ALLOC, memsize);
+  UNI10_MEMORY_ALLOC(ptr, memsize);
   return ptr;
 }
 
@@ -34,6 +38,8 @@ void* elemAllocForce(size_t memsize, bool ongpu){
     assert(ptr != NULL);
     MEM_USAGE += memsize;
   }
+  UNI10_PROFILE_COUNT(PROF_ALLOC, memsize);
+  UNI10_MEMORY_ALLOC(ptr, memsize);
   return ptr;
 }
 
@@ -63,6 +69,7 @@ void* elemCopy(void* des, const void* src, size_t memsize, bool des_ongpu, bool
 
 void elemFree(void* ptr, size_t memsize, bool ongpu){
 	cudaError_t cuflag;
+	UNI10_MEMORY_FREE(ptr);
 	assert(ptr != NULL);
 	if(ongpu){
 		//printf("FREE(%x) %d from GPU, %d used\n", ptr, memsize, GPU_MEM_USAGE);
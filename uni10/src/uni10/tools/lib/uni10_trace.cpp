@@ -0,0 +1,134 @@
+/****************************************************************************
+*  @file uni10_trace.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file for the scoped tracing regions and their Chrome trace export
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/tools/uni10_trace.h>
+#include <uni10/tools/uni10_tools.h>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+namespace uni10{
+
+std::atomic<bool> TRACE_ON(false);
+
+namespace{
+  struct TraceEvent{
+    std::string name;
+    const char* cat;
+    int64_t start;  // ns since TRACE_EPOCH
+    int64_t dur;    // ns
+  };
+
+  // Each thread appends to its own buffer; the registry is only locked when a thread records
+  // its first region and when the buffers are saved or cleared.
+  struct TraceBuffer{
+    int tid;
+    std::vector<TraceEvent> events;
+  };
+
+  std::mutex traceMutex;
+  std::vector<std::unique_ptr<TraceBuffer> > traceBuffers;
+  const std::chrono::steady_clock::time_point TRACE_EPOCH = std::chrono::steady_clock::now();
+  thread_local TraceBuffer* localBuffer = NULL;
+
+  TraceBuffer* threadBuffer(){
+    if(localBuffer == NULL){
+      std::lock_guard<std::mutex> lock(traceMutex);
+      traceBuffers.push_back(std::unique_ptr<TraceBuffer>(new TraceBuffer()));
+      localBuffer = traceBuffers.back().get();
+      localBuffer->tid = traceBuffers.size() - 1;
+    }
+    return localBuffer;
+  }
+
+  std::string jsonEscape(const std::string& str){
+    std::string esc;
+    for(size_t i = 0; i < str.size(); i++){
+      if(str[i] == '"' || str[i] == '\\')
+        esc += '\\';
+      if((unsigned char)str[i] >= 0x20)
+        esc += str[i];
+    }
+    return esc;
+  }
+}
+
+void traceBegin(){
+  TRACE_ON = true;
+}
+
+void traceEnd(){
+  TRACE_ON = false;
+}
+
+void traceRecord(const std::string& name, const char* cat, std::chrono::steady_clock::time_point start,
+    std::chrono::steady_clock::time_point end){
+  TraceBuffer* buf = threadBuffer();
+  TraceEvent ev;
+  ev.name = name;
+  ev.cat = cat;
+  ev.start = std::chrono::duration_cast<std::chrono::nanoseconds>(start - TRACE_EPOCH).count();
+  ev.dur = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+  buf->events.push_back(ev);
+}
+
+void traceSave(const std::string& fname){
+  std::ofstream os(fname.c_str());
+  if(!os){
+    std::ostringstream err;
+    err<<"Error in opening file '" << fname <<"'.";
+    throw std::runtime_error(exception_msg(err.str()));
+  }
+  std::lock_guard<std::mutex> lock(traceMutex);
+  os<<"{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  bool first = true;
+  for(size_t b = 0; b < traceBuffers.size(); b++){
+    const TraceBuffer& buf = *traceBuffers[b];
+    os<<(first ? "\n" : ",\n")<<"{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "<<buf.tid
+      <<", \"args\": {\"name\": \"uni10 thread "<<buf.tid<<"\"}}";
+    first = false;
+    char ts[64];
+    for(size_t e = 0; e < buf.events.size(); e++){
+      const TraceEvent& ev = buf.events[e];
+      snprintf(ts, sizeof(ts), "%.3f, \"dur\": %.3f", ev.start * 1E-3, ev.dur * 1E-3);
+      os<<",\n{\"name\": \""<<jsonEscape(ev.name)<<"\", \"cat\": \""<<jsonEscape(ev.cat)
+        <<"\", \"ph\": \"X\", \"pid\": 1, \"tid\": "<<buf.tid<<", \"ts\": "<<ts<<"}";
+    }
+  }
+  os<<"\n]}\n";
+}
+
+void traceClear(){
+  std::lock_guard<std::mutex> lock(traceMutex);
+  for(size_t b = 0; b < traceBuffers.size(); b++)
+    traceBuffers[b]->events.clear();
+}
+
+};	/* namespace uni10 */
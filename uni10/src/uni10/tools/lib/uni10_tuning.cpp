@@ -0,0 +1,159 @@
+/****************************************************************************
+*  @file uni10_tuning.cpp
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Implementation file for the machine-dependent kernel parameters
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#include <uni10/tools/uni10_tuning.h>
+#include <uni10/tools/uni10_tools.h>
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+namespace uni10{
+
+namespace{
+  // The kernels read the parameters from other threads while setTuning() may replace them. Every
+  // setTuning() publishes a new copy and the old copies are never freed, so that a kernel holding
+  // the reference returned by tuning() keeps reading consistent values.
+  std::atomic<const TuningParams*> currentTuning(NULL);
+  std::mutex publishMutex;
+
+  // values the kernels cannot run with
+  void clampTuning(TuningParams& params){
+    if(params.permuteTile == 0)
+      params.permuteTile = 1;
+  }
+
+  void publishTuning(const TuningParams& params){
+    static std::deque<TuningParams> published;
+    std::lock_guard<std::mutex> lock(publishMutex);
+    published.push_back(params);
+    clampTuning(published.back());
+    currentTuning.store(&published.back(), std::memory_order_release);
+  }
+
+  void loadStartupTuning(){
+    const char* env = getenv("UNI10_TUNING");
+    std::string fname = env ? env : defaultTuningFile();
+    TuningParams params;
+    if(!fname.empty() && std::ifstream(fname.c_str())){
+      try{
+        params = loadTuning(fname);
+      }
+      catch(const std::exception& e){
+        std::cerr << e.what() << "\nThe default kernel parameters are used.\n";
+      }
+    }
+    publishTuning(params);
+  }
+
+  std::once_flag startupFlag;
+};
+
+TuningParams::TuningParams(): gemmSmallCutoff(512), permuteTile(32), vectorParallelMin(1 << 18){}
+
+std::string TuningParams::str()const{
+  std::ostringstream os;
+  os << "gemm_small_cutoff " << gemmSmallCutoff << "\n";
+  os << "permute_tile " << permuteTile << "\n";
+  os << "vector_parallel_min " << vectorParallelMin << "\n";
+  return os.str();
+}
+
+const TuningParams& tuning(){
+  std::call_once(startupFlag, loadStartupTuning);
+  return *currentTuning.load(std::memory_order_acquire);
+}
+
+void setTuning(const TuningParams& params){
+  std::call_once(startupFlag, loadStartupTuning);
+  publishTuning(params);
+}
+
+TuningParams loadTuning(const std::string& fname){
+  TuningParams params;
+  try{
+    std::ifstream in(fname.c_str());
+    if(!in){
+      std::ostringstream err;
+      err<<"Error in opening the tuning profile '" << fname << "'.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    std::string line;
+    for(int lineNo = 1; std::getline(in, line); lineNo++){
+      std::istringstream ls(line);
+      std::string key;
+      if(!(ls >> key) || key[0] == '#')
+        continue;
+      size_t* value = NULL;
+      if(key == "gemm_small_cutoff")
+        value = &params.gemmSmallCutoff;
+      else if(key == "permute_tile")
+        value = &params.permuteTile;
+      else if(key == "vector_parallel_min")
+        value = &params.vectorParallelMin;
+      else
+        continue;
+      if(!(ls >> *value)){
+        std::ostringstream err;
+        err<<"Invalid value of '" << key << "' at line " << lineNo << " of the tuning profile '" << fname << "'.";
+        throw std::runtime_error(exception_msg(err.str()));
+      }
+    }
+    clampTuning(params);
+    params.source = fname;
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function loadTuning(std::string&):");
+  }
+  return params;
+}
+
+void saveTuning(const std::string& fname, const TuningParams& params){
+  try{
+    std::ofstream out(fname.c_str());
+    if(!out){
+      std::ostringstream err;
+      err<<"Error in writing the tuning profile '" << fname << "'.";
+      throw std::runtime_error(exception_msg(err.str()));
+    }
+    out << "# uni10 tuning profile, written by uni10-autotune\n" << params.str();
+  }
+  catch(const std::exception& e){
+    propogate_exception(e, "In function saveTuning(std::string&, uni10::TuningParams&):");
+  }
+}
+
+std::string defaultTuningFile(){
+  const char* home = getenv("HOME");
+  return home ? std::string(home) + "/.uni10/tuning" : std::string();
+}
+
+};	/* namespace uni10 */
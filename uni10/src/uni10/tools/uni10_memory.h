@@ -0,0 +1,111 @@
+/****************************************************************************
+*  @file uni10_memory.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file for the allocation tracking memory profiler
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef UNI10_MEMORY_H
+#define UNI10_MEMORY_H
+#include <atomic>
+#include <string>
+#include <vector>
+namespace uni10{
+
+extern std::atomic<bool> MEMTRACK_ON;
+
+/// @brief Memory held by the allocations of one call site
+struct MemorySite{
+  std::string site;   ///< Call site, e.g. "launch H > ((W1 U) Ob) > contract"
+  size_t bytes;       ///< Bytes allocated at the site and alive
+  size_t count;       ///< Number of allocations alive
+};
+
+/// @brief Live allocations and those alive at the high-water mark, grouped by call site
+struct MemorySnapshot{
+  size_t liveBytes;                 ///< Bytes currently alive
+  size_t peakBytes;                 ///< High-water mark of the tracked bytes
+  std::vector<MemorySite> live;     ///< Sites of the allocations alive now, largest first
+  std::vector<MemorySite> peak;     ///< Sites of the allocations alive at the high-water mark, largest first
+  /// @brief Report of the high-water mark, listing the \c maxSites largest sites
+  std::string str(size_t maxSites = 10)const;
+};
+
+/// @brief Starts tracking the element allocations
+///
+/// Every allocation made while tracking is attributed to its call site, the nesting of the
+/// Network::launch, the Network node, the operation (permute, contract, svd, ...) and the name of
+/// the tensor being allocated. User code can add its own levels with MemoryScope. Allocations made
+/// before memoryTrackBegin() are not tracked. Requires uni10 built with \c BUILD_PROFILING.
+/// \code
+/// memoryTrackBegin();
+/// UniTensor H = net.launch("H");
+/// std::cout << memorySnapshot().str();
+/// memoryTrackEnd();
+/// \endcode
+void memoryTrackBegin();
+
+/// @brief Stops tracking and forgets the live allocations. The high-water mark is kept.
+void memoryTrackEnd();
+
+/// @brief \c true between memoryTrackBegin() and memoryTrackEnd()
+inline bool isMemoryTracking(){
+  return MEMTRACK_ON.load(std::memory_order_relaxed);
+}
+
+/// @brief Live allocations and the allocations alive at the high-water mark
+MemorySnapshot memorySnapshot();
+
+/// @brief Restarts the high-water mark from the bytes alive now
+void memoryResetPeak();
+
+/// @brief Registers an allocation of \c bytes at the current call site of the calling thread
+void memoryTrackAlloc(const void* ptr, size_t bytes);
+/// @brief Unregisters an allocation, ignored if \c ptr is not tracked
+void memoryTrackFree(const void* ptr);
+
+/// @brief Adds a level to the call site of the allocations of the calling thread, for as long as the object lives
+class MemoryScope{
+  public:
+    explicit MemoryScope(const std::string& site);
+    ~MemoryScope();
+  private:
+    bool active;
+};
+
+};  /* namespace uni10 */
+
+/// Allocation tracking inside the library compiles to nothing without UNI10_PROFILE.
+#ifdef UNI10_PROFILE
+#define UNI10_MEMORY_SCOPE(var, site) uni10::MemoryScope var(uni10::isMemoryTracking() ? std::string(site) : std::string())
+#define UNI10_MEMORY_ALLOC(ptr, bytes) if(uni10::isMemoryTracking()) uni10::memoryTrackAlloc(ptr, bytes)
+#define UNI10_MEMORY_FREE(ptr) if(uni10::isMemoryTracking()) uni10::memoryTrackFree(ptr)
+#else
+#define UNI10_MEMORY_SCOPE(var, site)
+#define UNI10_MEMORY_ALLOC(ptr, bytes)
+#define UNI10_MEMORY_FREE(ptr)
+#endif
+
+#endif /* UNI10_MEMORY_H */
@@ -0,0 +1,133 @@
+/****************************************************************************
+*  @file uni10_profile.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file for the hot-path profiling counters
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef UNI10_PROFILE_H
+#define UNI10_PROFILE_H
+#include <cstdint>
+#include <string>
+#include <chrono>
+#include <uni10/tools/uni10_trace.h>
+#include <uni10/tools/uni10_memory.h>
+namespace uni10{
+
+/// @brief Operations counted by the profiler
+enum profOp{
+  PROF_PERMUTE = 0, ///< UniTensor::permute
+  PROF_CONTRACT,    ///< contract() and the dense path of Network::launch
+  PROF_ALLOC,       ///< Element allocations
+  PROF_SVD,         ///< Singular value decompositions
+  PROF_EIG,         ///< General eigenvalue decompositions
+  PROF_EIGH,        ///< Symmetric/Hermitian eigenvalue decompositions
+  PROF_QR,          ///< QR, RQ, LQ and QL decompositions
+  PROF_COPY,        ///< Copy construction and assignment of UniTensor and Matrix
+  PROF_RTOC,        ///< Real to complex promotions
+  PROF_GEMM,        ///< Matrix-matrix products, also those inside contractions
+  PROF_OP_NUM
+};
+
+/// @brief Counters accumulated for one operation
+struct OpProfile{
+  size_t calls;     ///< Number of calls
+  size_t bytes;     ///< Bytes of elements processed, or allocated for PROF_ALLOC
+  uint64_t flops;   ///< Floating point operations, counted for contractions
+  double seconds;   ///< Wall time spent in the operation, including nested operations
+};
+
+/// @brief Snapshot of the profiling counters
+///
+/// The counters are cumulative; the cost of a region is the difference of the snapshots taken
+/// before and after it, or the snapshot after the region if the counters are reset before it.
+/// \code
+/// ProfileData before = UniTensor::profileData();
+/// net.launch();
+/// ProfileData cost = UniTensor::profileData() - before;
+/// size_t flops = cost[PROF_CONTRACT].flops;
+/// \endcode
+class ProfileData{
+  public:
+    ProfileData();
+    const OpProfile& operator[](profOp op)const;
+    /// @brief Counters accumulated since the snapshot \c prev
+    ProfileData operator-(const ProfileData& prev)const;
+    /// @brief Table of the counters, one row per operation with at least one call
+    std::string str()const;
+    /// @brief Name of the operation as printed by str()
+    static const char* opName(profOp op);
+    /// @brief \c true if uni10 was built with the counters (cmake -DBUILD_PROFILING=ON)
+    static bool enabled();
+    OpProfile ops[PROF_OP_NUM];
+};
+
+/// @brief Adds one call of \c op to the counters. Thread-safe and lock-free.
+void profileAdd(profOp op, size_t bytes, uint64_t flops, double seconds);
+/// @brief Current value of the counters
+ProfileData profileSnapshot();
+/// @brief Sets all counters to zero
+void profileReset();
+
+/// @brief Times an operation for as long as the object lives
+///
+/// While tracing (see traceBegin()) the operation is also recorded as a region named after the operation,
+/// and while tracking memory (see memoryTrackBegin()) it is a level of the call site of the allocations.
+class ProfileScope{
+  public:
+    ProfileScope(profOp _op, size_t _bytes = 0, uint64_t _flops = 0):
+      op(_op), bytes(_bytes), flops(_flops), traced(isTracing()),
+      site(isMemoryTracking() ? std::string(ProfileData::opName(_op)) : std::string()), start(std::chrono::steady_clock::now()){}
+    ~ProfileScope(){
+      std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+      profileAdd(op, bytes, flops, std::chrono::duration<double>(end - start).count());
+      if(traced)
+        traceRecord(ProfileData::opName(op), "uni10", start, end);
+    }
+    void addBytes(size_t _bytes){bytes += _bytes;}
+    void addFlops(uint64_t _flops){flops += _flops;}
+  private:
+    profOp op;
+    size_t bytes;
+    uint64_t flops;
+    bool traced;
+    MemoryScope site;
+    std::chrono::steady_clock::time_point start;
+};
+
+};  /* namespace uni10 */
+
+/// The library is instrumented through these macros, which compile to nothing without UNI10_PROFILE.
+#ifdef UNI10_PROFILE
+#define UNI10_PROFILE_SCOPE(var, op, bytes) uni10::ProfileScope var(op, bytes)
+#define UNI10_PROFILE_FLOPS(var, flops) var.addFlops(flops)
+#define UNI10_PROFILE_COUNT(op, bytes) uni10::profileAdd(op, bytes, 0, 0)
+#else
+#define UNI10_PROFILE_SCOPE(var, op, bytes)
+#define UNI10_PROFILE_FLOPS(var, flops)
+#define UNI10_PROFILE_COUNT(op, bytes)
+#endif
+
+#endif /* UNI10_PROFILE_H */
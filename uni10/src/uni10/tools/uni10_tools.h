@@ -39,11 +39,14 @@
 #include <locale>
 #include <sstream>
 #include <complex>
+#include <atomic>
+#include <exception>
+#include <thread>
 #include <uni10/data-structure/uni10_struct.h>
 namespace uni10{
 
-extern size_t MEM_USAGE;
-extern size_t GPU_MEM_USAGE;
+extern std::atomic<size_t> MEM_USAGE;
+extern std::atomic<size_t> GPU_MEM_USAGE;
 
 const size_t UNI10_GPU_GLOBAL_MEM = ((size_t)5) * 1<<30;
 const int UNI10_THREADMAX = 1024;
@@ -67,8 +70,64 @@ double getElemAt(size_t idx, double* elem, bool ongpu);
 void setElemAt(size_t idx, double val, double* elem, bool ongpu);
 void propogate_exception(const std::exception& e, const std::string& func_msg);
 std::string exception_msg(const std::string& msg);
+
+/// @brief Calls <tt>f(begin, end)</tt> on contiguous chunks of <tt>[0, N)</tt>, one per thread when every
+/// thread gets at least \c grain elements; a \c grain of 0 runs everything on the calling thread
+template<typename F>
+void parallelRange(size_t N, size_t grain, F f){
+  size_t threadNum = grain ? std::min((size_t)std::max(1u, std::thread::hardware_concurrency()), N / grain) : 1;
+  if(threadNum <= 1){
+    f((size_t)0, N);
+    return;
+  }
+  size_t chunk = ((N + threadNum - 1) / threadNum + 7) / 8 * 8;    // whole cache lines of doubles
+  std::vector<std::thread> pool;
+  for(size_t begin = chunk; begin < N; begin += chunk)
+    pool.push_back(std::thread(f, begin, std::min(N, begin + chunk)));
+  f((size_t)0, std::min(N, chunk));
+  for(size_t t = 0; t < pool.size(); t++)
+    pool[t].join();
+}
+
+/// @brief Threads for \c num independent tasks: \c threads, 0 for one per core, but no more than the tasks
+/// and, if their total \c cost in multiply-adds is given, than one per \c grain multiply-adds
+inline size_t taskThreads(int threads, size_t num, double cost = 0, double grain = 1 << 18){
+  size_t threadNum = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+  threadNum = std::min(threadNum, num);
+  if(cost > 0)
+    threadNum = std::min(threadNum, (size_t)(cost / grain));
+  return std::max((size_t)1, threadNum);
+}
+
+/// @brief Calls <tt>task(k, t)</tt> for every \c k of <tt>[0, num)</tt> on \c threadNum threads, the calling
+/// thread included, which take the next \c k until none is left; \c t is the index of the thread, e.g. of
+/// its own buffers. The first exception of a task is rethrown once all the threads are done.
+template<typename Task>
+void parallelTasks(size_t num, size_t threadNum, Task task){
+  std::atomic<size_t> next(0);
+  std::vector<std::exception_ptr> errors(std::max((size_t)1, threadNum));
+  auto worker = [&](size_t t){
+    try{
+      for(size_t k = next++; k < num; k = next++)
+        task(k, t);
+    }
+    catch(...){
+      errors[t] = std::current_exception();
+    }
+  };
+  std::vector<std::thread> pool;
+  for(size_t t = 1; t < threadNum; t++)
+    pool.push_back(std::thread(worker, t));
+  worker(0);
+  for(size_t t = 0; t < pool.size(); t++)
+    pool[t].join();
+  for(size_t t = 0; t < errors.size(); t++)
+    if(errors[t])
+      std::rethrow_exception(errors[t]);
+}
 double elemMax(double *elem, size_t ElemNum, bool ongpu);
 double elemAbsMax(double *elem, size_t ElemNum, bool ongpu);
+void permuteElem(const double* src, int bondNum, const int* dims, const int* rsp_outin, double* des);
 /***** Complex version *****/
 std::complex<double> getElemAt(size_t idx, std::complex<double>* elem, bool ongpu);
 void setElemAt(size_t idx, std::complex<double> val, std::complex<double>* elem, bool ongpu);
@@ -78,6 +137,7 @@ void elemCast(double *des, std::complex<double> *src, size_t N, bool des_ongpu,
 void setDiag(std::complex<double>* elem, std::complex<double>* diag_elem, size_t M, size_t N, size_t diag_N, bool ongpu, bool diag_ongpu);
 void getDiag(std::complex<double>* elem, std::complex<double>* diag_elem, size_t M, size_t N, size_t diag_N, bool ongpu, bool diag_ongpu);
 void reshapeElem(std::complex<double>* oldElem, int bondNum, size_t elemNum, size_t* offset, std::complex<double>* newElem);
+void permuteElem(const std::complex<double>* src, int bondNum, const int* dims, const int* rsp_outin, std::complex<double>* des);
 
 // trim from start
 static inline std::string &ltrim(std::string &s) {
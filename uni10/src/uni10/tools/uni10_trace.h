@@ -0,0 +1,107 @@
+/****************************************************************************
+*  @file uni10_trace.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file for the scoped tracing regions and their Chrome trace export
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef UNI10_TRACE_H
+#define UNI10_TRACE_H
+#include <atomic>
+#include <chrono>
+#include <string>
+namespace uni10{
+
+extern std::atomic<bool> TRACE_ON;
+
+/// @brief Starts recording tracing regions
+///
+/// Regions are recorded by TraceScope objects, which uni10 places around permute, contract, the
+/// decompositions, the nodes of Network::launch and save/load (when built with \c BUILD_PROFILING),
+/// and which user code can add around its own work:
+/// \code
+/// traceBegin();
+/// for(int sweep = 0; sweep < 10; sweep++){
+///   TraceScope scope("sweep");
+///   ...
+/// }
+/// traceEnd();
+/// traceSave("sweeps.json");   // open in chrome://tracing or ui.perfetto.dev
+/// \endcode
+void traceBegin();
+
+/// @brief Stops recording tracing regions. The recorded regions are kept until traceClear().
+void traceEnd();
+
+/// @brief \c true between traceBegin() and traceEnd()
+inline bool isTracing(){
+  return TRACE_ON.load(std::memory_order_relaxed);
+}
+
+/// @brief Writes the recorded regions of all threads as Chrome trace JSON
+///
+/// Must not be called while other threads are still recording.
+/// @param fname Output file
+void traceSave(const std::string& fname);
+
+/// @brief Discards the recorded regions. Must not be called while other threads are still recording.
+void traceClear();
+
+/// @brief Records a region of the calling thread, appended to a per-thread buffer without locking
+void traceRecord(const std::string& name, const char* cat, std::chrono::steady_clock::time_point start,
+    std::chrono::steady_clock::time_point end);
+
+/// @brief Records the lifetime of the object as a region of the calling thread
+///
+/// Costs a single flag check when tracing is off.
+class TraceScope{
+  public:
+    explicit TraceScope(const std::string& _name, const char* _cat = "user"): active(isTracing()), cat(_cat){
+      if(active){
+        name = _name;
+        start = std::chrono::steady_clock::now();
+      }
+    }
+    ~TraceScope(){
+      if(active)
+        traceRecord(name, cat, start, std::chrono::steady_clock::now());
+    }
+  private:
+    bool active;
+    std::string name;
+    const char* cat;
+    std::chrono::steady_clock::time_point start;
+};
+
+};  /* namespace uni10 */
+
+/// Tracing regions inside the library compile to nothing without UNI10_PROFILE.
+#ifdef UNI10_PROFILE
+#define UNI10_TRACE_SCOPE(var, name, cat) uni10::TraceScope var(name, cat)
+#else
+#define UNI10_TRACE_SCOPE(var, name, cat)
+#endif
+
+#endif /* UNI10_TRACE_H */
@@ -0,0 +1,81 @@
+/****************************************************************************
+*  @file uni10_tuning.h
+*  @license
+*    Universal Tensor Network Library
+*    Copyright (c) 2013-2016
+*    National Taiwan University
+*    National Tsing-Hua University
+*
+*    This file is part of Uni10, the Universal Tensor Network Library.
+*
+*    Uni10 is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU Lesser General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Uni10 is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Lesser General Public License for more details.
+*
+*    You should have received a copy of the GNU Lesser General Public License
+*    along with Uni10.  If not, see <http://www.gnu.org/licenses/>.
+*  @endlicense
+*  @brief Header file for the machine-dependent kernel parameters
+*  @author Ying-Jer Kao
+*  @date 2016-06-06
+*  @since 1.0.0
+*
+*****************************************************************************/
+#ifndef UNI10_TUNING_H
+#define UNI10_TUNING_H
+#include <string>
+namespace uni10{
+
+/// @brief Machine-dependent kernel parameters
+///
+/// The defaults suit a typical x86-64 workstation. The parameters of a machine are measured by the
+/// \c uni10-autotune program, which writes them to a tuning profile, read by uni10 the first time
+/// a kernel asks for them (see tuning()).
+struct TuningParams{
+  TuningParams();
+  /// Products \c M*N*K below which matrixMul uses the built-in loop instead of BLAS, 0 always uses BLAS
+  size_t gemmSmallCutoff;
+  /// Edge in elements of the tiles of the transposition in the permutation of non-symmetric tensors
+  size_t permuteTile;
+  /// Elements per thread from which the element-wise vector kernels run on several threads, 0 never
+  size_t vectorParallelMin;
+  /// Profile the parameters were loaded from, empty for the defaults
+  std::string source;
+  /// @brief Parameters in the format of the tuning profile
+  std::string str()const;
+};
+
+/// @brief The parameters in use
+///
+/// On the first call the tuning profile is read from the file named by the environment variable
+/// \c UNI10_TUNING, or from defaultTuningFile() if it is not set. Without a profile the defaults of
+/// TuningParams are used. The reference stays valid after setTuning(), it keeps the parameters
+/// in use at the time of the call.
+const TuningParams& tuning();
+
+/// @brief Replaces the parameters in use
+///
+/// Safe to call while kernels run on other threads, they see either the old or the new parameters.
+/// A \c permuteTile of 0 is raised to 1, as in loadTuning().
+void setTuning(const TuningParams& params);
+
+/// @brief Reads a tuning profile, keys missing in the file keep their default value
+///
+/// The profile has one <tt>key value</tt> pair per line, lines starting with \c # are comments
+/// and unknown keys are ignored so that profiles of other versions of uni10 remain readable.
+TuningParams loadTuning(const std::string& fname);
+
+/// @brief Writes \c params to the tuning profile \c fname
+void saveTuning(const std::string& fname, const TuningParams& params);
+
+/// @brief <tt>$HOME/.uni10/tuning</tt>
+std::string defaultTuningFile();
+
+};	/* namespace uni10 */
+#endif /* UNI10_TUNING_H */
@@ -0,0 +1,197 @@
+//
+//  testBoundaryMPS.cpp
+//
+//
+//  Created by Ying-Jer Kao on 6/6/16.
+//
+//
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "uni10.hpp"
+using namespace uni10;
+
+namespace{
+  const int PHYS = 1000;
+
+  // The state of a small PEPS as a single tensor with the physical bonds PHYS + r * cols + c
+  UniTensor exactState(const PEPS& peps){
+    size_t rows = peps.rows(), cols = peps.cols();
+    int horizontal = 0, vertical = 500;
+    UniTensor psi;
+    for(size_t r = 0; r < rows; r++)
+      for(size_t c = 0; c < cols; c++){
+        int label[] = {horizontal + (int)(r * (cols + 1) + c), vertical + (int)(r * cols + c), PHYS + (int)(r * cols + c),
+          horizontal + (int)(r * (cols + 1) + c + 1), vertical + (int)((r + 1) * cols + c)};
+        UniTensor A(peps(r, c));
+        A.setLabel(label);
+        if(r == 0 && c == 0)
+          psi = A;
+        else
+          psi = contract(psi, A, true);
+      }
+    return psi;
+  }
+
+  Real overlap(const UniTensor& bra, const UniTensor& ket){
+    UniTensor B(bra), K(ket);
+    return contract(B, K, true).getElem()[0];
+  }
+
+  // op acting on the physical bonds of the sites, which have the labels sites, of psi
+  UniTensor applied(const UniTensor& psi, const Matrix& op, const std::vector<int>& sites, int d){
+    std::vector<Bond> bonds(sites.size(), Bond(BD_IN, d));
+    bonds.insert(bonds.end(), sites.size(), Bond(BD_OUT, d));
+    UniTensor O(bonds);
+    O.putBlock(op);
+    std::vector<int> label;
+    for(size_t i = 0; i < sites.size(); i++)
+      label.push_back(-1 - (int)i);
+    label.insert(label.end(), sites.begin(), sites.end());
+    O.setLabel(label);
+    UniTensor K(psi);
+    K = contract(K, O, true);
+    std::vector<int> out = K.label();
+    for(size_t i = 0; i < out.size(); i++)
+      if(out[i] < 0)
+        out[i] = sites[-1 - out[i]];
+    K.setLabel(out);
+    return K;
+  }
+
+  Real exactExpectation(const UniTensor& psi, const Matrix& op, const std::vector<int>& sites, int d){
+    return overlap(psi, applied(psi, op, sites, d)) / overlap(psi, psi);
+  }
+
+  Matrix sz(){
+    Real elem[] = {1, 0, 0, -1};
+    return Matrix(2, 2, elem);
+  }
+
+  Matrix sx(){
+    Real elem[] = {0, 1, 1, 0};
+    return Matrix(2, 2, elem);
+  }
+
+  // A two-site operator that is not symmetric under the exchange of the sites
+  Matrix bondOperator(){
+    Real a[] = {0.3, 1.2, -0.7, 0.5};
+    Matrix A(2, 2, a);
+    Matrix op(4, 4);
+    op.set_zero();
+    for(int i = 0; i < 2; i++)
+      for(int j = 0; j < 2; j++)
+        for(int k = 0; k < 2; k++)
+          for(int l = 0; l < 2; l++)
+            op.at(i * 2 + k, j * 2 + l) = A.at(i, j) * sz().at(k, l) + (i == j ? sx().at(k, l) : 0);
+    return op;
+  }
+};
+
+TEST(BoundaryMPS, NormAndLocalExpectations){
+  PEPS peps(3, 3, 2, 2);
+  UniTensor psi = exactState(peps);
+  BoundaryMPS bmps(peps);
+  EXPECT_NEAR(bmps.logNorm(), std::log(overlap(psi, psi)), 1E-10);
+  for(size_t r = 0; r < 3; r++){
+    std::vector<Real> mz = bmps.expectations(r, sz());
+    ASSERT_EQ(mz.size(), 3);
+    for(size_t c = 0; c < 3; c++){
+      Real exact = exactExpectation(psi, sz(), std::vector<int>(1, PHYS + (int)(r * 3 + c)), 2);
+      EXPECT_NEAR(mz[c], exact, 1E-10);
+      EXPECT_NEAR(bmps.expectation(r, c, sx()), exactExpectation(psi, sx(), std::vector<int>(1, PHYS + (int)(r * 3 + c)), 2), 1E-10);
+    }
+  }
+  EXPECT_LT(bmps.discarded(), 1E-20);
+}
+
+TEST(BoundaryMPS, BondExpectations){
+  PEPS peps(3, 4, 2, 2);
+  UniTensor psi = exactState(peps);
+  BoundaryMPS bmps(peps);
+  std::vector<int> sites(2);
+  for(size_t r = 0; r < 3; r++)
+    for(size_t c = 0; c + 1 < 4; c++){
+      sites[0] = PHYS + (int)(r * 4 + c);
+      sites[1] = sites[0] + 1;
+      EXPECT_NEAR(bmps.bondExpectation(r, c, bondOperator()), exactExpectation(psi, bondOperator(), sites, 2), 1E-10);
+    }
+  // the vertical bonds are the horizontal bonds of the transpose
+  PEPS transposed = peps.transpose();
+  BoundaryMPS vertical(transposed);
+  for(size_t c = 0; c < 4; c++)
+    for(size_t r = 0; r + 1 < 3; r++){
+      sites[0] = PHYS + (int)(r * 4 + c);
+      sites[1] = sites[0] + 4;
+      EXPECT_NEAR(vertical.bondExpectation(c, r, bondOperator()), exactExpectation(psi, bondOperator(), sites, 2), 1E-10);
+    }
+  EXPECT_NEAR(vertical.logNorm(), bmps.logNorm(), 1E-10);
+}
+
+TEST(BoundaryMPS, ProductState){
+  std::vector<Real> local(2);
+  local[0] = 0.6;
+  local[1] = 0.8;
+  PEPS peps = PEPS::product(4, 3, local);
+  BoundaryParams params;
+  params.maxChi = 1;
+  BoundaryMPS bmps(peps, params);
+  EXPECT_NEAR(bmps.norm(), 1, 1E-12);
+  std::vector<Real> mz = bmps.expectations(2, sz());
+  for(size_t c = 0; c < mz.size(); c++)
+    EXPECT_NEAR(mz[c], 0.36 - 0.64, 1E-12);
+  Real zz[16] = {0};
+  for(int i = 0; i < 4; i++)
+    zz[i * 5] = (i == 0 || i == 3) ? 1 : -1;
+  EXPECT_NEAR(bmps.bondExpectation(3, 1, Matrix(4, 4, zz)), 0.28 * 0.28, 1E-12);
+}
+
+TEST(BoundaryMPS, CachedBoundaries){
+  PEPS peps(4, 3, 2, 2);
+  BoundaryMPS bmps(peps);
+  bmps.expectations(1, sz());
+  size_t absorbed = bmps.absorptions();
+  EXPECT_EQ(absorbed, 3);   // rows 0 from the top, 3 and 2 from the bottom
+  bmps.expectations(1, sx());
+  bmps.expectation(1, 2, sz());
+  EXPECT_EQ(bmps.absorptions(), absorbed);
+  bmps.expectations(2, sz());   // one more row from the top
+  EXPECT_EQ(bmps.absorptions(), absorbed + 1);
+
+  PEPS changed(4, 3, 2, 2);
+  peps.setSite(2, 1, changed(2, 1));
+  bmps.invalidate(2);
+  std::vector<Real> mz = bmps.expectations(1, sz());
+  UniTensor psi = exactState(peps);
+  for(size_t c = 0; c < 3; c++)
+    EXPECT_NEAR(mz[c], exactExpectation(psi, sz(), std::vector<int>(1, PHYS + 3 + (int)c), 2), 1E-10);
+}
+
+TEST(BoundaryMPS, TruncatedBoundaries){
+  // with the bond dimension of the boundaries below the exact one, the variational sweeps improve on the
+  // zip-up alone
+  PEPS peps(6, 6, 2, 3);
+  BoundaryParams zipUp, fitted;
+  zipUp.maxChi = fitted.maxChi = 6;
+  zipUp.sweeps = 0;
+  fitted.sweeps = 2;
+  BoundaryMPS exact(peps), a(peps, zipUp), b(peps, fitted);
+  std::vector<Real> ref = exact.expectations(3, sz()), ma = a.expectations(3, sz()), mb = b.expectations(3, sz());
+  Real errA = 0, errB = 0;
+  for(size_t c = 0; c < 6; c++){
+    errA += std::fabs(ma[c] - ref[c]);
+    errB += std::fabs(mb[c] - ref[c]);
+  }
+  EXPECT_GT(a.discarded(), 0);
+  EXPECT_LT(errA, 1E-2);
+  EXPECT_LT(errB, errA);
+  EXPECT_LT(std::fabs(exact.logNorm() - b.logNorm()), std::fabs(exact.logNorm() - a.logNorm()));
+}
+
+TEST(BoundaryMPS, Errors){
+  PEPS peps(2, 2, 2, 2);
+  BoundaryMPS bmps(peps);
+  EXPECT_THROW(bmps.expectation(2, 0, sz()), std::exception);
+  EXPECT_THROW(bmps.bondExpectation(0, 1, bondOperator()), std::exception);
+  EXPECT_THROW(bmps.expectation(0, 0, bondOperator()), std::exception);
+}
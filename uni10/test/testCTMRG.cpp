@@ -0,0 +1,151 @@
+//
+//  testCTMRG.cpp
+//
+//
+//  Created by Ying-Jer Kao on 6/6/16.
+//
+//
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "uni10.hpp"
+using namespace uni10;
+
+namespace{
+  // Weights of the classical Ising model on the square lattice in the eigenbasis of the bond weights,
+  // nonzero for an even number of odd bond states. With weight set, the right bond carries the energy
+  // of the bond instead, so that the ratio of the two networks is <s_i s_j>.
+  std::vector<Real> isingElem(Real beta, bool weight){
+    Real lambda[] = {2 * std::cosh(beta), 2 * std::sinh(beta)};
+    Real energy[] = {std::tanh(beta), 1 / std::tanh(beta)};
+    std::vector<Real> elem(16, 0);
+    for(int l = 0; l < 2; l++)
+      for(int u = 0; u < 2; u++)
+        for(int r = 0; r < 2; r++)
+          for(int d = 0; d < 2; d++)
+            if((l + u + r + d) % 2 == 0)
+              elem[((l * 2 + u) * 2 + r) * 2 + d] = std::sqrt(lambda[l] * lambda[u] * lambda[r] * lambda[d]) / 2
+                * (weight ? energy[r] : 1);
+    return elem;
+  }
+
+  UniTensor isingTensor(Real beta, bool symmetric, bool weight = false){
+    std::vector<Bond> bonds;
+    if(symmetric){
+      std::vector<Qnum> qnums;
+      qnums.push_back(Qnum(0, PRT_EVEN));
+      qnums.push_back(Qnum(0, PRT_ODD));
+      bonds.push_back(Bond(BD_IN, qnums));
+      bonds.push_back(Bond(BD_IN, qnums));
+      bonds.push_back(Bond(BD_OUT, qnums));
+      bonds.push_back(Bond(BD_OUT, qnums));
+    }
+    else{
+      bonds.push_back(Bond(BD_IN, 2));
+      bonds.push_back(Bond(BD_IN, 2));
+      bonds.push_back(Bond(BD_OUT, 2));
+      bonds.push_back(Bond(BD_OUT, 2));
+    }
+    UniTensor a(bonds);
+    a.setRawElem(isingElem(beta, weight));
+    return a;
+  }
+
+  // Two uncoupled Ising layers at beta1 and beta2 on bonds of dimension four, the weight on the first one
+  UniTensor isingLayers(Real beta1, Real beta2, bool weight = false){
+    std::vector<Real> e1 = isingElem(beta1, weight), e2 = isingElem(beta2, false);
+    std::vector<Real> elem(256);
+    for(int i = 0; i < 16; i++)
+      for(int j = 0; j < 16; j++){
+        int idx = 0;
+        for(int b = 3; b >= 0; b--)
+          idx = idx * 4 + ((i >> b) & 1) * 2 + ((j >> b) & 1);
+        elem[idx] = e1[i] * e2[j];
+      }
+    std::vector<Bond> bonds(2, Bond(BD_IN, 4));
+    bonds.resize(4, Bond(BD_OUT, 4));
+    UniTensor a(bonds);
+    a.setRawElem(elem);
+    return a;
+  }
+
+  // Onsager's nearest neighbour correlation of the square lattice Ising model
+  Real isingCorrelation(Real beta){
+    Real k = 2 * std::sinh(2 * beta) / std::pow(std::cosh(2 * beta), 2);
+    Real x = 1, y = std::sqrt(1 - k * k);
+    for(int i = 0; i < 40; i++){
+      Real m = (x + y) / 2;
+      y = std::sqrt(x * y);
+      x = m;
+    }
+    Real K = M_PI / (2 * x);
+    Real t = std::tanh(2 * beta);
+    return (1 + 2 / M_PI * (2 * t * t - 1) * K) / (2 * t);
+  }
+};
+
+TEST(CTMRG, IsingCorrelation){
+  Real beta = 0.35;
+  CTMRGParams params;
+  params.maxChi = 16;
+  CTMRG ctm(isingTensor(beta, false), params);
+  ctm.run();
+  EXPECT_TRUE(ctm.converged());
+  EXPECT_LE(ctm.chi(0), 16);
+  EXPECT_GT(ctm.chi(0), 1);
+  EXPECT_NEAR(isingCorrelation(beta), ctm.expectation(isingTensor(beta, false, true)), 1E-8);
+  Matrix s = ctm.cornerSpectrum(0);
+  for(size_t i = 1; i < s.row(); i++)
+    EXPECT_GE(s[i - 1], s[i]);
+}
+
+TEST(CTMRG, Z2Symmetric){
+  Real beta = 0.35;
+  CTMRGParams params;
+  params.maxChi = 16;
+  CTMRG dense(isingTensor(beta, false), params), sym(isingTensor(beta, true), params);
+  dense.run();
+  sym.run();
+  EXPECT_TRUE(sym.converged());
+  // the environment stays block diagonal in the parity
+  EXPECT_EQ(2, sym.corner(0).blockNum());
+  EXPECT_NEAR(isingCorrelation(beta), sym.expectation(isingTensor(beta, true, true)), 1E-8);
+  for(int k = 0; k < 4; k++){
+    Matrix sd = dense.cornerSpectrum(k), ss = sym.cornerSpectrum(k);
+    ASSERT_EQ(sd.row(), ss.row());
+    for(size_t i = 0; i < sd.row(); i++)
+      EXPECT_NEAR(sd[i], ss[i], 1E-8);
+  }
+}
+
+TEST(CTMRG, RandomizedProjectors){
+  // the blocks are much larger than the bonds kept only for bonds of a dimension above two
+  CTMRGParams params;
+  params.maxChi = 12;
+  params.oversampling = 4;
+  CTMRG full(isingLayers(0.3, 0.35), params);
+  params.randomized = true;
+  CTMRG randomized(isingLayers(0.3, 0.35), params);
+  full.run();
+  randomized.run();
+  EXPECT_TRUE(randomized.converged());
+  UniTensor b = isingLayers(0.3, 0.35, true);
+  EXPECT_NEAR(isingCorrelation(0.3), randomized.expectation(b), 1E-6);
+  EXPECT_NEAR(full.expectation(b), randomized.expectation(b), 1E-8);
+}
+
+TEST(CTMRG, ParallelMoves){
+  Real beta = 0.3;
+  CTMRGParams params;
+  params.maxChi = 12;
+  params.threads = 1;
+  CTMRG serial(isingTensor(beta, false), params);
+  params.threads = 2;
+  CTMRG parallel(isingTensor(beta, false), params);
+  for(int n = 0; n < 10; n++)
+    EXPECT_EQ(serial.sweep(), parallel.sweep());
+  EXPECT_EQ(40u, parallel.moves());
+  UniTensor b = isingTensor(beta, false, true);
+  EXPECT_EQ(serial.expectation(b), parallel.expectation(b));
+  EXPECT_THROW(serial.move(4), std::exception);
+}
@@ -0,0 +1,265 @@
+//
+//  testCompression.cpp
+//
+//
+//  Created by Ying-Jer Kao on 6/6/16.
+//
+//
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "uni10.hpp"
+using namespace uni10;
+
+namespace{
+  // The state of a short chain as a single tensor, the physical bonds labelled by their sites
+  UniTensor fullState(const MPS& psi){
+    UniTensor T;
+    for(size_t i = 0; i < psi.size(); i++){
+      int label[] = {100 + (int)i, (int)i, 101 + (int)i};
+      UniTensor A(psi[i]);
+      A.setLabel(label);
+      T = i ? contract(T, A, true) : A;
+    }
+    return T;
+  }
+
+  Real overlap(const UniTensor& a, const UniTensor& b){
+    UniTensor A(a), B(b);
+    return contract(A, B, true).getElem()[0];
+  }
+
+  // W|psi> at the full bond dimension
+  MPS product(const MPO& W, const MPS& psi){
+    std::vector<UniTensor> sites(psi.size());
+    int labelW[] = {1, 2, 3, 4}, labelA[] = {5, 4, 6}, labelOut[] = {1, 2, 3};
+    std::vector<int> left(2), right(2);
+    left[0] = 1;
+    left[1] = 5;
+    right[0] = 3;
+    right[1] = 6;
+    for(size_t i = 0; i < psi.size(); i++){
+      UniTensor Wi(W[i]), Ai(psi[i]);
+      Wi.setLabel(labelW);
+      Ai.setLabel(labelA);
+      sites[i] = contract(Wi, Ai, true);
+      sites[i].combineBond(left);
+      sites[i].combineBond(right);
+      sites[i].permute(labelOut, 2);
+    }
+    return MPS(sites);
+  }
+
+  // ||phi - exact|| / ||exact||
+  Real distance(const MPS& phi, const UniTensor& exact){
+    UniTensor P = fullState(phi);
+    Real pp = overlap(P, P), ee = overlap(exact, exact), pe = overlap(P, exact);
+    return std::sqrt(std::fabs(pp + ee - 2 * pe) / ee);
+  }
+
+  std::vector<Qnum> parities(bool odd){
+    std::vector<Qnum> qnums(1, Qnum(0, PRT_EVEN));
+    if(odd)
+      qnums.push_back(Qnum(0, PRT_ODD));
+    return qnums;
+  }
+
+  // Random parity symmetric MPS and MPO with bonds of two or four states of each parity
+  MPS parityMPS(size_t L){
+    std::vector<UniTensor> sites(L);
+    for(size_t i = 0; i < L; i++){
+      std::vector<Qnum> inner = parities(true);
+      inner.insert(inner.end(), inner.begin(), inner.end());
+      std::vector<Bond> bonds;
+      bonds.push_back(Bond(BD_IN, i ? inner : parities(false)));
+      bonds.push_back(Bond(BD_IN, parities(true)));
+      bonds.push_back(Bond(BD_OUT, i + 1 < L ? inner : parities(false)));
+      sites[i] = UniTensor(bonds);
+      sites[i].randomize();
+    }
+    return MPS(sites);
+  }
+
+  MPO parityMPO(size_t L){
+    std::vector<UniTensor> sites(L);
+    for(size_t i = 0; i < L; i++){
+      std::vector<Bond> bonds;
+      bonds.push_back(Bond(BD_IN, parities(i > 0)));
+      bonds.push_back(Bond(BD_IN, parities(true)));
+      bonds.push_back(Bond(BD_OUT, parities(i + 1 < L)));
+      bonds.push_back(Bond(BD_OUT, parities(true)));
+      sites[i] = UniTensor(bonds);
+      sites[i].randomize();
+    }
+    return MPO(sites);
+  }
+
+  // Random MPS of spins 1/2 at total S_z = 0 and MPO conserving S_z, the quantum numbers are 2 S_z
+  void u1Chain(size_t L, MPS& psi, MPO& W){
+    std::vector<Qnum> edge(1, Qnum(0)), spin, inner, op;
+    spin.push_back(Qnum(1));
+    spin.push_back(Qnum(-1));
+    int sz[] = {-2, 0, 0, 2, 1, -1}, ops[] = {0, 2, -2};
+    for(int i = 0; i < 6; i++)
+      inner.push_back(Qnum(sz[i]));
+    for(int i = 0; i < 3; i++)
+      op.push_back(Qnum(ops[i]));
+    std::vector<UniTensor> A(L), B(L);
+    for(size_t i = 0; i < L; i++){
+      std::vector<Bond> bonds;
+      bonds.push_back(Bond(BD_IN, i ? inner : edge));
+      bonds.push_back(Bond(BD_IN, spin));
+      bonds.push_back(Bond(BD_OUT, i + 1 < L ? inner : edge));
+      A[i] = UniTensor(bonds);
+      A[i].randomize();
+      bonds.clear();
+      bonds.push_back(Bond(BD_IN, i ? op : edge));
+      bonds.push_back(Bond(BD_IN, spin));
+      bonds.push_back(Bond(BD_OUT, i + 1 < L ? op : edge));
+      bonds.push_back(Bond(BD_OUT, spin));
+      B[i] = UniTensor(bonds);
+      B[i].randomize();
+    }
+    psi = MPS(A);
+    W = MPO(B);
+  }
+};
+
+TEST(Compression, BlockTruncatedSvd){
+  std::vector<Qnum> qnums = parities(true);
+  qnums.insert(qnums.end(), qnums.begin(), qnums.end());
+  std::vector<Bond> bonds(2, Bond(BD_IN, qnums));
+  bonds.push_back(Bond(BD_OUT, qnums));
+  UniTensor T(bonds);
+  T.randomize();
+  Real discarded;
+  std::vector<UniTensor> usv = truncatedSvd(T, 100, 0, discarded);
+  int labelU[] = {1, 2, 3}, labelS[] = {3, 4}, labelV[] = {4, 5}, labelT[] = {1, 2, 5};
+  usv[0].setLabel(labelU);
+  usv[1].setLabel(labelS);
+  usv[2].setLabel(labelV);
+  UniTensor R = contract(usv[0], usv[1], true);
+  R = contract(R, usv[2], true);
+  R.permute(labelT, 2);
+  T.setLabel(labelT);
+  EXPECT_EQ(usv[1].bond(0).dim(), 4);
+  EXPECT_EQ(discarded, 0);
+  EXPECT_LT((T + (-1.0) * R).norm(), 1E-12 * T.norm());
+
+  // the largest values of both blocks are kept together
+  std::vector<UniTensor> cut = truncatedSvd(T, 3, 0, discarded);
+  EXPECT_EQ(cut[1].bond(0).dim(), 3);
+  EXPECT_GT(discarded, 0);
+  std::vector<Matrix> even = T.getBlock(Qnum(0, PRT_EVEN)).svd(), odd = T.getBlock(Qnum(0, PRT_ODD)).svd();
+  std::vector<Real> all;
+  for(int i = 0; i < 2; i++){
+    all.push_back(even[1][i]);
+    all.push_back(odd[1][i]);
+  }
+  std::sort(all.begin(), all.end());
+  EXPECT_NEAR(discarded, all[0] * all[0] / (T.norm() * T.norm()), 1E-12);
+}
+
+TEST(Compression, ApplyMPO){
+  size_t L = 8;
+  MPS psi(L, 2, 8);
+  MPO H = MPO::heisenberg(L, 1, 0.7, 0.3);
+  UniTensor exact = fullState(product(H, psi));
+  CompressionParams params;
+  params.cutoff = 0;
+  CompressionInfo info;
+  MPS phi = applyMPO(H, psi, params, &info);
+  EXPECT_EQ(phi.center(), (int)L - 1);
+  EXPECT_LT(distance(phi, exact), 1E-6);   // the square root of the rounding errors
+  EXPECT_LT(info.discarded, 1E-20);
+  EXPECT_GE(info.sweeps, 1);
+
+  // the zip-up alone is exact without truncation too
+  params.sweeps = 0;
+  EXPECT_LT(distance(applyMPO(H, psi, params), exact), 1E-6);
+  EXPECT_LT(distance(applyMPO(H, psi), exact), 1E-5);
+}
+
+TEST(Compression, VariationalSweeps){
+  size_t L = 10;
+  MPS psi(L, 2, 12);
+  MPO H = MPO::transverseIsing(L, 1, 0.8);
+  UniTensor exact = fullState(product(H, psi));
+  CompressionParams params;
+  params.maxChi = 6;
+  params.sweeps = 0;
+  CompressionInfo zipInfo, fitInfo;
+  MPS zip = applyMPO(H, psi, params, &zipInfo);
+  params.sweeps = 8;
+  params.tol = 1E-12;
+  MPS fit = applyMPO(H, psi, params, &fitInfo);
+  for(size_t b = 0; b <= L; b++)
+    EXPECT_LE(fit.bondDim(b), 6);
+  EXPECT_GT(zipInfo.discarded, 0);
+  EXPECT_EQ(zipInfo.sweeps, 0);
+  EXPECT_GT(fitInfo.sweeps, 1);
+  Real errZip = distance(zip, exact), errFit = distance(fit, exact);
+  EXPECT_LT(errFit, errZip);
+  EXPECT_LT(errFit, 0.1);
+}
+
+TEST(Compression, Compress){
+  size_t L = 10;
+  MPS psi(L, 2, 16);
+  UniTensor exact = fullState(psi);
+  EXPECT_LT(distance(compress(psi), exact), 1E-5);
+
+  // the sweeps do at least as well as the truncation of the canonical form alone
+  CompressionParams params;
+  params.maxChi = 4;
+  params.sweeps = 0;
+  Real errSvd = distance(compress(psi, params), exact);
+  params.sweeps = 4;
+  MPS phi = compress(psi, params);
+  EXPECT_EQ(phi.maxBondDim(), 4);
+  EXPECT_LE(distance(phi, exact), errSvd + 1E-12);
+}
+
+TEST(Compression, ParitySymmetric){
+  size_t L = 6;
+  MPS psi = parityMPS(L);
+  MPO W = parityMPO(L);
+  UniTensor exact = fullState(product(W, psi));
+  CompressionParams params;
+  params.cutoff = 0;
+  MPS phi = applyMPO(W, psi, params);
+  EXPECT_LT(distance(phi, exact), 1E-6);
+  // the bonds keep both parities and the sites stay block diagonal
+  EXPECT_EQ(phi[2].bond(2).Qlist().size(), phi[2].bond(2).dim());
+  EXPECT_GT(phi[2].blockQnum().size(), 1);
+  // the norm takes every block of the center into account, the canonical form needs a single block
+  ASSERT_GE(phi.center(), 0);
+  Real nrm = fullState(phi).norm();
+  EXPECT_NEAR(phi.norm(), nrm, 1E-8 * nrm);
+  EXPECT_THROW(phi.moveCenter(phi.center() ? 0 : L - 1), std::exception);
+  EXPECT_THROW(phi.overlap(phi), std::exception);
+  params.maxChi = 4;
+  CompressionInfo info;
+  phi = applyMPO(W, psi, params, &info);
+  EXPECT_LE(phi.maxBondDim(), 4);
+  EXPECT_GT(info.discarded, 0);
+  EXPECT_LT(distance(phi, exact), 0.5);
+}
+
+TEST(Compression, U1Symmetric){
+  MPS psi;
+  MPO W;
+  u1Chain(8, psi, W);
+  UniTensor exact = fullState(product(W, psi));
+  CompressionParams params;
+  params.cutoff = 0;
+  EXPECT_LT(distance(applyMPO(W, psi, params), exact), 1E-6);
+  params.maxChi = 5;
+  params.sweeps = 0;
+  MPS zip = applyMPO(W, psi, params);
+  params.sweeps = 6;
+  MPS fit = applyMPO(W, psi, params);
+  EXPECT_LE(fit.maxBondDim(), 5);
+  EXPECT_LT(distance(fit, exact), distance(zip, exact));
+}
@@ -0,0 +1,102 @@
+//
+//  testDMRG.cpp
+//
+//
+//  Created by Ying-Jer Kao on 6/6/16.
+//
+//
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "uni10.hpp"
+using namespace uni10;
+
+// Ground state energy of the open Heisenberg chain of 10 sites by exact diagonalization
+const Real HEISENBERG_E0_L10 = -4.258035207282883;
+
+TEST(DMRG, Lanczos){
+    size_t dim = 50;
+    Matrix A(dim, dim);
+    A.randomize();
+    Matrix At = A;
+    At.transpose();
+    A = A + At;
+    LinearMap map = [&A, dim](const Real* x, Real* y){
+        for(size_t i = 0; i < dim; i++){
+            y[i] = 0;
+            for(size_t j = 0; j < dim; j++)
+                y[i] += A.at(i, j) * x[j];
+        }
+    };
+    std::vector<Real> psi(dim, 1.0);
+    Real E0;
+    lanczosGroundState(map, dim, &psi[0], E0, 500, 1E-12, 20);
+    std::vector<Matrix> eig = A.eigh();
+    ASSERT_NEAR(E0, eig[0][0], 1E-9);
+}
+
+TEST(DMRG, TruncatedSvd){
+    Matrix M(6, 8);
+    M.randomize();
+    Real discarded;
+    std::vector<Matrix> usv = truncatedSvd(M, 3, 0, discarded);
+    ASSERT_EQ(usv[1].row(), 3);
+    ASSERT_EQ(usv[0].col(), 3);
+    ASSERT_EQ(usv[2].row(), 3);
+    std::vector<Matrix> full = M.svd();
+    Real tail = 0;
+    for(size_t j = 3; j < 6; j++)
+        tail += full[1][j] * full[1][j];
+    ASSERT_NEAR(discarded, tail / (M.norm() * M.norm()), 1E-12);
+    // a loose cutoff keeps fewer values
+    usv = truncatedSvd(M, 6, 0.5, discarded);
+    ASSERT_LT(usv[1].row(), 6);
+    ASSERT_LE(discarded, 0.5);
+}
+
+TEST(DMRG, TwoSiteHeisenberg){
+    size_t L = 10;
+    MPO H = MPO::heisenberg(L);
+    MPS psi(L, 2, 4);
+    DMRGParams params;
+    params.maxChi = 32;
+    DMRG dmrg(psi, H, params);
+    Real E = dmrg.run();
+    ASSERT_NEAR(E, HEISENBERG_E0_L10, 1E-8);
+    ASSERT_GT(dmrg.history().size(), 1);
+    ASSERT_EQ(psi.center(), 0);
+    // the energy of the state agrees with the eigenvalue
+    Environment env(psi, H);
+    ASSERT_NEAR(env.expectation(0), E, 1E-8);
+}
+
+TEST(DMRG, Truncated){
+    // a truncated state stays variational
+    size_t L = 16;
+    MPO H = MPO::heisenberg(L);
+    MPS psi(L, 2, 4);
+    DMRGParams params;
+    params.maxChi = 8;
+    params.sweeps = 4;
+    DMRG dmrg(psi, H, params);
+    Real E = dmrg.run();
+    ASSERT_LE(psi.maxBondDim(), 8);
+    Environment env(psi, H);
+    ASSERT_NEAR(env.expectation(0), E, 1E-6);
+    ASSERT_LT(E, -6.91);
+}
+
+TEST(DMRG, OneSiteExpansion){
+    size_t L = 10;
+    MPO H = MPO::heisenberg(L);
+    MPS psi(L, 2, 2);
+    DMRGParams params;
+    params.maxChi = 32;
+    params.twoSite = false;
+    params.expansion = 1E-2;
+    params.sweeps = 20;
+    DMRG dmrg(psi, H, params);
+    Real E = dmrg.run();
+    ASSERT_GT(psi.maxBondDim(), 2);
+    ASSERT_NEAR(E, HEISENBERG_E0_L10, 1E-7);
+}
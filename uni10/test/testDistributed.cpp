@@ -0,0 +1,278 @@
+//
+//  testDistributed.cpp
+//
+//
+//  Created by Ying-Jer Kao on 6/6/16.
+//
+//
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+#include "uni10.hpp"
+using namespace uni10;
+
+// Run by runMPITests under mpiexec; every process runs every test, as the calls are collective.
+
+namespace{
+  Bond u1Bond(bondType tp, int n2, int n1, int n0, int p1, int p2){
+    std::vector<Qnum> qnums;
+    int degs[] = {n2, n1, n0, p1, p2};
+    for(int q = -2; q <= 2; q++)
+      qnums.insert(qnums.end(), degs[q + 2], Qnum(q));
+    return Bond(tp, qnums);
+  }
+
+  // Blocks 12 x 4, 17 x 6, 12 x 4 and 4 x 2, the second split over the grid at a threshold of 60
+  UniTensor tallTensor(){
+    std::vector<Bond> bonds;
+    bonds.push_back(u1Bond(BD_IN, 0, 2, 3, 2, 0));
+    bonds.push_back(u1Bond(BD_IN, 0, 2, 3, 2, 0));
+    bonds.push_back(u1Bond(BD_OUT, 0, 4, 6, 4, 2));
+    UniTensor T(bonds);
+    T.randomize();
+    return T;
+  }
+
+  Real blockDiff(const UniTensor& A, const UniTensor& B){
+    std::map<Qnum, Matrix> a = A.getBlocks(), b = B.getBlocks();
+    Real diff = 0;
+    for(std::map<Qnum, Matrix>::iterator it = a.begin(); it != a.end(); ++it){
+      Matrix d = it->second + (-1.0) * b[it->first];
+      diff = std::max(diff, d.norm());
+    }
+    return diff;
+  }
+
+  Matrix randomMatrix(size_t m, size_t n){
+    Matrix M(m, n);
+    for(size_t i = 0; i < m * n; i++)
+      M[i] = (Real)rand() / RAND_MAX - 0.5;
+    return M;
+  }
+}
+
+TEST(DistMatrix, ScatterGather){
+  ProcessGrid grid;
+  Matrix M = randomMatrix(37, 23);
+  DistMatrix D(grid, 37, 23, 4);
+  D.scatter(M.getElem(), 0);
+  size_t elems = D.localRows() * D.localCols(), total;
+  MPI_Allreduce(&elems, &total, 1, MPI_UNSIGNED_LONG, MPI_SUM, grid.comm());
+  EXPECT_EQ(37 * 23, total);
+  for(size_t i = 0; i < D.localRows(); i++)
+    for(size_t j = 0; j < D.localCols(); j++)
+      EXPECT_EQ(M[D.globalRow(i) * 23 + D.globalCol(j)], D.local()[i * D.localCols() + j]);
+  EXPECT_NEAR(M.norm(), D.norm(), 1E-12);
+  Matrix G = D.gather(grid.size() - 1);
+  if(grid.rank() == grid.size() - 1)
+    EXPECT_TRUE(G == M);
+  EXPECT_TRUE(D.allgather() == M);
+  EXPECT_TRUE(D.transpose().allgather() == Matrix(M).transpose());
+  DistMatrix O = D.redistribute(1 % grid.size());
+  EXPECT_EQ(grid.rank() == 1 % grid.size() ? 37 * 23 * sizeof(Real) : 0, O.localBytes());
+  EXPECT_TRUE(O.transpose().redistribute(-1).transpose().allgather() == M);
+  Matrix L = D.leading(10, 7).allgather();
+  for(size_t i = 0; i < 10; i++)
+    for(size_t j = 0; j < 7; j++)
+      EXPECT_EQ(M[i * 23 + j], L[i * 7 + j]);
+}
+
+TEST(DistMatrix, Multiply){
+  ProcessGrid grid;
+  Matrix A = randomMatrix(29, 41), B = randomMatrix(41, 18);
+  Matrix AB = A * B;
+  DistMatrix dA(grid, 29, 41, 8), dB(grid, 41, 18, 8);
+  dA.assign(A.getElem());
+  dB.assign(B.getElem());
+  Matrix C = multiply(dA, dB).allgather();
+  EXPECT_LT((C + (-1.0) * AB).norm(), 1E-12);
+  // operands and product in other layouts
+  C = multiply(dA.redistribute(1 % grid.size()), dB, grid.size() - 1).allgather();
+  EXPECT_LT((C + (-1.0) * AB).norm(), 1E-12);
+  C = multiply(dA.redistribute(2 % grid.size()), dB.redistribute(3 % grid.size()), -1).allgather();
+  EXPECT_LT((C + (-1.0) * AB).norm(), 1E-12);
+  EXPECT_THROW(multiply(dB, dB), std::exception);
+}
+
+TEST(DistUniTensor, ScatterGather){
+  ProcessGrid grid;
+  UniTensor T = tallTensor();
+  int label[] = {5, 6, 7};
+  T.setLabel(label);
+  DistUniTensor D = DistUniTensor::scatter(grid, T, 0, 60, 4);
+  EXPECT_EQ(3, D.bondNum());
+  EXPECT_EQ(2, D.inBondNum());
+  EXPECT_EQ(T.label(), D.label());
+  EXPECT_EQ(T.blockQnum(), D.blockQnum());
+  EXPECT_EQ(T.elemNum(), D.elemNum());
+  EXPECT_EQ(grid.size() > 1 ? -1 : 0, D.blockOwner(Qnum(0)));
+  EXPECT_NE(-1, D.blockOwner(Qnum(1)));
+  EXPECT_NEAR(T.norm(), D.norm(), 1E-12);
+  size_t bytes = D.localBytes(), total;
+  MPI_Allreduce(&bytes, &total, 1, MPI_UNSIGNED_LONG, MPI_SUM, grid.comm());
+  EXPECT_EQ(T.elemNum() * sizeof(Real), total);
+  UniTensor G = D.gather(0);
+  if(grid.rank() == 0){
+    EXPECT_TRUE(G.similar(T));
+    EXPECT_EQ(T.label(), G.label());
+    EXPECT_LT(blockDiff(G, T), 1E-14);
+  }
+}
+
+TEST(DistUniTensor, Contract){
+  ProcessGrid grid;
+  UniTensor A = tallTensor();
+  std::vector<Bond> bonds;
+  bonds.push_back(u1Bond(BD_IN, 0, 4, 6, 4, 2));
+  bonds.push_back(u1Bond(BD_OUT, 0, 3, 5, 3, 1));
+  UniTensor B(bonds);
+  B.randomize();
+  int labelA[] = {1, 2, 3}, labelB[] = {3, 4}, labelC[] = {1, 2, 4};
+  A.setLabel(labelA);
+  B.setLabel(labelB);
+  DistUniTensor dA = DistUniTensor::scatter(grid, A, 0, 60, 4);
+  DistUniTensor dB = DistUniTensor::scatter(grid, B, 1 % grid.size(), 20, 4);
+  UniTensor C = contract(dA, dB).gather(0);
+  UniTensor exact = contract(A, B, true);
+  exact.permute(labelC, 2);
+  if(grid.rank() == 0){
+    EXPECT_EQ(std::vector<int>(labelC, labelC + 3), C.label());
+    EXPECT_LT(blockDiff(C, exact), 1E-12);
+  }
+  // the bonds must line up without a permutation
+  int swapped[] = {4, 3};
+  dB.setLabel(swapped);
+  EXPECT_THROW(contract(dA, dB), std::exception);
+}
+
+TEST(DistUniTensor, TruncatedSvd){
+  ProcessGrid grid;
+  UniTensor T = tallTensor();
+  // a wide copy, the outgoing bond first
+  UniTensor W = T;
+  W.permute(1);
+  UniTensor cases[] = {T, W};
+  for(int c = 0; c < 2; c++){
+    UniTensor& A = cases[c];
+    DistUniTensor D = DistUniTensor::scatter(grid, A, 0, 60, 4);
+    Real discarded, exactDiscarded;
+    std::vector<DistUniTensor> usv = truncatedSvd(D, 1000, 0, discarded);
+    EXPECT_NEAR(0, discarded, 1E-12);
+    // U takes the incoming bonds and the new bond 10, VT the new bond 11 and the outgoing bonds
+    std::vector<int> labelU, labelV(1, 11);
+    for(size_t b = 0; b < D.bondNum(); b++)
+      ((int)b < D.inBondNum() ? labelU : labelV).push_back(b);
+    labelU.push_back(10);
+    int labelS[] = {10, 11};
+    usv[0].setLabel(labelU);
+    usv[1].setLabel(labelS);
+    usv[2].setLabel(labelV);
+    DistUniTensor US = contract(usv[0], usv[1]);
+    UniTensor R = contract(US, usv[2]).gather(0);
+    if(grid.rank() == 0)
+      EXPECT_LT(blockDiff(R, A), 1E-10);
+    usv = truncatedSvd(D, 5, 0, discarded);
+    std::vector<UniTensor> exact = truncatedSvd(A, 5, 0, exactDiscarded);
+    EXPECT_NEAR(exactDiscarded, discarded, 1E-10);
+    EXPECT_EQ(5, usv[1].bond(0).dim());
+    UniTensor S = usv[1].gather(0);
+    if(grid.rank() == 0){
+      EXPECT_EQ(exact[1].bond(0), S.bond(0));
+      EXPECT_LT(blockDiff(S, exact[1]), 1E-10);
+    }
+  }
+}
+
+TEST(DistUniTensor, TruncatedSvdSmallValues){
+  ProcessGrid grid;
+  UniTensor T = tallTensor();
+  // singular values from 1 down to 1E-10 in the block split over the grid, out of reach of A^T A
+  Qnum split;
+  std::map<Qnum, Matrix> blocks = T.getBlocks();
+  for(std::map<Qnum, Matrix>::iterator it = blocks.begin(); it != blocks.end(); ++it)
+    if(it->second.row() == 17){
+      std::vector<Matrix> usv = it->second.svd();
+      for(size_t i = 0; i < usv[1].row(); i++)
+        usv[1].at(i, i) = std::pow(10.0, -2.0 * i);
+      T.putBlock(it->first, usv[0] * usv[1] * usv[2]);
+      split = it->first;
+    }
+  for(int c = 0; c < 2; c++){
+    if(c)
+      T.permute(1);
+    DistUniTensor D = DistUniTensor::scatter(grid, T, 0, 60, 4);
+    Real discarded, exactDiscarded;
+    UniTensor S = truncatedSvd(D, 1000, 0, discarded)[1].gather(0);
+    if(grid.rank() == 0){
+      Matrix exact = truncatedSvd(T, 1000, 0, exactDiscarded)[1].getBlock(split);
+      Matrix Sb = S.getBlock(split);
+      ASSERT_EQ(exact.row(), Sb.row());
+      for(size_t i = 0; i < exact.row(); i++)
+        EXPECT_NEAR(1, Sb.at(i, i) / exact.at(i, i), 1E-6);
+    }
+  }
+}
+
+TEST(MPISectorScheduler, Launch){
+  // every process builds the same network, as a serial program started by mpiexec
+  std::vector<Qnum> qnums;
+  int degs[] = {3, 5, 3};
+  for(int q = -1; q <= 1; q++)
+    qnums.insert(qnums.end(), degs[q + 1], Qnum(q));
+  Bond in(BD_IN, qnums), out(BD_OUT, qnums);
+  std::vector<Bond> pair(2, in);
+  std::vector<Bond> bondsA(2, in), bondsB(1, combine(BD_IN, pair));
+  bondsA.push_back(combine(BD_OUT, pair));
+  bondsB.push_back(out);
+  bondsB.push_back(out);
+  UniTensor A(bondsA), B(bondsB);
+  UniTensor* Ts[] = {&A, &B};
+  for(int t = 0; t < 2; t++){
+    std::map<Qnum, Matrix> blocks = Ts[t]->getBlocks();
+    for(std::map<Qnum, Matrix>::iterator it = blocks.begin(); it != blocks.end(); ++it){
+      for(size_t i = 0; i < it->second.elemNum(); i++)
+        it->second[i] = std::sin(1.0 + t + 0.37 * i);
+      Ts[t]->putBlock(it->first, it->second);
+    }
+  }
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if(rank == 0){
+    std::ofstream fnet("./MPISector.net");
+    fnet << "A: 1 2; 3\n";
+    fnet << "B: 3; 4 5\n";
+    fnet << "TOUT: 1 2; 4 5\n";
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+  Network net("./MPISector.net");
+  net.putTensor("A", A);
+  net.putTensor("B", B);
+  UniTensor ref = net.launch();
+  MPISectorScheduler scheduler(MPI_COMM_WORLD, 0);
+  net.setScheduler(&scheduler);
+  UniTensor T = net.launch();
+  ASSERT_TRUE(T.similar(ref));
+  for(size_t i = 0; i < ref.elemNum(); i++)
+    ASSERT_NEAR(ref[i], T[i], 1E-10);
+  MPI_Barrier(MPI_COMM_WORLD);
+  if(rank == 0)
+    remove("./MPISector.net");
+}
+
+int main(int argc, char **argv){
+  MPI_Init(&argc, &argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if(rank != 0){
+    ::testing::TestEventListeners& listeners = ::testing::UnitTest::GetInstance()->listeners();
+    delete listeners.Release(listeners.default_result_printer());
+  }
+  int result = RUN_ALL_TESTS();
+  int failed = result != 0, anyFailed;
+  MPI_Allreduce(&failed, &anyFailed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  MPI_Finalize();
+  return anyFailed;
+}
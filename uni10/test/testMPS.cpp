@@ -0,0 +1,96 @@
+//
+//  testMPS.cpp
+//
+//
+//  Created by Ying-Jer Kao on 6/6/16.
+//
+//
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include <type_traits>
+#include "uni10.hpp"
+using namespace uni10;
+
+TEST(MPS, CanonicalForm){
+    MPS psi(8, 2, 8);
+    ASSERT_EQ(psi.center(), 0);
+    ASSERT_EQ(psi.maxBondDim(), 8);
+    ASSERT_EQ(psi.bondDim(1), 2);
+    ASSERT_NEAR(psi.norm(), 1, 1E-12);
+    ASSERT_NEAR(psi.overlap(psi), 1, 1E-12);
+    MPS phi = psi;
+    psi.moveCenter(5);
+    ASSERT_EQ(psi.center(), 5);
+    ASSERT_NEAR(psi.overlap(phi), 1, 1E-12);
+    // the sites left of the center are left-normalized
+    Matrix A = psi[2].getBlock();
+    Matrix AtA = A;
+    AtA.transpose();
+    AtA = AtA * A;
+    for(size_t r = 0; r < AtA.row(); r++)
+        for(size_t c = 0; c < AtA.col(); c++)
+            ASSERT_NEAR(AtA.at(r, c), r == c ? 1 : 0, 1E-12);
+    // the Schmidt values of a bond are the same from both sides
+    ASSERT_TRUE(psi.hasLambda(3));
+    Matrix lambda = psi.lambda(3);
+    ASSERT_NEAR(lambda.norm(), 1, 1E-12);
+    psi.moveCenter(2);
+    Matrix lambdaBack = psi.lambda(3);
+    for(size_t i = 0; i < lambda.elemNum(); i++)
+        ASSERT_NEAR(lambdaBack[i], lambda[i], 1E-12);
+    psi.setSite(4, psi[4]);
+    ASSERT_EQ(psi.center(), -1);
+    ASSERT_FALSE(psi.hasLambda(3));
+    ASSERT_NEAR(psi.norm(), 1, 1E-12);
+}
+
+TEST(MPS, EnvironmentEnergy){
+    size_t L = 6;
+    std::vector<Real> up(2, 0), plus(2, 1);
+    up[0] = 1;
+    MPS ferro = MPS::product(L, up);
+    MPO H = MPO::heisenberg(L, 1, 1, 0.3);
+    Environment env(ferro, H);
+    ASSERT_NEAR(env.expectation(0), (L - 1) * 0.25 - 0.3 * L / 2, 1E-12);
+
+    MPS para = MPS::product(L, plus);
+    MPO ising = MPO::transverseIsing(L, 1, 0.7);
+    Environment envIsing(para, ising);
+    ASSERT_NEAR(envIsing.expectation(L), -0.7 * L, 1E-12);
+
+    // every cut gives the same value
+    MPS psi(L, 2, 4);
+    Environment envPsi(psi, H);
+    Real E = envPsi.expectation(0);
+    for(size_t i = 1; i <= L; i++)
+        ASSERT_NEAR(envPsi.expectation(i), E, 1E-12);
+}
+
+TEST(MPS, EnvironmentIncremental){
+    size_t L = 10;
+    MPS psi(L, 2, 8);
+    MPO H = MPO::heisenberg(L);
+    Environment env(psi, H);
+    for(size_t i = 0; i <= L; i++)
+        env.left(i);
+    ASSERT_EQ(env.updates(), L);
+    env.right(0);
+    ASSERT_EQ(env.updates(), 2 * L);
+    // changing a site costs one update on each side
+    env.invalidate(4);
+    env.left(5);
+    env.right(4);
+    ASSERT_EQ(env.updates(), 2 * L + 2);
+
+    // environments spilled to disk give the same values
+    Real E = env.expectation(5);
+    Environment spilled(psi, H, 1);
+    for(size_t i = 0; i <= L; i++)
+        spilled.left(i);
+    ASSERT_GT(spilled.spilledNum(), 0);
+    ASSERT_NEAR(spilled.expectation(5), E, 1E-12);
+    // a copy would delete the spill files of the original
+    ASSERT_FALSE(std::is_copy_constructible<Environment>::value);
+    ASSERT_FALSE(std::is_copy_assignable<Environment>::value);
+}
@@ -134,3 +134,23 @@ TEST(Matrix, maxNorm){
         ASSERT_EQ(flag, true);
     }
 }
+
+TEST(Matrix, BlockOnExternalBuffer){
+
+    double elem[6] = {1, 2, 3, 4, 5, 6};
+    Block B(2, 3, elem);
+    ASSERT_EQ(B.typeID(), 1);
+    ASSERT_EQ(B.getElem(), elem);
+    Matrix M(B);
+    ASSERT_NE(M.getElem(), elem);
+    elem[4] = -5;
+    ASSERT_EQ(B.at(1, 1), -5);
+    ASSERT_EQ(M.at(1, 1), 5);
+
+    Complex celem[2] = {Complex(1, 1), Complex(0, 2)};
+    Block CB(2, 2, celem, true);
+    ASSERT_EQ(CB.typeID(), 2);
+    ASSERT_EQ(CB.elemNum(), 2);
+    ASSERT_EQ(CB.getElem(CTYPE), celem);
+    ASSERT_EQ(Matrix(CB)(1), Complex(0, 2));
+}
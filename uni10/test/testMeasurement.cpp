@@ -0,0 +1,172 @@
+//
+//  testMeasurement.cpp
+//
+//
+//  Created by Ying-Jer Kao on 6/6/16.
+//
+//
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "uni10.hpp"
+using namespace uni10;
+
+namespace{
+  const int L = 6, d = 2;
+
+  // Random MPS of L sites, neither normalized nor canonical
+  MPS randomMPS(){
+    int chis[L + 1] = {1, 2, 4, 5, 4, 2, 1};
+    std::vector<UniTensor> sites(L);
+    for(int i = 0; i < L; i++){
+      std::vector<Bond> bonds;
+      bonds.push_back(Bond(BD_IN, chis[i]));
+      bonds.push_back(Bond(BD_IN, d));
+      bonds.push_back(Bond(BD_OUT, chis[i + 1]));
+      sites[i] = UniTensor(bonds);
+      sites[i].randomize();
+    }
+    return MPS(sites);
+  }
+
+  // The d^L amplitudes, site 0 the most significant digit
+  std::vector<Real> amplitudes(const MPS& psi){
+    std::vector<Real> amps;
+    for(int c = 0; c < (int)std::pow((double)d, L); c++){
+      std::vector<Real> v(1, 1);
+      for(int i = 0; i < L; i++){
+        int s = (c / (int)std::pow((double)d, L - 1 - i)) % d;
+        Matrix A = psi[i].getRawElem();
+        int l = psi[i].bond(0).dim(), r = psi[i].bond(2).dim();
+        std::vector<Real> w(r, 0);
+        for(int x = 0; x < l; x++)
+          for(int z = 0; z < r; z++)
+            w[z] += v[x] * A[(x * d + s) * r + z];
+        v = w;
+      }
+      amps.push_back(v[0]);
+    }
+    return amps;
+  }
+
+  // op acting on site i of the state vector
+  std::vector<Real> apply(const std::vector<Real>& amps, int i, const Matrix& op){
+    std::vector<Real> out(amps.size(), 0);
+    int stride = (int)std::pow((double)d, L - 1 - i);
+    for(size_t c = 0; c < amps.size(); c++){
+      int s = (c / stride) % d;
+      for(int t = 0; t < d; t++)
+        out[c + (t - s) * stride] += op.getElem()[t * d + s] * amps[c];
+    }
+    return out;
+  }
+
+  Real expect(const std::vector<Real>& amps, const std::vector<Real>& phi){
+    Real num = 0, den = 0;
+    for(size_t c = 0; c < amps.size(); c++){
+      num += amps[c] * phi[c];
+      den += amps[c] * amps[c];
+    }
+    return num / den;
+  }
+
+  Matrix op(Real a, Real b, Real c, Real e){
+    Real elem[] = {a, b, c, e};
+    return Matrix(2, 2, elem);
+  }
+};
+
+TEST(Measurement, Local){
+  MPS psi = randomMPS();
+  std::vector<Real> amps = amplitudes(psi);
+  Measurement m(psi);
+  EXPECT_EQ(m.size(), L);
+  Real norm2 = 0;
+  for(size_t c = 0; c < amps.size(); c++)
+    norm2 += amps[c] * amps[c];
+  EXPECT_NEAR(m.norm() * m.norm(), norm2, 1E-10 * norm2);
+  std::vector<Matrix> ops;
+  ops.push_back(op(0.5, 0, 0, -0.5));
+  ops.push_back(op(0, 0.5, 0.5, 0));
+  ops.push_back(op(0.3, -1, 0.2, 0.7));
+  std::vector<std::vector<Real> > vals = m.local(ops);
+  ASSERT_EQ(vals.size(), ops.size());
+  for(size_t k = 0; k < ops.size(); k++)
+    for(int i = 0; i < L; i++)
+      EXPECT_NEAR(vals[k][i], expect(amps, apply(amps, i, ops[k])), 1E-10);
+  // a diagonal operator is the same as its dense form
+  Real sz[] = {0.5, -0.5};
+  std::vector<Real> mz = m.local(Matrix(2, 2, sz, true));
+  for(int i = 0; i < L; i++)
+    EXPECT_NEAR(mz[i], vals[0][i], 1E-12);
+  EXPECT_THROW(m.local(Matrix(3, 3)), std::exception);
+}
+
+TEST(Measurement, Correlations){
+  MPS psi = randomMPS();
+  std::vector<Real> amps = amplitudes(psi);
+  Measurement m(psi);
+  Matrix sz = op(0.5, 0, 0, -0.5), sp = op(0, 1, 0, 0), sm = op(0, 0, 1, 0), parity = op(1, 0, 0, -1);
+  std::vector<Correlator> corrs;
+  corrs.push_back(Correlator(sz, sz));
+  corrs.push_back(Correlator(sp, sm, parity));
+  corrs.push_back(Correlator(sp, sz, parity));   // shares the sweeps of the second
+  std::vector<Matrix> vals = m.correlations(corrs);
+  ASSERT_EQ(vals.size(), corrs.size());
+  for(size_t c = 0; c < corrs.size(); c++)
+    for(int i = 0; i < L; i++)
+      for(int j = 0; j < L; j++){
+        Real exact = 0;
+        if(i == j)
+          exact = expect(amps, apply(amps, i, corrs[c].left * corrs[c].right));
+        else if(i < j){
+          std::vector<Real> phi = apply(amps, j, corrs[c].right);
+          for(int k = i + 1; k < j && corrs[c].string.elemNum(); k++)
+            phi = apply(phi, k, corrs[c].string);
+          exact = expect(amps, apply(phi, i, corrs[c].left));
+        }
+        EXPECT_NEAR(vals[c][i * L + j], exact, 1E-10) << c << " " << i << " " << j;
+      }
+  Matrix single = m.correlation(corrs[1]);
+  for(int x = 0; x < L * L; x++)
+    EXPECT_NEAR(single[x], vals[1][x], 1E-12);
+
+  std::vector<Matrix> ops(3, sz);
+  ops[1] = sp + sm;
+  std::vector<Real> phi = apply(apply(apply(amps, 3, ops[2]), 2, ops[1]), 1, ops[0]);
+  EXPECT_NEAR(m.product(1, ops), expect(amps, phi), 1E-10);
+  EXPECT_THROW(m.product(4, ops), std::exception);
+}
+
+TEST(Measurement, Entropy){
+  MPS psi = randomMPS();
+  std::vector<Real> amps = amplitudes(psi);
+  Measurement m(psi);
+  std::vector<Real> S = m.entropies();
+  ASSERT_EQ(S.size(), L + 1);
+  EXPECT_EQ(S[0], 0);
+  EXPECT_EQ(S[L], 0);
+  Real norm2 = 0;
+  for(size_t c = 0; c < amps.size(); c++)
+    norm2 += amps[c] * amps[c];
+  for(int b = 1; b < L; b++){
+    int rows = (int)std::pow((double)d, b);
+    Matrix lambda = Matrix(rows, amps.size() / rows, &amps[0]).svd()[1];
+    std::vector<Real> p = m.spectrum(b);
+    Real exact = 0;
+    for(size_t k = 0; k < lambda.elemNum(); k++){
+      Real pk = lambda[k] * lambda[k] / norm2;
+      if(pk > 1E-12){
+        exact -= pk * std::log(pk);
+        ASSERT_LT(k, p.size());
+        EXPECT_NEAR(p[k], pk, 1E-8);
+      }
+    }
+    EXPECT_NEAR(S[b], exact, 1E-8);
+  }
+  // product states carry no entanglement
+  std::vector<Real> local(2, 1);
+  std::vector<Real> S0 = Measurement(MPS::product(L, local)).entropies();
+  for(int b = 0; b <= L; b++)
+    EXPECT_NEAR(S0[b], 0, 1E-12);
+}
@@ -6,11 +6,16 @@
 //
 //
 #include <gtest/gtest.h>
+#include <cmath>
 #include <iostream>
 #include <map>
 #include "uni10.hpp"
 #include <time.h>
 #include <vector>
+#include <fstream>
+#include <algorithm>
+#include <future>
+#include <thread>
 using namespace uni10;
 
 
@@ -91,3 +96,261 @@ TEST(Network,SimpleContract){
     ASSERT_EQ(C.typeID(), 2);
 
 }
+
+TEST(Network, DenseContract){
+
+    {
+        std::ofstream fnet("./Dense.net");
+        fnet << "A: 1 2; 3 4\n";
+        fnet << "B: 3 5; 6\n";
+        fnet << "C: 6 4; 7 2\n";
+        fnet << "TOUT: 5 1; 7\n";
+        fnet << "ORDER: ((A C) B)\n";
+    }
+    int dims[] = {0, 2, 3, 4, 2, 3, 2, 5};
+    int labelA[] = {1, 2, 3, 4};
+    int labelB[] = {3, 5, 6};
+    int labelC[] = {6, 4, 7, 2};
+    int labelOut[] = {5, 1, 7};
+    std::vector<Bond> bondsA, bondsB, bondsC;
+    for(int i = 0; i < 4; i++)
+        bondsA.push_back(Bond(i < 2 ? BD_IN : BD_OUT, dims[labelA[i]]));
+    for(int i = 0; i < 3; i++)
+        bondsB.push_back(Bond(i < 2 ? BD_IN : BD_OUT, dims[labelB[i]]));
+    for(int i = 0; i < 4; i++)
+        bondsC.push_back(Bond(i < 2 ? BD_IN : BD_OUT, dims[labelC[i]]));
+    UniTensor A(bondsA, labelA), B(bondsB, labelB), C(bondsC, labelC);
+    A.randomize();
+    B.randomize();
+    C.randomize();
+
+    Network net("./Dense.net");
+    net.putTensor("A", A);
+    net.putTensor("B", B);
+    net.putTensor("C", C);
+    UniTensor T = net.launch();
+    UniTensor AC = contract(A, C);
+    UniTensor ref = contract(AC, B);
+    ref.permute(labelOut, 2);
+    ASSERT_EQ(T.typeID(), 1);
+    ASSERT_EQ(T.label(), ref.label());
+    ASSERT_EQ(T.inBondNum(), 2);
+    for(size_t i = 0; i < ref.elemNum(); i++)
+        ASSERT_NEAR(T[i], ref[i], 1E-12);
+
+    UniTensor CB(CTYPE, bondsB, labelB);
+    CB.randomize();
+    net.putTensor("B", CB);
+    T = net.launch();
+    ref = contract(AC, CB);
+    ref.permute(labelOut, 2);
+    ASSERT_EQ(T.typeID(), 2);
+    for(size_t i = 0; i < ref.elemNum(); i++)
+        ASSERT_NEAR(std::abs(T(i) - ref(i)), 0, 1E-12);
+
+    // Contracted bonds leading in A and trailing in B: both operands are fed transposed to GEMM.
+    {
+        std::ofstream fnet("./Dense.net");
+        fnet << "A: 1 2; 3 4\n";
+        fnet << "D: 5 6; 1 2\n";
+        fnet << "TOUT: 3 5; 4 6\n";
+    }
+    int labelD[] = {5, 6, 1, 2};
+    int labelOut2[] = {3, 5, 4, 6};
+    std::vector<Bond> bondsD(2, Bond(BD_IN, 4));
+    bondsD.push_back(Bond(BD_OUT, dims[1]));
+    bondsD.push_back(Bond(BD_OUT, dims[2]));
+    UniTensor D(bondsD, labelD);
+    D.randomize();
+    Network net2("./Dense.net");
+    net2.putTensor("A", A);
+    net2.putTensor("D", D);
+    T = net2.launch();
+    ref = contract(A, D);
+    ref.permute(labelOut2, 2);
+    ASSERT_EQ(T.label(), ref.label());
+    for(size_t i = 0; i < ref.elemNum(); i++)
+        ASSERT_NEAR(T[i], ref[i], 1E-12);
+    remove("./Dense.net");
+}
+
+TEST(Network, DenseMemoryTracking){
+    if(!ProfileData::enabled())
+        return;
+    {
+        std::ofstream fnet("./Dense.net");
+        fnet << "A: 1; 2\n";
+        fnet << "B: 2; 3\n";
+        fnet << "C: 3; 4\n";
+        fnet << "TOUT: 1; 4\n";
+        fnet << "ORDER: ((A B) C)\n";
+    }
+    std::vector<Bond> bonds(2, Bond(BD_OUT, 32));
+    bonds[0] = Bond(BD_IN, 32);
+    UniTensor A(bonds), B(bonds), C(bonds);
+    A.identity();
+    B.identity();
+    C.identity();
+    Network net("./Dense.net");
+    net.putTensor("A", A);
+    net.putTensor("B", B);
+    net.putTensor("C", C);
+    memoryTrackBegin();
+    memoryResetPeak();
+    {
+        UniTensor T = net.launch("T");
+        // the GEMM output of the dense path is alive while it is copied into T
+        MemorySnapshot snap = memorySnapshot();
+        ASSERT_GE(snap.peakBytes, 2 * 32 * 32 * sizeof(Real));
+        bool dense = false;
+        for(size_t i = 0; i < snap.peak.size(); i++)
+            if(snap.peak[i].site.find("launch T > ((A B) C)") == 0)
+                dense = true;
+        ASSERT_TRUE(dense);
+    }
+    // the buffers of the dense path are released
+    ASSERT_EQ(memorySnapshot().liveBytes, 0);
+    memoryTrackEnd();
+    remove("./Dense.net");
+}
+
+namespace{
+    // A: 1 2; 3, B: 3; 4 5 and C: 4 5; 6 of U1 bonds, deterministic elements
+    void sectorNetwork(UniTensor& A, UniTensor& B, UniTensor& C){
+        std::ofstream fnet("./Sector.net");
+        fnet << "A: 1 2; 3\n";
+        fnet << "B: 3; 4 5\n";
+        fnet << "C: 4 5; 6\n";
+        fnet << "TOUT: 1 2; 6\n";
+        fnet << "ORDER: ((A B) C)\n";
+        fnet.close();
+        std::vector<Qnum> qnums;
+        int degs[] = {3, 5, 3};
+        for(int q = -1; q <= 1; q++)
+            qnums.insert(qnums.end(), degs[q + 1], Qnum(q));
+        Bond in(BD_IN, qnums), out(BD_OUT, qnums);
+        std::vector<Bond> pair(2, in);
+        Bond inPair = combine(BD_IN, pair), outPair = combine(BD_OUT, pair);
+        std::vector<Bond> bondsA(2, in), bondsB(1, inPair), bondsC(2, in);
+        bondsA.push_back(outPair);
+        bondsB.push_back(out);
+        bondsB.push_back(out);
+        bondsC.push_back(outPair);
+        A = UniTensor(bondsA);
+        B = UniTensor(bondsB);
+        C = UniTensor(bondsC);
+        UniTensor* Ts[] = {&A, &B, &C};
+        for(int t = 0; t < 3; t++){
+            std::map<Qnum, Matrix> blocks = Ts[t]->getBlocks();
+            for(std::map<Qnum, Matrix>::iterator it = blocks.begin(); it != blocks.end(); ++it){
+                for(size_t i = 0; i < it->second.elemNum(); i++)
+                    it->second[i] = std::sin(1.0 + t + 0.37 * i);
+                Ts[t]->putBlock(it->first, it->second);
+            }
+        }
+    }
+}
+
+TEST(Network, ForkScheduler){
+    UniTensor A, B, C;
+    sectorNetwork(A, B, C);
+    Network net("./Sector.net");
+    net.putTensor("A", A);
+    net.putTensor("B", B);
+    net.putTensor("C", C);
+    UniTensor ref = net.launch();
+    EXPECT_TRUE(net.getScheduler() == NULL);
+    ForkSectorScheduler scheduler(3, 0);
+    net.setScheduler(&scheduler);
+    UniTensor T = net.launch();
+    ASSERT_TRUE(T.similar(ref));
+    ASSERT_EQ(ref.label(), T.label());
+    for(size_t i = 0; i < ref.elemNum(); i++)
+        ASSERT_NEAR(ref[i], T[i], 1E-10);
+    // the scheduler is only installed inside launch
+    EXPECT_TRUE(sectorScheduler() == NULL);
+    int labelA[] = {1, 2, 3}, labelB[] = {3, 4, 5};
+    A.setLabel(labelA);
+    B.setLabel(labelB);
+    UniTensor AB = contract(A, B, false);
+    {
+        SchedulerScope scope(&scheduler);
+        EXPECT_EQ(&scheduler, sectorScheduler());
+        UniTensor forked = contract(A, B, false);
+        for(size_t i = 0; i < AB.elemNum(); i++)
+            ASSERT_NEAR(AB[i], forked[i], 1E-10);
+    }
+    EXPECT_TRUE(sectorScheduler() == NULL);
+    remove("./Sector.net");
+}
+
+TEST(Network, SplitSectors){
+    // one large product and two small ones over 4 workers
+    std::vector<double> A(40 * 30), B(30 * 20), C(40 * 20, 0), ref(40 * 20);
+    for(size_t i = 0; i < A.size(); i++)
+        A[i] = std::cos(0.1 * i);
+    for(size_t i = 0; i < B.size(); i++)
+        B[i] = std::sin(0.2 * i);
+    SectorGemm<double> big = {&A[0], &B[0], &C[0], 40, 20, 30};
+    SectorGemm<double> small = {&A[0], &B[0], &ref[0], 2, 20, 30};
+    std::vector<SectorGemm<double> > gemms(1, big);
+    gemms.push_back(small);
+    gemms.push_back(small);
+    std::vector<SectorGemm<double> > tasks = splitSectors(gemms, 4);
+    size_t rows = 0;
+    for(size_t t = 0; t + 2 < tasks.size(); t++){
+        EXPECT_EQ(big.C + rows * 20, tasks[t].C);
+        EXPECT_EQ(big.A + rows * 30, tasks[t].A);
+        rows += tasks[t].M;
+    }
+    EXPECT_EQ(40, rows);
+    EXPECT_EQ(4 + 2, tasks.size());
+    std::vector<int> owner = balanceSectors(tasks, 4);
+    std::vector<int> bands(4, 0);
+    for(size_t t = 0; t < 4; t++)
+        bands[owner[t]]++;
+    EXPECT_EQ(std::vector<int>(4, 1), bands);
+
+    Matrix MA(40, 30, &A[0]), MB(30, 20, &B[0]);
+    Matrix MC = MA * MB;
+    ForkSectorScheduler scheduler(4, 0);
+    std::vector<SectorGemm<double> > one(1, big);
+    scheduler.run(one);
+    for(size_t i = 0; i < C.size(); i++)
+        ASSERT_NEAR(MC[i], C[i], 1E-12);
+}
+
+TEST(Network, ForkSchedulerFallback){
+    std::vector<double> A(60 * 50), B(50 * 40), C(60 * 40);
+    for(size_t i = 0; i < A.size(); i++)
+        A[i] = std::cos(0.1 * i);
+    for(size_t i = 0; i < B.size(); i++)
+        B[i] = std::sin(0.2 * i);
+    Matrix MC = Matrix(60, 50, &A[0]) * Matrix(50, 40, &B[0]);
+    SectorGemm<double> gemm = {&A[0], &B[0], &C[0], 60, 40, 50};
+    // workers killed right away have their products computed by the caller
+    ForkSectorScheduler impatient(4, 0, 0);
+    std::vector<SectorGemm<double> > one(1, gemm);
+    impatient.run(one);
+    for(size_t i = 0; i < C.size(); i++)
+        ASSERT_NEAR(MC[i], C[i], 1E-12);
+    EXPECT_EQ(impatient.forked() + impatient.notForked(), 1u);
+    // products below minCost are not meant to be forked
+    ForkSectorScheduler patient(4, 1E12);
+    patient.run(one);
+    EXPECT_EQ(patient.forked() + patient.notForked(), 0u);
+    // a process with another thread is not forked
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::thread other([released](){ released.wait(); });
+    EXPECT_FALSE(ForkSectorScheduler::forkable());
+    std::fill(C.begin(), C.end(), 0);
+    ForkSectorScheduler scheduler(4, 0);
+    scheduler.run(one);
+    release.set_value();
+    other.join();
+    EXPECT_EQ(scheduler.forked(), 0u);
+    EXPECT_EQ(scheduler.notForked(), 1u);
+    for(size_t i = 0; i < C.size(); i++)
+        ASSERT_NEAR(MC[i], C[i], 1E-12);
+}
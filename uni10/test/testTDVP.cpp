@@ -0,0 +1,176 @@
+//
+//  testTDVP.cpp
+//
+//
+//  Created by Ying-Jer Kao on 6/6/16.
+//
+//
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "uni10.hpp"
+using namespace uni10;
+
+// Ground state energy of the open Heisenberg chain of 10 sites by exact diagonalization
+const Real HEISENBERG_E0_L10 = -4.258035207282883;
+
+namespace{
+  // The elements of the state of a short chain, the physical indices in the order of the sites
+  std::vector<Complex> fullState(const MPS& psi){
+    size_t L = psi.size();
+    UniTensor T;
+    std::vector<int> order(1, 100);
+    for(size_t i = 0; i < L; i++){
+      int label[] = {100 + (int)i, (int)i, 101 + (int)i};
+      UniTensor A(psi[i]);
+      A.setLabel(label);
+      T = i ? contract(T, A, true) : A;
+      order.push_back(i);
+    }
+    order.push_back(100 + L);
+    T.permute(order, 1);
+    if(T.typeID() == 1)
+      RtoC(T);
+    return std::vector<Complex>(T.getElem(CTYPE), T.getElem(CTYPE) + T.elemNum());
+  }
+
+  // The MPO of a short chain as a matrix, the bra indices as the rows
+  Matrix fullOperator(const MPO& H){
+    size_t L = H.size();
+    UniTensor T;
+    std::vector<int> order(1, 200);
+    for(size_t i = 0; i < L; i++){
+      int label[] = {200 + (int)i, (int)i, 201 + (int)i, 300 + (int)i};
+      UniTensor W(H[i]);
+      W.setLabel(label);
+      T = i ? contract(T, W, true) : W;
+      order.push_back(i);
+    }
+    for(size_t i = 0; i < L; i++)
+      order.push_back(300 + i);
+    order.push_back(200 + L);
+    T.permute(order, L + 1);
+    return T.getBlock();
+  }
+
+  // e^{-itA} x of the real symmetric A by its eigendecomposition
+  std::vector<Complex> exactEvolution(const Matrix& A, const std::vector<Complex>& x, Real t){
+    size_t n = x.size();
+    std::vector<Matrix> eig = A.eigh();
+    const Real* D = eig[0].getElem();
+    const Real* U = eig[1].getElem();
+    std::vector<Complex> y(n, 0);
+    for(size_t k = 0; k < n; k++){
+      Complex proj = 0;
+      for(size_t q = 0; q < n; q++)
+        proj += U[k * n + q] * x[q];
+      proj *= std::exp(Complex(0, -t * D[k]));
+      for(size_t p = 0; p < n; p++)
+        y[p] += U[k * n + p] * proj;
+    }
+    return y;
+  }
+};
+
+TEST(TDVP, KrylovExpm){
+  size_t n = 60;
+  Matrix M(n, n);
+  M.randomize();
+  Matrix A = M;
+  A.transpose();
+  A += M;
+  std::vector<Real> x(n);
+  for(size_t i = 0; i < n; i++)
+    x[i] = std::cos(i);
+  // imaginary time, against the dense exponential
+  Matrix expected = takeExp(-0.3, A) * Matrix(n, 1, &x[0]);
+  std::vector<Real> y(x);
+  size_t matvecs = lanczosExpm([&](const Real* in, Real* out){
+      Matrix r = A * Matrix(n, 1, in);
+      for(size_t i = 0; i < n; i++)
+        out[i] = r[i];
+    }, n, &y[0], -0.3, 1E-12, 20);
+  ASSERT_GT(matvecs, 0);
+  for(size_t i = 0; i < n; i++)
+    ASSERT_NEAR(y[i], expected[i], 1E-9 * expected.norm());
+  // real time keeps the norm and matches e^{-itA} by the eigendecomposition
+  std::vector<Complex> z(x.begin(), x.end());
+  matvecs = lanczosExpm([&](const Complex* in, Complex* out){
+      for(size_t p = 0; p < n; p++){
+        out[p] = 0;
+        for(size_t q = 0; q < n; q++)
+          out[p] += A.at(p, q) * in[q];
+      }
+    }, n, &z[0], 0.7, 1E-12, 20);
+  ASSERT_GT(matvecs, 0);
+  std::vector<Complex> exact = exactEvolution(A, std::vector<Complex>(x.begin(), x.end()), 0.7);
+  for(size_t p = 0; p < n; p++)
+    ASSERT_NEAR(std::abs(z[p] - exact[p]), 0, 1E-9);
+}
+
+TEST(TDVP, TwoSiteImaginaryTime){
+  size_t L = 10;
+  MPO H = MPO::heisenberg(L);
+  MPS psi(L, 2, 2);
+  TDVPParams params;
+  params.maxChi = 32;
+  TDVP tdvp(psi, H, params);
+  Real E = 0;
+  for(int n = 0; n < 60; n++)
+    E = tdvp.step(0.5);
+  ASSERT_NEAR(tdvp.time(), 30, 1E-12);
+  ASSERT_GT(psi.maxBondDim(), 2);
+  ASSERT_NEAR(E, HEISENBERG_E0_L10, 1E-5);
+  Environment env(psi, H);
+  ASSERT_NEAR(env.expectation(0), E, 1E-9);
+  ASSERT_NEAR(psi.norm(), 1, 1E-9);
+}
+
+TEST(TDVP, OneSiteKeepsBonds){
+  size_t L = 10;
+  MPO H = MPO::heisenberg(L);
+  MPS psi(L, 2, 16);
+  std::vector<int> dims;
+  for(size_t b = 0; b <= L; b++)
+    dims.push_back(psi.bondDim(b));
+  TDVPParams params;
+  params.twoSite = false;
+  TDVP tdvp(psi, H, params);
+  Real last = 0;
+  for(int n = 0; n < 60; n++){
+    Real E = tdvp.step(0.5);
+    if(n > 0)
+      ASSERT_LT(E, last + 1E-10);
+    last = E;
+  }
+  for(size_t b = 0; b <= L; b++)
+    ASSERT_EQ(psi.bondDim(b), dims[b]);
+  ASSERT_NEAR(last, HEISENBERG_E0_L10, 1E-5);
+  Environment env(psi, H);
+  ASSERT_NEAR(env.expectation(0), last, 1E-9);
+}
+
+TEST(TDVP, OneSiteRealTime){
+  size_t L = 6;
+  MPO H = MPO::heisenberg(L);
+  MPS psi(L, 2, 8);  // the full bond dimensions, the one-site integrator is then exact
+  std::vector<Complex> x = fullState(psi);
+  TDVPParams params;
+  params.twoSite = false;
+  TDVP tdvp(psi, H, params);
+  ASSERT_THROW(TDVP(psi, H).realTimeStep(0.1), std::exception);
+  Environment env0(psi, H);
+  Real E0 = env0.expectation(0);
+  Real dt = 0.05;
+  for(int n = 0; n < 20; n++)
+    ASSERT_NEAR(tdvp.realTimeStep(dt), E0, 1E-8);
+  ASSERT_NEAR(tdvp.realTime(), 1, 1E-12);
+  ASSERT_EQ(psi[0].typeID(), 2);
+  ASSERT_NEAR(psi.norm(), 1, 1E-9);
+  std::vector<Complex> y = fullState(psi);
+  std::vector<Complex> exact = exactEvolution(fullOperator(H), x, tdvp.realTime());
+  for(size_t p = 0; p < exact.size(); p++)
+    ASSERT_NEAR(std::abs(y[p] - exact[p]), 0, 1E-7);
+  // the imaginary time evolution needs real sites
+  ASSERT_THROW(tdvp.step(0.1), std::exception);
+}
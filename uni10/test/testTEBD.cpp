@@ -0,0 +1,153 @@
+//
+//  testTEBD.cpp
+//
+//
+//  Created by Ying-Jer Kao on 6/6/16.
+//
+//
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "uni10.hpp"
+using namespace uni10;
+
+namespace{
+  // S.S of two spin-1/2 in the basis |uu>, |ud>, |du>, |dd>
+  Matrix heisenbergBond(){
+    Real elem[] = {0.25, 0, 0, 0,
+                   0, -0.25, 0.5, 0,
+                   0, 0.5, -0.25, 0,
+                   0, 0, 0, 0.25};
+    return Matrix(4, 4, elem);
+  }
+
+  // Applies the 4 x 4 gate G to the sites i and i+1 of the state of L spin-1/2
+  void applyDense(std::vector<Complex>& psi, size_t L, size_t i, const Complex* G){
+    size_t left = 1 << i, right = 1 << (L - i - 2);
+    std::vector<Complex> out(psi.size(), 0);
+    for(size_t a = 0; a < left; a++)
+      for(size_t e = 0; e < right; e++)
+        for(size_t p = 0; p < 4; p++)
+          for(size_t q = 0; q < 4; q++)
+            out[(a * 4 + p) * right + e] += G[p * 4 + q] * psi[(a * 4 + q) * right + e];
+    psi.swap(out);
+  }
+};
+
+TEST(TEBD, ImaginaryTimeHeisenberg){
+  size_t L = 10;
+  std::vector<Real> up(2, 0), down(2, 0);
+  up[0] = down[1] = 1;
+  std::vector<UniTensor> sites;
+  for(size_t i = 0; i < L; i++)
+    sites.push_back(MPS::product(1, i % 2 ? down : up)[0]);
+  TEBDParams params;
+  params.maxChi = 32;
+  TEBD tebd(MPS(sites), params);
+  Matrix h = heisenbergBond();
+  Real taus[] = {0.1, 0.01};
+  for(int n = 0; n < 2; n++){
+    std::vector<Matrix> half(1, TEBD::imaginaryTimeGate(h, taus[n] / 2)), full(1, TEBD::imaginaryTimeGate(h, taus[n]));
+    for(int step = 0; step < 200; step++){
+      tebd.applyLayer(half, 0);
+      tebd.applyLayer(full, 1);
+      tebd.applyLayer(half, 0);
+    }
+  }
+  ASSERT_EQ(tebd.applications(), 400 * (5 + 4 + 5));
+  MPS psi = tebd.toMPS();
+  ASSERT_EQ(psi.center(), (int)L - 1);
+  ASSERT_NEAR(psi.norm(), 1, 1E-8);
+  MPO H = MPO::heisenberg(L);
+  Environment env(psi, H);
+  Real E = env.expectation(0);
+  ASSERT_GT(E, -4.258035207282883 - 1E-10);
+  ASSERT_NEAR(E, -4.258035207282883, 1E-3);
+  // the Vidal tensors stay close to canonical at small time steps
+  Real bonds = 0;
+  for(size_t i = 0; i + 1 < L; i++)
+    bonds += tebd.bondExpectation(i, h);
+  ASSERT_NEAR(bonds, E, 1E-2);
+}
+
+TEST(TEBD, RealTimeExact){
+  // without truncation the gates act exactly as on the full state
+  size_t L = 6;
+  std::vector<Real> up(2, 0), down(2, 0);
+  up[0] = down[1] = 1;
+  std::vector<UniTensor> sites;
+  std::vector<Complex> psi(1 << L, 0);
+  size_t neel = 0;
+  for(size_t i = 0; i < L; i++){
+    sites.push_back(MPS::product(1, i % 2 ? down : up)[0]);
+    neel = neel * 2 + i % 2;
+  }
+  psi[neel] = 1;
+  TEBDParams params;
+  params.cutoff = 0;
+  params.threads = 2;
+  TEBD tebd(MPS(sites), params);
+  Matrix gate = TEBD::realTimeGate(heisenbergBond(), 0.1);
+  ASSERT_EQ(gate.typeID(), 2);
+  std::vector<Matrix> gates(1, gate);
+  for(int step = 0; step < 10; step++){
+    tebd.step(gates);
+    for(int parity = 0; parity < 2; parity++)
+      for(size_t i = parity; i + 1 < L; i += 2)
+        applyDense(psi, L, i, gate.getElem(CTYPE));
+  }
+  ASSERT_TRUE(tebd.isComplex());
+  Real sz[] = {0.5, 0, 0, -0.5};
+  for(size_t i = 0; i < L; i++){
+    Real exact = 0;
+    for(size_t n = 0; n < psi.size(); n++)
+      exact += std::norm(psi[n]) * ((n >> (L - 1 - i)) & 1 ? -0.5 : 0.5);
+    ASSERT_NEAR(tebd.expectation(i, Matrix(2, 2, sz)), exact, 1E-10);
+  }
+}
+
+TEST(TEBD, InfiniteIsing){
+  // critical transverse field Ising chain, the energy per site is -4/pi
+  Real hBond[] = {-1, -0.5, -0.5, 0,
+                  -0.5, 1, 0, -0.5,
+                  -0.5, 0, 1, -0.5,
+                  0, -0.5, -0.5, -1};
+  Matrix h(4, 4, hBond);
+  TEBDParams params;
+  params.maxChi = 16;
+  std::vector<Real> plus(2, 1);
+  TEBD tebd = TEBD::infinite(2, plus, params);
+  ASSERT_TRUE(tebd.isInfinite());
+  Real taus[] = {0.1, 0.01};
+  for(int n = 0; n < 2; n++){
+    std::vector<Matrix> gates(1, TEBD::imaginaryTimeGate(h, taus[n]));
+    for(int step = 0; step < 500; step++)
+      tebd.step(gates);
+  }
+  ASSERT_EQ(tebd.bondDim(0), 16);
+  Real energy = (tebd.bondExpectation(0, h) + tebd.bondExpectation(1, h)) / 2;
+  ASSERT_NEAR(energy, -4 / M_PI, 1E-3);
+}
+
+TEST(TEBD, ParallelLayer){
+  // the gates of a layer give the same state with one or several threads
+  size_t L = 16;
+  MPS psi(L, 2, 32);
+  Matrix gate = TEBD::imaginaryTimeGate(heisenbergBond(), 0.05);
+  std::vector<Matrix> gates(1, gate);
+  TEBDParams params;
+  params.maxChi = 24;
+  params.threads = 1;
+  TEBD serial(psi, params);
+  params.threads = 4;
+  TEBD parallel(psi, params);
+  for(int step = 0; step < 3; step++){
+    ASSERT_DOUBLE_EQ(serial.step(gates), parallel.step(gates));
+  }
+  for(size_t b = 1; b < L; b++){
+    Matrix ls = serial.lambda(b), lp = parallel.lambda(b);
+    ASSERT_EQ(ls.row(), lp.row());
+    for(size_t k = 0; k < ls.row(); k++)
+      ASSERT_DOUBLE_EQ(ls.getElem()[k], lp.getElem()[k]);
+  }
+}
@@ -10,8 +10,10 @@
 #include <iostream>
 #include <map>
 #include "uni10.hpp"
+#include <uni10/tools/uni10_tools.h>
 #include <time.h>
 #include <vector>
+#include <stdexcept>
 using namespace uni10;
 
 TEST(Tools, RDotR){
@@ -303,3 +305,32 @@ TEST(Tools, CAddR){
 
 }
 
+TEST(Tools, ParallelTasks){
+
+    EXPECT_EQ(3u, taskThreads(3, 10));
+    EXPECT_EQ(2u, taskThreads(3, 2));
+    EXPECT_EQ(1u, taskThreads(3, 0));
+    // at least a grain of cost per thread
+    EXPECT_EQ(2u, taskThreads(4, 10, 2.5, 1));
+    EXPECT_EQ(1u, taskThreads(4, 10, 0.5, 1));
+
+    std::vector<int> done(100, 0);
+    std::vector<size_t> thread(100);
+    parallelTasks(done.size(), 3, [&](size_t k, size_t t){
+        done[k]++;
+        thread[k] = t;
+    });
+    for(size_t k = 0; k < done.size(); k++){
+        ASSERT_EQ(1, done[k]);
+        ASSERT_LT(thread[k], 3u);
+    }
+    // the other tasks still run
+    std::fill(done.begin(), done.end(), 0);
+    EXPECT_THROW(parallelTasks(done.size(), 4, [&](size_t k, size_t){
+        done[k]++;
+        if(k == 17)
+            throw std::runtime_error("task 17");
+    }), std::runtime_error);
+    EXPECT_EQ(std::vector<int>(100, 1), done);
+
+}
@@ -11,6 +11,11 @@
 #include "uni10.hpp"
 #include <time.h>
 #include <vector>
+#include <thread>
+#include <fstream>
+#include <iterator>
+#include <type_traits>
+#include <algorithm>
 using namespace uni10;
 
 TEST(UniTensor,DefaultConstructor){
@@ -253,3 +258,672 @@ TEST(UniTensor, maxNorm){
     }
 }
 
+
+TEST(UniTensor, ConcurrentContract){
+    const int nthreads = 4, ncontract = 50;
+    std::vector<Bond> bonds(2, Bond(BD_OUT, 8));
+    bonds[0] = Bond(BD_IN, 8);
+    int labelA[] = {1, 2};
+    int labelB[] = {2, 3};
+    int labelC[] = {3, 1};
+    std::vector<UniTensor> As, Bs, serial;
+    for(int i = 0; i < ncontract; i++){
+        UniTensor A(bonds), B(bonds);
+        A.randomize();
+        B.randomize();
+        A.setLabel(labelA);
+        B.setLabel(labelB);
+        UniTensor C = contract(A, B, false);
+        C.permute(labelC, 1);
+        As.push_back(A);
+        Bs.push_back(B);
+        serial.push_back(C);
+    }
+    std::string before = UniTensor::profile(false);
+    std::vector<std::vector<UniTensor> > results(nthreads);
+    std::vector<std::thread> workers;
+    for(int t = 0; t < nthreads; t++)
+        workers.push_back(std::thread([&, t](){
+            for(int i = 0; i < ncontract; i++){
+                UniTensor A = As[i], B = Bs[i];  // contract permutes its operands
+                UniTensor C = contract(A, B, false);
+                C.permute(labelC, 1);
+                results[t].push_back(C);
+            }
+        }));
+    for(size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+    // Every thread gets the serial results, and leaves its inputs untouched.
+    for(int t = 0; t < nthreads; t++){
+        ASSERT_EQ(results[t].size(), (size_t)ncontract);
+        for(int i = 0; i < ncontract; i++){
+            ASSERT_EQ(results[t][i].label(), serial[i].label());
+            ASSERT_EQ(results[t][i].getBlock(), serial[i].getBlock());
+        }
+    }
+    results.clear();
+    std::string after = UniTensor::profile(false);
+    // The number of existing tensors and elements must be balanced again.
+    ASSERT_EQ(before.substr(0, before.find("Max")), after.substr(0, after.find("Max")));
+}
+
+TEST(UniTensor, ProfileCounters){
+    std::vector<Bond> bonds(2, Bond(BD_OUT, 4));
+    bonds[0] = Bond(BD_IN, 3);
+    UniTensor A(bonds), B(bonds);
+    A.randomize();
+    B.randomize();
+    int labelA[] = {1, 2};
+    int labelB[] = {3, 2};
+    A.setLabel(labelA);
+    B.setLabel(labelB);
+
+    UniTensor::resetProfile();
+    ProfileData before = UniTensor::profileData();
+    UniTensor C = contract(A, B, false);
+    ProfileData cost = UniTensor::profileData() - before;
+    if(!ProfileData::enabled()){
+        ASSERT_EQ(cost[PROF_CONTRACT].calls, 0);
+        return;
+    }
+    ASSERT_EQ(cost[PROF_CONTRACT].calls, 1);
+    // A (3 x 4) times B^T (4 x 3)
+    ASSERT_EQ(cost[PROF_CONTRACT].flops, 2 * 3 * 3 * 4);
+    ASSERT_GE(cost[PROF_PERMUTE].calls, 2);
+    ASSERT_GE(cost[PROF_ALLOC].calls, 1);
+
+    UniTensor D = C;
+    Matrix M = C.getBlock();
+    std::vector<Matrix> usv = M.svd();
+    cost = UniTensor::profileData() - before;
+    ASSERT_GE(cost[PROF_COPY].calls, 2);
+    ASSERT_EQ(cost[PROF_COPY].bytes >= C.elemNum() * sizeof(Real), true);
+    ASSERT_EQ(cost[PROF_SVD].calls, 1);
+    // the real and the complex eigensolvers are counted once per call
+    std::vector<Matrix> eigs = M.eig();
+    ASSERT_EQ((UniTensor::profileData() - before)[PROF_EIG].calls, 1);
+
+    RtoC(D);
+    ASSERT_EQ(UniTensor::profileData()[PROF_RTOC].calls, 1);
+    UniTensor::resetProfile();
+    ASSERT_EQ(UniTensor::profileData()[PROF_CONTRACT].calls, 0);
+}
+
+TEST(UniTensor, TraceRegions){
+    std::vector<Bond> bonds(2, Bond(BD_OUT, 4));
+    bonds[0] = Bond(BD_IN, 4);
+    traceClear();
+    traceBegin();
+    std::vector<std::thread> workers;
+    for(int t = 0; t < 2; t++)
+        workers.push_back(std::thread([&bonds](){
+            TraceScope scope("worker \"region\"");
+            UniTensor A(bonds), B(bonds);
+            A.randomize();
+            B.randomize();
+            UniTensor C = A * B;
+        }));
+    for(size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+    traceEnd();
+    {
+        TraceScope scope("not recorded");
+    }
+    traceSave("trace.json");
+    std::ifstream ifs("trace.json");
+    std::string json((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    ifs.close();
+    remove("trace.json");
+    ASSERT_NE(json.find("\"traceEvents\""), std::string::npos);
+    ASSERT_NE(json.find("worker \\\"region\\\""), std::string::npos);
+    ASSERT_EQ(json.find("not recorded"), std::string::npos);
+    if(ProfileData::enabled())
+        ASSERT_NE(json.find("\"name\": \"contract\""), std::string::npos);
+    traceClear();
+}
+
+TEST(UniTensor, MemoryTracking){
+    if(!ProfileData::enabled())
+        return;
+    std::vector<Bond> bonds(2, Bond(BD_OUT, 16));
+    bonds[0] = Bond(BD_IN, 16);
+    memoryTrackBegin();
+    memoryResetPeak();
+    size_t peak;
+    {
+        MemoryScope site("test");
+        UniTensor A(bonds, "A"), B(bonds, "B");
+        A.randomize();
+        B.randomize();
+        int labelB[] = {1, 2};
+        B.setLabel(labelB);
+        UniTensor C = A * B;
+        MemorySnapshot snap = memorySnapshot();
+        ASSERT_GE(snap.liveBytes, 3 * 16 * 16 * sizeof(Real));
+        bool tensorA = false;
+        for(size_t i = 0; i < snap.live.size(); i++)
+            if(snap.live[i].site == "test > tensor A")
+                tensorA = true;
+        ASSERT_TRUE(tensorA);
+        peak = snap.peakBytes;
+    }
+    MemorySnapshot snap = memorySnapshot();
+    // everything allocated inside the scope is freed, the peak remembers it
+    ASSERT_EQ(snap.liveBytes, 0);
+    ASSERT_EQ(snap.peakBytes, peak);
+    ASSERT_NE(snap.str().find("test > tensor B"), std::string::npos);
+    memoryTrackEnd();
+}
+
+TEST(UniTensor, TuningParams){
+    TuningParams saved = tuning();
+    TuningParams params;
+    params.gemmSmallCutoff = 1000;
+    params.permuteTile = 3;
+    params.vectorParallelMin = 5;
+    saveTuning("tuning.test", params);
+    std::ofstream("tuning.test", std::ios::app) << "# comment\nunknown_key 1\n";
+    TuningParams loaded = loadTuning("tuning.test");
+    ASSERT_EQ(loaded.gemmSmallCutoff, 1000);
+    ASSERT_EQ(loaded.permuteTile, 3);
+    ASSERT_EQ(loaded.vectorParallelMin, 5);
+    ASSERT_EQ(loaded.source, "tuning.test");
+    std::ofstream("tuning.test") << "permute_tile x\n";
+    ASSERT_THROW(loadTuning("tuning.test"), std::exception);
+    params.permuteTile = 0;
+    setTuning(params);
+    ASSERT_EQ(tuning().permuteTile, 1);
+
+    // the results do not depend on the parameters
+    int dims[] = {3, 5, 7, 4};
+    std::vector<Bond> bonds;
+    for(int b = 0; b < 4; b++)
+        bonds.push_back(Bond(b < 2 ? BD_IN : BD_OUT, dims[b]));
+    UniTensor T(bonds);
+    T.randomize();
+    int order[] = {2, 0, 3, 1};
+    std::vector<Real> ref(T.elemNum());
+    Real* elem = T.getElem();
+    for(int i = 0; i < 3; i++) for(int j = 0; j < 5; j++) for(int k = 0; k < 7; k++) for(int l = 0; l < 4; l++)
+        ref[((k * 3 + i) * 4 + l) * 5 + j] = elem[((i * 5 + j) * 7 + k) * 4 + l];
+    Matrix A(13, 9), B(9, 11);
+    A.randomize();
+    B.randomize();
+    std::vector<Matrix> products;
+    size_t tiles[] = {1, 3, 32};
+    for(int t = 0; t < 3; t++){
+        params.permuteTile = tiles[t];
+        params.gemmSmallCutoff = t % 2 ? 0 : 100000;
+        setTuning(params);
+        UniTensor P = T;
+        P.permute(order, 2);
+        for(size_t i = 0; i < ref.size(); i++)
+            ASSERT_EQ(P.getElem()[i], ref[i]);
+        products.push_back(A * B);
+    }
+
+    // the parameters can be replaced while kernels run on another thread
+    std::thread tuner([&](){
+        TuningParams p = params;
+        for(int i = 0; i < 200; i++){
+            p.permuteTile = tiles[i % 3];
+            setTuning(p);
+        }
+    });
+    bool same = true;
+    for(int i = 0; i < 50; i++){
+        UniTensor P = T;
+        P.permute(order, 2);
+        same = same && std::equal(ref.begin(), ref.end(), P.getElem());
+    }
+    tuner.join();
+    ASSERT_TRUE(same);
+    setTuning(saved);
+    remove("tuning.test");
+    for(size_t i = 0; i < products[0].elemNum(); i++)
+        ASSERT_NEAR(products[0][i], products[1][i], 1E-12);
+}
+
+TEST(UniTensor, InPlaceArithmetic){
+    Qnum q0(0), q1(1), q_1(-1);
+    std::vector<Qnum> qnums;
+    qnums.push_back(q_1);
+    qnums.push_back(q0);
+    qnums.push_back(q0);
+    qnums.push_back(q1);
+    std::vector<Bond> bonds(2, Bond(BD_IN, qnums));
+    bonds.push_back(Bond(BD_OUT, qnums));
+    bonds.push_back(Bond(BD_OUT, qnums));
+    UniTensor A(bonds), B(bonds), C(bonds);
+    A.randomize();
+    B.randomize();
+    C.randomize();
+    size_t n = A.elemNum();
+    std::vector<Real> a(A.getElem(), A.getElem() + n), b(B.getElem(), B.getElem() + n), c(C.getElem(), C.getElem() + n);
+
+    TuningParams saved = tuning();
+    for(int threaded = 0; threaded < 2; threaded++){
+        TuningParams params = saved;
+        params.vectorParallelMin = threaded ? 8 : 0;
+        setTuning(params);
+        UniTensor T = A;
+        T.scale(2.0);
+        T.axpy(-0.5, B);
+        T.axpby(3.0, C, 0.5);
+        T.add(B);
+        T.hadamard(C);
+        for(size_t i = 0; i < n; i++)
+            ASSERT_NEAR(T.getElem()[i], ((2 * a[i] - 0.5 * b[i]) * 0.5 + 3 * c[i] + b[i]) * c[i], 1E-12);
+        // aliasing
+        T.axpby(1.0, T, 1.0);
+        for(size_t i = 0; i < n; i++)
+            ASSERT_NEAR(T.getElem()[i], 2 * ((2 * a[i] - 0.5 * b[i]) * 0.5 + 3 * c[i] + b[i]) * c[i], 1E-12);
+    }
+    setTuning(saved);
+
+    // the operators agree with the kernels
+    UniTensor S = A + B, T = A;
+    T += B;
+    S *= 1.5;
+    T.scale(1.5);
+    for(size_t i = 0; i < n; i++){
+        ASSERT_NEAR(S.getElem()[i], 1.5 * (a[i] + b[i]), 1E-12);
+        ASSERT_EQ(S.getElem()[i], T.getElem()[i]);
+    }
+
+    // complex scalars and operands promote the tensor, a real operand is used as it is
+    UniTensor Z = A;
+    Z.axpy(Complex(0, 1), B);
+    ASSERT_EQ(Z.typeID(), 2);
+    Z.add(C);
+    Z.hadamard(B);
+    for(size_t i = 0; i < n; i++){
+        Complex z = Z.getElem(CTYPE)[i];
+        ASSERT_NEAR(z.real(), (a[i] + c[i]) * b[i], 1E-12);
+        ASSERT_NEAR(z.imag(), b[i] * b[i], 1E-12);
+    }
+    UniTensor R = A;
+    R.add(Z);
+    ASSERT_EQ(R.typeID(), 2);
+    ASSERT_NEAR(R.getElem(CTYPE)[0].real(), a[0] + (a[0] + c[0]) * b[0], 1E-12);
+
+    // bonds of the same blocks are combined sector by sector
+    std::vector<Qnum> more(qnums);
+    more.push_back(Qnum(10));
+    std::vector<Bond> other(bonds);
+    other[0] = Bond(BD_IN, more);
+    UniTensor D(other);
+    D.randomize();
+    std::map<Qnum, Matrix> blocksA = A.getBlocks(), blocksD = D.getBlocks();
+    ASSERT_EQ(blocksA.size(), blocksD.size());
+    UniTensor E = A;
+    E.axpy(2.0, D);
+    for(std::map<Qnum, Matrix>::iterator it = blocksA.begin(); it != blocksA.end(); it++){
+        Matrix expect = it->second + 2.0 * blocksD[it->first];
+        Matrix got = E.getBlock(it->first);
+        for(size_t k = 0; k < got.elemNum(); k++)
+            ASSERT_NEAR(got[k], expect[k], 1E-12);
+    }
+    std::vector<Bond> wrong(bonds);
+    wrong[0] = Bond(BD_IN, 2);
+    UniTensor W(wrong);
+    W.randomize();
+    ASSERT_THROW(E.add(W), std::exception);
+    ASSERT_THROW(E += W, std::exception);
+
+    // bonds of the same blocks but of other dimensions or in another order are not combined
+    std::vector<Bond> bonds23, bonds32;
+    bonds23.push_back(Bond(BD_IN, 2));
+    bonds23.push_back(Bond(BD_IN, 3));
+    bonds23.push_back(Bond(BD_OUT, 4));
+    bonds32.push_back(Bond(BD_IN, 3));
+    bonds32.push_back(Bond(BD_IN, 2));
+    bonds32.push_back(Bond(BD_OUT, 4));
+    UniTensor P(bonds23), Q(bonds32);
+    P.randomize();
+    Q.randomize();
+    ASSERT_THROW(P.add(Q), std::exception);
+    ASSERT_THROW(P.axpy(2.0, Q), std::exception);
+    ASSERT_THROW(P.hadamard(Q), std::exception);
+    ASSERT_THROW(P = lazy(P) + lazy(Q), std::exception);
+    std::vector<Qnum> swapped(qnums.rbegin(), qnums.rend());
+    std::vector<Bond> reordered(bonds);
+    reordered[0] = Bond(BD_IN, swapped);
+    UniTensor O(reordered);
+    O.randomize();
+    ASSERT_THROW(E.add(O), std::exception);
+}
+
+TEST(UniTensor, LazyExpressions){
+    std::vector<Qnum> qnums;
+    qnums.push_back(Qnum(-1));
+    qnums.push_back(Qnum(0));
+    qnums.push_back(Qnum(0));
+    qnums.push_back(Qnum(1));
+    std::vector<Bond> bonds(2, Bond(BD_IN, qnums));
+    bonds.push_back(Bond(BD_OUT, qnums));
+    bonds.push_back(Bond(BD_OUT, qnums));
+    UniTensor A(bonds), B(bonds), C(bonds);
+    A.randomize();
+    B.randomize();
+    C.randomize();
+    int labels[] = {5, 6, 7, 8};
+    A.setLabel(labels);
+    size_t n = A.elemNum();
+    std::vector<Real> a(A.getElem(), A.getElem() + n), b(B.getElem(), B.getElem() + n), c(C.getElem(), C.getElem() + n);
+
+    UniTensor R = 2 * lazy(A) - 0.5 * lazy(B) + hadamard(lazy(A), C);
+    ASSERT_EQ(R.label(), A.label());
+    for(size_t i = 0; i < n; i++)
+        ASSERT_NEAR(R.getElem()[i], 2 * a[i] - 0.5 * b[i] + a[i] * c[i], 1E-12);
+
+    // the target is updated in place, also when it is an operand
+    Real* elem = R.getElem();
+    R = lazy(R) - 3 * lazy(B);
+    ASSERT_EQ(R.getElem(), elem);
+    for(size_t i = 0; i < n; i++)
+        ASSERT_NEAR(R.getElem()[i], 2 * a[i] - 3.5 * b[i] + a[i] * c[i], 1E-12);
+
+    // complex scalars, conjugation and products
+    UniTensor Z = Complex(0, 1) * lazy(A) + B;
+    ASSERT_EQ(Z.typeID(), 2);
+    UniTensor N = hadamard(conj(lazy(Z)), Z) - lazy(B);
+    for(size_t i = 0; i < n; i++){
+        ASSERT_NEAR(Z.getElem(CTYPE)[i].imag(), a[i], 1E-12);
+        ASSERT_NEAR(N.getElem(CTYPE)[i].real(), a[i] * a[i] + b[i] * b[i] - b[i], 1E-12);
+        ASSERT_NEAR(N.getElem(CTYPE)[i].imag(), 0, 1E-12);
+    }
+
+    // the threaded evaluation gives the same elements
+    TuningParams saved = tuning(), params = saved;
+    params.vectorParallelMin = 8;
+    setTuning(params);
+    UniTensor P = 2 * lazy(A) - 0.5 * lazy(B) + hadamard(lazy(A), C);
+    setTuning(saved);
+    for(size_t i = 0; i < n; i++)
+        ASSERT_EQ(P.getElem()[i], 2 * a[i] - 0.5 * b[i] + a[i] * c[i]);
+
+    // tensors of the same blocks and different bonds are combined sector by sector
+    std::vector<Qnum> more(qnums);
+    more.push_back(Qnum(10));
+    std::vector<Bond> other(bonds);
+    other[0] = Bond(BD_IN, more);
+    UniTensor D(other);
+    D.randomize();
+    UniTensor S = lazy(A) + 2 * lazy(D);
+    std::map<Qnum, Matrix> blocksA = A.getBlocks(), blocksD = D.getBlocks();
+    for(std::map<Qnum, Matrix>::iterator it = blocksA.begin(); it != blocksA.end(); it++){
+        Matrix expect = it->second + 2.0 * blocksD[it->first];
+        Matrix got = S.getBlock(it->first);
+        for(size_t k = 0; k < got.elemNum(); k++)
+            ASSERT_NEAR(got[k], expect[k], 1E-12);
+    }
+    ASSERT_THROW(S = TensorExpr(), std::exception);
+}
+
+TEST(UniTensor, LazyPermute){
+    std::vector<Bond> bonds;
+    bonds.push_back(Bond(BD_IN, 2));
+    bonds.push_back(Bond(BD_IN, 3));
+    bonds.push_back(Bond(BD_OUT, 4));
+    UniTensor T(bonds);
+    T.randomize();
+    int labels[] = {0, 1, 2};
+    int rotated[] = {2, 0, 1};
+    T.setLabel(labels);
+
+    // permuting back restores the original elements without moving them
+    Real* elem = T.getElem();
+    T.permute(rotated, 1);
+    T.permute(labels, 2);
+    ASSERT_EQ(T.getElem(), elem);
+    UniTensor U = T;
+
+    U.permute(rotated, 1);
+    ASSERT_EQ(U.inBondNum(), 1);
+    ASSERT_EQ(U.bond(0).dim(), 4);
+    std::vector<int> idx(3), rot(3);
+    for(idx[0] = 0; idx[0] < 2; idx[0]++)
+        for(idx[1] = 0; idx[1] < 3; idx[1]++)
+            for(idx[2] = 0; idx[2] < 4; idx[2]++){
+                rot[0] = idx[2];
+                rot[1] = idx[0];
+                rot[2] = idx[1];
+                ASSERT_EQ(U.at(rot), T.at(idx));
+            }
+
+    // a chain of permutations moves the elements once, as the steps one by one would
+    std::vector<Qnum> qnums;
+    qnums.push_back(Qnum(-1));
+    qnums.push_back(Qnum(0));
+    qnums.push_back(Qnum(0));
+    qnums.push_back(Qnum(1));
+    std::vector<Bond> sbonds(2, Bond(BD_IN, qnums));
+    sbonds.push_back(Bond(BD_OUT, qnums));
+    sbonds.push_back(Bond(BD_OUT, qnums));
+    UniTensor A(sbonds);
+    A.randomize();
+    int labelA[] = {0, 1, 2, 3};
+    int first[] = {3, 1, 0, 2};
+    int second[] = {1, 2, 3, 0};
+    A.setLabel(labelA);
+    UniTensor B = A, C = A;
+    B.permute(first, 1);
+    B.getElem();
+    B.permute(second, 3);
+    C.permute(first, 1);
+    C.permute(second, 3);
+    ASSERT_EQ(C.label(), B.label());
+    ASSERT_EQ(C.inBondNum(), 3);
+    ASSERT_TRUE(C.elemCmp(B));
+
+    // the copies, the complex elements and the contractions see the permuted tensor
+    UniTensor D = C;
+    ASSERT_TRUE(D.elemCmp(B));
+    UniTensor Z = A;
+    RtoC(Z);
+    Z.permute(first, 1);
+    Z.permute(second, 3);
+    for(size_t i = 0; i < B.elemNum(); i++)
+        ASSERT_EQ(Z.getElem(CTYPE)[i].real(), B.getElem()[i]);
+    UniTensor E = A;
+    int labelE[] = {4, 5, 1, 0};
+    E.setLabel(labelE);
+    C.permute(labelA, 2);
+    UniTensor F = contract(C, E, false), G = contract(A, E, false);
+    ASSERT_TRUE(F.elemCmp(G));
+    ASSERT_EQ(C.label(), std::vector<int>(labelA, labelA + 4));
+}
+
+TEST(UniTensor, LazyPermuteConcurrentCopies){
+    std::vector<Qnum> qnums;
+    qnums.push_back(Qnum(-1));
+    qnums.push_back(Qnum(0));
+    qnums.push_back(Qnum(0));
+    qnums.push_back(Qnum(1));
+    std::vector<Bond> bonds(2, Bond(BD_IN, qnums));
+    bonds.push_back(Bond(BD_OUT, qnums));
+    bonds.push_back(Bond(BD_OUT, qnums));
+    UniTensor A(bonds);
+    A.randomize();
+    int labels[] = {0, 1, 2, 3};
+    int permuted[] = {3, 1, 0, 2};
+    A.setLabel(labels);
+    UniTensor expect = A;
+    expect.permute(permuted, 1);
+    expect.getElem();
+
+    // several threads copy the same pending permutation, the first one to arrive moves the elements
+    const int nthreads = 4;
+    for(int round = 0; round < 20; round++){
+        UniTensor P = A;
+        P.permute(permuted, 1);
+        std::vector<UniTensor> copies(nthreads);
+        std::vector<std::thread> workers;
+        for(int t = 0; t < nthreads; t++)
+            workers.push_back(std::thread([&, t](){
+                copies[t] = UniTensor(P);
+            }));
+        for(size_t t = 0; t < workers.size(); t++)
+            workers[t].join();
+        for(int t = 0; t < nthreads; t++){
+            ASSERT_EQ(copies[t].label(), expect.label());
+            ASSERT_TRUE(copies[t].elemCmp(expect));
+            ASSERT_EQ(copies[t].getBlocks(), expect.getBlocks());
+        }
+    }
+}
+
+TEST(UniTensor, CopyOnWrite){
+    std::vector<Qnum> qnums;
+    qnums.push_back(Qnum(-1));
+    qnums.push_back(Qnum(0));
+    qnums.push_back(Qnum(1));
+    std::vector<Bond> bonds(2, Bond(BD_IN, qnums));
+    bonds.push_back(Bond(BD_OUT, qnums));
+    bonds.push_back(Bond(BD_OUT, qnums));
+    UniTensor A(bonds);
+    A.randomize();
+    std::vector<Qnum> blockQnums = A.blockQnum();
+    const Real* elem = A.const_getBlock(blockQnums[0]).getElem();
+
+    // copies and assignments share the elements until one of them is written
+    UniTensor B = A, C;
+    C = B;
+    ASSERT_EQ(B.const_getBlock(blockQnums[0]).getElem(), elem);
+    ASSERT_EQ(C.const_getBlock(blockQnums[0]).getElem(), elem);
+    Real a0 = A.at(0);
+    B.getElem()[0] = a0 + 1;
+    ASSERT_NE(B.const_getBlock(blockQnums[0]).getElem(), elem);
+    ASSERT_EQ(A.at(0), a0);
+    ASSERT_EQ(C.at(0), a0);
+    ASSERT_EQ(B.at(0), a0 + 1);
+
+    // in-place arithmetic and block writes detach the written tensor only
+    C *= 2.0;
+    ASSERT_EQ(C.at(0), 2 * a0);
+    ASSERT_EQ(A.at(0), a0);
+    UniTensor D = A;
+    D.putBlock(blockQnums[0], Matrix(D.getBlock(blockQnums[0]).row(), D.getBlock(blockQnums[0]).col()));
+    ASSERT_EQ(A.const_getBlock(blockQnums[0]).getElem(), elem);
+    ASSERT_EQ(A.at(0), a0);
+    UniTensor E = A * 3.0;
+    ASSERT_EQ(E.at(0), 3 * a0);
+    ASSERT_EQ(A.at(0), a0);
+    UniTensor F = A;
+    F = 2 * lazy(F) - lazy(A);
+    ASSERT_EQ(F.at(0), a0);
+    ASSERT_EQ(A.const_getBlock(blockQnums[0]).getElem(), elem);
+
+    // the last owner frees the elements
+    std::string before = UniTensor::profile(false);
+    {
+        UniTensor G = A, H = G;
+        G.randomize();
+    }
+    std::string after = UniTensor::profile(false);
+    ASSERT_EQ(before.substr(0, before.find("Max")), after.substr(0, after.find("Max")));
+    ASSERT_EQ(A.at(0), a0);
+
+    // once a writable address is handed out, copies get their own elements
+    UniTensor P = A;
+    Real* p = P.getElem();
+    UniTensor Q = P, R;
+    R = P;
+    p[0] = a0 + 5;
+    ASSERT_EQ(P.at(0), a0 + 5);
+    ASSERT_EQ(Q.at(0), a0);
+    ASSERT_EQ(R.at(0), a0);
+    ASSERT_EQ(A.at(0), a0);
+}
+
+TEST(UniTensor, BlockViews){
+    std::vector<Qnum> qnums;
+    qnums.push_back(Qnum(-1));
+    qnums.push_back(Qnum(0));
+    qnums.push_back(Qnum(1));
+    std::vector<Bond> bonds(2, Bond(BD_IN, qnums));
+    bonds.push_back(Bond(BD_OUT, qnums));
+    bonds.push_back(Bond(BD_OUT, qnums));
+    UniTensor A(bonds);
+    A.randomize();
+    std::vector<Qnum> blockQnums = A.blockQnum();
+    Qnum q = blockQnums[1];
+    Matrix orig = A.getBlock(q);
+
+    // only the tensor makes views, a const block does not become writable
+    ASSERT_FALSE((std::is_constructible<BlockView, const Block&>::value));
+
+    // a view refers to the elements of the sector in place, and block algorithms run on it
+    UniTensor B = A;
+    BlockView view = B.getBlockView(q);
+    ASSERT_EQ(view.getElem(), B.const_getBlock(q).getElem());
+    ASSERT_NE(view.getElem(), A.const_getBlock(q).getElem());
+    ASSERT_EQ(view.row(), orig.row());
+    ASSERT_EQ(view.col(), orig.col());
+    ASSERT_EQ(view.ld(), orig.col());
+    std::vector<Matrix> usv = view.svd(), ref = orig.svd();
+    for(size_t i = 0; i < ref[1].elemNum(); i++)
+        ASSERT_NEAR(usv[1][i], ref[1][i], 1E-12);
+    ASSERT_NEAR(view.norm(), orig.norm(), 1E-12);
+
+    // writes through the view land in the tensor, and not in the copy it shared the elements with
+    view *= 2.0;
+    view += orig;
+    for(size_t i = 0; i < orig.elemNum(); i++){
+        ASSERT_NEAR(B.const_getBlock(q)[i], 3 * orig[i], 1E-12);
+        ASSERT_EQ(A.const_getBlock(q)[i], orig[i]);
+    }
+    view.put(orig);
+    ASSERT_EQ(B.getBlock(q), orig);
+    view.set_zero();
+    ASSERT_EQ(B.const_getBlock(q).norm(), 0);
+    ASSERT_ANY_THROW(view.put(Matrix(orig.row() + 1, orig.col())));
+    ASSERT_ANY_THROW(view *= Complex(0, 1));
+    ASSERT_ANY_THROW(B.getBlockView(Qnum(5)));
+
+    // copies made while a view is alive do not see its writes
+    view.put(orig);
+    UniTensor U = B;
+    view *= 2.0;
+    ASSERT_EQ(U.getBlock(q), orig);
+    ASSERT_EQ(B.getBlock(q), 2.0 * orig);
+
+    // a complex view takes real blocks
+    UniTensor C(CTYPE, bonds);
+    C.set_zero();
+    std::map<Qnum, BlockView> views = C.getBlockViews();
+    ASSERT_EQ(views.size(), blockQnums.size());
+    views[q].put(orig);
+    views[q] *= Complex(0, 1);
+    for(size_t i = 0; i < orig.elemNum(); i++)
+        ASSERT_EQ(C.const_getBlock(q).getElem(CTYPE)[i], Complex(0, orig[i]));
+}
+
+TEST(UniTensor, TensorOnExternalBuffer){
+    double elem[6] = {1, 2, 3, 4, 5, 6};
+    std::vector<Bond> bonds;
+    bonds.push_back(Bond(BD_IN, 2));
+    bonds.push_back(Bond(BD_OUT, 3));
+    {
+        UniTensor T(bonds, elem);
+        ASSERT_EQ(T.typeID(), 1);
+        ASSERT_EQ(T.getElem(), elem);
+        elem[4] = -5;
+        ASSERT_EQ(T.at(4), -5);
+        UniTensor U = T;
+        T *= 2.0;
+        ASSERT_EQ(T.getElem(), elem);
+        ASSERT_EQ(elem[4], -10);
+        ASSERT_EQ(U.at(4), -5);
+    }
+    // the buffer outlives the tensor
+    ASSERT_EQ(elem[5], 12);
+
+    Complex celem[6];
+    UniTensor C(bonds, celem);
+    C.set_zero();
+    C.getBlockView() += Matrix(2, 3, elem);
+    ASSERT_EQ(celem[4], Complex(-10, 0));
+    ASSERT_EQ(C.getElem(CTYPE), celem);
+}